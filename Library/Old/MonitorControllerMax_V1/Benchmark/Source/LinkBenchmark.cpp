@@ -0,0 +1,383 @@
+﻿/*
+  ==============================================================================
+
+    LinkBenchmark.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    跨进程链路基准实现 - 跟随进程启动/握手、RenderState轮询、结果行汇总
+
+  ==============================================================================
+*/
+
+#include "LinkBenchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    double ticksToMicroseconds(juce::int64 ticks) noexcept
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    }
+
+    // 链路按Master组打开：基准进程里的插件都在默认组，取插件所在组的链路
+    SharedStateLink* getLink(const MonitorControllerMaxAudioProcessor* processor) noexcept
+    {
+        auto* group = processor != nullptr ? processor->getMasterGroup() : nullptr;
+        return group != nullptr ? group->getSharedLink() : nullptr;
+    }
+}
+
+//==============================================================================
+LinkBenchmark::LinkBenchmark(const Options& benchmarkOptions)
+    : juce::Thread("Link Benchmark"),
+      options(benchmarkOptions)
+{
+}
+
+LinkBenchmark::~LinkBenchmark()
+{
+    stopThread(options.timeoutMs);
+}
+
+//==============================================================================
+LinkBenchmark::Result LinkBenchmark::runMaster(MonitorControllerMaxAudioProcessor& master)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+    jassert(master.getCurrentRole() == PluginRole::Master);
+
+    Result result;
+    result.processes = options.processes;
+
+    auto* link = getLink(&master);
+    if (link == nullptr || !link->isLocalMaster())
+    {
+        result.failureReason = "Cross-process link is not open or this process does not hold the Master token";
+        return result;
+    }
+
+    // 探测只切换Mute：先清空Master的Solo/Mute，跟随进程的期望状态就是Mute掩码本身
+    const auto channelNames = master.getPhysicalMapper().getActiveSemanticChannels();
+    auto& masterState = master.getSemanticState();
+    for (const auto& channelName : channelNames)
+    {
+        masterState.setSoloState(channelName, false);
+        masterState.setMuteState(channelName, false);
+    }
+
+    if (channelNames.empty())
+    {
+        result.failureReason = "Layout has no channels";
+        return result;
+    }
+
+    //==========================================================================
+    // 以当前可执行文件启动跟随进程，逐个等待握手
+    const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName();
+
+    juce::StringArray arguments{ executable, "--link-follower",
+                                 "--link-segment=" + options.segmentName,
+                                 "--link-timeout=" + juce::String(options.timeoutMs),
+                                 "--layout=" + options.speakerLayout,
+                                 "--sub=" + options.subLayout };
+
+    std::vector<std::unique_ptr<juce::ChildProcess>> followers;
+    for (int i = 0; i < options.processes; ++i)
+    {
+        auto process = std::make_unique<juce::ChildProcess>();
+        if (!process->start(arguments, juce::ChildProcess::wantStdOut))
+        {
+            result.failureReason = "Failed to start follower process " + juce::String(i);
+            break;
+        }
+
+        followers.push_back(std::move(process));
+    }
+
+    for (auto& process : followers)
+    {
+        juce::String line;
+        do
+        {
+            line = readLine(*process);
+        } while (line.isNotEmpty() && line != READY_LINE);
+
+        if (line == READY_LINE)
+            ++result.readyFollowers;
+    }
+
+    //==========================================================================
+    // 固定间隔切换Mute：每次切换是一次快照发布
+    const auto publishedBefore = link->getStats().published;
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    if (result.readyFollowers > 0)
+    {
+        for (int i = 0; i < options.probes; ++i)
+        {
+            const auto& channelName = channelNames[static_cast<size_t>(i) % channelNames.size()];
+            masterState.setMuteState(channelName, !masterState.getMuteState(channelName));
+            ++result.probes;
+
+            juce::Thread::sleep(options.intervalMs);
+        }
+    }
+
+    result.totalSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    result.published = link->getStats().published - publishedBefore;
+
+    // 释放Master令牌：跟随进程看到Master离开后输出结果并退出
+    master.switchToStandalone();
+
+    for (auto& process : followers)
+    {
+        FollowerResult follower;
+
+        juce::String line;
+        do
+        {
+            line = readLine(*process);
+        } while (line.isNotEmpty() && !parseResultLine(line, follower));
+
+        if (!process->waitForProcessToFinish(options.timeoutMs))
+            process->kill();
+
+        result.followers.push_back(follower);
+    }
+
+    if (result.failureReason.isEmpty() && result.readyFollowers != options.processes)
+        result.failureReason = juce::String(options.processes - result.readyFollowers) + " follower processes did not attach to the Master";
+
+    return result;
+}
+
+//==============================================================================
+int LinkBenchmark::runFollower(const Options& options)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // 与宿主恢复工程相同的顺序：构造 -> 布局 -> Slave角色 -> prepareToPlay（Slave不初始化OSC）
+    auto processor = std::make_unique<MonitorControllerMaxAudioProcessor>();
+    processor->setCurrentLayout(options.speakerLayout, options.subLayout);
+    processor->switchToSlave();
+    processor->prepareToPlay(48000.0, 512);
+
+    int exitCode = 1;
+    {
+        LinkBenchmark benchmark(options);
+        benchmark.follower = processor.get();
+
+        for (const auto& channelInfo : processor->getCurrentLayout().channels)
+        {
+            const int channelId = OSCAddressTable::findChannelId(channelInfo.name);
+            if (channelId == OSCAddressTable::INVALID_CHANNEL_ID
+                || channelInfo.channelIndex < 0 || channelInfo.channelIndex >= RenderState::MAX_CHANNELS)
+                continue;
+
+            benchmark.channels.push_back({ channelId, channelInfo.channelIndex });
+        }
+
+        if (getLink(processor.get()) != nullptr && !benchmark.channels.empty())
+        {
+            // 基准线程结束后退出分发循环；远端状态在分发循环中应用
+            benchmark.startThread();
+            juce::MessageManager::getInstance()->runDispatchLoop();
+            benchmark.stopThread(options.timeoutMs);
+            exitCode = benchmark.measuring.load() ? 0 : 1;
+        }
+    }
+
+    processor->releaseResources();
+    processor.reset();
+    return exitCode;
+}
+
+//==============================================================================
+// 跟随进程的基准线程：握手 -> 逐次发布测量 -> Master离开后输出结果
+void LinkBenchmark::run()
+{
+    auto* link = getLink(follower);
+    const auto timeoutTicks = juce::Time::secondsToHighResolutionTicks(options.timeoutMs / 1000.0);
+
+    auto finish = [](const juce::String& line)
+    {
+        if (line.isNotEmpty())
+        {
+            std::printf("%s\n", line.toRawUTF8());
+            std::fflush(stdout);
+        }
+
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    };
+
+    // 握手：远端Master存活，且本实例已反映其当前状态
+    uint64_t stateWord = 0;
+    juce::int64 publishedTicks = 0;
+    const auto handshakeDeadline = juce::Time::getHighResolutionTicks() + timeoutTicks;
+
+    while (!threadShouldExit())
+    {
+        if (link->isRemoteMasterActive() && link->readState(stateWord, publishedTicks) && isReflected(stateWord))
+            break;
+
+        if (juce::Time::getHighResolutionTicks() > handshakeDeadline)
+        {
+            finish({});
+            return;
+        }
+
+        juce::Thread::sleep(1);
+    }
+
+    measuring.store(true);
+    std::printf("%s\n", READY_LINE);
+    std::fflush(stdout);
+
+    //==========================================================================
+    std::vector<double> samplesUs;
+    int timeouts = 0;
+    uint32_t lastVersion = MasterStateSnapshot::unpack(stateWord).version;
+
+    while (!threadShouldExit() && link->isRemoteMasterActive())
+    {
+        if (!link->readState(stateWord, publishedTicks))
+            continue;
+
+        const uint32_t version = MasterStateSnapshot::unpack(stateWord).version;
+        if (version == lastVersion)
+        {
+            juce::Thread::yield();
+            continue;
+        }
+
+        // 版本跳跃：中间的发布在本线程看到之前已被覆盖
+        missed += static_cast<int>(version - lastVersion) - 1;
+        lastVersion = version;
+
+        // 等到活跃RenderState反映该状态；期间出现更新的发布则本次记为被覆盖
+        const auto deadline = juce::Time::getHighResolutionTicks() + timeoutTicks;
+        uint64_t lastPublish = follower->stateManager->getPublishCount();
+        bool reflected = isReflected(stateWord);
+        bool overtaken = false;
+
+        while (!reflected && !threadShouldExit() && juce::Time::getHighResolutionTicks() < deadline)
+        {
+            uint64_t latestWord = 0;
+            juce::int64 latestTicks = 0;
+            if (link->readState(latestWord, latestTicks) && MasterStateSnapshot::unpack(latestWord).version != version)
+            {
+                overtaken = true;
+                break;
+            }
+
+            const uint64_t publish = follower->stateManager->getPublishCount();
+            if (publish != lastPublish)
+            {
+                lastPublish = publish;
+                reflected = isReflected(stateWord);
+            }
+            else
+            {
+                juce::Thread::yield();
+            }
+        }
+
+        if (reflected)
+            samplesUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - publishedTicks));
+        else if (overtaken)
+            ++missed;
+        else if (!threadShouldExit())
+            ++timeouts;
+    }
+
+    finish(formatResultLine(samplesUs, timeouts));
+}
+
+bool LinkBenchmark::isReflected(uint64_t stateWord) const noexcept
+{
+    // 基准线程不是音频线程：按发布计数/版本号校验后的一致快照比较
+    const auto snapshot = MasterStateSnapshot::unpack(stateWord);
+    bool reflected = false;
+
+    const bool hasState = follower->stateManager->readRenderState([this, &snapshot, &reflected](const RenderState& state)
+    {
+        reflected = std::all_of(channels.begin(), channels.end(), [&snapshot, &state](const auto& channel)
+        {
+            const bool expectedMute = (snapshot.muteMask >> channel.channelId) & 1u;
+            return state.channelShouldMute[channel.physicalIndex] == expectedMute;
+        });
+    });
+
+    return hasState && reflected;
+}
+
+juce::String LinkBenchmark::formatResultLine(std::vector<double>& samplesUs, int timeouts) const
+{
+    const auto summary = OSCBenchmark::LatencySummary::fromSamples(samplesUs, timeouts);
+    auto* link = getLink(follower);
+    const auto stats = link != nullptr ? link->getStats() : SharedStateLink::Stats{};
+
+    juce::String line(RESULT_PREFIX);
+    line << " samples=" << summary.samples
+         << " timeouts=" << summary.timeouts
+         << " mean=" << juce::String(summary.meanUs, 2)
+         << " p50=" << juce::String(summary.p50Us, 2)
+         << " p90=" << juce::String(summary.p90Us, 2)
+         << " p99=" << juce::String(summary.p99Us, 2)
+         << " p999=" << juce::String(summary.p999Us, 2)
+         << " max=" << juce::String(summary.maxUs, 2)
+         << " missed=" << missed
+         << " deliveryMean=" << juce::String(stats.meanDeliveryUs, 2)
+         << " deliveryMax=" << juce::String(stats.maxDeliveryUs, 2)
+         << " resyncs=" << juce::String(static_cast<juce::int64>(stats.resyncs));
+    return line;
+}
+
+//==============================================================================
+juce::String LinkBenchmark::readLine(juce::ChildProcess& process)
+{
+    // 逐字节读取：管道读取阻塞到有数据或子进程退出（退出时返回空行）
+    juce::MemoryOutputStream line;
+    char c = 0;
+
+    while (process.readProcessOutput(&c, 1) == 1)
+    {
+        if (c == '\n')
+        {
+            if (line.getDataSize() > 0)
+                return line.toString().trim();
+            continue;
+        }
+
+        line.writeByte(c);
+    }
+
+    return line.toString().trim();
+}
+
+bool LinkBenchmark::parseResultLine(const juce::String& line, FollowerResult& result)
+{
+    if (!line.startsWith(RESULT_PREFIX))
+        return false;
+
+    juce::StringPairArray fields;
+    for (const auto& token : juce::StringArray::fromTokens(line.fromFirstOccurrenceOf(" ", false, false), " ", ""))
+        fields.set(token.upToFirstOccurrenceOf("=", false, false), token.fromFirstOccurrenceOf("=", false, false));
+
+    result.reported = true;
+    result.apply.samples = fields["samples"].getIntValue();
+    result.apply.timeouts = fields["timeouts"].getIntValue();
+    result.apply.meanUs = fields["mean"].getDoubleValue();
+    result.apply.p50Us = fields["p50"].getDoubleValue();
+    result.apply.p90Us = fields["p90"].getDoubleValue();
+    result.apply.p99Us = fields["p99"].getDoubleValue();
+    result.apply.p999Us = fields["p999"].getDoubleValue();
+    result.apply.maxUs = fields["max"].getDoubleValue();
+    result.missed = fields["missed"].getIntValue();
+    result.deliveryMeanUs = fields["deliveryMean"].getDoubleValue();
+    result.deliveryMaxUs = fields["deliveryMax"].getDoubleValue();
+    result.resyncs = static_cast<uint64_t>(fields["resyncs"].getLargeIntValue());
+    return true;
+}
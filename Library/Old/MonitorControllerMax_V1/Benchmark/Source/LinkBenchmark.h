@@ -0,0 +1,111 @@
+﻿/*
+  ==============================================================================
+
+    LinkBenchmark.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    跨进程链路基准 - 同一台机器上一个Master进程驱动K个Slave进程（共享内存，无套接字）
+
+    - 父进程：本实例作为Master，以当前可执行文件启动K个跟随进程，握手后按固定间隔切换Mute
+    - 跟随进程：一个Slave实例，基准线程等待RenderState反映最新发布的状态
+    - 延迟：Master发布（共享段时间戳）-> Slave进程的活跃RenderState反映新状态
+      （高精度计时为同机单调时钟，跨进程可直接相减）
+    - 跟随进程结束时向stdout输出一行LINK_RESULT，由父进程汇总
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "OSCBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/**
+ * 跨进程链路基准
+ *
+ * runMaster在消息线程同步运行（父进程不需要分发循环：发布在调用线程完成，心跳由链路线程写入）；
+ * runFollower在跟随进程的主线程运行分发循环，远端状态经链路回调在消息线程应用。
+ * 跟随进程的基准线程以yield轮询，K个跟随进程会各占一个核心，K应小于核心数。
+ */
+class LinkBenchmark : private juce::Thread
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        int processes = 4;              // 跟随进程数
+        int probes = 500;               // Master的Mute切换次数
+        int intervalMs = 5;             // 切换间隔（小于事件环容量对应的时长，跟随进程不会溢出）
+        int timeoutMs = 10000;          // 跟随进程握手/结束的超时
+        juce::String segmentName;       // 共享段名（父进程传给跟随进程）
+        juce::String speakerLayout{ "7.1.4" };
+        juce::String subLayout{ "2" };
+    };
+
+    struct FollowerResult
+    {
+        bool reported = false;                      // 收到LINK_RESULT
+        OSCBenchmark::LatencySummary apply;         // 发布 -> 跟随进程RenderState反映
+        int missed = 0;                             // 被下一次发布覆盖、未单独观测到的切换
+        double deliveryMeanUs = 0.0;                // 发布 -> 跟随进程链路线程读到
+        double deliveryMaxUs = 0.0;
+        uint64_t resyncs = 0;
+    };
+
+    struct Result
+    {
+        int processes = 0;
+        int readyFollowers = 0;                     // 完成握手（已作为Slave跟随远端Master）
+        int probes = 0;
+        uint64_t published = 0;                     // 父进程链路发布次数
+        double totalSeconds = 0.0;
+        std::vector<FollowerResult> followers;
+        juce::String failureReason;
+    };
+
+    //==============================================================================
+    explicit LinkBenchmark(const Options& options);
+    ~LinkBenchmark() override;
+
+    // 父进程：master必须已是Master角色；返回时所有跟随进程已退出，master已切回Standalone
+    Result runMaster(MonitorControllerMaxAudioProcessor& master);
+
+    // 跟随进程入口（消息线程），返回进程退出码
+    static int runFollower(const Options& options);
+
+    static constexpr const char* READY_LINE = "LINK_READY";
+    static constexpr const char* RESULT_PREFIX = "LINK_RESULT";
+
+private:
+    //==============================================================================
+    struct FollowerChannel
+    {
+        int channelId = 0;          // OSCAddressTable通道ID = 快照位号
+        int physicalIndex = 0;
+    };
+
+    // 跟随进程的基准线程
+    void run() override;
+    bool isReflected(uint64_t stateWord) const noexcept;
+    juce::String formatResultLine(std::vector<double>& samplesUs, int timeouts) const;
+
+    static juce::String readLine(juce::ChildProcess& process);
+    static bool parseResultLine(const juce::String& line, FollowerResult& result);
+
+    //==============================================================================
+    const Options options;
+
+    // 仅跟随进程使用
+    MonitorControllerMaxAudioProcessor* follower = nullptr;
+    std::vector<FollowerChannel> channels;
+    int missed = 0;
+    std::atomic<bool> measuring{ false };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinkBenchmark)
+};
@@ -0,0 +1,552 @@
+﻿/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC基准测试命令行入口 - 无界面运行（Linux/Windows）
+
+    用法：
+      OSCBenchmark [--mix=single,burst,pattern] [--probes=1000] [--warmup=50]
+                   [--burst-size=8] [--pattern-size=4] [--duration=5] [--rate=0]
+                   [--port=9445] [--sink-port=9444] [--layout=7.1.4] [--sub=2]
+                   [--csv=latency.csv] [--verbose-log]
+      OSCBenchmark --session-slaves=40 [--session-groups=1] [--master-clicks=200] [--layout=7.1.4] [--sub=2]
+      OSCBenchmark --link-processes=4 [--link-probes=500] [--link-interval=5] [--layout=7.1.4] [--sub=2]
+      OSCBenchmark --tcp-cycles=5 [--tcp-port=9446] [--tcp-toggles=20] [--layout=7.1.4] [--sub=2]
+      OSCBenchmark --stress-instances=200 [--stress-ops=5000] [--stress-groups=4] [--stress-seed=1]
+                   [--stress-audio-threads=2] [--stress-observers=2] [--stress-scaling=1,4,16,64,256]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <cstdio>
+#include "OSCBenchmark.h"
+#include "SessionLoadBenchmark.h"
+#include "LinkBenchmark.h"
+#include "StressBenchmark.h"
+#include "StreamBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/DebugLogger.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::printf("OSCBenchmark - MonitorControllerMax OSC receive/dispatch benchmark over loopback\n\n"
+                    "  --mix=<list>          single,burst,pattern (default: all)\n"
+                    "  --probes=<n>          latency probes per mix (default 1000)\n"
+                    "  --warmup=<n>          unmeasured probes per mix (default 50)\n"
+                    "  --burst-size=<n>      messages per burst (default 8)\n"
+                    "  --pattern-size=<n>    channels per pattern message (default 4)\n"
+                    "  --duration=<s>        throughput phase per mix, 0 = skip (default 5)\n"
+                    "  --rate=<msg/s>        throughput send rate, 0 = unlimited (default 0)\n"
+                    "  --port=<n>            plugin receive port (default 9445)\n"
+                    "  --sink-port=<n>       port receiving the plugin's OSC feedback (default 9444)\n"
+                    "  --layout=<name>       speaker layout (default 7.1.4)\n"
+                    "  --sub=<name>          SUB layout (default 2)\n"
+                    "  --csv=<file>          write end-to-end latency samples\n"
+                    "  --session-slaves=<n>  session-load mode: join n Slaves to a Master instead of the OSC run\n"
+                    "  --session-groups=<n>  session-load mode: spread the Slaves over n Master groups, one Master each (default 1)\n"
+                    "  --master-clicks=<n>   session-load mode: Master Solo toggles timed with all Slaves joined (default 200)\n"
+                    "  --link-processes=<n>  cross-process mode: drive n follower processes over shared memory instead of the OSC run\n"
+                    "  --link-probes=<n>     cross-process mode: Master Mute toggles (default 500)\n"
+                    "  --link-interval=<ms>  cross-process mode: interval between toggles (default 5)\n"
+                    "  --stress-instances=<n>      stress mode: deterministic create/destroy/role/group/state script, at most n live instances\n"
+                    "  --stress-ops=<n>            stress mode: script operations (default 5000)\n"
+                    "  --stress-groups=<n>         stress mode: Master groups the instances are spread over (default 4)\n"
+                    "  --stress-seed=<n>           stress mode: script seed, same seed = same operation sequence (default 1)\n"
+                    "  --stress-audio-threads=<n>  stress mode: threads calling processBlock on live instances (default 2)\n"
+                    "  --stress-observers=<n>      stress mode: threads reading the health report (default 2)\n"
+                    "  --stress-scaling=<list>     stress mode: Slave counts for the broadcast scaling curve (default 1,4,16,64,256)\n"
+                    "  --stress-clicks=<n>         stress mode: Master Solo toggles per scaling point (default 50)\n"
+                    "  --tcp-cycles=<n>      TCP mode: send state to a loopback TCP/SLIP sink, force n disconnects and check full state after each reconnect\n"
+                    "  --tcp-port=<n>        TCP mode: sink listen port (default 9446)\n"
+                    "  --tcp-toggles=<n>     TCP mode: Solo/Mute toggles while the sink is disconnected (default 20)\n"
+                    "  --verbose-log         keep INFO logging (default: CRITICAL only)\n");
+    }
+
+    int getIntOption(const juce::ArgumentList& args, const juce::String& option, int defaultValue, int minValue)
+    {
+        const auto value = args.getValueForOption(option);
+        return value.isNotEmpty() ? juce::jmax(minValue, value.getIntValue()) : defaultValue;
+    }
+
+    void printLatencyRow(const char* label, const OSCBenchmark::LatencySummary& summary)
+    {
+        std::printf("  %-22s %8d %8d %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", label,
+                    summary.samples, summary.timeouts, summary.meanUs, summary.p50Us,
+                    summary.p90Us, summary.p99Us, summary.p999Us, summary.maxUs);
+    }
+
+    void printResult(const OSCBenchmark::MixResult& result)
+    {
+        std::printf("\n[%s]\n", OSCBenchmark::getMixName(result.mix).toRawUTF8());
+        std::printf("  %-22s %8s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)",
+                    "samples", "timeouts", "mean", "p50", "p90", "p99", "p99.9", "max");
+        printLatencyRow("send -> RenderState", result.endToEnd);
+        printLatencyRow("arrival -> publish", result.arrivalToPublish);
+
+        if (result.sentMessages == 0)
+            return;
+
+        const double drainSeconds = juce::jmax(1.0e-9, result.drainSeconds);
+        const juce::int64 lost = result.sentMessages - result.receivedMessages;
+        const juce::int64 notDispatched = result.receivedMessages - result.dispatchedCommands;
+
+        std::printf("  throughput: sent %lld in %.2fs (%.0f msg/s), received %lld, dispatched %lld (%.0f cmd/s), "
+                    "RenderState publishes %llu\n",
+                    static_cast<long long>(result.sentMessages), result.sendSeconds,
+                    static_cast<double>(result.sentMessages) / juce::jmax(1.0e-9, result.sendSeconds),
+                    static_cast<long long>(result.receivedMessages),
+                    static_cast<long long>(result.dispatchedCommands),
+                    static_cast<double>(result.dispatchedCommands) / drainSeconds,
+                    static_cast<unsigned long long>(result.renderStatePublishes));
+
+        if (lost > 0 || notDispatched > 0)
+        {
+            std::printf("  lost in socket buffer: %lld, dropped/rejected after receive: %lld\n",
+                        static_cast<long long>(lost), static_cast<long long>(notDispatched));
+        }
+    }
+
+    void printSessionResult(const SessionLoadBenchmark::Result& result)
+    {
+        std::printf("\n[session load: %d slaves in %d master groups]\n", result.slaves, result.groups);
+        std::printf("  %-22s %8s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)",
+                    "samples", "timeouts", "mean", "p50", "p90", "p99", "p99.9", "max");
+        printLatencyRow("instantiate", result.instantiate);
+        printLatencyRow("join (snapshot)", result.join);
+        printLatencyRow("master solo click", result.masterClick);
+
+        std::printf("  total %.3fs, RenderState publishes per join: %.2f avg / %llu max, mirrored %d/%d\n",
+                    result.totalSeconds,
+                    static_cast<double>(result.joinPublishes) / juce::jmax(1, result.slaves),
+                    static_cast<unsigned long long>(result.maxJoinPublishes),
+                    result.mirroredSlaves, result.slaves);
+    }
+
+    void printLinkResult(const LinkBenchmark::Result& result)
+    {
+        std::printf("\n[cross-process link: %d followers, %d ready]\n", result.processes, result.readyFollowers);
+        std::printf("  %-22s %8s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)",
+                    "samples", "timeouts", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+        for (size_t i = 0; i < result.followers.size(); ++i)
+        {
+            const auto& follower = result.followers[i];
+            const auto label = "follower " + juce::String(static_cast<int>(i)) + " apply";
+
+            if (!follower.reported)
+            {
+                std::printf("  %-22s no result\n", label.toRawUTF8());
+                continue;
+            }
+
+            printLatencyRow(label.toRawUTF8(), follower.apply);
+            std::printf("  %-22s link delivery mean %.1f us / max %.1f us, missed %d, resyncs %llu\n", "",
+                        follower.deliveryMeanUs, follower.deliveryMaxUs, follower.missed,
+                        static_cast<unsigned long long>(follower.resyncs));
+        }
+
+        std::printf("  %d Mute toggles in %.3fs, %llu link publishes\n", result.probes, result.totalSeconds,
+                    static_cast<unsigned long long>(result.published));
+    }
+
+    void printStressResult(const StressBenchmark::Result& result)
+    {
+        std::printf("\n[multi-instance stress: seed %lld, %d operations, peak %d instances]\n",
+                    static_cast<long long>(result.seed), result.operations, result.peakInstances);
+        std::printf("  %-22s %8s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)",
+                    "samples", "timeouts", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+        for (const auto& point : result.population)
+        {
+            const auto label = "create @" + juce::String(point.liveInstances) + "+ live";
+            printLatencyRow(label.toRawUTF8(), point.create);
+        }
+
+        printLatencyRow("destroy", result.destroy);
+        printLatencyRow("role switch", result.roleSwitch);
+        printLatencyRow("group switch", result.groupSwitch);
+        printLatencyRow("master state change", result.stateChange);
+
+        std::printf("  script %.3fs: created %d, destroyed %d, role switches %d (%d Master refused), "
+                    "group switches %d, state changes %d\n",
+                    result.scriptSeconds, result.created, result.destroyed, result.roleSwitches,
+                    result.roleSwitchesRefused, result.groupSwitches, result.stateChanges);
+
+        const auto& lock = result.lockStats;
+        std::printf("  registry lock: %llu acquisitions, %llu contended (%.3f%%), %.2f ms waiting\n",
+                    static_cast<unsigned long long>(lock.acquisitions), static_cast<unsigned long long>(lock.contentions),
+                    lock.acquisitions > 0 ? 100.0 * static_cast<double>(lock.contentions) / static_cast<double>(lock.acquisitions) : 0.0,
+                    lock.waitMs);
+        std::printf("  concurrent: %llu audio blocks, %llu health reports\n",
+                    static_cast<unsigned long long>(result.audioBlocks), static_cast<unsigned long long>(result.observerReports));
+        std::printf("  verify: connected Slaves mirroring their Master %d/%d, registered after teardown %d (expected %d)\n",
+                    result.mirroredSlaves, result.connectedSlaves, result.registeredAtEnd, result.expectedAtEnd);
+
+        const auto& local = result.localOverrides;
+        std::printf("  local overrides: Slave mirrored %d/%d Master updates, kept local mute/trim %d/%d, "
+                    "layer rebuilds master %llu / local %llu (expected 0)%s%s\n",
+                    local.mirroredUpdates, local.masterUpdates, local.keptUpdates, local.masterUpdates,
+                    static_cast<unsigned long long>(local.masterLayerRebuilds), static_cast<unsigned long long>(local.localLayerRebuilds),
+                    local.failureReason.isNotEmpty() ? " - " : "", local.failureReason.toRawUTF8());
+
+        if (result.scaling.empty())
+            return;
+
+        std::printf("\n[scaling: one Master + S Slaves]\n");
+        std::printf("  %-22s %8s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)",
+                    "samples", "timeouts", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+        for (const auto& point : result.scaling)
+        {
+            const auto suffix = " S=" + juce::String(point.slaves);
+            printLatencyRow(("join" + suffix).toRawUTF8(), point.join);
+            printLatencyRow(("publish" + suffix).toRawUTF8(), point.publish);
+            printLatencyRow(("broadcast" + suffix).toRawUTF8(), point.broadcast);
+            std::printf("  %-22s broadcast per Slave %.2f us, mirrored %d/%d\n", "",
+                        point.broadcast.meanUs / juce::jmax(1, point.slaves), point.mirroredSlaves, point.slaves);
+        }
+    }
+
+    void printStreamResult(const StreamBenchmark::Result& result)
+    {
+        std::printf("\n[TCP/SLIP stream: %d forced disconnects, %d connections]\n", result.cycles, result.connections);
+        std::printf("  %-22s %8s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)",
+                    "samples", "timeouts", "mean", "p50", "p90", "p99", "p99.9", "max");
+        printLatencyRow("disconnect -> accept", result.reconnect);
+        printLatencyRow("accept -> full state", result.converge);
+
+        std::printf("  received %lld frames / %lld messages, malformed frames %lld, full state delivered %d/%d\n",
+                    static_cast<long long>(result.frames), static_cast<long long>(result.messages),
+                    static_cast<long long>(result.malformedFrames), result.converged, result.connections);
+    }
+
+    bool writeCsv(const juce::File& file, const std::vector<OSCBenchmark::MixResult>& results)
+    {
+        juce::String csv("mix,probe,latency_us\n");
+
+        for (const auto& result : results)
+        {
+            const auto mixName = OSCBenchmark::getMixName(result.mix);
+            for (size_t i = 0; i < result.endToEndSamplesUs.size(); ++i)
+                csv << mixName << "," << static_cast<int>(i) << "," << juce::String(result.endToEndSamplesUs[i], 2) << "\n";
+        }
+
+        return file.replaceWithText(csv);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // 主线程即消息线程：插件的AsyncUpdater/Timer照常在这里分发
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto speakerLayout = args.containsOption("--layout") ? args.getValueForOption("--layout") : juce::String("7.1.4");
+    const auto subLayout = args.containsOption("--sub") ? args.getValueForOption("--sub") : juce::String("2");
+
+    // 跨进程模式：段名须在首个插件实例注册前设置；独立段名，不加入正在运行的宿主会话
+    LinkBenchmark::Options linkOptions;
+    linkOptions.processes = getIntOption(args, "--link-processes", 0, 0);
+    linkOptions.probes = getIntOption(args, "--link-probes", linkOptions.probes, 1);
+    linkOptions.intervalMs = getIntOption(args, "--link-interval", linkOptions.intervalMs, 1);
+    linkOptions.timeoutMs = getIntOption(args, "--link-timeout", linkOptions.timeoutMs, 100);
+    linkOptions.speakerLayout = speakerLayout;
+    linkOptions.subLayout = subLayout;
+
+    if (!args.containsOption("--verbose-log"))
+        DebugLogger::getInstance().setLogLevel(LogLevel::CRITICAL);
+
+    if (args.containsOption("--link-follower"))
+    {
+        linkOptions.segmentName = args.getValueForOption("--link-segment");
+        if (linkOptions.segmentName.isEmpty())
+            return 1;
+
+        GlobalPluginState::setSharedLinkSegmentName(linkOptions.segmentName);
+        return LinkBenchmark::runFollower(linkOptions);
+    }
+
+    if (linkOptions.processes > 0)
+    {
+        linkOptions.segmentName = "MonitorControllerMax_LinkBench_" + juce::String(juce::Random::getSystemRandom().nextInt(0x7fffffff));
+        GlobalPluginState::setSharedLinkSegmentName(linkOptions.segmentName);
+    }
+
+    OSCBenchmark::Options options;
+    options.probes = getIntOption(args, "--probes", options.probes, 1);
+    options.warmup = getIntOption(args, "--warmup", options.warmup, 0);
+    options.burstSize = getIntOption(args, "--burst-size", options.burstSize, 1);
+    options.patternSize = getIntOption(args, "--pattern-size", options.patternSize, 2);
+    options.messagesPerSecond = getIntOption(args, "--rate", options.messagesPerSecond, 0);
+    options.port = juce::jlimit(1, 65535, getIntOption(args, "--port", options.port, 1));
+
+    if (args.containsOption("--duration"))
+        options.throughputSeconds = juce::jmax(0.0, args.getValueForOption("--duration").getDoubleValue());
+
+    if (args.containsOption("--mix"))
+    {
+        options.mixes.clear();
+        for (const auto& name : juce::StringArray::fromTokens(args.getValueForOption("--mix"), ",", ""))
+        {
+            auto mix = OSCBenchmark::Mix::Single;
+            if (!OSCBenchmark::parseMixName(name, mix))
+            {
+                std::fprintf(stderr, "Unknown mix '%s'\n", name.toRawUTF8());
+                return 1;
+            }
+            options.mixes.addIfNotAlreadyThere(mix);
+        }
+    }
+
+    const int sinkPort = juce::jlimit(1, 65535, getIntOption(args, "--sink-port", 9444, 1));
+
+    StreamBenchmark::Options streamOptions;
+    streamOptions.cycles = getIntOption(args, "--tcp-cycles", 0, 0);
+    streamOptions.port = juce::jlimit(1, 65535, getIntOption(args, "--tcp-port", streamOptions.port, 1));
+    streamOptions.togglesPerCycle = getIntOption(args, "--tcp-toggles", streamOptions.togglesPerCycle, 0);
+    const bool streamMode = args.containsOption("--tcp-cycles");
+
+    //==========================================================================
+    // 与宿主加载相同的路径：构造 -> prepareToPlay（自动布局 + Standalone角色初始化OSC）
+    auto processor = std::make_unique<MonitorControllerMaxAudioProcessor>();
+
+    processor->prepareToPlay(48000.0, 512);
+    processor->setCurrentLayout(speakerLayout, subLayout);
+
+    // 工程加载模式：本实例作为Master（角色切换会按用户配置重建OSC，随后被下面的基准配置替换）
+    const int sessionSlaves = getIntOption(args, "--session-slaves", 0, 0);
+    if (sessionSlaves > 0 || linkOptions.processes > 0)
+    {
+        processor->switchToMaster();
+        if (processor->getCurrentRole() != PluginRole::Master)
+        {
+            std::fprintf(stderr, "Failed to switch to Master - another Master exists\n");
+            processor->releaseResources();
+            return 1;
+        }
+    }
+
+    // 跨进程模式不使用OSC：Master只经共享段发布
+    if (linkOptions.processes > 0)
+    {
+        std::printf("MonitorControllerMax cross-process link benchmark - layout %s + %s, %d follower processes, segment %s\n",
+                    speakerLayout.toRawUTF8(), subLayout.toRawUTF8(), linkOptions.processes, linkOptions.segmentName.toRawUTF8());
+
+        LinkBenchmark linkBenchmark(linkOptions);
+        const auto result = linkBenchmark.runMaster(*processor);
+        printLinkResult(result);
+
+        int exitCode = 0;
+        if (result.failureReason.isNotEmpty())
+        {
+            std::fprintf(stderr, "Link benchmark failed: %s\n", result.failureReason.toRawUTF8());
+            exitCode = 1;
+        }
+
+        for (const auto& follower : result.followers)
+        {
+            if (!follower.reported || follower.apply.timeouts > 0)
+                exitCode = 1;
+        }
+
+        processor->releaseResources();
+        processor.reset();
+        SharedStateLink::removeSegment(linkOptions.segmentName);
+        return exitCode;
+    }
+
+    // 插件的状态反馈发往本地接收端（只绑定不读取，不影响插件发送）
+    juce::DatagramSocket feedbackSink;
+    feedbackSink.bindToPort(sinkPort, "127.0.0.1");
+
+    // 基准专用端口，不写入用户目录的OSC_Targets.json
+    OSCNetworkConfig networkConfig;
+    networkConfig.receivePort = options.port;
+
+    OSCTargetConfig sink;
+    sink.name = "BenchmarkSink";
+    sink.host = "127.0.0.1";
+    sink.port = sinkPort;
+
+    // TCP模式：唯一目标为回环TCP/SLIP对端（由StreamBenchmark监听）
+    if (streamMode)
+    {
+        sink.transport = OSCTargetConfig::Transport::TCP;
+        sink.port = streamOptions.port;
+    }
+
+    networkConfig.targets.add(sink);
+
+    if (!processor->getOSCCommunicator().setNetworkConfig(networkConfig, false))
+    {
+        std::fprintf(stderr, "Failed to start OSC on port %d (sink %d)\n", options.port, sinkPort);
+        processor->releaseResources();
+        return 1;
+    }
+
+    //==========================================================================
+    int exitCode = 0;
+    const int stressInstances = getIntOption(args, "--stress-instances", 0, 0);
+
+    if (stressInstances > 0)
+    {
+        StressBenchmark::Options stressOptions;
+        stressOptions.instances = stressInstances;
+        stressOptions.operations = getIntOption(args, "--stress-ops", stressOptions.operations, 1);
+        stressOptions.groups = getIntOption(args, "--stress-groups", stressOptions.groups, 1);
+        stressOptions.audioThreads = getIntOption(args, "--stress-audio-threads", stressOptions.audioThreads, 0);
+        stressOptions.observerThreads = getIntOption(args, "--stress-observers", stressOptions.observerThreads, 0);
+        stressOptions.scalingClicks = getIntOption(args, "--stress-clicks", stressOptions.scalingClicks, 0);
+        stressOptions.speakerLayout = speakerLayout;
+        stressOptions.subLayout = subLayout;
+
+        if (args.containsOption("--stress-seed"))
+            stressOptions.seed = args.getValueForOption("--stress-seed").getLargeIntValue();
+
+        if (args.containsOption("--stress-scaling"))
+        {
+            stressOptions.scalingSlaves.clear();
+            for (const auto& count : juce::StringArray::fromTokens(args.getValueForOption("--stress-scaling"), ",", ""))
+            {
+                if (count.getIntValue() > 0)
+                    stressOptions.scalingSlaves.push_back(count.getIntValue());
+            }
+        }
+
+        std::printf("MonitorControllerMax multi-instance stress benchmark - layout %s + %s, up to %d instances in %d groups, "
+                    "%d audio / %d observer threads\n",
+                    speakerLayout.toRawUTF8(), subLayout.toRawUTF8(), stressOptions.instances, stressOptions.groups,
+                    stressOptions.audioThreads, stressOptions.observerThreads);
+
+        StressBenchmark stressBenchmark(stressOptions);
+
+        // 驱动线程把每个操作投递到消息线程，结束后退出分发循环
+        stressBenchmark.onFinished = []
+        {
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        };
+
+        stressBenchmark.start();
+        juce::MessageManager::getInstance()->runDispatchLoop();
+
+        const auto& result = stressBenchmark.getResult();
+        printStressResult(result);
+
+        if (!result.passed())
+        {
+            std::fprintf(stderr, "Stress run failed: %d/%d Slaves mirrored, %d registered after teardown (expected %d)%s%s\n",
+                         result.mirroredSlaves, result.connectedSlaves, result.registeredAtEnd, result.expectedAtEnd,
+                         result.failureReason.isNotEmpty() ? " - " : "", result.failureReason.toRawUTF8());
+            exitCode = 1;
+        }
+
+        for (const auto& point : result.scaling)
+        {
+            if (point.mirroredSlaves != point.slaves)
+                exitCode = 1;
+        }
+    }
+    else if (streamMode)
+    {
+        std::printf("MonitorControllerMax TCP/SLIP stream check - layout %s + %s, sink port %d, %d forced disconnects\n",
+                    speakerLayout.toRawUTF8(), subLayout.toRawUTF8(), streamOptions.port, streamOptions.cycles);
+
+        StreamBenchmark streamBenchmark(*processor, streamOptions);
+
+        streamBenchmark.onFinished = []
+        {
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        };
+
+        streamBenchmark.start();
+        juce::MessageManager::getInstance()->runDispatchLoop();
+
+        const auto& result = streamBenchmark.getResult();
+        printStreamResult(result);
+
+        if (!result.passed())
+        {
+            std::fprintf(stderr, "TCP stream check failed: full state delivered %d/%d, malformed frames %lld%s%s\n",
+                         result.converged, result.connections, static_cast<long long>(result.malformedFrames),
+                         result.failureReason.isNotEmpty() ? " - " : "", result.failureReason.toRawUTF8());
+            exitCode = 1;
+        }
+    }
+    else if (sessionSlaves > 0)
+    {
+        SessionLoadBenchmark::Options sessionOptions;
+        sessionOptions.slaves = sessionSlaves;
+        sessionOptions.groups = getIntOption(args, "--session-groups", sessionOptions.groups, 1);
+        sessionOptions.masterClicks = getIntOption(args, "--master-clicks", sessionOptions.masterClicks, 0);
+        sessionOptions.speakerLayout = speakerLayout;
+        sessionOptions.subLayout = subLayout;
+
+        std::printf("MonitorControllerMax session-load benchmark - layout %s + %s, %d slaves\n",
+                    speakerLayout.toRawUTF8(), subLayout.toRawUTF8(), sessionSlaves);
+
+        SessionLoadBenchmark sessionBenchmark(sessionOptions);
+        const auto result = sessionBenchmark.run(*processor);
+        printSessionResult(result);
+
+        if (result.mirroredSlaves != result.slaves)
+        {
+            std::fprintf(stderr, "%d slaves did not mirror the Master state after joining\n", result.slaves - result.mirroredSlaves);
+            exitCode = 1;
+        }
+    }
+    else
+    {
+        OSCBenchmark benchmark(*processor, options);
+
+        std::printf("MonitorControllerMax OSC benchmark - layout %s + %s (%d channels), receive port %d\n",
+                    speakerLayout.toRawUTF8(), subLayout.toRawUTF8(), benchmark.getNumChannels(), options.port);
+
+        // 基准线程结束后退出分发循环
+        benchmark.onFinished = []
+        {
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        };
+
+        benchmark.start();
+        juce::MessageManager::getInstance()->runDispatchLoop();
+
+        if (benchmark.hasFailed())
+        {
+            std::fprintf(stderr, "Benchmark failed: %s\n", benchmark.getFailureReason().toRawUTF8());
+            exitCode = 1;
+        }
+        else
+        {
+            for (const auto& result : benchmark.getResults())
+                printResult(result);
+
+            if (args.containsOption("--csv"))
+            {
+                const auto csvFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--csv"));
+                if (!writeCsv(csvFile, benchmark.getResults()))
+                {
+                    std::fprintf(stderr, "Failed to write %s\n", csvFile.getFullPathName().toRawUTF8());
+                    exitCode = 1;
+                }
+            }
+        }
+    }
+
+    processor->releaseResources();
+    processor.reset();
+    return exitCode;
+}
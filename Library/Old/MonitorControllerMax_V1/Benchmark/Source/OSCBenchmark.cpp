@@ -0,0 +1,439 @@
+﻿/*
+  ==============================================================================
+
+    OSCBenchmark.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC基准测试实现 - 回环负载生成、RenderState轮询、百分位统计
+
+  ==============================================================================
+*/
+
+#include "OSCBenchmark.h"
+#include "../../Source/OSCSlipCodec.h"
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+OSCBenchmark::LatencySummary OSCBenchmark::LatencySummary::fromSamples(std::vector<double>& samplesUs, int timeouts)
+{
+    LatencySummary summary;
+    summary.samples = static_cast<int>(samplesUs.size());
+    summary.timeouts = timeouts;
+
+    if (samplesUs.empty())
+        return summary;
+
+    std::sort(samplesUs.begin(), samplesUs.end());
+
+    // 最近秩法：第ceil(p*n)个样本
+    auto percentile = [&samplesUs](double p)
+    {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samplesUs.size())));
+        return samplesUs[juce::jlimit<size_t>(1, samplesUs.size(), rank) - 1];
+    };
+
+    double sum = 0.0;
+    for (const double sample : samplesUs)
+        sum += sample;
+
+    summary.meanUs = sum / static_cast<double>(samplesUs.size());
+    summary.p50Us = percentile(0.50);
+    summary.p90Us = percentile(0.90);
+    summary.p99Us = percentile(0.99);
+    summary.p999Us = percentile(0.999);
+    summary.maxUs = samplesUs.back();
+    return summary;
+}
+
+//==============================================================================
+OSCBenchmark::OSCBenchmark(MonitorControllerMaxAudioProcessor& processorToUse, const Options& benchmarkOptions)
+    : juce::Thread("OSC Benchmark"),
+      processor(processorToUse),
+      options(benchmarkOptions)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // 布局只在消息线程读取一次；基准期间不切换布局
+    for (const auto& channelInfo : processor.getCurrentLayout().channels)
+    {
+        if (channelInfo.channelIndex < 0 || channelInfo.channelIndex >= RenderState::MAX_CHANNELS)
+            continue;
+
+        BenchmarkChannel channel;
+        channel.oscName = channelInfo.name.replaceCharacter(' ', '_');
+        channel.physicalIndex = channelInfo.channelIndex;
+        channels.push_back(channel);
+    }
+
+    // 🚀 插件内延迟：命令分发完成时RenderState已发布
+    processor.getOSCCommunicator().onCommandDispatched = [this](const OSCControlCommand& command, juce::int64 completedTicks)
+    {
+        if (!recordServerSamples.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard<std::mutex> lock(serverSamplesMutex);
+        serverSamplesUs.push_back(ticksToMicroseconds(completedTicks - command.receivedTicks));
+    };
+}
+
+OSCBenchmark::~OSCBenchmark()
+{
+    stopThread(5000);
+    processor.getOSCCommunicator().onCommandDispatched = nullptr;
+}
+
+void OSCBenchmark::start()
+{
+    startThread(juce::Thread::Priority::high);
+}
+
+juce::String OSCBenchmark::getMixName(Mix mix)
+{
+    switch (mix)
+    {
+        case Mix::Single:  return "single";
+        case Mix::Burst:   return "burst";
+        case Mix::Pattern: return "pattern";
+    }
+
+    return {};
+}
+
+bool OSCBenchmark::parseMixName(const juce::String& name, Mix& mix)
+{
+    for (const auto candidate : { Mix::Single, Mix::Burst, Mix::Pattern })
+    {
+        if (name.trim().equalsIgnoreCase(getMixName(candidate)))
+        {
+            mix = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+double OSCBenchmark::ticksToMicroseconds(juce::int64 ticks) noexcept
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+}
+
+//==============================================================================
+void OSCBenchmark::run()
+{
+    if (channels.size() < 2)
+    {
+        failureReason = "Current layout has fewer than 2 channels";
+        failed.store(true);
+    }
+    else if (!socket.bindToPort(0))
+    {
+        failureReason = "Failed to create UDP socket";
+        failed.store(true);
+    }
+
+    if (!failed.load())
+    {
+        for (const auto mix : options.mixes)
+        {
+            if (threadShouldExit())
+                break;
+
+            MixResult result;
+            result.mix = mix;
+
+            measureLatency(result);
+
+            if (options.throughputSeconds > 0.0 && !threadShouldExit())
+                measureThroughput(result);
+
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (onFinished)
+        onFinished();
+}
+
+//==============================================================================
+// 延迟阶段：闭环，每个探测单元等到RenderState反映后再发下一个
+//==============================================================================
+
+void OSCBenchmark::measureLatency(MixResult& result)
+{
+    std::vector<OutgoingMessage> messages;
+    std::vector<int> touchedChannels;
+    std::vector<double>& samples = result.endToEndSamplesUs;
+    samples.reserve(static_cast<size_t>(options.probes));
+
+    const auto timeoutTicks = juce::Time::secondsToHighResolutionTicks(options.probeTimeoutMs * 0.001);
+    int timeouts = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(serverSamplesMutex);
+        serverSamplesUs.clear();
+        serverSamplesUs.reserve(static_cast<size_t>(options.probes * juce::jmax(1, options.burstSize)));
+    }
+
+    for (int probe = 0; probe < options.warmup + options.probes && !threadShouldExit(); ++probe)
+    {
+        const bool measured = probe >= options.warmup;
+        recordServerSamples.store(measured);
+
+        buildProbe(result.mix, messages, touchedChannels);
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        for (const auto& message : messages)
+            sendMessage(message);
+
+        const bool reflected = waitUntilReflected(touchedChannels, startTicks + timeoutTicks);
+        const auto endTicks = juce::Time::getHighResolutionTicks();
+
+        if (!reflected)
+        {
+            // 丢包或被拒绝：以RenderState实际状态为准继续
+            resyncExpectedState(touchedChannels);
+            if (measured)
+                ++timeouts;
+            continue;
+        }
+
+        if (measured)
+            samples.push_back(ticksToMicroseconds(endTicks - startTicks));
+    }
+
+    recordServerSamples.store(false);
+
+    std::vector<double> sortedSamples(samples);
+    result.endToEnd = LatencySummary::fromSamples(sortedSamples, timeouts);
+
+    // 消息线程可能仍在处理最后一个探测的尾部回调
+    std::lock_guard<std::mutex> lock(serverSamplesMutex);
+    result.arrivalToPublish = LatencySummary::fromSamples(serverSamplesUs, 0);
+}
+
+//==============================================================================
+// 吞吐阶段：开环，按速率连续发送，结束后等待消息线程处理完积压
+//==============================================================================
+
+void OSCBenchmark::measureThroughput(MixResult& result)
+{
+    auto& communicator = processor.getOSCCommunicator();
+
+    const auto statsBefore = communicator.getReceiveStats();
+    const uint64_t publishesBefore = processor.stateManager->getPublishCount();
+
+    std::vector<OutgoingMessage> messages;
+    std::vector<int> touchedChannels;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto durationTicks = juce::Time::secondsToHighResolutionTicks(options.throughputSeconds);
+    const double ticksPerMessage = options.messagesPerSecond > 0
+                                 ? static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / options.messagesPerSecond
+                                 : 0.0;
+
+    juce::int64 sent = 0;
+
+    while (!threadShouldExit() && juce::Time::getHighResolutionTicks() - startTicks < durationTicks)
+    {
+        buildProbe(result.mix, messages, touchedChannels);
+
+        for (const auto& message : messages)
+        {
+            // 限速：第n条消息不早于 start + n / rate
+            if (ticksPerMessage > 0.0)
+            {
+                const auto dueTicks = startTicks + static_cast<juce::int64>(static_cast<double>(sent) * ticksPerMessage);
+                while (juce::Time::getHighResolutionTicks() < dueTicks)
+                    juce::Thread::yield();
+            }
+
+            if (sendMessage(message))
+                ++sent;
+        }
+    }
+
+    result.sendSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    result.sentMessages = sent;
+
+    waitForDispatchToSettle(startTicks, result);
+
+    const auto statsAfter = communicator.getReceiveStats();
+    result.receivedMessages = statsAfter.receivedMessages - statsBefore.receivedMessages;
+    result.dispatchedCommands = statsAfter.dispatchedCommands - statsBefore.dispatchedCommands;
+    result.renderStatePublishes = processor.stateManager->getPublishCount() - publishesBefore;
+
+    // 开环阶段可能丢包：以实际状态为准，供下一种组合使用
+    std::vector<int> allChannels(channels.size());
+    for (size_t i = 0; i < allChannels.size(); ++i)
+        allChannels[i] = static_cast<int>(i);
+    resyncExpectedState(allChannels);
+}
+
+void OSCBenchmark::waitForDispatchToSettle(juce::int64 sendStartTicks, MixResult& result)
+{
+    auto& communicator = processor.getOSCCommunicator();
+
+    // 分发计数100ms不再增长且已追上接收计数（或最多等5秒）视为积压处理完毕
+    const auto quietTicks = juce::Time::secondsToHighResolutionTicks(0.1);
+    const auto giveUpTicks = juce::Time::getHighResolutionTicks() + juce::Time::secondsToHighResolutionTicks(5.0);
+
+    auto lastStats = communicator.getReceiveStats();
+    auto lastChangeTicks = juce::Time::getHighResolutionTicks();
+
+    while (!threadShouldExit())
+    {
+        juce::Thread::sleep(1);
+
+        const auto stats = communicator.getReceiveStats();
+        const auto now = juce::Time::getHighResolutionTicks();
+
+        if (stats.dispatchedCommands != lastStats.dispatchedCommands || stats.receivedMessages != lastStats.receivedMessages)
+        {
+            lastStats = stats;
+            lastChangeTicks = now;
+            continue;
+        }
+
+        if ((stats.dispatchedCommands >= stats.receivedMessages && now - lastChangeTicks >= quietTicks) || now >= giveUpTicks)
+            break;
+    }
+
+    result.drainSeconds = juce::Time::highResolutionTicksToSeconds(lastChangeTicks - sendStartTicks);
+}
+
+//==============================================================================
+// 负载生成
+//==============================================================================
+
+void OSCBenchmark::buildProbe(Mix mix, std::vector<OutgoingMessage>& messages, std::vector<int>& touchedChannels)
+{
+    messages.clear();
+    touchedChannels.clear();
+
+    const int numChannels = static_cast<int>(channels.size());
+
+    auto takeNextChannel = [this, numChannels]
+    {
+        const int index = nextChannel;
+        nextChannel = (nextChannel + 1) % numChannels;
+        return index;
+    };
+
+    switch (mix)
+    {
+        case Mix::Single:
+        case Mix::Burst:
+        {
+            // 每条消息切换一个不同通道，保证每条都产生状态变化
+            const int count = mix == Mix::Single ? 1 : juce::jlimit(1, numChannels, options.burstSize);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const int index = takeNextChannel();
+                auto& channel = channels[static_cast<size_t>(index)];
+                channel.expectedMute = !channel.expectedMute;
+
+                messages.push_back({ "/Monitor/Mute/" + channel.oscName, channel.expectedMute ? 1.0f : 0.0f });
+                touchedChannels.push_back(index);
+            }
+            break;
+        }
+
+        case Mix::Pattern:
+        {
+            // /Monitor/Mute/{A,B,C}：整组设为首个通道的相反状态，至少一个通道发生变化
+            const int count = juce::jlimit(2, numChannels, options.patternSize);
+            juce::String alternatives;
+            bool newState = false;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const int index = takeNextChannel();
+                auto& channel = channels[static_cast<size_t>(index)];
+
+                if (i == 0)
+                    newState = !channel.expectedMute;
+
+                channel.expectedMute = newState;
+                alternatives << (i == 0 ? "" : ",") << channel.oscName;
+                touchedChannels.push_back(index);
+            }
+
+            messages.push_back({ "/Monitor/Mute/{" + alternatives + "}", newState ? 1.0f : 0.0f });
+            break;
+        }
+    }
+}
+
+bool OSCBenchmark::sendMessage(const OutgoingMessage& message)
+{
+    // 与控制器相同的线上格式：单条OSC消息一个数据报
+    packet.reset();
+    OSCSlipCodec::writeMessage(packet, juce::OSCMessage(juce::OSCAddressPattern(message.address), message.value));
+
+    const int size = static_cast<int>(packet.getDataSize());
+    return socket.write("127.0.0.1", options.port, packet.getData(), size) == size;
+}
+
+bool OSCBenchmark::isReflected(const std::vector<int>& touchedChannels) const noexcept
+{
+    // 基准线程不是音频线程：按发布计数/版本号校验后的一致快照比较
+    bool reflected = false;
+
+    const bool hasState = processor.stateManager->readRenderState([this, &touchedChannels, &reflected](const RenderState& state)
+    {
+        reflected = std::all_of(touchedChannels.begin(), touchedChannels.end(), [this, &state](int index)
+        {
+            const auto& channel = channels[static_cast<size_t>(index)];
+            return state.channelShouldMute[channel.physicalIndex] == channel.expectedMute;
+        });
+    });
+
+    return hasState && reflected;
+}
+
+bool OSCBenchmark::waitUntilReflected(const std::vector<int>& touchedChannels, juce::int64 deadlineTicks) const
+{
+    uint64_t lastPublish = processor.stateManager->getPublishCount();
+    if (isReflected(touchedChannels))
+        return true;
+
+    // 只在发布计数变化后重新比较快照内容
+    while (juce::Time::getHighResolutionTicks() < deadlineTicks)
+    {
+        const uint64_t publish = processor.stateManager->getPublishCount();
+        if (publish != lastPublish)
+        {
+            lastPublish = publish;
+            if (isReflected(touchedChannels))
+                return true;
+        }
+        else
+        {
+            juce::Thread::yield();
+        }
+    }
+
+    return isReflected(touchedChannels);
+}
+
+void OSCBenchmark::resyncExpectedState(const std::vector<int>& touchedChannels)
+{
+    // 先读到局部结果，快照校验通过后才写回期望状态
+    std::vector<bool> rendered(touchedChannels.size());
+
+    const bool hasState = processor.stateManager->readRenderState([this, &touchedChannels, &rendered](const RenderState& state)
+    {
+        for (size_t i = 0; i < touchedChannels.size(); ++i)
+            rendered[i] = state.channelShouldMute[channels[static_cast<size_t>(touchedChannels[i])].physicalIndex];
+    });
+
+    if (!hasState)
+        return;
+
+    for (size_t i = 0; i < touchedChannels.size(); ++i)
+        channels[static_cast<size_t>(touchedChannels[i])].expectedMute = rendered[i];
+}
@@ -0,0 +1,158 @@
+﻿/*
+  ==============================================================================
+
+    OSCBenchmark.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC负载生成与延迟基准 - 经本机回环驱动真实的OSCCommunicator接收/分发路径
+
+    - 负载组合：单通道切换、突发（多通道背靠背）、地址模式（/Monitor/Mute/{A,B,...}）
+    - 端到端延迟：发送数据报 -> 活跃RenderState反映新状态（基准线程轮询，与音频线程相同的读取方式）
+    - 插件内延迟：数据报到达接收线程 -> 消息线程分发完成（OSCControlCommand::receivedTicks）
+    - 持续吞吐：开环按速率（或不限速）发送，统计接收、分发与RenderState发布次数
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/**
+ * OSC基准测试
+ *
+ * 线程模型：
+ * - 构造/析构在消息线程（读取布局、挂接onCommandDispatched）
+ * - 负载生成与轮询在基准线程；插件照常由消息线程（主线程分发循环）驱动
+ * - 结束后在基准线程回调onFinished
+ */
+class OSCBenchmark : private juce::Thread
+{
+public:
+    //==============================================================================
+    enum class Mix
+    {
+        Single,     // 每次切换一个通道的Mute
+        Burst,      // 一次背靠背发送burstSize个不同通道
+        Pattern     // 一条地址模式消息同时设置patternSize个通道
+    };
+
+    struct Options
+    {
+        juce::Array<Mix> mixes{ Mix::Single, Mix::Burst, Mix::Pattern };
+        int probes = 1000;              // 每种组合的延迟探测次数（不含预热）
+        int warmup = 50;
+        int burstSize = 8;
+        int patternSize = 4;
+        int probeTimeoutMs = 1000;
+        double throughputSeconds = 5.0; // 0 = 跳过吞吐阶段
+        int messagesPerSecond = 0;      // 吞吐阶段发送速率，0 = 不限速
+        int port = 9445;                // 插件接收端口（回环）
+    };
+
+    struct LatencySummary
+    {
+        int samples = 0;
+        int timeouts = 0;
+        double meanUs = 0.0;
+        double p50Us = 0.0;
+        double p90Us = 0.0;
+        double p99Us = 0.0;
+        double p999Us = 0.0;
+        double maxUs = 0.0;
+
+        static LatencySummary fromSamples(std::vector<double>& samplesUs, int timeouts);
+    };
+
+    struct MixResult
+    {
+        Mix mix = Mix::Single;
+
+        LatencySummary endToEnd;          // 发送 -> RenderState反映（探测单元：一次切换/一次突发/一条模式消息）
+        LatencySummary arrivalToPublish;  // 到达 -> 分发完成（每条命令）
+        std::vector<double> endToEndSamplesUs;
+
+        // 吞吐阶段
+        juce::int64 sentMessages = 0;
+        juce::int64 receivedMessages = 0;
+        juce::int64 dispatchedCommands = 0;
+        uint64_t renderStatePublishes = 0;
+        double sendSeconds = 0.0;
+        double drainSeconds = 0.0;        // 首条发送 -> 最后一条分发完成
+    };
+
+    //==============================================================================
+    OSCBenchmark(MonitorControllerMaxAudioProcessor& processor, const Options& options);
+    ~OSCBenchmark() override;
+
+    void start();
+    bool hasFailed() const noexcept { return failed.load(); }
+    const juce::String& getFailureReason() const noexcept { return failureReason; }
+
+    // 基准线程结束后读取
+    const std::vector<MixResult>& getResults() const noexcept { return results; }
+    int getNumChannels() const noexcept { return static_cast<int>(channels.size()); }
+
+    std::function<void()> onFinished;
+
+    static juce::String getMixName(Mix mix);
+    static bool parseMixName(const juce::String& name, Mix& mix);
+
+private:
+    //==============================================================================
+    void run() override;
+
+    struct BenchmarkChannel
+    {
+        juce::String oscName;   // 空格已替换为'_'
+        int physicalIndex = 0;
+        bool expectedMute = false;
+    };
+
+    struct OutgoingMessage
+    {
+        juce::String address;
+        float value = 0.0f;
+    };
+
+    void measureLatency(MixResult& result);
+    void measureThroughput(MixResult& result);
+
+    void buildProbe(Mix mix, std::vector<OutgoingMessage>& messages, std::vector<int>& touchedChannels);
+    bool sendMessage(const OutgoingMessage& message);
+    bool isReflected(const std::vector<int>& touchedChannels) const noexcept;
+    bool waitUntilReflected(const std::vector<int>& touchedChannels, juce::int64 deadlineTicks) const;
+    void resyncExpectedState(const std::vector<int>& touchedChannels);
+    void waitForDispatchToSettle(juce::int64 sendStartTicks, MixResult& result);
+
+    static double ticksToMicroseconds(juce::int64 ticks) noexcept;
+
+    //==============================================================================
+    MonitorControllerMaxAudioProcessor& processor;
+    const Options options;
+
+    std::vector<BenchmarkChannel> channels;
+    int nextChannel = 0;
+
+    juce::DatagramSocket socket;
+    juce::MemoryOutputStream packet;
+
+    // 插件内延迟样本（消息线程写入）
+    std::mutex serverSamplesMutex;
+    std::vector<double> serverSamplesUs;
+    std::atomic<bool> recordServerSamples{ false };
+
+    std::vector<MixResult> results;
+    std::atomic<bool> failed{ false };
+    juce::String failureReason;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCBenchmark)
+};
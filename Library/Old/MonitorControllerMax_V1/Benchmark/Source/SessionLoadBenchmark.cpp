@@ -0,0 +1,164 @@
+﻿/*
+  ==============================================================================
+
+    SessionLoadBenchmark.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    工程加载基准实现
+
+  ==============================================================================
+*/
+
+#include "SessionLoadBenchmark.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    double ticksToMicroseconds(juce::int64 ticks) noexcept
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    }
+}
+
+//==============================================================================
+SessionLoadBenchmark::SessionLoadBenchmark(const Options& benchmarkOptions)
+    : options(benchmarkOptions)
+{
+}
+
+SessionLoadBenchmark::Result SessionLoadBenchmark::run(MonitorControllerMaxAudioProcessor& master)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+    jassert(master.getCurrentRole() == PluginRole::Master);
+
+    Result result;
+    result.slaves = options.slaves;
+    result.groups = juce::jmax(1, options.groups);
+
+    prepareMasterState(master);
+
+    // 其他Master组：每组一个Master，状态与第0组相同，Slave按组校验
+    std::vector<std::unique_ptr<MonitorControllerMaxAudioProcessor>> groupMasters;
+    std::vector<MonitorControllerMaxAudioProcessor*> masters{ &master };
+
+    for (int g = 1; g < result.groups; ++g)
+    {
+        auto groupMaster = std::make_unique<MonitorControllerMaxAudioProcessor>();
+        groupMaster->setCurrentLayout(options.speakerLayout, options.subLayout);
+        const juce::String groupName = "Group" + juce::String(g);
+        groupMaster->setOSCGroup(groupName);        // 每个Master在共享OSC中心占用独立的地址组
+        groupMaster->setMasterGroupName(groupName);
+        groupMaster->switchToMaster();
+        prepareMasterState(*groupMaster);
+
+        masters.push_back(groupMaster.get());
+        groupMasters.push_back(std::move(groupMaster));
+    }
+
+    std::vector<std::unique_ptr<MonitorControllerMaxAudioProcessor>> slaves;
+    slaves.reserve(static_cast<size_t>(options.slaves));
+
+    std::vector<double> instantiateUs, joinUs;
+    const auto sessionStart = juce::Time::getHighResolutionTicks();
+
+    // 与宿主恢复工程相同的顺序：构造 -> 恢复布局与角色 -> prepareToPlay（Slave角色不初始化OSC）
+    for (int i = 0; i < options.slaves; ++i)
+    {
+        auto& groupMaster = *masters[static_cast<size_t>(i) % masters.size()];
+
+        auto start = juce::Time::getHighResolutionTicks();
+        auto slave = std::make_unique<MonitorControllerMaxAudioProcessor>();
+        slave->setCurrentLayout(options.speakerLayout, options.subLayout);
+        slave->setMasterGroupName(groupMaster.getMasterGroupName());
+        instantiateUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+        const auto publishesBefore = slave->stateManager->getPublishCount();
+
+        start = juce::Time::getHighResolutionTicks();
+        slave->switchToSlave();
+        joinUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+        const auto publishes = slave->stateManager->getPublishCount() - publishesBefore;
+        result.joinPublishes += publishes;
+        result.maxJoinPublishes = juce::jmax(result.maxJoinPublishes, publishes);
+
+        if (slave->getCurrentRole() == PluginRole::Slave && mirrorsMaster(*slave, groupMaster))
+            ++result.mirroredSlaves;
+
+        slave->prepareToPlay(48000.0, 512);
+        slaves.push_back(std::move(slave));
+    }
+
+    result.totalSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - sessionStart);
+    result.instantiate = OSCBenchmark::LatencySummary::fromSamples(instantiateUs, 0);
+    result.join = OSCBenchmark::LatencySummary::fromSamples(joinUs, 0);
+
+    // 🚀 Master点击：全部Slave在线时，状态发布只是一次原子写入
+    const auto channels = master.getPhysicalMapper().getActiveSemanticChannels();
+    if (!channels.empty())
+    {
+        std::vector<double> clickUs;
+        auto& masterState = master.getSemanticState();
+
+        for (int i = 0; i < options.masterClicks; ++i)
+        {
+            const auto& channelName = channels[static_cast<size_t>(i) % channels.size()];
+            const bool newState = !masterState.getSoloState(channelName);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            masterState.setSoloState(channelName, newState);
+            clickUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+            // 复原，保持每次点击的起始状态一致
+            masterState.setSoloState(channelName, !newState);
+        }
+
+        result.masterClick = OSCBenchmark::LatencySummary::fromSamples(clickUs, 0);
+    }
+
+    for (auto& slave : slaves)
+        slave->releaseResources();
+    slaves.clear();
+    groupMasters.clear();
+
+    return result;
+}
+
+//==============================================================================
+// Master状态：约1/4通道Solo、另1/4通道Mute、Mono开启
+void SessionLoadBenchmark::prepareMasterState(MonitorControllerMaxAudioProcessor& master) const
+{
+    const auto channels = master.getPhysicalMapper().getActiveSemanticChannels();
+
+    std::vector<SemanticChannelState::ChannelStateChange> changes;
+    for (size_t i = 0; i < channels.size(); ++i)
+    {
+        if (i % 4 == 0)
+            changes.push_back({ channels[i], true, true });
+        else if (i % 4 == 1)
+            changes.push_back({ channels[i], false, true });
+    }
+
+    master.getSemanticState().applyStateTransaction(changes);
+    master.masterBusProcessor.setMonoActive(true);
+}
+
+bool SessionLoadBenchmark::mirrorsMaster(MonitorControllerMaxAudioProcessor& slave, MonitorControllerMaxAudioProcessor& master)
+{
+    if (slave.masterBusProcessor.isMonoActive() != master.masterBusProcessor.isMonoActive())
+        return false;
+
+    const auto& slaveState = slave.getSemanticState();
+    const auto& masterState = master.getSemanticState();
+
+    for (const auto& channelName : slave.getPhysicalMapper().getActiveSemanticChannels())
+    {
+        if (slaveState.getSoloState(channelName) != masterState.getSoloState(channelName)
+            || slaveState.getMuteState(channelName) != masterState.getMuteState(channelName))
+            return false;
+    }
+
+    return true;
+}
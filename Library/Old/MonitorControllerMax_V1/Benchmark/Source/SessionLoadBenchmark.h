@@ -0,0 +1,75 @@
+﻿/*
+  ==============================================================================
+
+    SessionLoadBenchmark.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    工程加载基准 - 在一个Master下实例化N个Slave，测量加入（快照交接）开销
+
+    - 实例化：构造 + 设置布局（宿主加载插件的固定成本，作为对照）
+    - 加入：switchToSlave()，包含applyMasterSnapshot一次性交接，统计每次加入的RenderState发布次数
+    - 校验：每个Slave的Solo/Mute/Mono与Master一致
+    - Master点击：N个Slave在线时Master单次Solo切换的耗时（快照发布与Slave数量无关）
+    - 多组：G个Master组各一个Master，Slave轮流分配到各组（组间不共享锁，加入耗时应与组数无关）
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OSCBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/**
+ * 工程加载基准
+ *
+ * 全部在消息线程同步运行（插件实例的构造、角色切换与状态交接都要求消息线程），
+ * 不需要分发循环。
+ */
+class SessionLoadBenchmark
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        int slaves = 40;
+        int masterClicks = 200;     // 偶数次，结束后Master状态复原
+        int groups = 1;             // Master组数：第0组为传入的Master所在组，其余组由基准创建Master
+        juce::String speakerLayout{ "7.1.4" };
+        juce::String subLayout{ "2" };
+    };
+
+    struct Result
+    {
+        int slaves = 0;
+        int groups = 0;
+        int mirroredSlaves = 0;                         // 加入后与本组Master状态一致的Slave数
+
+        OSCBenchmark::LatencySummary instantiate;       // 构造 + 布局
+        OSCBenchmark::LatencySummary join;              // switchToSlave（含快照交接）
+        OSCBenchmark::LatencySummary masterClick;       // N个Slave在线时Master单次Solo切换
+
+        uint64_t joinPublishes = 0;                     // 所有加入累计的RenderState发布次数
+        uint64_t maxJoinPublishes = 0;
+        double totalSeconds = 0.0;                      // 实例化 + 加入 + prepareToPlay
+    };
+
+    //==============================================================================
+    explicit SessionLoadBenchmark(const Options& options);
+
+    // master必须已是Master角色；返回前销毁所有Slave与基准创建的其他组Master
+    Result run(MonitorControllerMaxAudioProcessor& master);
+
+private:
+    //==============================================================================
+    void prepareMasterState(MonitorControllerMaxAudioProcessor& master) const;
+    static bool mirrorsMaster(MonitorControllerMaxAudioProcessor& slave, MonitorControllerMaxAudioProcessor& master);
+
+    const Options options;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionLoadBenchmark)
+};
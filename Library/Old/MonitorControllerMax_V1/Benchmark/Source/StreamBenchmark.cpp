@@ -0,0 +1,329 @@
+﻿/*
+  ==============================================================================
+
+    StreamBenchmark.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC-over-TCP回环校验实现 - 监听对端、SLIP解码、OSC包解析、断线重连循环
+
+  ==============================================================================
+*/
+
+#include "StreamBenchmark.h"
+#include "../../Source/OSCAddressTable.h"
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    constexpr int READ_BUFFER_BYTES = 65536;
+
+    double ticksToMicroseconds(juce::int64 ticks) noexcept
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    }
+
+    // 在消息线程同步执行：调用方阻塞到执行完毕
+    template <typename Function>
+    void callOnMessageThread(Function&& function)
+    {
+        using FunctionType = std::remove_reference_t<Function>;
+
+        juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* context) -> void*
+        {
+            (*static_cast<FunctionType*>(context))();
+            return nullptr;
+        }, &function);
+    }
+
+    uint32_t readBigEndian32(const uint8_t* bytes) noexcept
+    {
+        return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16)
+             | (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+    }
+
+    // OSC字符串：内容 + 结尾0，补齐到4字节
+    bool readPaddedString(const uint8_t* data, size_t size, size_t& offset, juce::String& result)
+    {
+        if (offset >= size)
+            return false;
+
+        const auto* start = data + offset;
+        const auto* terminator = static_cast<const uint8_t*>(std::memchr(start, 0, size - offset));
+        if (terminator == nullptr)
+            return false;
+
+        const auto length = static_cast<size_t>(terminator - start);
+        result = juce::String::fromUTF8(reinterpret_cast<const char*>(start), static_cast<int>(length));
+        offset += (length + 4) & ~static_cast<size_t>(3);
+        return offset <= size;
+    }
+
+    // 最小OSC包解析：消息或（嵌套）Bundle，每条消息只取第一个float/int参数
+    template <typename Callback>
+    bool parsePacket(const uint8_t* data, size_t size, Callback& callback, int depth = 0)
+    {
+        if (size >= 16 && std::memcmp(data, "#bundle", 8) == 0)
+        {
+            if (depth >= 4)
+                return false;
+
+            // 跳过8字节时间标签，逐个元素：4字节长度 + 包
+            size_t offset = 16;
+            while (offset < size)
+            {
+                if (size - offset < 4)
+                    return false;
+
+                const size_t elementSize = readBigEndian32(data + offset);
+                offset += 4;
+
+                if (elementSize > size - offset || !parsePacket(data + offset, elementSize, callback, depth + 1))
+                    return false;
+
+                offset += elementSize;
+            }
+
+            return true;
+        }
+
+        size_t offset = 0;
+        juce::String address, typeTags;
+
+        if (!readPaddedString(data, size, offset, address) || !address.startsWithChar('/'))
+            return false;
+
+        if (!readPaddedString(data, size, offset, typeTags) || !typeTags.startsWithChar(','))
+            return false;
+
+        float value = 0.0f;
+        if (typeTags.length() > 1)
+        {
+            if (size - offset < 4)
+                return false;
+
+            const uint32_t bits = readBigEndian32(data + offset);
+            if (typeTags[1] == 'f')
+                std::memcpy(&value, &bits, sizeof(value));
+            else if (typeTags[1] == 'i')
+                value = static_cast<float>(static_cast<int32_t>(bits));
+        }
+
+        callback(address, value);
+        return true;
+    }
+
+    juce::String getChannelAddress(OSCAddressTable::Action action, const juce::String& channelName)
+    {
+        return "/Monitor/" + OSCAddressTable::getActionName(action) + "/" + channelName.replaceCharacter(' ', '_');
+    }
+}
+
+//==============================================================================
+StreamBenchmark::StreamBenchmark(MonitorControllerMaxAudioProcessor& processorToUse, const Options& benchmarkOptions)
+    : juce::Thread("StreamBenchmark"),
+      processor(processorToUse),
+      options(benchmarkOptions),
+      readBuffer(static_cast<size_t>(READ_BUFFER_BYTES))
+{
+}
+
+StreamBenchmark::~StreamBenchmark()
+{
+    stopThread(10000);
+    closeConnection();
+    listener.close();
+}
+
+void StreamBenchmark::start()
+{
+    startThread();
+}
+
+//==============================================================================
+void StreamBenchmark::run()
+{
+    std::vector<double> reconnectUs, convergeUs;
+    juce::Random random(options.seed);
+
+    callOnMessageThread([this] { captureExpectedState(); });
+
+    if (!listener.createListener(options.port, "127.0.0.1"))
+    {
+        result.failureReason = "Failed to listen on TCP port " + juce::String(options.port);
+    }
+    else if (!acceptConnection(options.timeoutMs))
+    {
+        result.failureReason = "Plugin did not connect to the TCP sink";
+    }
+    else
+    {
+        // 首次连接：插件检测到新的TCP连接后全量同步
+        const auto connectedTicks = juce::Time::getHighResolutionTicks();
+        if (waitUntilConverged(connectedTicks + juce::Time::secondsToHighResolutionTicks(options.timeoutMs * 0.001)))
+        {
+            ++result.converged;
+            convergeUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - connectedTicks));
+        }
+
+        for (int cycle = 0; cycle < options.cycles && !threadShouldExit(); ++cycle)
+        {
+            // 强制断线：对端关闭，插件在后续写入时才发现（之前一次写入可能已进入内核缓冲区后丢失）
+            const auto disconnectTicks = juce::Time::getHighResolutionTicks();
+            closeConnection();
+
+            for (int i = 0; i < options.togglesPerCycle && !threadShouldExit(); ++i)
+            {
+                callOnMessageThread([this, &random] { toggleState(random); });
+                juce::Thread::sleep(options.toggleIntervalMs);
+            }
+
+            callOnMessageThread([this] { captureExpectedState(); });
+
+            if (!acceptConnection(options.timeoutMs))
+            {
+                result.failureReason = "Plugin did not reconnect after forced disconnect " + juce::String(cycle + 1);
+                break;
+            }
+
+            const auto reconnectedTicks = juce::Time::getHighResolutionTicks();
+            reconnectUs.push_back(ticksToMicroseconds(reconnectedTicks - disconnectTicks));
+            ++result.cycles;
+
+            if (waitUntilConverged(reconnectedTicks + juce::Time::secondsToHighResolutionTicks(options.timeoutMs * 0.001)))
+            {
+                ++result.converged;
+                convergeUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - reconnectedTicks));
+            }
+        }
+    }
+
+    result.reconnect = OSCBenchmark::LatencySummary::fromSamples(reconnectUs, result.cycles < options.cycles ? 1 : 0);
+    result.converge = OSCBenchmark::LatencySummary::fromSamples(convergeUs, result.connections - result.converged);
+
+    closeConnection();
+    listener.close();
+
+    if (onFinished)
+        onFinished();
+}
+
+//==============================================================================
+// 对端（驱动线程）
+//==============================================================================
+
+bool StreamBenchmark::acceptConnection(int timeoutMs)
+{
+    if (listener.waitUntilReady(true, timeoutMs) <= 0)
+        return false;
+
+    std::unique_ptr<juce::StreamingSocket> accepted(listener.waitForNextConnection());
+    if (accepted == nullptr)
+        return false;
+
+    // 新连接从空状态开始：之前收到的值不能替代重连后的全量同步
+    connection = std::move(accepted);
+    decoder.reset();
+    received.clear();
+    ++result.connections;
+    return true;
+}
+
+void StreamBenchmark::closeConnection()
+{
+    if (connection != nullptr)
+    {
+        connection->close();
+        connection.reset();
+    }
+}
+
+void StreamBenchmark::readAvailable(int waitMs)
+{
+    if (connection == nullptr)
+    {
+        juce::Thread::sleep(waitMs);
+        return;
+    }
+
+    if (connection->waitUntilReady(true, waitMs) <= 0)
+        return;
+
+    const int bytesRead = connection->read(readBuffer.data(), static_cast<int>(readBuffer.size()), false);
+    if (bytesRead <= 0)
+    {
+        // 插件关闭了连接（例如目标被重建）
+        closeConnection();
+        return;
+    }
+
+    auto onMessage = [this](const juce::String& address, float value)
+    {
+        received[address] = value;
+        ++result.messages;
+    };
+
+    decoder.feed(readBuffer.data(), static_cast<size_t>(bytesRead), [this, &onMessage](const uint8_t* packet, size_t size)
+    {
+        ++result.frames;
+        if (!parsePacket(packet, size, onMessage))
+            ++result.malformedFrames;
+    });
+}
+
+bool StreamBenchmark::waitUntilConverged(juce::int64 deadlineTicks)
+{
+    while (!threadShouldExit() && juce::Time::getHighResolutionTicks() < deadlineTicks)
+    {
+        readAvailable(5);
+
+        if (isConverged())
+            return true;
+    }
+
+    return isConverged();
+}
+
+bool StreamBenchmark::isConverged() const
+{
+    for (const auto& [address, value] : expected)
+    {
+        const auto it = received.find(address);
+        if (it == received.end() || it->second != value)
+            return false;
+    }
+
+    return !expected.empty();
+}
+
+//==============================================================================
+// 插件状态（消息线程）
+//==============================================================================
+
+void StreamBenchmark::toggleState(juce::Random& random)
+{
+    const auto channels = processor.getPhysicalMapper().getActiveSemanticChannels();
+    if (channels.empty())
+        return;
+
+    auto& semanticState = processor.getSemanticState();
+    const auto& channelName = channels[static_cast<size_t>(random.nextInt(static_cast<int>(channels.size())))];
+
+    if (random.nextInt(4) == 0)
+        semanticState.setSoloState(channelName, !semanticState.getSoloState(channelName));
+    else
+        semanticState.setMuteState(channelName, !semanticState.getMuteState(channelName));
+}
+
+void StreamBenchmark::captureExpectedState()
+{
+    expected.clear();
+
+    const auto& semanticState = processor.getSemanticState();
+    for (const auto& channelName : processor.getPhysicalMapper().getActiveSemanticChannels())
+    {
+        expected[getChannelAddress(OSCAddressTable::Action::Solo, channelName)] = semanticState.getSoloState(channelName) ? 1.0f : 0.0f;
+        expected[getChannelAddress(OSCAddressTable::Action::Mute, channelName)] = semanticState.getMuteState(channelName) ? 1.0f : 0.0f;
+    }
+}
@@ -0,0 +1,112 @@
+﻿/*
+  ==============================================================================
+
+    StreamBenchmark.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC-over-TCP回环校验 - 驱动OSCTarget的TCP/SLIP流式路径
+
+    - 本机TCP监听端作为OSC对端：接受插件的"tcp"目标连接，SLIP Decoder逐帧解码为 地址 -> 最新值
+    - 强制断线：对端关闭连接，断线期间插件继续切换Solo/Mute（写入失败 -> 未写出消息重新入队 -> 按间隔重连）
+    - 每次（重新）连接都清空对端状态：只有重连后的全量同步把完整状态送达，才算无损
+    - 校验：每次连接后对端收到的每个通道Solo/Mute都与插件当前状态一致，且没有无法解析的帧
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "OSCBenchmark.h"
+#include "../../Source/OSCSlipCodec.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/**
+ * TCP流式传输回环校验
+ *
+ * 线程模型：
+ * - 监听、读取与解码都在驱动线程（对端只有一个连接，无需额外线程）
+ * - 插件状态的切换与采样同步投递到消息线程；调用方在主线程运行分发循环
+ * - onFinished在驱动线程结束时调用
+ *
+ * 调用方负责把插件的OSC目标配置为指向options.port的"tcp"目标。
+ */
+class StreamBenchmark : private juce::Thread
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        int port = 9446;                // 回环TCP对端的监听端口
+        int cycles = 5;                 // 强制断线 -> 重连次数
+        int togglesPerCycle = 20;       // 断线期间插件的Solo/Mute切换次数
+        int toggleIntervalMs = 15;      // 大于批量发送间隔，保证断线期间有多次写入
+        int timeoutMs = 5000;           // 等待连接/状态收敛的超时（重连间隔为1秒）
+        juce::int64 seed = 1;
+    };
+
+    struct Result
+    {
+        int cycles = 0;                 // 完成的断线 -> 重连次数
+        int connections = 0;            // 对端接受的连接数（含首次连接）
+        int converged = 0;              // 连接后完整状态送达的次数
+        juce::int64 frames = 0;
+        juce::int64 messages = 0;
+        juce::int64 malformedFrames = 0;
+
+        OSCBenchmark::LatencySummary reconnect;     // 对端断开 -> 新连接被接受
+        OSCBenchmark::LatencySummary converge;      // 新连接被接受 -> 对端状态与插件一致
+
+        juce::String failureReason;
+
+        bool passed() const noexcept
+        {
+            return failureReason.isEmpty() && converged == connections && malformedFrames == 0;
+        }
+    };
+
+    //==============================================================================
+    StreamBenchmark(MonitorControllerMaxAudioProcessor& processor, const Options& options);
+    ~StreamBenchmark() override;
+
+    void start();
+    const Result& getResult() const noexcept { return result; }
+
+    std::function<void()> onFinished;   // 驱动线程结束时调用（驱动线程）
+
+private:
+    //==============================================================================
+    void run() override;
+
+    bool acceptConnection(int timeoutMs);
+    void closeConnection();
+    void readAvailable(int waitMs);
+    bool waitUntilConverged(juce::int64 deadlineTicks);
+    bool isConverged() const;
+
+    // 消息线程
+    void toggleState(juce::Random& random);
+    void captureExpectedState();
+
+    //==============================================================================
+    MonitorControllerMaxAudioProcessor& processor;
+    const Options options;
+    Result result;
+
+    juce::StreamingSocket listener;
+    std::unique_ptr<juce::StreamingSocket> connection;
+    OSCSlipCodec::Decoder decoder;
+    std::vector<char> readBuffer;
+
+    std::map<juce::String, float> received;     // 对端：地址 -> 最新值（驱动线程）
+    std::map<juce::String, float> expected;     // 插件当前状态（消息线程采样，驱动线程比较）
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamBenchmark)
+};
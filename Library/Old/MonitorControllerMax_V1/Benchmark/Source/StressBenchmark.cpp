@@ -0,0 +1,655 @@
+﻿/*
+  ==============================================================================
+
+    StressBenchmark.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    多实例压力与扩展基准实现
+
+  ==============================================================================
+*/
+
+#include "StressBenchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int BLOCK_SIZE = 256;
+    constexpr int MAX_AUDIO_CHANNELS = 128;     // 主输入 + Stem/Reference输入 + Cue输出，留足余量
+    constexpr float LOCAL_TRIM_DB = 6.0f;       // 本地覆盖校验中Slave的本地Trim
+
+    double ticksToMicroseconds(juce::int64 ticks) noexcept
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    }
+
+    // 在消息线程同步执行：调用方阻塞到执行完毕，消息线程在两次调用之间照常分发定时器与异步回调
+    template <typename Function>
+    void callOnMessageThread(Function&& function)
+    {
+        using FunctionType = std::remove_reference_t<Function>;
+
+        juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* context) -> void*
+        {
+            (*static_cast<FunctionType*>(context))();
+            return nullptr;
+        }, &function);
+    }
+
+    juce::String getGroupName(int group)
+    {
+        // 第0组为默认组（与宿主中未设置组名的实例相同）
+        return group == 0 ? juce::String() : "Stress" + juce::String(group);
+    }
+}
+
+//==============================================================================
+/**
+ * 并发工作线程：音频线程按宿主方式对本车道登记的实例调用processBlock，观察线程循环读取健康报告
+ */
+class StressBenchmark::WorkerThread : public juce::Thread
+{
+public:
+    WorkerThread(StressBenchmark& ownerToUse, int laneToUse)
+        : juce::Thread(laneToUse >= 0 ? "StressAudio " + juce::String(laneToUse) : juce::String("StressObserver")),
+          owner(ownerToUse), lane(laneToUse)
+    {
+    }
+
+    ~WorkerThread() override
+    {
+        stopThread(5000);
+    }
+
+    void run() override
+    {
+        if (lane >= 0)
+        {
+            juce::AudioBuffer<float> scratch(MAX_AUDIO_CHANNELS, BLOCK_SIZE);
+            juce::MidiBuffer midi;
+
+            while (!threadShouldExit())
+            {
+                owner.processAudio(*owner.lanes[static_cast<size_t>(lane)], scratch, midi);
+                juce::Thread::sleep(1);
+            }
+        }
+        else
+        {
+            // 只取一次单例引用（getInstance每次调用都会计数）
+            auto state = GlobalPluginState::getInstance();
+
+            while (!threadShouldExit())
+            {
+                owner.observe(*state);
+                juce::Thread::sleep(1);
+            }
+        }
+    }
+
+private:
+    StressBenchmark& owner;
+    const int lane;     // 音频车道下标，-1 = 观察线程
+};
+
+//==============================================================================
+StressBenchmark::StressBenchmark(const Options& benchmarkOptions)
+    : juce::Thread("StressBenchmark"), options(benchmarkOptions)
+{
+    for (int i = 0; i < options.audioThreads; ++i)
+        lanes.push_back(std::make_unique<AudioLane>());
+}
+
+StressBenchmark::~StressBenchmark()
+{
+    stopThread(10000);
+    workers.clear();
+
+    // 驱动线程中途退出时剩下的实例（析构在主线程 = 消息线程）
+    instances.clear();
+}
+
+void StressBenchmark::start()
+{
+    startThread();
+}
+
+//==============================================================================
+void StressBenchmark::run()
+{
+    result.seed = options.seed;
+
+    callOnMessageThread([this]
+    {
+        result.expectedAtEnd = GlobalPluginState::getRef().getRegisteredPluginCount();
+    });
+
+    for (int lane = 0; lane < options.audioThreads; ++lane)
+        workers.push_back(std::make_unique<WorkerThread>(*this, lane));
+
+    for (int i = 0; i < options.observerThreads; ++i)
+        workers.push_back(std::make_unique<WorkerThread>(*this, -1));
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    runScript();
+
+    // 稳定：消息线程分发Slave定时器与异步回调（Master丢失/恢复通知）
+    if (!threadShouldExit())
+        juce::Thread::sleep(options.settleMs);
+
+    callOnMessageThread([this] { verifyAfterSettle(); });
+
+    // 扩展档位需要安静的消息线程：先停止并发线程
+    workers.clear();
+    result.audioBlocks = audioBlocks.load();
+    result.observerReports = observerReports.load();
+
+    callOnMessageThread([this]
+    {
+        destroyAll();
+        result.registeredAtEnd = GlobalPluginState::getRef().getRegisteredPluginCount();
+    });
+
+    if (!threadShouldExit())
+        runLocalOverrideCheck();
+
+    if (!threadShouldExit())
+        runScaling();
+
+    if (onFinished)
+        onFinished();
+}
+
+//==============================================================================
+// 脚本阶段：固定种子，所有随机数都在消息线程按操作顺序取用
+//==============================================================================
+
+void StressBenchmark::runScript()
+{
+    juce::Random random(options.seed);
+    createUsByPopulation.assign(static_cast<size_t>(options.instances / POPULATION_BUCKET + 1), {});
+
+    const auto lockBefore = GlobalPluginState::getRef().getLockStats();
+    const auto scriptStart = juce::Time::getHighResolutionTicks();
+
+    for (int op = 0; op < options.operations && !threadShouldExit(); ++op)
+    {
+        callOnMessageThread([this, &random]
+        {
+            execute(nextOperation(random), random);
+        });
+
+        ++result.operations;
+    }
+
+    result.scriptSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - scriptStart);
+
+    const auto lockAfter = GlobalPluginState::getRef().getLockStats();
+    result.lockStats.acquisitions = lockAfter.acquisitions - lockBefore.acquisitions;
+    result.lockStats.contentions = lockAfter.contentions - lockBefore.contentions;
+    result.lockStats.waitMs = lockAfter.waitMs - lockBefore.waitMs;
+
+    for (size_t bucket = 0; bucket < createUsByPopulation.size(); ++bucket)
+    {
+        if (createUsByPopulation[bucket].empty())
+            continue;
+
+        PopulationPoint point;
+        point.liveInstances = static_cast<int>(bucket) * POPULATION_BUCKET;
+        point.create = OSCBenchmark::LatencySummary::fromSamples(createUsByPopulation[bucket], 0);
+        result.population.push_back(point);
+    }
+
+    result.destroy = OSCBenchmark::LatencySummary::fromSamples(destroyUs, 0);
+    result.roleSwitch = OSCBenchmark::LatencySummary::fromSamples(roleSwitchUs, 0);
+    result.groupSwitch = OSCBenchmark::LatencySummary::fromSamples(groupSwitchUs, 0);
+    result.stateChange = OSCBenchmark::LatencySummary::fromSamples(stateChangeUs, 0);
+}
+
+StressBenchmark::Operation StressBenchmark::nextOperation(juce::Random& random) const
+{
+    const int live = static_cast<int>(instances.size());
+    if (live == 0)
+        return Operation::Create;
+    if (live >= options.instances)
+        return Operation::Destroy;
+
+    // 创建多于销毁：实例数先爬升到上限，再在上限附近震荡
+    const int roll = random.nextInt(100);
+    if (roll < 30) return Operation::Create;
+    if (roll < 45) return Operation::Destroy;
+    if (roll < 70) return Operation::SwitchRole;
+    if (roll < 75) return Operation::SwitchGroup;
+    return Operation::ChangeMasterState;
+}
+
+void StressBenchmark::execute(Operation operation, juce::Random& random)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    switch (operation)
+    {
+        case Operation::Create:
+        {
+            const auto groupName = getGroupName(random.nextInt(juce::jmax(1, options.groups)));
+            const auto bucket = juce::jmin(instances.size() / POPULATION_BUCKET, createUsByPopulation.size() - 1);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            createInstance(groupName);
+            createUsByPopulation[bucket].push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+            ++result.created;
+            result.peakInstances = juce::jmax(result.peakInstances, static_cast<int>(instances.size()));
+            break;
+        }
+
+        case Operation::Destroy:
+        {
+            const auto index = static_cast<size_t>(random.nextInt(static_cast<int>(instances.size())));
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            destroyInstance(index);
+            destroyUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+            ++result.destroyed;
+            break;
+        }
+
+        case Operation::SwitchRole:
+        {
+            auto& processor = *instances[static_cast<size_t>(random.nextInt(static_cast<int>(instances.size())))].processor;
+            const int target = random.nextInt(3);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            if (target == 0)
+                processor.switchToStandalone();
+            else if (target == 1)
+                processor.switchToMaster();
+            else
+                processor.switchToSlave();
+            roleSwitchUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+            ++result.roleSwitches;
+            if (target == 1 && processor.getCurrentRole() != PluginRole::Master)
+                ++result.roleSwitchesRefused;
+            break;
+        }
+
+        case Operation::SwitchGroup:
+        {
+            auto& processor = *instances[static_cast<size_t>(random.nextInt(static_cast<int>(instances.size())))].processor;
+            const auto groupName = getGroupName(random.nextInt(juce::jmax(1, options.groups)));
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.setMasterGroupName(groupName);
+            groupSwitchUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+            ++result.groupSwitches;
+            break;
+        }
+
+        case Operation::ChangeMasterState:
+        {
+            std::vector<MonitorControllerMaxAudioProcessor*> masters;
+            for (const auto& instance : instances)
+            {
+                if (instance.processor->getCurrentRole() == PluginRole::Master)
+                    masters.push_back(instance.processor.get());
+            }
+
+            // 还没有Master：本次改为把随机实例切换为Master
+            if (masters.empty())
+            {
+                execute(Operation::SwitchRole, random);
+                break;
+            }
+
+            auto& master = *masters[static_cast<size_t>(random.nextInt(static_cast<int>(masters.size())))];
+            const auto channels = master.getPhysicalMapper().getActiveSemanticChannels();
+            const int kind = random.nextInt(3);
+            auto& semanticState = master.getSemanticState();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            if (kind == 2 || channels.empty())
+            {
+                master.masterBusProcessor.setMonoActive(!master.masterBusProcessor.isMonoActive());
+            }
+            else
+            {
+                const auto& channelName = channels[static_cast<size_t>(random.nextInt(static_cast<int>(channels.size())))];
+                if (kind == 0)
+                    semanticState.setSoloState(channelName, !semanticState.getSoloState(channelName));
+                else
+                    semanticState.setMuteState(channelName, !semanticState.getMuteState(channelName));
+            }
+            stateChangeUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+            ++result.stateChanges;
+            break;
+        }
+    }
+}
+
+//==============================================================================
+// 校验：稳定后每个已连接的Slave与本组Master一致
+//==============================================================================
+
+void StressBenchmark::verifyAfterSettle()
+{
+    auto& globalState = GlobalPluginState::getRef();
+
+    for (const auto& instance : instances)
+    {
+        auto& processor = *instance.processor;
+        if (processor.getCurrentRole() != PluginRole::Slave)
+            continue;
+
+        auto* master = globalState.getMasterPlugin(&processor);
+        if (master == nullptr)
+            continue;   // 等待Master的Slave
+
+        ++result.connectedSlaves;
+        if (mirrorsMaster(processor, *master))
+            ++result.mirroredSlaves;
+    }
+}
+
+bool StressBenchmark::mirrorsMaster(MonitorControllerMaxAudioProcessor& slave, MonitorControllerMaxAudioProcessor& master)
+{
+    if (slave.masterBusProcessor.isMonoActive() != master.masterBusProcessor.isMonoActive())
+        return false;
+
+    const auto& slaveState = slave.getSemanticState();
+    const auto& masterState = master.getSemanticState();
+
+    for (const auto& channelName : slave.getPhysicalMapper().getActiveSemanticChannels())
+    {
+        if (slaveState.getSoloState(channelName) != masterState.getSoloState(channelName)
+            || slaveState.getMuteState(channelName) != masterState.getMuteState(channelName))
+            return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+// 本地覆盖：Slave的本地静音/Trim叠加在Master镜像之上，Master更新只重建Master层
+//==============================================================================
+
+void StressBenchmark::runLocalOverrideCheck()
+{
+    callOnMessageThread([this]
+    {
+        auto& check = result.localOverrides;
+        const juce::String groupName = "StressLocal";
+
+        auto* master = createInstance(groupName);
+        master->switchToMaster();
+        auto* slave = createInstance(groupName);
+        slave->switchToSlave();
+
+        const auto channels = master->getPhysicalMapper().getActiveSemanticChannels();
+        if (master->getCurrentRole() != PluginRole::Master || slave->getCurrentRole() != PluginRole::Slave || channels.size() < 2)
+        {
+            check.failureReason = "Could not set up a Master and a Slave with two channels";
+            destroyAll();
+            return;
+        }
+
+        const auto& mutedChannel = channels[0];
+        const auto& trimmedChannel = channels[1];
+        const int mutedIndex = findPhysicalIndex(*slave, mutedChannel);
+        const int trimmedIndex = findPhysicalIndex(*slave, trimmedChannel);
+
+        if (mutedIndex < 0 || trimmedIndex < 0 || mutedIndex >= RenderState::MAX_CHANNELS || trimmedIndex >= RenderState::MAX_CHANNELS)
+        {
+            check.failureReason = "Slave layout has no physical channel for " + mutedChannel + " / " + trimmedChannel;
+            destroyAll();
+            return;
+        }
+
+        slave->setLocalMuteOverride(mutedChannel, true);
+        slave->setLocalTrimOffset(trimmedChannel, LOCAL_TRIM_DB);
+
+        // 本地层的期望增益：GAIN_n + 本地Trim（与StateManager::rebuildLocalLayer相同的合成）
+        const auto gainParamID = "GAIN_" + juce::String(trimmedIndex + 1);
+        const float expectedGain = juce::Decibels::decibelsToGain(slave->apvts.getRawParameterValue(gainParamID)->load() + LOCAL_TRIM_DB);
+
+        auto& stateManager = *slave->stateManager;
+        const auto masterRebuildsBefore = stateManager.getMasterLayerRebuildCount();
+        const auto localRebuildsBefore = stateManager.getLocalLayerRebuildCount();
+
+        auto& masterState = master->getSemanticState();
+
+        auto applyAndCheck = [&]
+        {
+            slave->applyMasterSnapshot(master->getMasterGroup()->getSnapshot());
+            ++check.masterUpdates;
+
+            if (mirrorsMaster(*slave, *master))
+                ++check.mirroredUpdates;
+
+            // 消息线程即发布线程：此处读取当前快照没有并发写入
+            const auto* renderState = stateManager.getCurrentRenderState();
+            if (slave->getLocalMuteOverride(mutedChannel) && slave->getLocalTrimOffset(trimmedChannel) == LOCAL_TRIM_DB
+                && renderState != nullptr && renderState->channelShouldMute[mutedIndex]
+                && std::abs(renderState->channelFinalGain[trimmedIndex] - expectedGain) <= expectedGain * 1.0e-5f)
+                ++check.keptUpdates;
+        };
+
+        // 🚀 Master的Solo/Mute切换覆盖两个带本地覆盖的通道
+        for (int click = 0; click < options.scalingClicks; ++click)
+        {
+            const auto& channelName = channels[static_cast<size_t>(click) % channels.size()];
+
+            if (click % 3 == 0)
+                masterState.setSoloState(channelName, !masterState.getSoloState(channelName));
+            else
+                masterState.setMuteState(channelName, !masterState.getMuteState(channelName));
+
+            applyAndCheck();
+        }
+
+        // 最后Master全部清除：本地静音是该通道唯一的静音来源，Trim通道不应被静音
+        {
+            StateManager::ScopedTransaction transaction(*master->stateManager);
+            for (const auto& channelName : channels)
+            {
+                masterState.setSoloState(channelName, false);
+                masterState.setMuteState(channelName, false);
+            }
+        }
+
+        applyAndCheck();
+
+        const auto* renderState = stateManager.getCurrentRenderState();
+        if (renderState == nullptr || renderState->channelShouldMute[trimmedIndex])
+            check.failureReason = "Trimmed channel muted after Master cleared Solo/Mute";
+
+        check.masterLayerRebuilds = stateManager.getMasterLayerRebuildCount() - masterRebuildsBefore;
+        check.localLayerRebuilds = stateManager.getLocalLayerRebuildCount() - localRebuildsBefore;
+
+        destroyAll();
+    });
+}
+
+int StressBenchmark::findPhysicalIndex(MonitorControllerMaxAudioProcessor& processor, const juce::String& channelName)
+{
+    for (const auto& channelInfo : processor.getCurrentLayout().channels)
+    {
+        if (channelInfo.name == channelName)
+            return channelInfo.channelIndex;
+    }
+
+    return -1;
+}
+
+//==============================================================================
+// 扩展档位：一个Master + S个Slave，单独一个组，其他实例已全部销毁
+//==============================================================================
+
+void StressBenchmark::runScaling()
+{
+    for (const int slaveCount : options.scalingSlaves)
+    {
+        if (threadShouldExit())
+            break;
+
+        ScalingPoint point;
+        point.slaves = slaveCount;
+
+        callOnMessageThread([this, &point]
+        {
+            const juce::String groupName = "StressScale" + juce::String(point.slaves);
+
+            auto* master = createInstance(groupName);
+            master->switchToMaster();
+
+            std::vector<MonitorControllerMaxAudioProcessor*> slaves;
+            std::vector<double> joinUs, publishUs, broadcastUs;
+
+            for (int i = 0; i < point.slaves; ++i)
+            {
+                auto* slave = createInstance(groupName);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                slave->switchToSlave();
+                joinUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+                slaves.push_back(slave);
+            }
+
+            // 🚀 发布与Slave数无关；广播 = 每个Slave的跟随节拍各应用一次快照
+            const auto channels = master->getPhysicalMapper().getActiveSemanticChannels();
+            auto& masterState = master->getSemanticState();
+
+            for (int click = 0; click < options.scalingClicks && !channels.empty(); ++click)
+            {
+                const auto& channelName = channels[static_cast<size_t>(click) % channels.size()];
+
+                auto start = juce::Time::getHighResolutionTicks();
+                masterState.setSoloState(channelName, !masterState.getSoloState(channelName));
+                publishUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+
+                const auto snapshot = master->getMasterGroup()->getSnapshot();
+
+                start = juce::Time::getHighResolutionTicks();
+                for (auto* slave : slaves)
+                    slave->applyMasterSnapshot(snapshot);
+                broadcastUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+            }
+
+            for (auto* slave : slaves)
+            {
+                if (slave->getCurrentRole() == PluginRole::Slave && mirrorsMaster(*slave, *master))
+                    ++point.mirroredSlaves;
+            }
+
+            point.join = OSCBenchmark::LatencySummary::fromSamples(joinUs, 0);
+            point.publish = OSCBenchmark::LatencySummary::fromSamples(publishUs, 0);
+            point.broadcast = OSCBenchmark::LatencySummary::fromSamples(broadcastUs, 0);
+
+            destroyAll();
+        });
+
+        result.scaling.push_back(point);
+    }
+}
+
+//==============================================================================
+// 实例管理（消息线程）
+//==============================================================================
+
+MonitorControllerMaxAudioProcessor* StressBenchmark::createInstance(const juce::String& groupName)
+{
+    Instance instance;
+    instance.processor = std::make_unique<MonitorControllerMaxAudioProcessor>();
+    instance.processor->setCurrentLayout(options.speakerLayout, options.subLayout);
+    instance.processor->setMasterGroupName(groupName);
+    instance.processor->prepareToPlay(SAMPLE_RATE, BLOCK_SIZE);
+
+    // prepareToPlay之后才交给音频线程（宿主顺序）
+    if (!lanes.empty())
+    {
+        instance.lane = static_cast<int>(nextLane++ % lanes.size());
+        auto& lane = *lanes[static_cast<size_t>(instance.lane)];
+
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.instances.push_back(instance.processor.get());
+    }
+
+    auto* processor = instance.processor.get();
+    instances.push_back(std::move(instance));
+    return processor;
+}
+
+void StressBenchmark::destroyInstance(size_t index)
+{
+    auto& instance = instances[index];
+
+    // 先从音频车道移除（等待进行中的processBlock结束），再释放资源并析构
+    if (instance.lane >= 0)
+    {
+        auto& lane = *lanes[static_cast<size_t>(instance.lane)];
+
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.instances.erase(std::remove(lane.instances.begin(), lane.instances.end(), instance.processor.get()),
+                             lane.instances.end());
+    }
+
+    instance.processor->releaseResources();
+
+    // 与末尾交换后删除：下标只由脚本的随机数决定
+    if (index != instances.size() - 1)
+        std::swap(instances[index], instances.back());
+
+    instances.pop_back();
+}
+
+void StressBenchmark::destroyAll()
+{
+    while (!instances.empty())
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        destroyInstance(instances.size() - 1);
+        destroyUs.push_back(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+    }
+}
+
+//==============================================================================
+// 并发工作线程
+//==============================================================================
+
+void StressBenchmark::processAudio(AudioLane& lane, juce::AudioBuffer<float>& scratch, juce::MidiBuffer& midi)
+{
+    std::lock_guard<std::mutex> lock(lane.mutex);
+
+    for (auto* processor : lane.instances)
+    {
+        const int numChannels = juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
+        if (numChannels == 0 || numChannels > scratch.getNumChannels())
+            continue;
+
+        juce::AudioBuffer<float> buffer(scratch.getArrayOfWritePointers(), numChannels, BLOCK_SIZE);
+        buffer.clear();
+
+        processor->processBlock(buffer, midi);
+        audioBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void StressBenchmark::observe(GlobalPluginState& state)
+{
+    // 共享锁路径：遍历各组、解析Slave句柄、读取传播统计
+    const auto report = state.getHealthReport();
+    const auto groupNames = state.getGroupNames();
+    juce::ignoreUnused(report, groupNames, state.getRegisteredPluginCount());
+
+    observerReports.fetch_add(1, std::memory_order_relaxed);
+}
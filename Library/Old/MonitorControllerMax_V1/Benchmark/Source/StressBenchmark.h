@@ -0,0 +1,205 @@
+﻿/*
+  ==============================================================================
+
+    StressBenchmark.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    多实例压力与扩展基准 - GlobalPluginState在数百个实例下的生命周期正确性与开销
+
+    - 确定性脚本：创建/销毁实例、随机切换角色与组、Master状态变化，全部来自固定种子的伪随机序列
+      （同一种子 + 同一参数 = 同一操作序列；Slave定时器与异步回调照常在操作之间分发）
+    - 与宿主一致的线程模型：生命周期操作在消息线程执行；音频线程同时对已prepare的实例调用processBlock，
+      观察线程同时读取健康报告（注册表共享锁 + 句柄解析 + 各Slave的传播统计）
+    - 注册耗时按当时的实例数分档（扩展曲线），注册表锁统计获取/竞争次数与等待时间
+    - 扩展档位：每档一个Master + S个Slave，测量 加入 / Master单次发布 / 全部Slave应用快照（广播）
+    - 校验：脚本结束并稳定后，每个已连接的Slave与组Master一致；注册表实例数 = 存活实例数
+    - 本地覆盖校验：带本地静音/Trim的Slave镜像Master的Solo/Mute后仍保留本地层，且Master更新不重建本地层
+
+    ThreadSanitizer（Linux）：
+      cd Builds/LinuxMakefile
+      make CONFIG=Debug CXXFLAGS="-fsanitize=thread -g" LDFLAGS="-fsanitize=thread"
+      ./build/OSCBenchmark --stress-instances=200 --stress-ops=5000 --stress-seed=1
+    TSan下耗时约放大5-15倍，只看报告，不看数字。
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "OSCBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/**
+ * 多实例压力与扩展基准
+ *
+ * 驱动线程生成脚本并把每个操作同步投递到消息线程（callFunctionOnMessageThread），
+ * 调用方在主线程运行分发循环，onFinished在驱动线程结束时调用。
+ * 所有实例只在消息线程创建、修改与销毁；音频线程只在实例登记期间访问它（宿主的停止处理 -> 销毁顺序）。
+ */
+class StressBenchmark : private juce::Thread
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        int instances = 200;            // 脚本中同时存活的实例上限
+        int operations = 5000;          // 脚本操作数
+        int groups = 4;                 // 实例随机分布到的Master组数
+        juce::int64 seed = 1;
+        int audioThreads = 2;           // 0 = 不运行音频线程
+        int observerThreads = 2;        // 0 = 不运行观察线程
+        int settleMs = 300;             // 脚本结束后等待Slave跟随的时间
+        std::vector<int> scalingSlaves{ 1, 4, 16, 64, 256 };
+        int scalingClicks = 50;         // 每档Master Solo切换次数（本地覆盖校验同样使用）
+        juce::String speakerLayout{ "7.1.4" };
+        juce::String subLayout{ "2" };
+    };
+
+    struct PopulationPoint
+    {
+        int liveInstances = 0;                      // 分档下界（创建时的存活实例数）
+        OSCBenchmark::LatencySummary create;        // 构造（含注册）+ 布局 + 入组 + prepareToPlay
+    };
+
+    struct ScalingPoint
+    {
+        int slaves = 0;
+        OSCBenchmark::LatencySummary join;          // switchToSlave（含快照交接）
+        OSCBenchmark::LatencySummary publish;       // Master单次Solo切换（发布）
+        OSCBenchmark::LatencySummary broadcast;     // 全部Slave应用该次发布（各Slave定时器节拍的总和）
+        int mirroredSlaves = 0;
+    };
+
+    // 一个Master + 一个带本地覆盖的Slave：Master逐次发布，Slave每次应用后检查
+    struct LocalOverrideCheck
+    {
+        int masterUpdates = 0;                      // Slave应用的Master快照数
+        int mirroredUpdates = 0;                    // 应用后Solo/Mute与Master一致
+        int keptUpdates = 0;                        // 应用后本地静音与本地Trim仍在渲染快照中
+        uint64_t masterLayerRebuilds = 0;           // 期间Slave的Master层重建次数（应 > 0）
+        uint64_t localLayerRebuilds = 0;            // 期间Slave的本地层重建次数（应为0）
+        juce::String failureReason;
+
+        bool passed() const noexcept
+        {
+            return failureReason.isEmpty() && masterUpdates > 0 && mirroredUpdates == masterUpdates
+                && keptUpdates == masterUpdates && masterLayerRebuilds > 0 && localLayerRebuilds == 0;
+        }
+    };
+
+    struct Result
+    {
+        juce::int64 seed = 0;
+        int operations = 0;
+        int created = 0;
+        int destroyed = 0;
+        int roleSwitches = 0;
+        int roleSwitchesRefused = 0;                // 组内已有Master时switchToMaster被拒
+        int groupSwitches = 0;
+        int stateChanges = 0;
+        int peakInstances = 0;
+
+        OSCBenchmark::LatencySummary destroy;       // releaseResources + 析构（含注销）
+        OSCBenchmark::LatencySummary roleSwitch;
+        OSCBenchmark::LatencySummary groupSwitch;
+        OSCBenchmark::LatencySummary stateChange;   // Master通道Solo/Mute切换或Mono切换
+        std::vector<PopulationPoint> population;
+
+        GlobalPluginState::LockStats lockStats;     // 脚本阶段的注册表锁统计
+        uint64_t audioBlocks = 0;
+        uint64_t observerReports = 0;
+        double scriptSeconds = 0.0;
+
+        // 稳定后校验
+        int connectedSlaves = 0;
+        int mirroredSlaves = 0;
+        int registeredAtEnd = 0;                    // 脚本实例全部销毁后注册表中剩余的实例数
+        int expectedAtEnd = 0;
+
+        std::vector<ScalingPoint> scaling;
+        LocalOverrideCheck localOverrides;
+        juce::String failureReason;
+
+        bool passed() const noexcept
+        {
+            return failureReason.isEmpty() && mirroredSlaves == connectedSlaves && registeredAtEnd == expectedAtEnd
+                && localOverrides.passed();
+        }
+    };
+
+    //==============================================================================
+    explicit StressBenchmark(const Options& options);
+    ~StressBenchmark() override;
+
+    void start();
+    const Result& getResult() const noexcept { return result; }
+
+    std::function<void()> onFinished;   // 驱动线程结束时调用（驱动线程）
+
+    static constexpr int POPULATION_BUCKET = 64;
+
+private:
+    //==============================================================================
+    enum class Operation { Create, Destroy, SwitchRole, SwitchGroup, ChangeMasterState };
+
+    struct Instance
+    {
+        std::unique_ptr<MonitorControllerMaxAudioProcessor> processor;
+        int lane = -1;                  // 所在音频车道，-1 = 没有音频线程
+    };
+
+    // 音频车道：一个音频线程 + 登记在该线程上的实例（宿主式登记：登记期间实例不会被销毁）
+    struct AudioLane
+    {
+        std::mutex mutex;
+        std::vector<MonitorControllerMaxAudioProcessor*> instances;
+    };
+
+    class WorkerThread;
+
+    void run() override;
+    void runScript();
+    void runScaling();
+    void runLocalOverrideCheck();
+    void verifyAfterSettle();
+    void destroyAll();
+
+    Operation nextOperation(juce::Random& random) const;
+    void execute(Operation operation, juce::Random& random);
+
+    // 消息线程
+    MonitorControllerMaxAudioProcessor* createInstance(const juce::String& groupName);
+    void destroyInstance(size_t index);
+    static bool mirrorsMaster(MonitorControllerMaxAudioProcessor& slave, MonitorControllerMaxAudioProcessor& master);
+    static int findPhysicalIndex(MonitorControllerMaxAudioProcessor& processor, const juce::String& channelName);
+
+    // 工作线程
+    void processAudio(AudioLane& lane, juce::AudioBuffer<float>& scratch, juce::MidiBuffer& midi);
+    void observe(GlobalPluginState& state);
+
+    //==============================================================================
+    const Options options;
+    Result result;
+
+    // 消息线程独占
+    std::vector<Instance> instances;
+    std::vector<double> destroyUs, roleSwitchUs, groupSwitchUs, stateChangeUs;
+    std::vector<std::vector<double>> createUsByPopulation;
+    size_t nextLane = 0;
+
+    std::vector<std::unique_ptr<AudioLane>> lanes;
+
+    std::vector<std::unique_ptr<WorkerThread>> workers;
+    std::atomic<uint64_t> audioBlocks{ 0 };
+    std::atomic<uint64_t> observerReports{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StressBenchmark)
+};
@@ -0,0 +1,304 @@
+﻿/*
+  ==============================================================================
+
+    AnalyserPanel.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    弹出式分析器面板实现 - 频谱曲线、相关系数条和测角仪绘制
+
+  ==============================================================================
+*/
+
+#include "AnalyserPanel.h"
+#include "EffectsPanel.h"
+#include "DebugLogger.h"
+
+//==============================================================================
+AnalyserPanel::AnalyserPanel(MonitorControllerMaxAudioProcessor& processor)
+    : audioProcessor(processor)
+{
+    // 初始状态为隐藏
+    panelVisible = false;
+    setVisible(false);
+
+    // OSC输出开关：开启后即使面板关闭也以10Hz持续分析并发送
+    addAndMakeVisible(oscStreamButton);
+    oscStreamButton.setClickingTogglesState(true);
+    oscStreamButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::green);
+    oscStreamButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    oscStreamButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    oscStreamButton.setTooltip("Stream spectrum and correlation to /Monitor/Analyser/* at 10Hz");
+    oscStreamButton.onClick = [this]()
+    {
+        audioProcessor.setAnalyserOSCStreaming(oscStreamButton.getToggleState());
+    };
+
+    // 电平表OSC输出帧率：与分析器输出独立，开启后面板关闭也持续发送 /Monitor/Meter/*
+    addAndMakeVisible(meterRateButton);
+    meterRateButton.setClickingTogglesState(false);
+    meterRateButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::green);
+    meterRateButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    meterRateButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    meterRateButton.setTooltip("Stream per-channel peak/RMS to /Monitor/Meter/*: OFF / 10 / 20 / 30 / 60 Hz");
+    meterRateButton.onClick = [this]()
+    {
+        static constexpr int rates[] = { 0, 10, 20, 30, 60 };
+        const int currentRate = audioProcessor.getMeterOSCRate();
+
+        int next = 1;
+        for (int i = 0; i < static_cast<int>(std::size(rates)); ++i)
+        {
+            if (rates[i] == currentRate)
+            {
+                next = (i + 1) % static_cast<int>(std::size(rates));
+                break;
+            }
+        }
+
+        audioProcessor.setMeterOSCRate(rates[next]);
+        updateMeterRateButtonText();
+    };
+
+    updateMeterRateButtonText();
+}
+
+AnalyserPanel::~AnalyserPanel()
+{
+    stopTimer();
+
+    // 面板随编辑器销毁时必须注销视图，否则分析线程会一直运行
+    if (panelVisible)
+        audioProcessor.channelAnalyser.unregisterView();
+}
+
+//==============================================================================
+// 面板显示控制
+void AnalyserPanel::showPanel()
+{
+    if (!panelVisible)
+    {
+        panelVisible = true;
+        setVisible(true);
+        toFront(true);
+        resized();
+
+        oscStreamButton.setToggleState(audioProcessor.isAnalyserOSCStreaming(), juce::dontSendNotification);
+        updateMeterRateButtonText();
+
+        audioProcessor.channelAnalyser.registerView();
+        startTimerHz(REFRESH_RATE_HZ);
+
+        VST3_DBG_ROLE(&audioProcessor, "AnalyserPanel: Panel shown - analysis rate: " +
+                     juce::String(audioProcessor.channelAnalyser.getAnalysisRateHz()) + "Hz");
+    }
+}
+
+void AnalyserPanel::hidePanel()
+{
+    if (panelVisible)
+    {
+        panelVisible = false;
+        setVisible(false);
+        stopTimer();
+
+        audioProcessor.channelAnalyser.unregisterView();
+
+        VST3_DBG_ROLE(&audioProcessor, "AnalyserPanel: Panel hidden");
+    }
+}
+
+bool AnalyserPanel::isPanelVisible() const
+{
+    return panelVisible;
+}
+
+void AnalyserPanel::updateMeterRateButtonText()
+{
+    const int rateHz = audioProcessor.getMeterOSCRate();
+
+    meterRateButton.setButtonText(rateHz > 0 ? "METER " + juce::String(rateHz) + "Hz" : juce::String("METER OFF"));
+    meterRateButton.setToggleState(rateHz > 0, juce::dontSendNotification);
+}
+
+//==============================================================================
+void AnalyserPanel::timerCallback()
+{
+    // 只有分析线程发布了新快照才重绘
+    if (audioProcessor.channelAnalyser.getLatestSnapshot(snapshot, lastSequence))
+    {
+        lastSequence = snapshot.sequence;
+        repaint();
+    }
+}
+
+void AnalyserPanel::resized()
+{
+    auto area = getLocalBounds().reduced(10);
+
+    auto header = area.removeFromTop(24);
+    oscStreamButton.setBounds(header.removeFromRight(80));
+    header.removeFromRight(5);
+    meterRateButton.setBounds(header.removeFromRight(90));
+
+    area.removeFromTop(5);
+    spectrumArea = area.removeFromTop(area.getHeight() * 3 / 5);
+    area.removeFromTop(10);
+    pairsArea = area;
+}
+
+void AnalyserPanel::paint(juce::Graphics& g)
+{
+    auto area = getLocalBounds();
+
+    // 与EffectsPanel一致的半透明背景和边框
+    g.setColour(EffectsPanel::PANEL_SHADOW);
+    g.fillRoundedRectangle(area.expanded(2).toFloat(), PANEL_CORNER_RADIUS);
+    g.setColour(EffectsPanel::PANEL_BACKGROUND.withAlpha(0.9f));
+    g.fillRoundedRectangle(area.toFloat(), PANEL_CORNER_RADIUS);
+    g.setColour(EffectsPanel::PANEL_BORDER);
+    g.drawRoundedRectangle(area.toFloat(), PANEL_CORNER_RADIUS, 1.0f);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    g.drawText("ANALYSER", area.reduced(10).removeFromTop(24), juce::Justification::centredLeft);
+
+    drawSpectrum(g, spectrumArea.toFloat());
+
+    // 立体声对单元格：横向平均分布，每格为测角仪 + 相关系数条
+    if (snapshot.numPairs <= 0)
+    {
+        g.setColour(juce::Colours::grey);
+        g.drawText("No stereo pairs in current layout", pairsArea, juce::Justification::centred);
+        return;
+    }
+
+    const float cellWidth = static_cast<float>(pairsArea.getWidth()) / static_cast<float>(snapshot.numPairs);
+    for (int p = 0; p < snapshot.numPairs; ++p)
+    {
+        juce::Rectangle<float> cell(static_cast<float>(pairsArea.getX()) + cellWidth * static_cast<float>(p),
+                                    static_cast<float>(pairsArea.getY()),
+                                    cellWidth,
+                                    static_cast<float>(pairsArea.getHeight()));
+        drawPair(g, cell.reduced(4.0f), snapshot.pairs[static_cast<size_t>(p)]);
+    }
+}
+
+//==============================================================================
+// 私有绘制方法
+
+void AnalyserPanel::drawSpectrum(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.5f));
+    g.fillRect(area);
+
+    // 网格：每18dB一条水平线，100Hz/1k/10k竖线
+    g.setColour(juce::Colours::white.withAlpha(0.1f));
+    for (float db = MIN_DISPLAY_DB; db <= 0.0f; db += 18.0f)
+    {
+        const float y = juce::jmap(db, MIN_DISPLAY_DB, 0.0f, area.getBottom(), area.getY());
+        g.drawHorizontalLine(juce::roundToInt(y), area.getX(), area.getRight());
+    }
+
+    g.setFont(10.0f);
+    for (const float frequency : { 100.0f, 1000.0f, 10000.0f })
+    {
+        const float x = area.getX() + area.getWidth() * std::log10(frequency / 20.0f) / 3.0f;
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        g.drawVerticalLine(juce::roundToInt(x), area.getY(), area.getBottom());
+        g.setColour(juce::Colours::grey);
+        g.drawText(frequency >= 1000.0f ? juce::String(frequency / 1000.0f, 0) + "k" : juce::String(frequency, 0),
+                   juce::Rectangle<float>(x + 2.0f, area.getBottom() - 14.0f, 30.0f, 12.0f),
+                   juce::Justification::centredLeft);
+    }
+
+    // 每个激活通道一条曲线，颜色按通道索引在色环上分布
+    int activeCount = 0;
+    for (const bool isActive : snapshot.channelActive)
+        activeCount += isActive ? 1 : 0;
+
+    if (activeCount == 0)
+        return;
+
+    const float bandWidth = area.getWidth() / static_cast<float>(AnalyserSnapshot::NUM_BANDS);
+    int colourIndex = 0;
+    float legendX = area.getX() + 4.0f;
+
+    for (int ch = 0; ch < AnalyserSnapshot::MAX_CHANNELS; ++ch)
+    {
+        if (!snapshot.channelActive[static_cast<size_t>(ch)])
+            continue;
+
+        const auto colour = juce::Colour::fromHSV(static_cast<float>(colourIndex++) / static_cast<float>(activeCount),
+                                                  0.7f, 0.95f, 0.9f);
+        juce::Path curve;
+
+        for (int band = 0; band < AnalyserSnapshot::NUM_BANDS; ++band)
+        {
+            const float levelDb = juce::jlimit(MIN_DISPLAY_DB, 0.0f, snapshot.spectrumDb[static_cast<size_t>(ch)][static_cast<size_t>(band)]);
+            const float x = area.getX() + bandWidth * (static_cast<float>(band) + 0.5f);
+            const float y = juce::jmap(levelDb, MIN_DISPLAY_DB, 0.0f, area.getBottom(), area.getY());
+
+            if (band == 0)
+                curve.startNewSubPath(x, y);
+            else
+                curve.lineTo(x, y);
+        }
+
+        g.setColour(colour);
+        g.strokePath(curve, juce::PathStrokeType(1.5f));
+
+        // 图例
+        const juce::String name = getChannelName(ch);
+        g.drawText(name, juce::Rectangle<float>(legendX, area.getY() + 2.0f, 36.0f, 12.0f), juce::Justification::centredLeft);
+        legendX += 38.0f;
+    }
+}
+
+void AnalyserPanel::drawPair(juce::Graphics& g, juce::Rectangle<float> area, const AnalyserSnapshot::PairResult& pair)
+{
+    auto labelArea = area.removeFromBottom(14.0f);
+    auto correlationArea = area.removeFromBottom(10.0f);
+    area.removeFromBottom(4.0f);
+
+    // 测角仪：正方形区域，竖直方向为Mid（单声道），水平方向为Side
+    const float size = juce::jmin(area.getWidth(), area.getHeight());
+    auto scope = area.withSizeKeepingCentre(size, size);
+
+    g.setColour(juce::Colours::black.withAlpha(0.5f));
+    g.fillRect(scope);
+    g.setColour(juce::Colours::white.withAlpha(0.1f));
+    g.drawLine(scope.getCentreX(), scope.getY(), scope.getCentreX(), scope.getBottom());
+    g.drawLine(scope.getX(), scope.getCentreY(), scope.getRight(), scope.getCentreY());
+
+    g.setColour(juce::Colours::lightgreen.withAlpha(0.7f));
+    const float halfSize = size * 0.5f;
+    for (const auto& point : pair.goniometer)
+    {
+        const float x = scope.getCentreX() + point.x * halfSize;
+        const float y = scope.getCentreY() - point.y * halfSize;
+        g.fillRect(x - 1.0f, y - 1.0f, 2.0f, 2.0f);
+    }
+
+    // 相关系数条：中心为0，右侧（同相）绿色，左侧（反相）红色
+    g.setColour(juce::Colours::black.withAlpha(0.5f));
+    g.fillRect(correlationArea);
+
+    const float centreX = correlationArea.getCentreX();
+    const float barEnd = centreX + pair.correlation * correlationArea.getWidth() * 0.5f;
+    g.setColour(pair.correlation >= 0.0f ? juce::Colours::green : juce::Colours::red);
+    g.fillRect(juce::Rectangle<float>::leftTopRightBottom(juce::jmin(centreX, barEnd), correlationArea.getY(),
+                                                           juce::jmax(centreX, barEnd), correlationArea.getBottom()));
+
+    g.setColour(juce::Colours::white);
+    g.setFont(11.0f);
+    g.drawText(getChannelName(pair.leftChannel) + "/" + getChannelName(pair.rightChannel) + "  " +
+               juce::String(pair.correlation, 2),
+               labelArea, juce::Justification::centred);
+}
+
+juce::String AnalyserPanel::getChannelName(int channelIndex) const
+{
+    const auto& names = audioProcessor.analyserChannelNames;
+    return juce::isPositiveAndBelow(channelIndex, names.size()) ? names[channelIndex] : juce::String(channelIndex + 1);
+}
@@ -0,0 +1,73 @@
+﻿/*
+  ==============================================================================
+
+    AnalyserPanel.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    弹出式分析器面板 - 每通道频谱 + 立体声对相关系数/测角仪
+
+    - 与EffectsPanel相同的覆盖方式，显示在通道网格区域之上
+    - 打开时向ChannelAnalyser注册视图（分析频率随视图数量自适应），关闭即注销
+    - 只读取分析快照，不参与任何状态控制，Slave模式同样可用
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+ * 分析器面板类 - 弹出式界面组件
+ */
+class AnalyserPanel : public juce::Component,
+                      private juce::Timer
+{
+public:
+    //==============================================================================
+    explicit AnalyserPanel(MonitorControllerMaxAudioProcessor& processor);
+    ~AnalyserPanel() override;
+
+    //==============================================================================
+    // 面板显示控制
+    void showPanel();
+    void hidePanel();
+    bool isPanelVisible() const;
+
+    //==============================================================================
+    // Component overrides
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    //==============================================================================
+    static constexpr int REFRESH_RATE_HZ = 30;
+    static constexpr float MIN_DISPLAY_DB = -90.0f;
+    static constexpr float PANEL_CORNER_RADIUS = 6.0f;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    void drawSpectrum(juce::Graphics& g, juce::Rectangle<float> area);
+    void drawPair(juce::Graphics& g, juce::Rectangle<float> area, const AnalyserSnapshot::PairResult& pair);
+    juce::String getChannelName(int channelIndex) const;
+    void updateMeterRateButtonText();
+
+    //==============================================================================
+    MonitorControllerMaxAudioProcessor& audioProcessor;
+
+    bool panelVisible = false;
+    AnalyserSnapshot snapshot;
+    uint32_t lastSequence = 0;
+
+    juce::TextButton oscStreamButton{ "OSC OUT" };
+    juce::TextButton meterRateButton{ "METER OFF" };   // 电平表OSC输出帧率 OFF/10/20/30/60Hz 循环切换
+    juce::Rectangle<int> spectrumArea;
+    juce::Rectangle<int> pairsArea;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserPanel)
+};
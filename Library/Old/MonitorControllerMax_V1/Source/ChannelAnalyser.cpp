@@ -0,0 +1,391 @@
+﻿/*
+  ==============================================================================
+
+    ChannelAnalyser.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    后台频谱与相位相关分析器实现 - 无等待采集 + 低优先级FFT分析
+
+  ==============================================================================
+*/
+
+#include "ChannelAnalyser.h"
+#include "DebugLogger.h"
+
+//==============================================================================
+float AnalyserSnapshot::getBandCentreFrequency(int band)
+{
+    // 20Hz - 20kHz 三个十倍频程均分为NUM_BANDS段，取几何中心
+    return 20.0f * std::pow(1000.0f, (static_cast<float>(band) + 0.5f) / static_cast<float>(NUM_BANDS));
+}
+
+//==============================================================================
+ChannelAnalyser::ChannelAnalyser()
+    : juce::Thread("ChannelAnalyser")
+{
+    for (auto& flag : channelActive)
+        flag.store(false);
+
+    for (auto& channelSpectrum : workingSnapshot.spectrumDb)
+        channelSpectrum.fill(-100.0f);
+}
+
+ChannelAnalyser::~ChannelAnalyser()
+{
+    cancelPendingUpdate();
+    release();
+}
+
+//==============================================================================
+void ChannelAnalyser::prepare(double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    // 重新分配前先停止工作线程（prepareToPlay期间音频线程不会调用pushBlock）
+    release();
+
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+
+    // FIFO容量：至少0.25秒或4个音频块，工作线程最慢10Hz消费一次
+    const int fifoSize = juce::jmax(juce::roundToInt(currentSampleRate * 0.25),
+                                    maximumExpectedSamplesPerBlock * 4) + 1;
+    fifoBuffer.setSize(AnalyserSnapshot::MAX_CHANNELS, fifoSize, false, true, false);
+    fifo.setTotalSize(fifoSize);
+    fifo.reset();
+
+    history.setSize(AnalyserSnapshot::MAX_CHANNELS, FFT_SIZE, false, true, false);
+    history.clear();
+    historyWritePos = 0;
+
+    if (fft == nullptr) {
+        fft = std::make_unique<juce::dsp::FFT>(FFT_ORDER);
+        window = std::make_unique<juce::dsp::WindowingFunction<float>>(
+            static_cast<size_t>(FFT_SIZE), juce::dsp::WindowingFunction<float>::hann, false);
+        fftData.assign(static_cast<size_t>(FFT_SIZE * 2), 0.0f);
+        linearFrame.assign(static_cast<size_t>(FFT_SIZE), 0.0f);
+    }
+
+    computeBandBins();
+
+    prepared.store(true, std::memory_order_release);
+    startThread(juce::Thread::Priority::low);
+
+    VST3_DBG_DETAIL("ChannelAnalyser: Prepared - sampleRate: " + juce::String(currentSampleRate) +
+                    ", fifo: " + juce::String(fifoSize) + " samples, FFT: " + juce::String(FFT_SIZE));
+}
+
+void ChannelAnalyser::release()
+{
+    prepared.store(false, std::memory_order_release);
+    stopThread(1000);
+}
+
+void ChannelAnalyser::computeBandBins()
+{
+    const int maxBin = FFT_SIZE / 2;
+    const double binWidth = currentSampleRate / static_cast<double>(FFT_SIZE);
+
+    for (int band = 0; band <= AnalyserSnapshot::NUM_BANDS; ++band) {
+        const double edgeHz = 20.0 * std::pow(1000.0, static_cast<double>(band) / AnalyserSnapshot::NUM_BANDS);
+        int bin = juce::jlimit(1, maxBin, static_cast<int>(edgeHz / binWidth));
+
+        // 低频段FFT分辨率不足：保证每个频带至少包含一个bin
+        if (band > 0)
+            bin = juce::jmin(maxBin, juce::jmax(bin, bandBinEdges[static_cast<size_t>(band - 1)] + 1));
+
+        bandBinEdges[static_cast<size_t>(band)] = bin;
+    }
+}
+
+//==============================================================================
+void ChannelAnalyser::pushBlock(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    // 没有视图也没有OSC输出时音频线程零开销
+    if (!prepared.load(std::memory_order_acquire) || !isRunning())
+        return;
+
+    if (numSamples <= 0 || fifo.getFreeSpace() < numSamples) {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), AnalyserSnapshot::MAX_CHANNELS);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        if (!channelActive[static_cast<size_t>(ch)].load(std::memory_order_relaxed))
+            continue;
+
+        if (size1 > 0) fifoBuffer.copyFrom(ch, start1, buffer, ch, 0, size1);
+        if (size2 > 0) fifoBuffer.copyFrom(ch, start2, buffer, ch, size1, size2);
+    }
+    fifo.finishedWrite(size1 + size2);
+}
+
+//==============================================================================
+void ChannelAnalyser::setChannelActive(int channelIndex, bool shouldBeActive) noexcept
+{
+    if (channelIndex >= 0 && channelIndex < AnalyserSnapshot::MAX_CHANNELS)
+        channelActive[static_cast<size_t>(channelIndex)].store(shouldBeActive, std::memory_order_relaxed);
+}
+
+void ChannelAnalyser::setStereoPairs(const std::vector<std::pair<int, int>>& newPairs)
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(pairsLock);
+        stereoPairs = newPairs;
+    }
+
+    VST3_DBG_DETAIL("ChannelAnalyser: Stereo pairs updated - " + juce::String(static_cast<int>(newPairs.size())) + " pairs");
+}
+
+void ChannelAnalyser::registerView()
+{
+    const int views = ++viewCount;
+    notify();  // 立即按新频率开始分析
+
+    VST3_DBG_DETAIL("ChannelAnalyser: View registered - views: " + juce::String(views) +
+                    ", rate: " + juce::String(getAnalysisRateHz()) + "Hz");
+}
+
+void ChannelAnalyser::unregisterView()
+{
+    const int views = --viewCount;
+    jassert(views >= 0);
+
+    VST3_DBG_DETAIL("ChannelAnalyser: View unregistered - views: " + juce::String(views) +
+                    ", rate: " + juce::String(getAnalysisRateHz()) + "Hz");
+}
+
+void ChannelAnalyser::setOSCStreamingEnabled(bool shouldStream)
+{
+    oscStreaming.store(shouldStream);
+    notify();
+
+    VST3_DBG_IMPORTANT("ChannelAnalyser: OSC streaming " + juce::String(shouldStream ? "enabled" : "disabled"));
+}
+
+int ChannelAnalyser::getAnalysisRateHz() const noexcept
+{
+    // 自适应频率：多视图30Hz，单视图20Hz，仅OSC时10Hz，否则停止
+    const int views = viewCount.load(std::memory_order_relaxed);
+    if (views >= 2) return 30;
+    if (views == 1) return 20;
+    return oscStreaming.load(std::memory_order_relaxed) ? OSC_RATE_HZ : 0;
+}
+
+bool ChannelAnalyser::getLatestSnapshot(AnalyserSnapshot& destination, uint32_t lastSequence) const
+{
+    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+
+    if (publishedSnapshot.sequence == lastSequence)
+        return false;
+
+    destination = publishedSnapshot;
+    return true;
+}
+
+//==============================================================================
+void ChannelAnalyser::run()
+{
+    while (!threadShouldExit())
+    {
+        const int rateHz = getAnalysisRateHz();
+
+        // 停止状态：只丢弃残留数据，等待视图注册唤醒
+        if (rateHz == 0) {
+            drainFifo(false);
+            wait(100);
+            continue;
+        }
+
+        const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+        drainFifo(true);
+        analyse();
+
+        {
+            const juce::SpinLock::ScopedLockType lock(snapshotLock);
+            publishedSnapshot = workingSnapshot;
+        }
+
+        if (oscStreaming.load(std::memory_order_relaxed) && startMs - lastOSCTime >= 1000.0 / OSC_RATE_HZ) {
+            lastOSCTime = startMs;
+            triggerAsyncUpdate();
+        }
+
+        const int elapsedMs = static_cast<int>(juce::Time::getMillisecondCounterHiRes() - startMs);
+        wait(juce::jmax(1, 1000 / rateHz - elapsedMs));
+    }
+}
+
+void ChannelAnalyser::handleAsyncUpdate()
+{
+    if (!onSnapshotForOSC || !oscStreaming.load())
+        return;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        oscSnapshot = publishedSnapshot;
+    }
+
+    onSnapshotForOSC(oscSnapshot);
+}
+
+//==============================================================================
+void ChannelAnalyser::drainFifo(bool keepSamples)
+{
+    const int numReady = fifo.getNumReady();
+    if (numReady <= 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    if (keepSamples) {
+        // 写入每通道环形历史，始终保留最近FFT_SIZE个样本
+        auto appendToHistory = [this](int fifoStart, int size)
+        {
+            // 超过一帧的数据只保留尾部
+            if (size > FFT_SIZE) {
+                fifoStart += size - FFT_SIZE;
+                size = FFT_SIZE;
+            }
+
+            while (size > 0) {
+                const int chunk = juce::jmin(size, FFT_SIZE - historyWritePos);
+                for (int ch = 0; ch < AnalyserSnapshot::MAX_CHANNELS; ++ch) {
+                    if (channelActive[static_cast<size_t>(ch)].load(std::memory_order_relaxed))
+                        history.copyFrom(ch, historyWritePos, fifoBuffer, ch, fifoStart, chunk);
+                }
+
+                historyWritePos = (historyWritePos + chunk) % FFT_SIZE;
+                fifoStart += chunk;
+                size -= chunk;
+            }
+        };
+
+        if (size1 > 0) appendToHistory(start1, size1);
+        if (size2 > 0) appendToHistory(start2, size2);
+    }
+
+    fifo.finishedRead(size1 + size2);
+}
+
+void ChannelAnalyser::analyse()
+{
+    auto& snapshot = workingSnapshot;
+
+    // 频谱下落：约60dB/秒，按实际分析间隔折算
+    const float releaseDb = 60.0f / static_cast<float>(juce::jmax(1, getAnalysisRateHz()));
+
+    // 展开环形历史：historyWritePos处是最旧的样本
+    auto unrollChannel = [this](int ch, float* destination)
+    {
+        const float* source = history.getReadPointer(ch);
+        const int tail = FFT_SIZE - historyWritePos;
+        juce::FloatVectorOperations::copy(destination, source + historyWritePos, tail);
+        juce::FloatVectorOperations::copy(destination + tail, source, historyWritePos);
+    };
+
+    //==============================================================================
+    // 每通道频谱
+    for (int ch = 0; ch < AnalyserSnapshot::MAX_CHANNELS; ++ch) {
+        const bool isActive = channelActive[static_cast<size_t>(ch)].load(std::memory_order_relaxed);
+        auto& bands = snapshot.spectrumDb[static_cast<size_t>(ch)];
+        snapshot.channelActive[static_cast<size_t>(ch)] = isActive;
+
+        if (!isActive) {
+            bands.fill(-100.0f);
+            continue;
+        }
+
+        unrollChannel(ch, fftData.data());
+        juce::FloatVectorOperations::clear(fftData.data() + FFT_SIZE, FFT_SIZE);
+        window->multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(FFT_SIZE));
+        fft->performFrequencyOnlyForwardTransform(fftData.data());
+
+        // 幅度归一化：Hann窗相干增益0.5，单边谱 ×2 → 满幅正弦 = 0dBFS
+        const float scale = 4.0f / static_cast<float>(FFT_SIZE);
+
+        for (int band = 0; band < AnalyserSnapshot::NUM_BANDS; ++band) {
+            const int binStart = bandBinEdges[static_cast<size_t>(band)];
+            const int binEnd = juce::jmax(binStart + 1, bandBinEdges[static_cast<size_t>(band + 1)]);
+
+            float peak = 0.0f;
+            for (int bin = binStart; bin < binEnd && bin <= FFT_SIZE / 2; ++bin)
+                peak = juce::jmax(peak, fftData[static_cast<size_t>(bin)]);
+
+            const float levelDb = juce::Decibels::gainToDecibels(peak * scale, -100.0f);
+            auto& smoothed = bands[static_cast<size_t>(band)];
+            smoothed = juce::jmax(levelDb, smoothed - releaseDb);
+        }
+    }
+
+    //==============================================================================
+    // 立体声对相关系数与测角仪
+    int numPairs = 0;
+    {
+        const juce::SpinLock::ScopedLockType lock(pairsLock);
+        for (const auto& pair : stereoPairs) {
+            if (numPairs >= AnalyserSnapshot::MAX_PAIRS)
+                break;
+
+            snapshot.pairs[static_cast<size_t>(numPairs)].leftChannel = pair.first;
+            snapshot.pairs[static_cast<size_t>(numPairs)].rightChannel = pair.second;
+            ++numPairs;
+        }
+    }
+    snapshot.numPairs = numPairs;
+
+    float* left = linearFrame.data();
+    float* right = fftData.data();   // 频谱已计算完毕，复用作右声道缓冲
+
+    for (int p = 0; p < numPairs; ++p) {
+        auto& result = snapshot.pairs[static_cast<size_t>(p)];
+
+        if (!juce::isPositiveAndBelow(result.leftChannel, AnalyserSnapshot::MAX_CHANNELS) ||
+            !juce::isPositiveAndBelow(result.rightChannel, AnalyserSnapshot::MAX_CHANNELS))
+        {
+            result.correlation = 0.0f;
+            result.goniometer.fill({});
+            continue;
+        }
+
+        unrollChannel(result.leftChannel, left);
+        unrollChannel(result.rightChannel, right);
+
+        double sumLR = 0.0, sumLL = 0.0, sumRR = 0.0;
+        for (int i = 0; i < FFT_SIZE; ++i) {
+            sumLR += static_cast<double>(left[i]) * right[i];
+            sumLL += static_cast<double>(left[i]) * left[i];
+            sumRR += static_cast<double>(right[i]) * right[i];
+        }
+
+        // 静音时相关系数无意义，显示为0
+        const double energy = std::sqrt(sumLL * sumRR);
+        result.correlation = energy > 1.0e-12 ? static_cast<float>(juce::jlimit(-1.0, 1.0, sumLR / energy)) : 0.0f;
+
+        // 测角仪：抽取GONIO_POINTS个点，Mid/Side旋转45°，按峰值归一化
+        constexpr int stride = FFT_SIZE / AnalyserSnapshot::GONIO_POINTS;
+        constexpr float rotation = 0.70710678f;
+        float peak = 1.0e-6f;
+
+        for (int i = 0; i < AnalyserSnapshot::GONIO_POINTS; ++i) {
+            const float l = left[i * stride];
+            const float r = right[i * stride];
+            const float side = (l - r) * rotation;
+            const float mid = (l + r) * rotation;
+            result.goniometer[static_cast<size_t>(i)] = { side, mid };
+            peak = juce::jmax(peak, std::abs(side), std::abs(mid));
+        }
+
+        const float normalise = 1.0f / peak;
+        for (auto& point : result.goniometer)
+            point = { point.x * normalise, point.y * normalise };
+    }
+
+    ++snapshot.sequence;
+    if (snapshot.sequence == 0)
+        snapshot.sequence = 1;  // 0保留给"从未读取"
+}
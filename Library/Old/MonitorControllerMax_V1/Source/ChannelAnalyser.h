@@ -0,0 +1,151 @@
+﻿/*
+  ==============================================================================
+
+    ChannelAnalyser.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    后台频谱与相位相关分析器 - 房间与混音QA
+
+    - 每个激活通道的实时频谱（Hann窗FFT，对数频带）
+    - PhysicalChannelMapper已知的每个立体声对（L/R、LSS/RSS、LTF/RTF...）的
+      相关系数与测角仪（Goniometer）数据
+    - 音频线程只向无等待环形缓冲写入，FFT与相关计算在低优先级工作线程完成
+    - 分析频率随打开的分析视图数量自适应，结果送往编辑器和OSC
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <functional>
+
+//==============================================================================
+/**
+ * 分析结果快照（工作线程生成，UI/OSC读取副本，音频线程从不访问）
+ */
+struct AnalyserSnapshot
+{
+    static constexpr int MAX_CHANNELS = 26;
+    static constexpr int NUM_BANDS = 32;          // 20Hz - 20kHz 对数频带
+    static constexpr int MAX_PAIRS = 13;
+    static constexpr int GONIO_POINTS = 128;      // 每个立体声对的测角仪点数
+
+    struct PairResult
+    {
+        int leftChannel = -1;
+        int rightChannel = -1;
+        float correlation = 0.0f;                 // -1 (反相) ... +1 (单声道)
+        std::array<juce::Point<float>, GONIO_POINTS> goniometer;  // x = Side, y = Mid，按峰值归一化
+    };
+
+    std::array<bool, MAX_CHANNELS> channelActive{};
+    std::array<std::array<float, NUM_BANDS>, MAX_CHANNELS> spectrumDb{};
+    std::array<PairResult, MAX_PAIRS> pairs;
+    int numPairs = 0;
+    uint32_t sequence = 0;                        // 每次分析递增，UI据此判断是否需要重绘
+
+    static float getBandCentreFrequency(int band);
+};
+
+//==============================================================================
+/**
+ * 通道分析器
+ *
+ * 线程模型：
+ * - 音频线程：pushBlock() 向AbstractFifo写入（单生产者单消费者，无等待），满则丢块
+ * - 工作线程：低优先级，按自适应频率取出数据做FFT/相关计算并发布快照
+ * - 消息线程：registerView()/unregisterView() 调整分析频率；OSC回调经AsyncUpdater执行
+ *
+ * 没有视图且未开启OSC输出时完全停止（音频线程也不再写入）。
+ */
+class ChannelAnalyser : private juce::Thread,
+                        private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    ChannelAnalyser();
+    ~ChannelAnalyser() override;
+
+    //==============================================================================
+    // 生命周期（prepareToPlay / releaseResources调用）
+    void prepare(double sampleRate, int maximumExpectedSamplesPerBlock);
+    void release();
+
+    //==============================================================================
+    // 音频线程接口：只写环形缓冲，不做任何分析
+    void pushBlock(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    bool isRunning() const noexcept { return getAnalysisRateHz() > 0; }
+
+    //==============================================================================
+    // 消息线程接口
+    void setChannelActive(int channelIndex, bool shouldBeActive) noexcept;
+    void setStereoPairs(const std::vector<std::pair<int, int>>& newPairs);
+
+    // 分析视图注册：频率随视图数量自适应
+    void registerView();
+    void unregisterView();
+    void setOSCStreamingEnabled(bool shouldStream);
+    bool isOSCStreamingEnabled() const noexcept { return oscStreaming.load(); }
+    int getAnalysisRateHz() const noexcept;
+
+    // 读取最新快照（UI线程），返回是否有比lastSequence更新的数据
+    bool getLatestSnapshot(AnalyserSnapshot& destination, uint32_t lastSequence = 0) const;
+
+    // OSC输出回调（消息线程，最高10Hz）
+    std::function<void(const AnalyserSnapshot&)> onSnapshotForOSC;
+
+    //==============================================================================
+    static constexpr int FFT_ORDER = 11;
+    static constexpr int FFT_SIZE = 1 << FFT_ORDER;   // 2048点
+    static constexpr int OSC_RATE_HZ = 10;
+
+private:
+    //==============================================================================
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    void drainFifo(bool keepSamples);
+    void analyse();
+    void computeBandBins();
+
+    //==============================================================================
+    // 音频线程 -> 工作线程
+    juce::AbstractFifo fifo{ 1 };
+    juce::AudioBuffer<float> fifoBuffer;
+    std::atomic<bool> prepared{ false };
+    std::atomic<uint32_t> droppedBlocks{ 0 };
+
+    // 配置（消息线程写，工作线程读）
+    std::array<std::atomic<bool>, AnalyserSnapshot::MAX_CHANNELS> channelActive;
+    juce::SpinLock pairsLock;
+    std::vector<std::pair<int, int>> stereoPairs;
+    std::atomic<int> viewCount{ 0 };
+    std::atomic<bool> oscStreaming{ false };
+
+    //==============================================================================
+    // 工作线程状态
+    double currentSampleRate = 48000.0;
+    juce::AudioBuffer<float> history;                 // 每通道最近FFT_SIZE个样本（环形）
+    int historyWritePos = 0;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    std::vector<float> fftData;                       // 2 × FFT_SIZE（JUCE频率变换要求）
+    std::vector<float> linearFrame;                   // 展开后的时域帧
+    std::array<int, AnalyserSnapshot::NUM_BANDS + 1> bandBinEdges{};
+    double lastOSCTime = 0.0;
+
+    AnalyserSnapshot workingSnapshot;
+
+    // 工作线程 -> UI/OSC
+    juce::SpinLock snapshotLock;
+    AnalyserSnapshot publishedSnapshot;
+    AnalyserSnapshot oscSnapshot;                     // 消息线程使用的副本
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelAnalyser)
+};
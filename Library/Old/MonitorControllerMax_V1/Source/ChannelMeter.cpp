@@ -0,0 +1,96 @@
+﻿/*
+  ==============================================================================
+
+    ChannelMeter.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    通道电平表实现 - 音频线程原子累加，消息线程按帧率取走
+
+  ==============================================================================
+*/
+
+#include "ChannelMeter.h"
+
+ChannelMeter::ChannelMeter() = default;
+
+ChannelMeter::~ChannelMeter()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void ChannelMeter::process(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    if (!isRunning() || numSamples <= 0)
+        return;
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), MeterSnapshot::MAX_CHANNELS);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& accumulator = accumulators[static_cast<size_t>(ch)];
+
+        const float blockPeak = buffer.getMagnitude(ch, 0, numSamples);
+        const float blockRms = buffer.getRMSLevel(ch, 0, numSamples);
+        const float blockEnergy = blockRms * blockRms * static_cast<float>(numSamples);
+
+        // 单生产者：CAS只会在消费者同时exchange时重试
+        float peak = accumulator.peak.load(std::memory_order_relaxed);
+        while (blockPeak > peak
+               && !accumulator.peak.compare_exchange_weak(peak, blockPeak, std::memory_order_relaxed)) {}
+
+        float energy = accumulator.energy.load(std::memory_order_relaxed);
+        while (!accumulator.energy.compare_exchange_weak(energy, energy + blockEnergy, std::memory_order_relaxed)) {}
+
+        accumulator.samples.fetch_add(static_cast<uint32_t>(numSamples), std::memory_order_release);
+    }
+}
+
+//==============================================================================
+void ChannelMeter::setOSCRateHz(int newRateHz)
+{
+    rateHz = newRateHz > 0 ? juce::jlimit(MIN_RATE_HZ, MAX_RATE_HZ, newRateHz) : 0;
+
+    if (rateHz > 0)
+    {
+        // 丢弃关闭期间的残留累加值
+        MeterSnapshot discarded;
+        takeSnapshot(discarded);
+
+        running.store(true, std::memory_order_relaxed);
+        startTimerHz(rateHz);
+    }
+    else
+    {
+        stopTimer();
+        running.store(false, std::memory_order_relaxed);
+    }
+}
+
+void ChannelMeter::takeSnapshot(MeterSnapshot& destination) noexcept
+{
+    for (size_t ch = 0; ch < accumulators.size(); ++ch)
+    {
+        auto& accumulator = accumulators[ch];
+
+        const uint32_t samples = accumulator.samples.exchange(0, std::memory_order_acquire);
+        const float energy = accumulator.energy.exchange(0.0f, std::memory_order_relaxed);
+        const float peak = accumulator.peak.exchange(0.0f, std::memory_order_relaxed);
+
+        const float rms = samples > 0 ? std::sqrt(energy / static_cast<float>(samples)) : 0.0f;
+
+        destination.peakDb[ch] = juce::Decibels::gainToDecibels(peak, MeterSnapshot::SILENCE_DB);
+        destination.rmsDb[ch] = juce::Decibels::gainToDecibels(rms, MeterSnapshot::SILENCE_DB);
+    }
+
+    ++destination.sequence;
+}
+
+void ChannelMeter::timerCallback()
+{
+    takeSnapshot(snapshot);
+
+    if (onSnapshotForOSC)
+        onSnapshotForOSC(snapshot);
+}
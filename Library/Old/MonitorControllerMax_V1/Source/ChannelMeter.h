@@ -0,0 +1,95 @@
+﻿/*
+  ==============================================================================
+
+    ChannelMeter.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    通道电平表 - 每通道峰值/RMS，供硬件控制器LED表头使用
+
+    - 音频线程每块只做峰值与能量累加，写入每通道原子累加器（无锁、无分配）
+    - 消息线程定时器按配置频率（10-60Hz）取走累加值生成快照并清零，
+      快照覆盖上一帧以来的全部样本，不会漏掉瞬态峰值
+    - 帧率为0时完全停止（音频线程也不再累加）
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/**
+ * 电平快照（消息线程生成，dBFS）
+ */
+struct MeterSnapshot
+{
+    static constexpr int MAX_CHANNELS = 26;
+    static constexpr float SILENCE_DB = -100.0f;
+
+    std::array<float, MAX_CHANNELS> peakDb{};
+    std::array<float, MAX_CHANNELS> rmsDb{};
+    uint32_t sequence = 0;
+};
+
+//==============================================================================
+/**
+ * 通道电平表
+ *
+ * 线程模型：
+ * - 音频线程：process() 单生产者，每通道CAS累加峰值（取最大）与能量
+ * - 消息线程：定时器exchange取走累加值，回调onSnapshotForOSC
+ *
+ * 读取各通道的峰值、能量与样本数不是一次原子操作，一帧的RMS最多偏差一个音频块。
+ */
+class ChannelMeter : private juce::Timer
+{
+public:
+    //==============================================================================
+    ChannelMeter();
+    ~ChannelMeter() override;
+
+    //==============================================================================
+    // 音频线程接口
+    void process(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    bool isRunning() const noexcept { return running.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    // 消息线程接口：0 = 关闭，否则限制到 MIN_RATE_HZ - MAX_RATE_HZ
+    void setOSCRateHz(int newRateHz);
+    int getOSCRateHz() const noexcept { return rateHz; }
+
+    // 取走上一帧以来的峰值/RMS（也供UI直接调用）
+    void takeSnapshot(MeterSnapshot& destination) noexcept;
+
+    // OSC输出回调（消息线程，按配置频率）
+    std::function<void(const MeterSnapshot&)> onSnapshotForOSC;
+
+    //==============================================================================
+    static constexpr int MIN_RATE_HZ = 10;
+    static constexpr int MAX_RATE_HZ = 60;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    struct ChannelAccumulator
+    {
+        std::atomic<float> peak{ 0.0f };      // 线性峰值（取最大）
+        std::atomic<float> energy{ 0.0f };    // 样本平方和
+        std::atomic<uint32_t> samples{ 0 };
+    };
+
+    std::array<ChannelAccumulator, MeterSnapshot::MAX_CHANNELS> accumulators;
+    std::atomic<bool> running{ false };
+    int rateHz = 0;
+
+    MeterSnapshot snapshot;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelMeter)
+};
@@ -97,6 +97,11 @@ void EffectsPanel::setupButtons()
     setupMonoButton(); 
     setupDolbyCurveButton();
     setupPhoneCurveButton();
+    setupGainMatchButton();
+    setupSoloModeButton();
+    setupInputSourceButton();
+    setupGeneratorButton();
+    setupGeneratorSettingButtons();
 }
 
 void EffectsPanel::setupLowBoostButton()
@@ -164,6 +169,109 @@ void EffectsPanel::setupHighBoostButton()
     VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: High Boost button initialized");
 }
 
+void EffectsPanel::setupGainMatchButton()
+{
+    // 基本属性设置
+    addAndMakeVisible(gainMatchButton);
+    gainMatchButton.setButtonText("GAIN MATCH");
+    gainMatchButton.setClickingTogglesState(true);
+    
+    gainMatchButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::cyan.darker(0.3f));
+    gainMatchButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    gainMatchButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    
+    gainMatchButton.onClick = [this]()
+    {
+        handleGainMatchClick();
+    };
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Gain Match button initialized");
+}
+
+void EffectsPanel::setupSoloModeButton()
+{
+    // 非开关按钮：每次点击循环 SIP → AFL → PFL
+    addAndMakeVisible(soloModeButton);
+    soloModeButton.setClickingTogglesState(false);
+    
+    soloModeButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff2a8c4a));  // 与Solo绿色一致
+    soloModeButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    soloModeButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    
+    soloModeButton.onClick = [this]()
+    {
+        handleSoloModeClick();
+    };
+    
+    updateSoloModeButtonText();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Solo Mode button initialized");
+}
+
+void EffectsPanel::setupInputSourceButton()
+{
+    // 非开关按钮：每次点击循环 MAIN → STEM → REF
+    addAndMakeVisible(inputSourceButton);
+    inputSourceButton.setClickingTogglesState(false);
+    
+    inputSourceButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::mediumpurple);
+    inputSourceButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    inputSourceButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    
+    inputSourceButton.onClick = [this]()
+    {
+        handleInputSourceClick();
+    };
+    
+    updateInputSourceButtonText();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Input Source button initialized");
+}
+
+void EffectsPanel::setupGeneratorButton()
+{
+    // 非开关按钮：每次点击循环 OFF → PINK → PINK BL → SINE → SWEEP
+    addAndMakeVisible(generatorButton);
+    generatorButton.setClickingTogglesState(false);
+    
+    generatorButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red);
+    generatorButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    generatorButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    generatorButton.setTooltip("Calibration signal (-20 dBFS RMS) on routed channels, after GAIN trims and Solo/Mute");
+    
+    generatorButton.onClick = [this]()
+    {
+        handleGeneratorClick();
+    };
+    
+    updateGeneratorButtonText();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Signal Generator button initialized");
+}
+
+void EffectsPanel::setupGeneratorSettingButtons()
+{
+    // 非开关按钮：路由 / 电平 / 频率各自循环预设，与GEN按钮同列
+    for (auto* button : { &generatorRouteButton, &generatorLevelButton, &generatorToneButton })
+    {
+        addAndMakeVisible(*button);
+        button->setClickingTogglesState(false);
+        button->setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+        button->setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    }
+    
+    generatorRouteButton.setTooltip("Calibration signal routing: ALL / MAIN / SUB / single speaker");
+    generatorLevelButton.setTooltip("Calibration signal level (dBFS RMS)");
+    
+    generatorRouteButton.onClick = [this]() { handleGeneratorRouteClick(); };
+    generatorLevelButton.onClick = [this]() { handleGeneratorLevelClick(); };
+    generatorToneButton.onClick = [this]() { handleGeneratorToneClick(); };
+    
+    updateGeneratorSettingButtons();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Signal Generator setting buttons initialized");
+}
+
 void EffectsPanel::setupDolbyCurveButton()
 {
     // 基本属性设置 (完全参照LOW BOOST按钮)
@@ -252,6 +360,190 @@ void EffectsPanel::handleMonoClick()
                  juce::String(audioProcessor.masterBusProcessor.isMonoActive() ? "ON" : "OFF"));
 }
 
+void EffectsPanel::handleGainMatchClick()
+{
+    // 响度匹配只影响本实例的监听电平，不参与Master-Slave同步，所有角色可用
+    // 开启时的当前状态（如全布局）作为参考，之后切换Mono/Solo组合自动补偿到同一响度
+    const bool newState = !audioProcessor.isLoudnessMatchActive();
+    audioProcessor.setLoudnessMatchActive(newState);
+    
+    gainMatchButton.setToggleState(newState, juce::dontSendNotification);
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Gain Match toggled to " +
+                 juce::String(newState ? "ON" : "OFF"));
+}
+
+void EffectsPanel::handleSoloModeClick()
+{
+    // Solo监听模式是本实例的输出路由配置（Cue总线），所有角色可用
+    const int nextMode = (static_cast<int>(audioProcessor.getSoloMode()) + 1) % 3;
+    audioProcessor.setSoloMode(static_cast<SoloMode>(nextMode));
+    
+    updateSoloModeButtonText();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Solo mode switched to " +
+                 SemanticChannelState::getSoloModeName(audioProcessor.getSoloMode()));
+}
+
+void EffectsPanel::updateSoloModeButtonText()
+{
+    const SoloMode mode = audioProcessor.getSoloMode();
+    
+    soloModeButton.setButtonText("SOLO " + SemanticChannelState::getSoloModeName(mode));
+    
+    // AFL/PFL高亮，并提示Cue总线未启用
+    soloModeButton.setToggleState(mode != SoloMode::InPlace, juce::dontSendNotification);
+    soloModeButton.setTooltip(mode != SoloMode::InPlace && !audioProcessor.isCueBusEnabled()
+                                  ? "Cue bus is disabled in the host - enable the \"Cue\" output bus to hear AFL/PFL"
+                                  : "Solo listen mode: SIP / AFL / PFL");
+}
+
+void EffectsPanel::handleInputSourceClick()
+{
+    // 输入源是本实例的监听路由，所有角色可用
+    const int nextSource = (static_cast<int>(audioProcessor.getInputSource()) + 1) % 3;
+    audioProcessor.setInputSource(static_cast<InputSource>(nextSource));
+    
+    updateInputSourceButtonText();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Input source switched to " +
+                 MonitorControllerMaxAudioProcessor::getInputSourceName(audioProcessor.getInputSource()));
+}
+
+void EffectsPanel::updateInputSourceButtonText()
+{
+    const InputSource source = audioProcessor.getInputSource();
+    
+    inputSourceButton.setButtonText("SRC " + MonitorControllerMaxAudioProcessor::getInputSourceName(source));
+    inputSourceButton.setToggleState(source != InputSource::Main, juce::dontSendNotification);
+    inputSourceButton.setTooltip(audioProcessor.isInputSourceAvailable(source)
+                                     ? "Input source: MAIN / STEM / REF"
+                                     : "Sidechain bus is disabled in the host - playing the main input");
+}
+
+void EffectsPanel::handleGeneratorClick()
+{
+    // 校准信号只影响本实例的输出，所有角色可用
+    const int nextType = (static_cast<int>(audioProcessor.getGeneratorType()) + 1) % 5;
+    audioProcessor.setGeneratorType(static_cast<SignalGenerator::Type>(nextType));
+    
+    updateGeneratorButtonText();
+    
+    VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: Signal generator switched to " +
+                 SignalGenerator::getTypeName(audioProcessor.getGeneratorType()));
+}
+
+void EffectsPanel::updateGeneratorButtonText()
+{
+    const SignalGenerator::Type generatorType = audioProcessor.getGeneratorType();
+    
+    generatorButton.setButtonText("GEN " + SignalGenerator::getTypeName(generatorType));
+    generatorButton.setToggleState(generatorType != SignalGenerator::Type::Off, juce::dontSendNotification);
+    
+    // 频率按钮的含义随信号类型变化（正弦频率 / 扫频范围）
+    updateGeneratorSettingButtons();
+}
+
+void EffectsPanel::handleGeneratorRouteClick()
+{
+    // 循环：ALL → MAIN → SUB → 当前布局的每个通道 → ALL（逐个扬声器校准）
+    juce::StringArray routes{ "ALL", "MAIN", "SUB" };
+    for (const auto& channelInfo : audioProcessor.getCurrentLayout().channels)
+        routes.add(channelInfo.name);
+    
+    const auto& currentRouting = audioProcessor.getGeneratorRouting();
+    const int currentIndex = currentRouting.size() == 1 ? routes.indexOf(currentRouting[0]) : -1;
+    const juce::String nextRoute = routes[(currentIndex + 1) % routes.size()];
+    
+    audioProcessor.setGeneratorRouting(juce::StringArray{ nextRoute });
+    updateGeneratorSettingButtons();
+}
+
+void EffectsPanel::handleGeneratorLevelClick()
+{
+    // 常用校准电平：-20（SMPTE/默认）、-18（EBU）、-12、-30 dBFS RMS
+    static constexpr float levels[] = { -20.0f, -18.0f, -12.0f, -30.0f };
+    const float currentLevel = audioProcessor.getGeneratorLevelDb();
+    
+    int next = 0;
+    for (int i = 0; i < static_cast<int>(std::size(levels)); ++i)
+    {
+        if (std::abs(levels[i] - currentLevel) < 0.05f)
+        {
+            next = (i + 1) % static_cast<int>(std::size(levels));
+            break;
+        }
+    }
+    
+    audioProcessor.setGeneratorLevelDb(levels[next]);
+    updateGeneratorSettingButtons();
+}
+
+void EffectsPanel::handleGeneratorToneClick()
+{
+    if (audioProcessor.getGeneratorType() == SignalGenerator::Type::Sweep)
+    {
+        // 扫频范围预设：全频 / SUB / 主扬声器
+        struct SweepPreset { float startHz, endHz, seconds; };
+        static constexpr SweepPreset sweeps[] = { { 20.0f, 20000.0f, 10.0f }, { 20.0f, 200.0f, 10.0f }, { 200.0f, 20000.0f, 10.0f } };
+        const auto& generator = audioProcessor.signalGenerator;
+        
+        int next = 0;
+        for (int i = 0; i < static_cast<int>(std::size(sweeps)); ++i)
+        {
+            if (sweeps[i].startHz == generator.getSweepStartHz() && sweeps[i].endHz == generator.getSweepEndHz())
+            {
+                next = (i + 1) % static_cast<int>(std::size(sweeps));
+                break;
+            }
+        }
+        
+        audioProcessor.setGeneratorSweepRange(sweeps[next].startHz, sweeps[next].endHz, sweeps[next].seconds);
+    }
+    else
+    {
+        // 倍频程中心频率
+        static constexpr float frequencies[] = { 1000.0f, 2000.0f, 4000.0f, 8000.0f, 63.0f, 125.0f, 250.0f, 500.0f };
+        const float currentFrequency = audioProcessor.getGeneratorSineFrequency();
+        
+        int next = 0;
+        for (int i = 0; i < static_cast<int>(std::size(frequencies)); ++i)
+        {
+            if (frequencies[i] == currentFrequency)
+            {
+                next = (i + 1) % static_cast<int>(std::size(frequencies));
+                break;
+            }
+        }
+        
+        audioProcessor.setGeneratorSineFrequency(frequencies[next]);
+    }
+    
+    updateGeneratorSettingButtons();
+}
+
+void EffectsPanel::updateGeneratorSettingButtons()
+{
+    const auto& routing = audioProcessor.getGeneratorRouting();
+    generatorRouteButton.setButtonText("ROUTE " + (routing.size() == 1 ? routing[0] : juce::String("MULTI")));
+    
+    generatorLevelButton.setButtonText(juce::String(audioProcessor.getGeneratorLevelDb(), 0) + " dB");
+    
+    auto formatHz = [](float hz) { return hz >= 1000.0f ? juce::String(hz / 1000.0f, hz < 10000.0f ? 1 : 0) + "k" : juce::String(juce::roundToInt(hz)); };
+    
+    const auto& generator = audioProcessor.signalGenerator;
+    if (audioProcessor.getGeneratorType() == SignalGenerator::Type::Sweep)
+    {
+        generatorToneButton.setButtonText(formatHz(generator.getSweepStartHz()) + "-" + formatHz(generator.getSweepEndHz()));
+        generatorToneButton.setTooltip("Sweep range");
+    }
+    else
+    {
+        generatorToneButton.setButtonText(formatHz(generator.getSineFrequency()) + " Hz");
+        generatorToneButton.setTooltip("Sine frequency");
+    }
+}
+
 void EffectsPanel::handleHighBoostClick()
 {
     // 检查角色权限 - Slave模式禁止操作
@@ -344,6 +636,11 @@ void EffectsPanel::updateButtonStatesFromProcessor()
                                   juce::dontSendNotification);
     monoButton.setToggleState(audioProcessor.masterBusProcessor.isMonoActive(),
                               juce::dontSendNotification);
+    gainMatchButton.setToggleState(audioProcessor.isLoudnessMatchActive(),
+                                   juce::dontSendNotification);
+    updateSoloModeButtonText();
+    updateInputSourceButtonText();
+    updateGeneratorButtonText();
 }
 
 //==============================================================================
@@ -406,6 +703,15 @@ void EffectsPanel::setupEffectsGrid()
     
     // 第5行：MONO (位置21) - 最后一行第1个位置
     gridItems[20] = juce::GridItem(monoButton);      // 位置21 (第5行第1列)
+    gridItems[21] = juce::GridItem(gainMatchButton); // 位置22 (第5行第2列)
+    gridItems[22] = juce::GridItem(soloModeButton);  // 位置23 (第5行第3列)
+    gridItems[23] = juce::GridItem(inputSourceButton); // 位置24 (第5行第4列)
+    
+    // 第4行：校准信号设置，位于GEN按钮上方
+    gridItems[17] = juce::GridItem(generatorToneButton);  // 位置18 (第4行第3列)
+    gridItems[18] = juce::GridItem(generatorLevelButton); // 位置19 (第4行第4列)
+    gridItems[19] = juce::GridItem(generatorRouteButton); // 位置20 (第4行第5列)
+    gridItems[24] = juce::GridItem(generatorButton); // 位置25 (第5行第5列)
     
     // 将所有GridItem添加到网格中
     for (auto& item : gridItems)
@@ -414,7 +720,7 @@ void EffectsPanel::setupEffectsGrid()
     }
     
     VST3_DBG_ROLE(&audioProcessor, "EffectsPanel: 5x5 grid setup complete - " +
-                 juce::String("LOW BOOST@1, HIGH BOOST@2, DOLBY CURVE@6, PHONE CURVE@7, MONO@21"));
+                 juce::String("LOW BOOST@1, HIGH BOOST@2, DOLBY CURVE@6, PHONE CURVE@7, MONO@21, GAIN MATCH@22, SOLO MODE@23, SOURCE@24, GENERATOR@25, GEN TONE/LEVEL/ROUTE@18-20"));
 }
 
 void EffectsPanel::layoutButtons(juce::Rectangle<int> area)
@@ -81,6 +81,13 @@ private:
     juce::TextButton monoButton{ "MONO" };
     juce::TextButton dolbyCurveButton{ "DOLBY CURVE" };  // 新增
     juce::TextButton phoneCurveButton{ "PHONE CURVE" };  // 新增
+    juce::TextButton gainMatchButton{ "GAIN MATCH" };    // 响度匹配比较
+    juce::TextButton soloModeButton{ "SOLO SIP" };       // Solo监听模式 SIP/AFL/PFL 循环切换
+    juce::TextButton inputSourceButton{ "SRC MAIN" };    // 输入源 MAIN/STEM/REF 循环切换
+    juce::TextButton generatorButton{ "GEN OFF" };       // 校准信号 OFF/PINK/PINK BL/SINE/SWEEP 循环切换
+    juce::TextButton generatorRouteButton{ "ROUTE ALL" }; // 校准信号路由 ALL/MAIN/SUB/逐个通道 循环切换
+    juce::TextButton generatorLevelButton{ "-20 dB" };    // 校准信号电平预设循环切换
+    juce::TextButton generatorToneButton{ "1 kHz" };      // 正弦频率 / 扫频范围预设循环切换（随信号类型）
     
     // 5×5网格布局系统 (与主界面一致)
     juce::Grid effectsGrid;
@@ -93,6 +100,11 @@ private:
     void setupMonoButton();
     void setupDolbyCurveButton();   // 新增
     void setupPhoneCurveButton();   // 新增
+    void setupGainMatchButton();
+    void setupSoloModeButton();
+    void setupInputSourceButton();
+    void setupGeneratorButton();
+    void setupGeneratorSettingButtons();
     
     // 按钮回调处理
     void handleLowBoostClick();
@@ -100,6 +112,17 @@ private:
     void handleMonoClick();
     void handleDolbyCurveClick();   // 新增
     void handlePhoneCurveClick();   // 新增
+    void handleGainMatchClick();
+    void handleSoloModeClick();
+    void updateSoloModeButtonText();
+    void handleInputSourceClick();
+    void updateInputSourceButtonText();
+    void handleGeneratorClick();
+    void updateGeneratorButtonText();
+    void handleGeneratorRouteClick();
+    void handleGeneratorLevelClick();
+    void handleGeneratorToneClick();
+    void updateGeneratorSettingButtons();
     
     // 布局和绘制辅助
     void layoutButtons(juce::Rectangle<int> area);
@@ -1,5 +1,6 @@
 ﻿#include "GlobalPluginState.h"
 #include "PluginProcessor.h"
+#include "SharedOSCHub.h"
 #include "DebugLogger.h"
 
 // 🚀 静态成员初始化 - 引用计数生命周期管理
@@ -7,6 +8,7 @@ std::shared_ptr<GlobalPluginState> GlobalPluginState::instance = nullptr;
 std::mutex GlobalPluginState::instanceMutex;
 std::atomic<bool> GlobalPluginState::shuttingDown{false}; // 🛡️ 关闭状态标志
 std::atomic<int> GlobalPluginState::refCount{0}; // 🚀 引用计数器
+juce::String GlobalPluginState::sharedLinkSegmentName{ SharedStateLink::getDefaultSegmentName() };
 
 std::shared_ptr<GlobalPluginState> GlobalPluginState::getInstance() {
     std::lock_guard<std::mutex> lock(instanceMutex);
@@ -27,6 +29,11 @@ std::shared_ptr<GlobalPluginState> GlobalPluginState::getInstance() {
     return instance;
 }
 
+GlobalPluginState::~GlobalPluginState() {
+    // 插件可能仍持有组句柄：先关闭链路，之后不会再有回调进入本对象
+    closeAllGroupLinks();
+}
+
 // 🛡️ 显式关闭机制
 void GlobalPluginState::shutdown() {
     std::lock_guard<std::mutex> lock(instanceMutex);
@@ -34,26 +41,30 @@ void GlobalPluginState::shutdown() {
     shuttingDown.store(true);
     
     if (instance) {
+        // 先关闭跨进程链路：释放Master令牌，停止链路线程与回调
+        instance->closeAllGroupLinks();
+        
         // 清理所有插件引用
         {
-            std::lock_guard<std::mutex> pluginsLock(instance->pluginsMutex);
-            instance->allPlugins.clear();
-            instance->slavePlugins.clear();
-            instance->waitingSlavePlugins.clear();
-            instance->masterPlugin = nullptr;
+            std::unique_lock<std::shared_mutex> pluginsLock(instance->pluginsMutex);
             
-            // 🚀 清理生命周期系统
-            instance->pluginIds.clear();
-            instance->idToPlugin.clear();
-            instance->validPluginIds.clear();
-            instance->invalidatedPlugins.clear();
-        }
-        
-        // 清理状态数据
-        {
-            std::lock_guard<std::mutex> stateLock(instance->stateMutex);
-            instance->globalSoloStates.clear();
-            instance->globalMuteStates.clear();
+            // 🚀 清理生命周期系统：所有句柄立即过期，尚未执行的异步回调解析为nullptr
+            instance->registry->clear();
+            for (auto& group : instance->slotGroups) {
+                group.reset();
+            }
+            
+            for (auto& [groupName, group] : instance->groups) {
+                std::lock_guard<std::mutex> groupLock(group->membersMutex);
+                group->masterHandle = {};
+                group->slaveHandles.clear();
+                group->waitingSlaveHandles.clear();
+                
+                // 清理状态数据
+                std::lock_guard<std::mutex> stateLock(group->stateMutex);
+                group->soloStates.clear();
+                group->muteStates.clear();
+            }
         }
         
         // 清理日志
@@ -70,6 +81,11 @@ bool GlobalPluginState::isShuttingDown() {
     return shuttingDown.load();
 }
 
+void GlobalPluginState::setSharedLinkSegmentName(const juce::String& segmentName) {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    sharedLinkSegmentName = segmentName;
+}
+
 // 🚀 新增：引用计数释放机制
 void GlobalPluginState::releaseReference() {
     std::lock_guard<std::mutex> lock(instanceMutex);
@@ -83,15 +99,18 @@ void GlobalPluginState::releaseReference() {
         if (instance) {
             // 清理操作
             {
-                std::lock_guard<std::mutex> pluginsLock(instance->pluginsMutex);
-                instance->allPlugins.clear();
-                instance->slavePlugins.clear();
-                instance->waitingSlavePlugins.clear();
-                instance->masterPlugin = nullptr;
-                instance->pluginIds.clear();
-                instance->idToPlugin.clear();
-                instance->validPluginIds.clear();
-                instance->invalidatedPlugins.clear();
+                std::unique_lock<std::shared_mutex> pluginsLock(instance->pluginsMutex);
+                instance->registry->clear();
+                for (auto& group : instance->slotGroups) {
+                    group.reset();
+                }
+                
+                for (auto& [groupName, group] : instance->groups) {
+                    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+                    group->masterHandle = {};
+                    group->slaveHandles.clear();
+                    group->waitingSlaveHandles.clear();
+                }
             }
             
             instance.reset(); // 安全销毁
@@ -100,86 +119,162 @@ void GlobalPluginState::releaseReference() {
 }
 
 //==============================================================================
-// 🚀 生命周期安全：增强的插件管理实现
+// 🚀 Master组：状态分片与快照发布（只需组自己的stateMutex）
 
-juce::String GlobalPluginState::generateUniquePluginId(MonitorControllerMaxAudioProcessor* plugin) {
-    if (!plugin) return juce::String();
+void MasterGroup::setSoloState(const juce::String& channelName, bool state) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    soloStates[channelName] = state;
     
-    // 生成基于时间戳和内存地址的唯一ID
-    auto timestamp = juce::Time::getCurrentTime().toMilliseconds();
-    auto address = reinterpret_cast<juce::pointer_sized_int>(plugin);
-    return juce::String("Plugin_") + juce::String(timestamp) + "_" + juce::String::toHexString(address);
+    // 🚀 发布到快照：Slave在下一个定时器节拍拉取，Master不再逐个调用Slave
+    const int channelId = OSCAddressTable::findChannelId(channelName);
+    if (channelId != OSCAddressTable::INVALID_CHANNEL_ID) {
+        publishBit(channelId, state);
+    }
 }
 
-bool GlobalPluginState::isPluginValid(MonitorControllerMaxAudioProcessor* plugin) const {
-    if (!plugin) return false;
+void MasterGroup::setMuteState(const juce::String& channelName, bool state) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    muteStates[channelName] = state;
     
-    // 检查插件是否在有效ID集合中
-    auto it = pluginIds.find(plugin);
-    if (it != pluginIds.end()) {
-        return validPluginIds.count(it->second) > 0;
+    const int channelId = OSCAddressTable::findChannelId(channelName);
+    if (channelId != OSCAddressTable::INVALID_CHANNEL_ID) {
+        publishBit(MasterStateSnapshot::MUTE_SHIFT + channelId, state);
     }
-    
-    return false;
 }
 
-bool GlobalPluginState::isPluginSafeToAccess(MonitorControllerMaxAudioProcessor* plugin) const {
-    if (!plugin) return false;
+void MasterGroup::setMonoState(bool state) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    monoState = state;
+    publishBit(MasterStateSnapshot::MONO_SHIFT, state);
     
-    // 双重安全检查：1) 不在已失效列表中 2) 在有效ID集合中
-    if (invalidatedPlugins.count(plugin) > 0) {
-        return false; // 已明确标记为失效
+    VST3_DBG("Group " + getDisplayName() + " mono state set to: " + juce::String(state ? "ON" : "OFF"));
+}
+
+bool MasterGroup::getSoloState(const juce::String& channelName) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = soloStates.find(channelName);
+    return it != soloStates.end() ? it->second : false;
+}
+
+bool MasterGroup::getMuteState(const juce::String& channelName) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = muteStates.find(channelName);
+    return it != muteStates.end() ? it->second : false;
+}
+
+bool MasterGroup::getMonoState() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return monoState;
+}
+
+void MasterGroup::publishBit(int shift, bool state) {
+    const uint64_t bit = uint64_t(1) << shift;
+    const uint64_t versionField = MasterStateSnapshot::VERSION_BITS << MasterStateSnapshot::VERSION_SHIFT;
+    
+    // 写端由stateMutex串行化，无需CAS
+    const uint64_t current = stateWord.load(std::memory_order_relaxed);
+    uint64_t next = state ? (current | bit) : (current & ~bit);
+    if (next == current) {
+        return;
     }
     
-    return isPluginValid(plugin);
+    const uint64_t version = ((current >> MasterStateSnapshot::VERSION_SHIFT) + 1) & MasterStateSnapshot::VERSION_BITS;
+    next = (next & ~versionField) | (version << MasterStateSnapshot::VERSION_SHIFT);
+    
+    // 先写发布记录再发布状态字：Slave看到新状态字时，发布记录至少已是这一次
+    recordPublication(next, juce::Time::getHighResolutionTicks());
+    stateWord.store(next, std::memory_order_release);
+    publishCount.fetch_add(1, std::memory_order_relaxed);
+    
+    // 本进程持有该组跨进程Master令牌时同步发布到共享段（调用方持有stateMutex，发布顺序与快照一致）
+    if (sharedLink) {
+        sharedLink->publishState(next);
+    }
 }
 
-void GlobalPluginState::invalidatePlugin(MonitorControllerMaxAudioProcessor* plugin) {
-    if (!plugin) return;
+void MasterGroup::recordPublication(uint64_t word, juce::int64 publishedTicks) noexcept {
+    const uint32_t lock = publicationLock.load(std::memory_order_relaxed);
+    publicationLock.store(lock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    publicationSequence.store(publicationSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    publicationTicks.store(publishedTicks, std::memory_order_relaxed);
+    publicationWord.store(word, std::memory_order_relaxed);
     
-    // 双重标记：1) 从有效ID集合移除 2) 加入失效集合
-    auto it = pluginIds.find(plugin);
-    if (it != pluginIds.end()) {
-        validPluginIds.erase(it->second);
-        invalidatedPlugins.insert(plugin);
-        VST3_DBG("Plugin invalidated: " + it->second);
+    publicationLock.store(lock + 2, std::memory_order_release);
+}
+
+MasterPublication MasterGroup::getLatestPublication() const noexcept {
+    MasterPublication publication;
+    
+    for (;;) {
+        const uint32_t before = publicationLock.load(std::memory_order_acquire);
+        if ((before & 1u) == 0) {
+            publication.sequence = publicationSequence.load(std::memory_order_relaxed);
+            publication.publishedTicks = publicationTicks.load(std::memory_order_relaxed);
+            publication.stateWord = publicationWord.load(std::memory_order_relaxed);
+            
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (publicationLock.load(std::memory_order_relaxed) == before) {
+                return publication;
+            }
+        }
+        
+        std::this_thread::yield();
     }
 }
 
-void GlobalPluginState::removeFromAllLists(MonitorControllerMaxAudioProcessor* plugin) {
-    if (!plugin) return;
+//==============================================================================
+// 🚀 生命周期安全：增强的插件管理实现
+
+PluginHandle GlobalPluginState::lookupHandle(const MonitorControllerMaxAudioProcessor* plugin) const noexcept {
+    if (plugin == nullptr) return {};
     
-    // 从所有列表中安全移除插件
-    auto removeFromVector = [plugin](std::vector<MonitorControllerMaxAudioProcessor*>& vec) {
-        vec.erase(std::remove(vec.begin(), vec.end(), plugin), vec.end());
+    // 🚀 无锁：插件保存的句柄仍指向自己才算已注册（一次下标 + 代号比较）
+    const auto handle = plugin->getPluginHandle();
+    return registry->resolve(handle) == plugin ? handle : PluginHandle{};
+}
+
+void GlobalPluginState::removeFromGroup(MasterGroup& group, PluginHandle handle) {
+    if (handle.isNull()) return;
+    
+    // 从组内所有列表中安全移除插件
+    auto removeFromVector = [handle](std::vector<PluginHandle>& vec) {
+        vec.erase(std::remove(vec.begin(), vec.end(), handle), vec.end());
     };
     
-    removeFromVector(allPlugins);
-    removeFromVector(slavePlugins);
-    removeFromVector(waitingSlavePlugins);
+    removeFromVector(group.slaveHandles);
+    removeFromVector(group.waitingSlaveHandles);
     
-    if (masterPlugin == plugin) {
-        masterPlugin = nullptr;
+    // 🚀 增强的Master插件处理
+    if (group.masterHandle == handle) {
+        VST3_DBG("Master plugin leaving group " + group.getDisplayName() + " (ID: " + handle.toString() + ")");
+        
+        // 立即清空Master引用
+        group.masterHandle = {};
+        if (group.sharedLink) {
+            group.sharedLink->releaseMaster();
+        }
+        
+        juce::String masterLogMsg = formatGroupLog(group, "Master plugin removed (ID: " + handle.toString() + ") - Master role available");
+        VST3_DBG(masterLogMsg);
+        addConnectionLog(masterLogMsg);
+        
+        // 安全通知所有Slave，并将其移到等待列表
+        moveActiveSlavesToWaiting(group);
     }
 }
 
-void GlobalPluginState::notifySlavePluginsAboutMasterLoss() {
-    // 安全通知所有Slave插件Master已丢失
-    std::vector<MonitorControllerMaxAudioProcessor*> validSlaves;
-    
-    // 收集所有有效的Slave插件
-    for (auto* slave : slavePlugins) {
-        if (isPluginSafeToAccess(slave)) {
-            validSlaves.push_back(slave);
-        }
-    }
-    
-    // 通知所有有效的Slave
-    for (auto* slave : validSlaves) {
+void GlobalPluginState::notifySlavePluginsAboutMasterLoss(MasterGroup& group) {
+    // 安全通知组内所有Slave插件Master已丢失
+    for (const auto& slave : group.slaveHandles) {
+        if (!registry->isValid(slave)) continue;
+        
         try {
-            juce::MessageManager::callAsync([slave]() {
-                if (slave) { // 再次检查空指针
-                    slave->onMasterDisconnected();
+            // 回调执行时再解析句柄：插件在此期间注销（工程关闭）时直接跳过，不会访问悬空指针
+            juce::MessageManager::callAsync([registry = registry, slave]() {
+                if (auto* plugin = registry->resolve(slave)) {
+                    plugin->onMasterDisconnected();
                 }
             });
         } catch (...) {
@@ -190,65 +285,106 @@ void GlobalPluginState::notifySlavePluginsAboutMasterLoss() {
 }
 
 void GlobalPluginState::performSafeCleanup() {
-    // 安全的插件清理（双重验证）
+    // 从组内列表剔除过期句柄；此方法在已独占pluginsMutex时调用
     cleanupCounter++;
     
-    // 清理已失效的插件
-    auto cleanupVector = [this](std::vector<MonitorControllerMaxAudioProcessor*>& vec, const char* listName) {
+    auto cleanupVector = [this](std::vector<PluginHandle>& vec, const char* listName) {
         size_t originalSize = vec.size();
         vec.erase(
             std::remove_if(vec.begin(), vec.end(),
-                [this](MonitorControllerMaxAudioProcessor* plugin) {
-                    return !isPluginSafeToAccess(plugin);
+                [this](PluginHandle handle) {
+                    return !registry->isValid(handle);
                 }),
             vec.end()
         );
         
         if (vec.size() != originalSize) {
-            VST3_DBG(juce::String("Cleaned ") + juce::String(originalSize - vec.size()) + 
-                     " invalid plugins from " + listName);
+            VST3_DBG(juce::String("Cleaned ") + juce::String(originalSize - vec.size()) +
+                     " stale handles from " + listName);
             healthMonitor.invalidPluginCleanups++;
         }
     };
     
-    cleanupVector(allPlugins, "allPlugins");
-    cleanupVector(slavePlugins, "slavePlugins");
-    cleanupVector(waitingSlavePlugins, "waitingSlavePlugins");
+    for (auto& [groupName, group] : groups) {
+        std::lock_guard<std::mutex> groupLock(group->membersMutex);
+        cleanupVector(group->slaveHandles, "slaveHandles");
+        cleanupVector(group->waitingSlaveHandles, "waitingSlaveHandles");
+        
+        // 检查Master插件
+        if (!group->masterHandle.isNull() && !registry->isValid(group->masterHandle)) {
+            VST3_DBG("Master plugin of group " + group->getDisplayName() + " became invalid, clearing");
+            group->masterHandle = {};
+            notifySlavePluginsAboutMasterLoss(*group);
+        }
+    }
+}
+
+std::unique_lock<std::shared_mutex> GlobalPluginState::lockPluginsExclusive() const {
+    pluginsLockAcquisitions.fetch_add(1, std::memory_order_relaxed);
+    
+    std::unique_lock<std::shared_mutex> lock(pluginsMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        const auto waitStart = juce::Time::getHighResolutionTicks();
+        lock.lock();
+        pluginsLockContentions.fetch_add(1, std::memory_order_relaxed);
+        pluginsLockWaitTicks.fetch_add(juce::Time::getHighResolutionTicks() - waitStart, std::memory_order_relaxed);
+    }
     
-    // 检查Master插件
-    if (masterPlugin && !isPluginSafeToAccess(masterPlugin)) {
-        VST3_DBG("Master plugin became invalid, clearing");
-        masterPlugin = nullptr;
-        notifySlavePluginsAboutMasterLoss();
+    return lock;
+}
+
+std::shared_lock<std::shared_mutex> GlobalPluginState::lockPluginsShared() const {
+    pluginsLockAcquisitions.fetch_add(1, std::memory_order_relaxed);
+    
+    std::shared_lock<std::shared_mutex> lock(pluginsMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        const auto waitStart = juce::Time::getHighResolutionTicks();
+        lock.lock();
+        pluginsLockContentions.fetch_add(1, std::memory_order_relaxed);
+        pluginsLockWaitTicks.fetch_add(juce::Time::getHighResolutionTicks() - waitStart, std::memory_order_relaxed);
     }
+    
+    return lock;
 }
 
-void GlobalPluginState::registerPlugin(MonitorControllerMaxAudioProcessor* plugin) {
+GlobalPluginState::LockStats GlobalPluginState::getLockStats() const noexcept {
+    LockStats stats;
+    stats.acquisitions = pluginsLockAcquisitions.load(std::memory_order_relaxed);
+    stats.contentions = pluginsLockContentions.load(std::memory_order_relaxed);
+    stats.waitMs = juce::Time::highResolutionTicksToSeconds(pluginsLockWaitTicks.load(std::memory_order_relaxed)) * 1000.0;
+    return stats;
+}
+
+PluginHandle GlobalPluginState::registerPlugin(MonitorControllerMaxAudioProcessor* plugin, const juce::String& groupName) {
     // 🛡️ 关闭检查：防止在程序退出时操作
-    if (shuttingDown.load()) return;
+    if (shuttingDown.load()) return {};
     
     try {
-        std::lock_guard<std::mutex> lock(pluginsMutex);
+        auto lock = lockPluginsExclusive();
         
-        if (plugin == nullptr) return;
+        if (plugin == nullptr) return {};
         
-        // 🚀 增强安全检查：检查是否已注册或已失效
-        if (isPluginValid(plugin)) {
+        // 🚀 增强安全检查：已注册时返回原句柄
+        const auto existing = lookupHandle(plugin);
+        if (!existing.isNull()) {
             VST3_DBG("Plugin already registered");
-            return;
+            return existing;
         }
         
-        // 从失效集合中移除（如果存在）
-        invalidatedPlugins.erase(plugin);
-        
-        // 生成唯一ID并注册
-        juce::String pluginId = generateUniquePluginId(plugin);
+        // 分配句柄（槽位复用时代号递增，旧句柄全部过期）
+        const auto handle = registry->add(plugin);
+        if (handle.isNull()) {
+            juce::String logMsg = getCurrentTimeString() + " Plugin registry full (" +
+                                  juce::String(static_cast<int>(PluginHandleRegistry::MAX_PLUGINS)) +
+                                  " instances) - plugin runs without Master/Slave";
+            VST3_DBG(logMsg);
+            addConnectionLog(logMsg);
+            return {};
+        }
         
-        // 添加到所有跟踪系统
-        allPlugins.push_back(plugin);
-        pluginIds[plugin] = pluginId;
-        idToPlugin[pluginId] = plugin;
-        validPluginIds.insert(pluginId);
+        // 加入Master组（组首次出现时创建并附加跨进程链路）
+        auto group = getOrCreateGroup(groupName);
+        slotGroups[handle.index] = group;
         
         // 定期清理检查（每10个插件注册后）
         if (healthMonitor.pluginRegistrations.load() % 10 == 0) {
@@ -258,88 +394,50 @@ void GlobalPluginState::registerPlugin(MonitorControllerMaxAudioProcessor* plugi
         // Stability optimization: counter monitoring
         healthMonitor.pluginRegistrations++;
         
-        juce::String logMsg = getCurrentTimeString() + " Plugin registered (ID: " + pluginId + 
-                             ", Ptr: " + juce::String::toHexString(reinterpret_cast<juce::pointer_sized_int>(plugin)) + 
-                             ") - Total: " + juce::String(allPlugins.size());
+        juce::String logMsg = formatGroupLog(*group, "Plugin registered (ID: " + handle.toString() +
+                             ", Ptr: " + juce::String::toHexString(reinterpret_cast<juce::pointer_sized_int>(plugin)) +
+                             ") - Total: " + juce::String(registry->getLiveCount()));
         
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
         
-        // 已在上面实现定期清理
+        return handle;
     }
     catch (...) {
         // Stability optimization: exception handling
         healthMonitor.exceptionsCaught++;
         VST3_DBG("Exception caught in registerPlugin - continuing safely");
     }
+    
+    return {};
 }
 
 void GlobalPluginState::unregisterPlugin(MonitorControllerMaxAudioProcessor* plugin) {
     // 🛡️ 关闭检查：允许在关闭时注销插件
     try {
-        std::lock_guard<std::mutex> lock(pluginsMutex);
-        
-        if (plugin == nullptr) return;
-        
-        // 🚀 增强安全：立即标记为失效，防止并发访问
-        invalidatePlugin(plugin);
-        
-        // 获取插件ID
-        juce::String pluginId;
-        auto idIt = pluginIds.find(plugin);
-        if (idIt != pluginIds.end()) {
-            pluginId = idIt->second;
-        }
+        auto lock = lockPluginsExclusive();
         
-        // 🛡️ 安全移除：使用增强的移除方法
-        removeFromAllLists(plugin);
+        const auto handle = lookupHandle(plugin);
+        if (handle.isNull()) return;
         
-        // 清理跟踪系统
-        if (!pluginId.isEmpty()) {
-            pluginIds.erase(plugin);
-            idToPlugin.erase(pluginId);
-            validPluginIds.erase(pluginId);
-        }
-        invalidatedPlugins.insert(plugin); // 确保在失效集合中
+        // 🚀 先让句柄过期：无锁读者与排队中的异步回调立即看到插件已离开
+        registry->remove(handle);
         
-        // 🚀 增强的Master插件处理
-        if (masterPlugin == plugin) {
-            VST3_DBG("Master plugin being unregistered (ID: " + pluginId + ")");
-            
-            // 立即清空Master引用
-            masterPlugin = nullptr;
-            
-            // 安全通知所有Slave
-            notifySlavePluginsAboutMasterLoss();
-            
-            juce::String masterLogMsg = getCurrentTimeString() + " Master plugin unregistered (ID: " + pluginId + ") - Master role available";
-            VST3_DBG(masterLogMsg);
-            addConnectionLog(masterLogMsg);
-            
-            // 将所有有效的Slave移到等待列表
-            for (auto* slave : slavePlugins) {
-                if (isPluginSafeToAccess(slave)) {
-                    waitingSlavePlugins.push_back(slave);
-                }
-            }
-            slavePlugins.clear();
-            
-            if (!waitingSlavePlugins.empty()) {
-                juce::String waitingLogMsg = getCurrentTimeString() + " Moved " + juce::String(waitingSlavePlugins.size()) + 
-                                            " slaves to waiting list - waiting for new Master";
-                VST3_DBG(waitingLogMsg);
-                addConnectionLog(waitingLogMsg);
-            }
+        // 🛡️ 安全移除：Master离开时组内Slave转入等待
+        if (auto group = slotGroups[handle.index]) {
+            std::lock_guard<std::mutex> groupLock(group->membersMutex);
+            removeFromGroup(*group, handle);
         }
+        slotGroups[handle.index].reset();
         
         // 记录成功注销
         healthMonitor.pluginUnregistrations++;
         
-        juce::String logMsg = getCurrentTimeString() + " Plugin unregistered (ID: " + pluginId + 
-                             ") - Remaining: " + juce::String(allPlugins.size());
+        juce::String logMsg = getCurrentTimeString() + " Plugin unregistered (ID: " + handle.toString() +
+                             ") - Remaining: " + juce::String(registry->getLiveCount());
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
-        
+    
     }
     catch (...) {
         // Stability optimization: exception handling
@@ -348,49 +446,156 @@ void GlobalPluginState::unregisterPlugin(MonitorControllerMaxAudioProcessor* plu
     }
 }
 
+//==============================================================================
+// 🚀 Master组管理
+
+std::shared_ptr<MasterGroup> GlobalPluginState::setPluginGroup(MonitorControllerMaxAudioProcessor* plugin, const juce::String& groupName) {
+    auto lock = lockPluginsExclusive();
+    
+    const auto handle = lookupHandle(plugin);
+    if (handle.isNull()) return nullptr;
+    
+    auto newGroup = getOrCreateGroup(groupName);
+    auto oldGroup = findGroup(handle);
+    if (oldGroup == newGroup) return newGroup;
+    
+    // 调用方应已退出Master/Slave角色；仍在列表中时按离开处理，不把角色带进新组
+    if (oldGroup) {
+        std::lock_guard<std::mutex> groupLock(oldGroup->membersMutex);
+        removeFromGroup(*oldGroup, handle);
+    }
+    
+    slotGroups[handle.index] = newGroup;
+    
+    juce::String logMsg = formatGroupLog(*newGroup, "Plugin joined group (ID: " + handle.toString() + ")" +
+                                         (oldGroup ? " from " + oldGroup->getDisplayName() : juce::String()));
+    VST3_DBG(logMsg);
+    addConnectionLog(logMsg);
+    
+    return newGroup;
+}
+
+std::shared_ptr<MasterGroup> GlobalPluginState::getPluginGroup(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    return findGroup(lookupHandle(plugin));
+}
+
+juce::StringArray GlobalPluginState::getGroupNames() const {
+    auto lock = lockPluginsShared();
+    
+    juce::StringArray names;
+    for (const auto& [groupName, group] : groups) {
+        names.add(group->getDisplayName());
+    }
+    return names;
+}
+
+std::shared_ptr<MasterGroup> GlobalPluginState::findGroup(PluginHandle handle) const {
+    // 此方法在已持有pluginsMutex时调用
+    return registry->isValid(handle) ? slotGroups[handle.index] : nullptr;
+}
+
+std::shared_ptr<MasterGroup> GlobalPluginState::getOrCreateGroup(const juce::String& groupName) {
+    // 此方法在已独占pluginsMutex时调用
+    const juce::String name = SharedOSCHub::normaliseGroupName(groupName);
+    
+    auto it = groups.find(name);
+    if (it != groups.end()) {
+        return it->second;
+    }
+    
+    auto group = std::make_shared<MasterGroup>(name);
+    openSharedLink(*group);
+    groups[name] = group;
+    
+    juce::String logMsg = formatGroupLog(*group, "Master group created - Groups: " + juce::String(groups.size()));
+    VST3_DBG(logMsg);
+    addConnectionLog(logMsg);
+    
+    return group;
+}
+
+void GlobalPluginState::closeAllGroupLinks() {
+    std::vector<std::unique_ptr<SharedStateLink>> links;
+    
+    {
+        auto lock = lockPluginsExclusive();
+        for (auto& [groupName, group] : groups) {
+            std::lock_guard<std::mutex> stateLock(group->stateMutex);
+            if (group->sharedLink) {
+                links.push_back(std::move(group->sharedLink));
+            }
+        }
+    }
+    
+    // 锁外关闭：释放Master令牌并停止链路线程
+    links.clear();
+}
+
+juce::String GlobalPluginState::formatGroupLog(const MasterGroup& group, const juce::String& message) const {
+    // 默认组保持原有日志格式
+    return getCurrentTimeString() + (group.isDefault() ? juce::String() : " [" + group.getName() + "]") + " " + message;
+}
+
+//==============================================================================
+// Master插件管理（作用于插件所在组）
+
 bool GlobalPluginState::setAsMaster(MonitorControllerMaxAudioProcessor* plugin) {
     try {
-        std::lock_guard<std::mutex> lock(pluginsMutex);
+        auto lock = lockPluginsShared();
         
         // 🚀 增强安全检查
-        if (plugin == nullptr || !isPluginSafeToAccess(plugin)) {
+        const auto handle = lookupHandle(plugin);
+        if (handle.isNull()) {
             VST3_DBG("Cannot set invalid or unsafe plugin as Master");
             return false;
         }
         
-        // 检查是否已经有Master
-        if (masterPlugin != nullptr && masterPlugin != plugin) {
-            if (isPluginSafeToAccess(masterPlugin)) {
-                juce::String logMsg = getCurrentTimeString() + " Master role denied - Master already exists";
+        auto group = findGroup(handle);
+        if (!group) return false;
+        
+        std::lock_guard<std::mutex> groupLock(group->membersMutex);
+        
+        // 检查组内是否已经有Master
+        if (!group->masterHandle.isNull() && group->masterHandle != handle) {
+            if (registry->isValid(group->masterHandle)) {
+                juce::String logMsg = formatGroupLog(*group, "Master role denied - Master already exists");
                 VST3_DBG(logMsg);
                 addConnectionLog(logMsg);
                 return false;
             } else {
                 // 现有Master已无效，清理并通知Slave
                 VST3_DBG("Existing Master plugin is invalid, clearing");
-                masterPlugin = nullptr;
-                notifySlavePluginsAboutMasterLoss();
+                group->masterHandle = {};
+                notifySlavePluginsAboutMasterLoss(*group);
             }
         }
         
+        // 🚀 跨进程：其他进程中同组的Master仍存活时拒绝；认领成功立即发布当前快照
+        if (group->masterHandle.isNull() && group->sharedLink && !group->sharedLink->claimMaster(group->stateWord.load())) {
+            juce::String logMsg = formatGroupLog(*group, "Master role denied - Master exists in another process");
+            VST3_DBG(logMsg);
+            addConnectionLog(logMsg);
+            return false;
+        }
+        
         // 从Slave列表移除（如果存在）
-        auto it = std::find(slavePlugins.begin(), slavePlugins.end(), plugin);
-        if (it != slavePlugins.end()) {
-            slavePlugins.erase(it);
+        auto it = std::find(group->slaveHandles.begin(), group->slaveHandles.end(), handle);
+        if (it != group->slaveHandles.end()) {
+            group->slaveHandles.erase(it);
         }
         
-        masterPlugin = plugin;
+        group->masterHandle = handle;
         
         // Stability optimization: counter monitoring
         healthMonitor.masterPromotions++;
         
-        juce::String pluginId = pluginIds[plugin];
-        juce::String logMsg = getCurrentTimeString() + " Master role assigned (ID: " + pluginId + ")";
+        juce::String logMsg = formatGroupLog(*group, "Master role assigned (ID: " + handle.toString() + ")");
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
         
         // 将等待中的Slave提升为活跃Slave
-        promoteWaitingSlavesToActive();
+        promoteWaitingSlavesToActive(*group);
         
         return true;
     }
@@ -403,127 +608,126 @@ bool GlobalPluginState::setAsMaster(MonitorControllerMaxAudioProcessor* plugin)
 }
 
 void GlobalPluginState::removeMaster(MonitorControllerMaxAudioProcessor* plugin) {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
+    auto lock = lockPluginsShared();
+    
+    const auto handle = lookupHandle(plugin);
+    auto group = findGroup(handle);
+    if (!group) return;
     
-    if (masterPlugin == plugin) {
-        juce::String pluginId;
-        auto idIt = pluginIds.find(plugin);
-        if (idIt != pluginIds.end()) {
-            pluginId = idIt->second;
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    
+    if (group->masterHandle == handle) {
+        group->masterHandle = {};
+        if (group->sharedLink) {
+            group->sharedLink->releaseMaster();
         }
         
-        masterPlugin = nullptr;
-        
-        juce::String logMsg = getCurrentTimeString() + " Master role removed (ID: " + pluginId + ") - Role available";
+        juce::String logMsg = formatGroupLog(*group, "Master role removed (ID: " + handle.toString() + ") - Role available");
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
         
-        // 通知所有有效的Slave自动切换到Standalone
-        std::vector<MonitorControllerMaxAudioProcessor*> validSlaves;
-        for (auto* slave : slavePlugins) {
-            if (slave != nullptr && isPluginValid(slave)) {
-                validSlaves.push_back(slave);
-            }
-        }
-        
-        for (auto* slave : validSlaves) {
-            juce::MessageManager::callAsync([slave]() {
-                slave->onMasterDisconnected();
-            });
-            waitingSlavePlugins.push_back(slave);
-        }
-        
-        slavePlugins.clear();
-        
-        if (!validSlaves.empty()) {
-            juce::String waitingLogMsg = getCurrentTimeString() + " Moved " + juce::String(validSlaves.size()) + 
-                                        " slaves to waiting list - waiting for new Master";
-            VST3_DBG(waitingLogMsg);
-            addConnectionLog(waitingLogMsg);
-        }
+        // 通知组内所有有效的Slave自动切换到Standalone，并移到等待列表
+        moveActiveSlavesToWaiting(*group);
     }
 }
 
-bool GlobalPluginState::isMasterPlugin(MonitorControllerMaxAudioProcessor* plugin) const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
-    return masterPlugin == plugin && isPluginValid(plugin);
+bool GlobalPluginState::isMasterPlugin(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    
+    const auto handle = lookupHandle(plugin);
+    auto group = findGroup(handle);
+    if (!group) return false;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    return group->masterHandle == handle;
 }
 
+//==============================================================================
+// Slave插件管理（作用于插件所在组）
+
 bool GlobalPluginState::addSlavePlugin(MonitorControllerMaxAudioProcessor* plugin) {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
+    auto lock = lockPluginsShared();
     
-    if (plugin == nullptr || !isPluginValid(plugin)) {
+    const auto handle = lookupHandle(plugin);
+    if (handle.isNull()) {
         VST3_DBG("Cannot add invalid plugin as Slave");
         return false;
     }
     
+    auto group = findGroup(handle);
+    if (!group) return false;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    
     // 不能将Master设为Slave
-    if (plugin == masterPlugin) {
-        juce::String logMsg = getCurrentTimeString() + " Slave role denied - Plugin is Master";
+    if (handle == group->masterHandle) {
+        juce::String logMsg = formatGroupLog(*group, "Slave role denied - Plugin is Master");
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
         return false;
     }
     
-    // 检查是否有有效的Master
-    if (masterPlugin == nullptr || !isPluginValid(masterPlugin)) {
+    // 检查组内是否有有效的Master（本进程或其他进程）
+    if (!hasActiveMaster(*group)) {
         // 没有有效Master，将Slave加入等待列表
-        addWaitingSlavePlugin(plugin);
+        addWaitingSlavePlugin(*group, handle);
         return true;
     }
     
     // 有Master，直接加入活跃Slave列表
-    auto it = std::find(slavePlugins.begin(), slavePlugins.end(), plugin);
-    if (it == slavePlugins.end()) {
-        slavePlugins.push_back(plugin);
+    auto it = std::find(group->slaveHandles.begin(), group->slaveHandles.end(), handle);
+    if (it == group->slaveHandles.end()) {
+        group->slaveHandles.push_back(handle);
+        healthMonitor.slaveConnections++;
         
-        juce::String pluginId = pluginIds[plugin];
-        juce::String logMsg = getCurrentTimeString() + " Slave role assigned (ID: " + pluginId + 
-                             ") - Active slaves: " + juce::String(slavePlugins.size());
+        juce::String logMsg = formatGroupLog(*group, "Slave role assigned (ID: " + handle.toString() +
+                                             ") - Active slaves: " + juce::String(group->slaveHandles.size()));
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
         
         // 立即同步Master状态到新Slave
-        syncAllStatesToSlave(plugin);
+        syncSnapshotToSlave(*group, handle);
     }
     
     return true;
 }
 
 void GlobalPluginState::removeSlavePlugin(MonitorControllerMaxAudioProcessor* plugin) {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
+    auto lock = lockPluginsShared();
     
-    if (plugin == nullptr) return;
+    const auto handle = lookupHandle(plugin);
+    auto group = findGroup(handle);
+    if (!group) return;
     
-    juce::String pluginId;
-    auto idIt = pluginIds.find(plugin);
-    if (idIt != pluginIds.end()) {
-        pluginId = idIt->second;
-    }
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
     
     // 从活跃Slave列表移除
-    auto it = std::find(slavePlugins.begin(), slavePlugins.end(), plugin);
-    if (it != slavePlugins.end()) {
-        slavePlugins.erase(it);
+    auto it = std::find(group->slaveHandles.begin(), group->slaveHandles.end(), handle);
+    if (it != group->slaveHandles.end()) {
+        group->slaveHandles.erase(it);
         
-        juce::String logMsg = getCurrentTimeString() + " Slave role removed (ID: " + pluginId + 
-                             ") - Active slaves: " + juce::String(slavePlugins.size());
+        juce::String logMsg = formatGroupLog(*group, "Slave role removed (ID: " + handle.toString() +
+                                             ") - Active slaves: " + juce::String(group->slaveHandles.size()));
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
     }
     
     // 从等待Slave列表移除
-    removeWaitingSlavePlugin(plugin);
+    removeWaitingSlavePlugin(*group, handle);
 }
 
-std::vector<MonitorControllerMaxAudioProcessor*> GlobalPluginState::getSlavePlugins() const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
+std::vector<MonitorControllerMaxAudioProcessor*> GlobalPluginState::getSlavePlugins(MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
     
     std::vector<MonitorControllerMaxAudioProcessor*> validSlaves;
     
-    for (auto* slave : slavePlugins) {
-        if (slave != nullptr && isPluginValid(slave)) {
-            validSlaves.push_back(slave);
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) return validSlaves;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    for (const auto& slave : group->slaveHandles) {
+        if (auto* slavePlugin = registry->resolve(slave)) {
+            validSlaves.push_back(slavePlugin);
         }
     }
     
@@ -531,371 +735,335 @@ std::vector<MonitorControllerMaxAudioProcessor*> GlobalPluginState::getSlavePlug
 }
 
 //==============================================================================
-// 🚀 生命周期安全：清理机制实现
-
-void GlobalPluginState::cleanupInvalidPlugins() {
-    // 此方法假定已持有pluginsMutex锁
-    
-    // 🚀 增强的清理逻辑：使用双重安全检查
-    auto cleanupVector = [this](std::vector<MonitorControllerMaxAudioProcessor*>& container, const juce::String& name) {
-        auto oldSize = container.size();
-        container.erase(
-            std::remove_if(container.begin(), container.end(),
-                [this](MonitorControllerMaxAudioProcessor* plugin) {
-                    return plugin == nullptr || !isPluginSafeToAccess(plugin);
-                }),
-            container.end()
-        );
-        
-        auto cleanedCount = oldSize - container.size();
-        if (cleanedCount > 0) {
-            VST3_DBG("Cleaned " + juce::String(cleanedCount) + " invalid plugins from " + name);
-        }
-        return cleanedCount;
-    };
-    
-    // 清理各个容器中的无效插件
-    auto allCleaned = cleanupVector(allPlugins, "allPlugins");
-    auto slavesCleaned = cleanupVector(slavePlugins, "slavePlugins");
-    auto waitingCleaned = cleanupVector(waitingSlavePlugins, "waitingSlavePlugins");
-    
-    // 🛡️ 增强的Master检查
-    if (masterPlugin != nullptr && !isPluginSafeToAccess(masterPlugin)) {
-        VST3_DBG("Master plugin is unsafe, removing and notifying slaves");
-        masterPlugin = nullptr;
-        notifySlavePluginsAboutMasterLoss(); // 通知Slave
-        allCleaned++;
-    }
-    
-    // 清理已失效插件集合中的旧记录
-    size_t invalidatedSizeBefore = invalidatedPlugins.size();
-    if (invalidatedSizeBefore > 100) { // 防止集合过大
-        invalidatedPlugins.clear();
-        VST3_DBG("Cleared oversized invalidated plugins set (" + juce::String(invalidatedSizeBefore) + " entries)");
-    }
-    
-    // 更新健康监控
-    auto totalCleaned = allCleaned + slavesCleaned + waitingCleaned;
-    if (totalCleaned > 0) {
-        healthMonitor.invalidPluginCleanups += totalCleaned;
-        VST3_DBG("Total cleaned invalid plugins: " + juce::String(totalCleaned));
-    }
-}
+// 状态同步机制
 
-void GlobalPluginState::performHealthyCleanup() {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
-    
-    VST3_DBG("Performing healthy cleanup...");
-    
-    // 清理无效插件
-    cleanupInvalidPlugins();
-    
-    // 清理孤立的ID映射
-    std::vector<juce::String> orphanedIds;
-    for (const auto& [id, plugin] : idToPlugin) {
-        if (plugin == nullptr || !isPluginValid(plugin)) {
-            orphanedIds.push_back(id);
-        }
-    }
-    
-    for (const auto& id : orphanedIds) {
-        auto plugin = idToPlugin[id];
-        if (plugin) {
-            pluginIds.erase(plugin);
-        }
-        idToPlugin.erase(id);
-        validPluginIds.erase(id);
-    }
+void GlobalPluginState::syncAllStatesToSlave(MonitorControllerMaxAudioProcessor* slavePlugin) {
+    auto lock = lockPluginsShared();
     
-    if (!orphanedIds.empty()) {
-        VST3_DBG("Cleaned " + juce::String(orphanedIds.size()) + " orphaned ID mappings");
-    }
+    const auto handle = lookupHandle(slavePlugin);
+    auto group = findGroup(handle);
+    if (!group) return;
     
-    VST3_DBG("Healthy cleanup completed. Valid plugins: " + juce::String(validPluginIds.size()));
-}
-
-//==============================================================================
-// 状态同步机制（保持不变，但增加有效性检查）
-
-void GlobalPluginState::setGlobalSoloState(const juce::String& channelName, bool state) {
-    std::lock_guard<std::mutex> lock(stateMutex);
-    globalSoloStates[channelName] = state;
-}
-
-void GlobalPluginState::setGlobalMuteState(const juce::String& channelName, bool state) {
-    std::lock_guard<std::mutex> lock(stateMutex);
-    globalMuteStates[channelName] = state;
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    syncSnapshotToSlave(*group, handle);
 }
 
-bool GlobalPluginState::getGlobalSoloState(const juce::String& channelName) const {
-    std::lock_guard<std::mutex> lock(stateMutex);
-    auto it = globalSoloStates.find(channelName);
-    return it != globalSoloStates.end() ? it->second : false;
-}
-
-bool GlobalPluginState::getGlobalMuteState(const juce::String& channelName) const {
-    std::lock_guard<std::mutex> lock(stateMutex);
-    auto it = globalMuteStates.find(channelName);
-    return it != globalMuteStates.end() ? it->second : false;
-}
-
-void GlobalPluginState::broadcastStateToSlaves(const juce::String& channelName, const juce::String& action, bool state) {
-    try {
-        std::lock_guard<std::mutex> lock(pluginsMutex);
-        
-        // 🚀 增强安全：只向安全的Slave插件广播
-        std::vector<MonitorControllerMaxAudioProcessor*> safeSlaves;
-        for (auto* slave : slavePlugins) {
-            if (isPluginSafeToAccess(slave)) {
-                safeSlaves.push_back(slave);
-            } else {
-                VST3_DBG("Skipping unsafe slave plugin during broadcast");
-            }
-        }
-        
-        if (safeSlaves.empty()) {
-            VST3_DBG("No safe slave plugins available for broadcast");
-            return;
-        }
-        
-        // Stability optimization: counter monitoring
-        healthMonitor.broadcastCalls++;
-        
-        VST3_DBG("Broadcasting " + action + " " + channelName + " = " + (state ? "true" : "false") + 
-                 " to " + juce::String(safeSlaves.size()) + " safe slaves");
-        
-        // 🛡️ 安全广播：对每个插件再次检查
-        for (auto* slave : safeSlaves) {
-            if (!isPluginSafeToAccess(slave)) {
-                VST3_DBG("Slave plugin became unsafe during broadcast, skipping");
-                continue;
-            }
-            
-            try {
-                // Direct call to Slave's state receiver - zero latency
-                slave->receiveMasterState(channelName, action, state);
-            } catch (const std::exception& e) {
-                // Stability optimization: record individual Slave communication exceptions
-                healthMonitor.exceptionsCaught++;
-                VST3_DBG("Error broadcasting to slave: " + juce::String(e.what()));
-                
-                // 立即标记有问题的插件
-                invalidatePlugin(slave);
-            } catch (...) {
-                // Stability optimization: catch all exception types
-                healthMonitor.exceptionsCaught++;
-                VST3_DBG("Unknown error broadcasting to slave");
-                
-                // 立即标记有问题的插件
-                invalidatePlugin(slave);
-            }
-        }
-        
-        // 定期清理无效插件
-        if (healthMonitor.broadcastCalls % 50 == 0) {
-            cleanupInvalidPlugins();
-        }
-    }
-    catch (...) {
-        // Stability optimization: overall exception handling
-        healthMonitor.exceptionsCaught++;
-        VST3_DBG("Exception caught in broadcastStateToSlaves - continuing safely");
-    }
-}
-
-void GlobalPluginState::syncAllStatesToSlave(MonitorControllerMaxAudioProcessor* slavePlugin) {
-    if (slavePlugin == nullptr || !isPluginValid(slavePlugin)) return;
-    if (masterPlugin == nullptr || !isPluginValid(masterPlugin)) return;
+void GlobalPluginState::syncSnapshotToSlave(MasterGroup& group, PluginHandle slaveHandle) {
+    auto* slavePlugin = registry->resolve(slaveHandle);
+    if (slavePlugin == nullptr) return;
+    if (!hasActiveMaster(group)) return;
     
-    std::lock_guard<std::mutex> stateLock(stateMutex);
-    
-    VST3_DBG("Syncing all Master states to new Slave");
-    
-    // 同步所有Solo状态
-    for (const auto& [channelName, state] : globalSoloStates) {
-        try {
-            slavePlugin->receiveMasterState(channelName, "solo", state);
-        } catch (const std::exception& e) {
-            VST3_DBG("Error syncing solo state: " + juce::String(e.what()));
-            invalidatePlugin(slavePlugin);
-            return;
-        }
-    }
-    
-    // 同步所有Mute状态
-    for (const auto& [channelName, state] : globalMuteStates) {
-        try {
-            slavePlugin->receiveMasterState(channelName, "mute", state);
-        } catch (const std::exception& e) {
-            VST3_DBG("Error syncing mute state: " + juce::String(e.what()));
-            invalidatePlugin(slavePlugin);
-            return;
-        }
-    }
-    
-    // v4.1: 同步总线效果状态
+    // 🚀 一次性交接整个快照：一个事务、一次RenderState发布，不再逐通道回放
     try {
-        slavePlugin->receiveMasterBusState("mono", globalMonoState);
+        slavePlugin->applyMasterSnapshot(group.getSnapshot());
     } catch (const std::exception& e) {
-        VST3_DBG("Error syncing mono state: " + juce::String(e.what()));
-        invalidatePlugin(slavePlugin);
+        // 只持有共享锁，不在这里改写注册表；下一次定时器节拍会重新应用快照
+        healthMonitor.exceptionsCaught++;
+        VST3_DBG("Error syncing Master snapshot to slave: " + juce::String(e.what()));
     }
 }
 
 //==============================================================================
 // 其他现有方法的增强实现
 
-int GlobalPluginState::getSlaveCount() const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
-    
+int GlobalPluginState::countValid(const std::vector<PluginHandle>& handles) const {
     int validCount = 0;
-    for (auto* slave : slavePlugins) {
-        if (slave != nullptr && isPluginValid(slave)) {
+    for (const auto& handle : handles) {
+        if (registry->isValid(handle)) {
             validCount++;
         }
     }
     return validCount;
 }
 
-int GlobalPluginState::getWaitingSlaveCount() const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
+int GlobalPluginState::getSlaveCount(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
     
-    int validCount = 0;
-    for (auto* slave : waitingSlavePlugins) {
-        if (slave != nullptr && isPluginValid(slave)) {
-            validCount++;
-        }
-    }
-    return validCount;
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) return 0;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    return countValid(group->slaveHandles);
 }
 
-void GlobalPluginState::addWaitingSlavePlugin(MonitorControllerMaxAudioProcessor* plugin) {
+int GlobalPluginState::getWaitingSlaveCount(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) return 0;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    return countValid(group->waitingSlaveHandles);
+}
+
+void GlobalPluginState::addWaitingSlavePlugin(MasterGroup& group, PluginHandle handle) {
     // 此方法在已持有锁的情况下调用
-    if (plugin == nullptr || !isPluginValid(plugin)) return;
+    if (!registry->isValid(handle)) return;
     
     // 从活跃Slave列表移除（如果存在）
-    auto activeIt = std::find(slavePlugins.begin(), slavePlugins.end(), plugin);
-    if (activeIt != slavePlugins.end()) {
-        slavePlugins.erase(activeIt);
+    auto activeIt = std::find(group.slaveHandles.begin(), group.slaveHandles.end(), handle);
+    if (activeIt != group.slaveHandles.end()) {
+        group.slaveHandles.erase(activeIt);
     }
     
     // 检查是否已在等待列表
-    auto waitingIt = std::find(waitingSlavePlugins.begin(), waitingSlavePlugins.end(), plugin);
-    if (waitingIt == waitingSlavePlugins.end()) {
-        waitingSlavePlugins.push_back(plugin);
+    auto waitingIt = std::find(group.waitingSlaveHandles.begin(), group.waitingSlaveHandles.end(), handle);
+    if (waitingIt == group.waitingSlaveHandles.end()) {
+        group.waitingSlaveHandles.push_back(handle);
         
-        juce::String pluginId = pluginIds[plugin];
-        juce::String logMsg = getCurrentTimeString() + " Slave added to waiting list (ID: " + pluginId + 
-                             ") - Waiting slaves: " + juce::String(waitingSlavePlugins.size());
+        juce::String logMsg = formatGroupLog(group, "Slave added to waiting list (ID: " + handle.toString() +
+                                             ") - Waiting slaves: " + juce::String(group.waitingSlaveHandles.size()));
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
     }
 }
 
-void GlobalPluginState::removeWaitingSlavePlugin(MonitorControllerMaxAudioProcessor* plugin) {
+void GlobalPluginState::removeWaitingSlavePlugin(MasterGroup& group, PluginHandle handle) {
     // 此方法在已持有锁的情况下调用
-    auto waitingIt = std::find(waitingSlavePlugins.begin(), waitingSlavePlugins.end(), plugin);
-    if (waitingIt != waitingSlavePlugins.end()) {
-        waitingSlavePlugins.erase(waitingIt);
-        
-        juce::String pluginId;
-        auto idIt = pluginIds.find(plugin);
-        if (idIt != pluginIds.end()) {
-            pluginId = idIt->second;
-        }
+    auto waitingIt = std::find(group.waitingSlaveHandles.begin(), group.waitingSlaveHandles.end(), handle);
+    if (waitingIt != group.waitingSlaveHandles.end()) {
+        group.waitingSlaveHandles.erase(waitingIt);
         
-        juce::String logMsg = getCurrentTimeString() + " Slave removed from waiting list (ID: " + pluginId + 
-                             ") - Waiting slaves: " + juce::String(waitingSlavePlugins.size());
+        juce::String logMsg = formatGroupLog(group, "Slave removed from waiting list (ID: " + handle.toString() +
+                                             ") - Waiting slaves: " + juce::String(group.waitingSlaveHandles.size()));
         VST3_DBG(logMsg);
         addConnectionLog(logMsg);
     }
 }
 
-void GlobalPluginState::promoteWaitingSlavesToActive() {
+void GlobalPluginState::promoteWaitingSlavesToActive(MasterGroup& group) {
     // 此方法在已持有锁的情况下调用
-    if (waitingSlavePlugins.empty()) return;
+    if (group.waitingSlaveHandles.empty()) return;
     
-    std::vector<MonitorControllerMaxAudioProcessor*> validWaitingSlaves;
+    std::vector<PluginHandle> validWaitingSlaves;
     
     // 收集有效的等待Slave
-    for (auto* slave : waitingSlavePlugins) {
-        if (slave != nullptr && isPluginValid(slave)) {
+    for (const auto& slave : group.waitingSlaveHandles) {
+        if (registry->isValid(slave)) {
             validWaitingSlaves.push_back(slave);
         }
     }
     
     if (validWaitingSlaves.empty()) {
-        waitingSlavePlugins.clear();
+        group.waitingSlaveHandles.clear();
         return;
     }
     
-    juce::String logMsg = getCurrentTimeString() + " Promoting " + juce::String(validWaitingSlaves.size()) + 
-                         " waiting slaves to active - Master is now available";
+    juce::String logMsg = formatGroupLog(group, "Promoting " + juce::String(validWaitingSlaves.size()) +
+                                         " waiting slaves to active - Master is now available");
     VST3_DBG(logMsg);
     addConnectionLog(logMsg);
     
     // 将所有等待中的Slave提升为活跃Slave
-    for (auto* waitingSlave : validWaitingSlaves) {
-        slavePlugins.push_back(waitingSlave);
+    for (const auto& waitingSlave : validWaitingSlaves) {
+        group.slaveHandles.push_back(waitingSlave);
+        healthMonitor.slaveConnections++;
         
         // 同步Master状态到新连接的Slave
-        syncAllStatesToSlave(waitingSlave);
+        syncSnapshotToSlave(group, waitingSlave);
         
-        // 通知Slave现在已连接到Master
-        juce::MessageManager::callAsync([waitingSlave]() {
-            waitingSlave->onMasterConnected();
+        // 通知Slave现在已连接到Master（回调执行时再解析句柄）
+        juce::MessageManager::callAsync([registry = registry, waitingSlave]() {
+            if (auto* plugin = registry->resolve(waitingSlave)) {
+                plugin->onMasterConnected();
+            }
         });
     }
     
     // 清空等待列表
-    waitingSlavePlugins.clear();
+    group.waitingSlaveHandles.clear();
     
-    juce::String finalLogMsg = getCurrentTimeString() + " All waiting slaves promoted - Active slaves: " + 
-                              juce::String(slavePlugins.size());
+    juce::String finalLogMsg = formatGroupLog(group, "All waiting slaves promoted - Active slaves: " +
+                                              juce::String(group.slaveHandles.size()));
     VST3_DBG(finalLogMsg);
     addConnectionLog(finalLogMsg);
 }
 
-bool GlobalPluginState::hasMaster() const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
-    return masterPlugin != nullptr && isPluginValid(masterPlugin);
+bool GlobalPluginState::hasMaster(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) return false;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    return hasActiveMaster(*group);
 }
 
-juce::String GlobalPluginState::getConnectionInfo() const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
+juce::String GlobalPluginState::getConnectionInfo(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) return "Not registered";
     
-    juce::String info;
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
     
-    if (masterPlugin != nullptr && isPluginValid(masterPlugin)) {
+    juce::String info = "Group: " + group->getDisplayName() + " (" + juce::String(groups.size()) + " groups) | ";
+    
+    if (hasLocalMaster(*group)) {
         info += "Master: Active";
-        auto validSlaveCount = getSlaveCount();
+        auto validSlaveCount = countValid(group->slaveHandles);
         if (validSlaveCount > 0) {
             info += " | Slaves: " + juce::String(validSlaveCount);
         } else {
             info += " | No Slaves";
         }
+    } else if (group->sharedLink && group->sharedLink->isRemoteMasterActive()) {
+        info += "Master: Remote process";
     } else {
         info += "No Master";
-        auto validWaitingCount = getWaitingSlaveCount();
+        auto validWaitingCount = countValid(group->waitingSlaveHandles);
         if (validWaitingCount > 0) {
             info += " | Waiting Slaves: " + juce::String(validWaitingCount);
         }
-        info += " | Valid Plugins: " + juce::String(validPluginIds.size());
+        info += " | Valid Plugins: " + juce::String(registry->getLiveCount());
     }
     
     return info;
 }
 
-MonitorControllerMaxAudioProcessor* GlobalPluginState::getMasterPlugin() const {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
-    if (masterPlugin != nullptr && isPluginValid(masterPlugin)) {
-        return masterPlugin;
+MonitorControllerMaxAudioProcessor* GlobalPluginState::getMasterPlugin(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) return nullptr;
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    return registry->resolve(group->masterHandle);
+}
+
+//==============================================================================
+// 🚀 跨进程链路：每组一个共享段，其他进程中同组Master的快照经共享内存到达，本进程的Slave与进程内Master时一样跟随
+
+void GlobalPluginState::openSharedLink(MasterGroup& group) {
+    // 此方法在组创建时调用（已独占pluginsMutex，组尚未对外可见）
+    juce::String segmentName;
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex);
+        segmentName = sharedLinkSegmentName;
+    }
+    
+    // 默认组沿用原段名，其他组各自一个段：不同组的链路线程与令牌互不影响
+    if (!group.isDefault()) {
+        segmentName += "_" + group.getName().removeCharacters("\\");
+    }
+    
+    auto link = std::make_unique<SharedStateLink>(segmentName);
+    if (!link->open()) {
+        addConnectionLog(formatGroupLog(group, "Cross-process link unavailable - in-process mode only"));
+        return;
+    }
+    
+    // 链路归组所有，组在链路关闭前不会销毁
+    link->onRemoteState = [this, &group](uint64_t stateWord) { handleRemoteMasterState(group, stateWord); };
+    link->onRemoteMasterChanged = [this, &group](bool active) { handleRemoteMasterChanged(group, active); };
+    
+    // 其他进程已有Master：先取其当前状态，随后加入的Slave直接拿到正确快照
+    uint64_t stateWord = 0;
+    juce::int64 publishedTicks = 0;
+    if (link->isRemoteMasterActive() && link->readState(stateWord, publishedTicks)) {
+        std::lock_guard<std::mutex> stateLock(group.stateMutex);
+        group.recordPublication(stateWord, publishedTicks);
+        group.stateWord.store(stateWord, std::memory_order_release);
+    }
+    
+    group.sharedLink = std::move(link);
+    
+    juce::String logMsg = formatGroupLog(group, "Cross-process link attached (" + segmentName + ", processes: " +
+                                         juce::String(group.sharedLink->getAttachedProcessCount()) + ")");
+    VST3_DBG(logMsg);
+    addConnectionLog(logMsg);
+}
+
+bool GlobalPluginState::hasLocalMaster(const MasterGroup& group) const {
+    // 此方法在已持有pluginsMutex与group.membersMutex时调用
+    return registry->isValid(group.masterHandle);
+}
+
+bool GlobalPluginState::hasActiveMaster(const MasterGroup& group) const {
+    // 此方法在已持有pluginsMutex与group.membersMutex时调用
+    return hasLocalMaster(group) || (group.sharedLink != nullptr && group.sharedLink->isRemoteMasterActive());
+}
+
+void GlobalPluginState::moveActiveSlavesToWaiting(MasterGroup& group) {
+    // 此方法在已持有pluginsMutex与group.membersMutex时调用
+    std::vector<PluginHandle> validSlaves;
+    for (const auto& slave : group.slaveHandles) {
+        if (registry->isValid(slave)) {
+            validSlaves.push_back(slave);
+        }
+    }
+    
+    notifySlavePluginsAboutMasterLoss(group);
+    group.waitingSlaveHandles.insert(group.waitingSlaveHandles.end(), validSlaves.begin(), validSlaves.end());
+    group.slaveHandles.clear();
+    
+    if (!validSlaves.empty()) {
+        juce::String waitingLogMsg = formatGroupLog(group, "Moved " + juce::String(validSlaves.size()) +
+                                                    " slaves to waiting list - waiting for new Master");
+        VST3_DBG(waitingLogMsg);
+        addConnectionLog(waitingLogMsg);
+    }
+}
+
+void GlobalPluginState::handleRemoteMasterState(MasterGroup& group, uint64_t stateWord) {
+    if (shuttingDown.load()) return;
+    
+    // 写入组快照：Slave定时器拉取的也是远端状态
+    {
+        std::lock_guard<std::mutex> stateLock(group.stateMutex);
+        
+        // 发布时间取远端写入共享段的ticks（同一台机器上的高精度计时可跨进程比较）
+        uint64_t linkedWord = 0;
+        juce::int64 publishedTicks = 0;
+        if (group.sharedLink == nullptr || !group.sharedLink->readState(linkedWord, publishedTicks) || linkedWord != stateWord) {
+            publishedTicks = juce::Time::getHighResolutionTicks();
+        }
+        
+        group.recordPublication(stateWord, publishedTicks);
+        group.stateWord.store(stateWord, std::memory_order_release);
+    }
+    
+    // 🚀 立即应用到组内活跃Slave，不等下一个定时器节拍
+    auto lock = lockPluginsShared();
+    std::lock_guard<std::mutex> groupLock(group.membersMutex);
+    if (hasLocalMaster(group)) return;
+    
+    const auto snapshot = MasterStateSnapshot::unpack(stateWord);
+    for (const auto& slaveHandle : group.slaveHandles) {
+        auto* slave = registry->resolve(slaveHandle);
+        if (slave == nullptr) continue;
+        
+        try {
+            slave->applyMasterSnapshot(snapshot);
+        } catch (const std::exception& e) {
+            healthMonitor.exceptionsCaught++;
+            VST3_DBG("Error applying remote Master snapshot: " + juce::String(e.what()));
+        }
+    }
+}
+
+void GlobalPluginState::handleRemoteMasterChanged(MasterGroup& group, bool active) {
+    if (shuttingDown.load()) return;
+    
+    auto lock = lockPluginsShared();
+    std::lock_guard<std::mutex> groupLock(group.membersMutex);
+    
+    // 本进程自己的Master不受远端变化影响
+    if (hasLocalMaster(group)) return;
+    
+    juce::String logMsg = formatGroupLog(group, active ? "Remote Master connected" : "Remote Master lost");
+    VST3_DBG(logMsg);
+    addConnectionLog(logMsg);
+    
+    if (active) {
+        promoteWaitingSlavesToActive(group);
+    } else {
+        moveActiveSlavesToWaiting(group);
     }
-    return nullptr;
 }
 
 //==============================================================================
-// 其他现有方法...（日志管理、v4.1总线效果、健康监控等保持不变）
+// 其他现有方法...（日志管理、健康监控等保持不变）
 
 void GlobalPluginState::addConnectionLog(const juce::String& message) {
     std::lock_guard<std::mutex> lock(logsMutex);
@@ -923,44 +1091,10 @@ juce::String GlobalPluginState::getCurrentTimeString() const {
     return now.toString(false, true, true, true);  // 包含毫秒
 }
 
-//==============================================================================
-// v4.1: 总线效果状态管理（保持不变）
-void GlobalPluginState::setGlobalMonoState(bool monoState) {
-    std::lock_guard<std::mutex> lock(stateMutex);
-    globalMonoState = monoState;
-    
-    VST3_DBG("Global mono state set to: " + juce::String(monoState ? "ON" : "OFF"));
-}
-
-bool GlobalPluginState::getGlobalMonoState() const {
-    std::lock_guard<std::mutex> lock(stateMutex);
-    return globalMonoState;
-}
-
-void GlobalPluginState::broadcastMonoStateToSlaves(bool monoState) {
-    std::lock_guard<std::mutex> lock(pluginsMutex);
-    
-    auto validSlaves = getSlavePlugins();
-    
-    VST3_DBG("Broadcasting mono state to " + juce::String(validSlaves.size()) + " slaves: " + 
-             juce::String(monoState ? "ON" : "OFF"));
-    
-    for (auto* slave : validSlaves) {
-        try {
-            slave->receiveMasterBusState("mono", monoState);
-        } catch (const std::exception& e) {
-            // Stability optimization: monitor bus state broadcast exceptions
-            healthMonitor.exceptionsCaught++;
-            VST3_DBG("Error broadcasting mono state: " + juce::String(e.what()));
-            invalidatePlugin(slave);
-        }
-    }
-}
-
 //==============================================================================
 // Stability Optimization Step 4: Health Monitoring System Implementation（保持不变）
 
-juce::String GlobalPluginState::HealthMonitor::getHealthReport() const {
+juce::String GlobalPluginState::HealthMonitor::getHealthReport(uint32_t snapshotPublishes) const {
     juce::String report;
     report += "=== GlobalPluginState Health Report ===\n";
     report += "Plugin Registrations: " + juce::String(pluginRegistrations.load()) + "\n";
@@ -968,15 +1102,15 @@ juce::String GlobalPluginState::HealthMonitor::getHealthReport() const {
     report += "Master Promotions: " + juce::String(masterPromotions.load()) + "\n";
     report += "Slave Connections: " + juce::String(slaveConnections.load()) + "\n";
     report += "State Changes: " + juce::String(stateChanges.load()) + "\n";
-    report += "Broadcast Calls: " + juce::String(broadcastCalls.load()) + "\n";
+    report += "Snapshot Publishes: " + juce::String(snapshotPublishes) + "\n";
     report += "Exceptions Caught: " + juce::String(exceptionsCaught.load()) + "\n";
     report += "Lock Timeouts: " + juce::String(lockTimeouts.load()) + "\n";
     report += "Invalid Plugin Cleanups: " + juce::String(invalidPluginCleanups.load()) + "\n";
     
     // Health status assessment
     uint32_t totalExceptions = exceptionsCaught.load();
-    uint32_t totalOperations = pluginRegistrations.load() + pluginUnregistrations.load() + 
-                              broadcastCalls.load() + stateChanges.load();
+    uint32_t totalOperations = pluginRegistrations.load() + pluginUnregistrations.load() +
+                              snapshotPublishes + stateChanges.load();
     
     if (totalExceptions == 0) {
         report += "Status: EXCELLENT - No exceptions";
@@ -990,7 +1124,63 @@ juce::String GlobalPluginState::HealthMonitor::getHealthReport() const {
 }
 
 juce::String GlobalPluginState::getHealthReport() const {
-    return healthMonitor.getHealthReport();
+    // 快照发布在各组内计数（组发布路径不经过本对象）
+    uint32_t publishes = 0;
+    juce::String groupReport;
+    {
+        auto lock = lockPluginsShared();
+        for (const auto& [groupName, group] : groups) {
+            publishes += group->getPublishCount();
+            
+            std::lock_guard<std::mutex> groupLock(group->membersMutex);
+            groupReport += "\nGroup " + group->getDisplayName() + ": " + juce::String(group->getPublishCount()) +
+                           " publishes | " + buildPropagationReport(*group).toString();
+        }
+    }
+    
+    const auto lockStats = getLockStats();
+    groupReport += "\nRegistry Lock: " + juce::String(static_cast<juce::int64>(lockStats.contentions)) + " contended / " +
+                   juce::String(static_cast<juce::int64>(lockStats.acquisitions)) + " acquisitions, " +
+                   juce::String(lockStats.waitMs, 2) + " ms waiting";
+    
+    return healthMonitor.getHealthReport(publishes) + groupReport;
+}
+
+PropagationReport GlobalPluginState::getPropagationReport(const MonitorControllerMaxAudioProcessor* plugin) const {
+    auto lock = lockPluginsShared();
+    
+    auto group = findGroup(lookupHandle(plugin));
+    if (!group) {
+        return {};
+    }
+    
+    std::lock_guard<std::mutex> groupLock(group->membersMutex);
+    return buildPropagationReport(*group);
+}
+
+PropagationReport GlobalPluginState::buildPropagationReport(const MasterGroup& group) const {
+    // 此方法在已持有pluginsMutex与group.membersMutex时调用
+    PropagationReport report;
+    report.groupName = group.getDisplayName();
+    report.sequence = group.getSequence();
+    
+    for (const auto& slaveHandle : group.slaveHandles) {
+        auto* slave = registry->resolve(slaveHandle);
+        if (slave == nullptr) continue;
+        
+        PropagationReport::Slave entry;
+        entry.id = slaveHandle.toString();
+        entry.appliedSequence = slave->getAppliedMasterSequence();
+        entry.audibleSequence = slave->getAudibleMasterSequence();
+        entry.lag = report.sequence > entry.audibleSequence ? report.sequence - entry.audibleSequence : 0;
+        entry.lastLatencyUs = slave->getLastPropagationUs();
+        
+        report.maxLag = juce::jmax(report.maxLag, entry.lag);
+        report.latency.merge(slave->getMasterPropagation());
+        report.slaves.push_back(entry);
+    }
+    
+    return report;
 }
 
 void GlobalPluginState::resetHealthCounters() {
@@ -1000,8 +1190,10 @@ void GlobalPluginState::resetHealthCounters() {
     healthMonitor.masterPromotions = 0;
     healthMonitor.slaveConnections = 0;
     healthMonitor.stateChanges = 0;
-    healthMonitor.broadcastCalls = 0;
     healthMonitor.exceptionsCaught = 0;
     healthMonitor.lockTimeouts = 0;
     healthMonitor.invalidPluginCleanups = 0;
+    pluginsLockAcquisitions = 0;
+    pluginsLockContentions = 0;
+    pluginsLockWaitTicks = 0;
 }
\ No newline at end of file
@@ -7,18 +7,31 @@
     - 线程安全的单例模式
     - Master/Slave角色管理
     - 零延迟状态同步
-    - 插件生命周期管理
+    - Master状态以带版本号的位掩码快照发布，Slave无锁拉取
+    - 跨进程链路（SharedStateLink）：宿主把插件放进不同进程时，Slave跟随其他进程的Master
+    - 命名Master组（MasterGroup）：每组一个Master，状态分片与成员锁按组独立
+    - 插件生命周期管理：带代号的句柄（PluginHandleRegistry），有效性检查无锁
+    - 传播跟踪：每次发布带序号与时间戳，按组汇总各Slave的落后量与延迟直方图
   ==============================================================================
 */
 
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <vector>
+#include <array>
 #include <map>
 #include <algorithm>
+#include <thread>
+#include "OSCAddressTable.h"
+#include "SharedStateLink.h"
+#include "PluginHandleRegistry.h"
+#include "PropagationStats.h"
 
 // 前向声明
 class MonitorControllerMaxAudioProcessor;
@@ -30,9 +43,126 @@ enum class PluginRole {
     Slave = 2        // 从属显示模式
 };
 
+/**
+ * Master状态快照 - 不可变、带版本号
+ *
+ * Solo/Mute按OSCAddressTable通道ID存为位掩码，整体打包进一个64位字，
+ * Master发布与Slave读取都是单次原子操作：
+ *   bit 0-22 Solo | bit 23-45 Mute | bit 46 Mono | bit 47-63 版本号
+ * 版本号只用于区分发布，回绕无妨（Slave按整字比较，掩码相同即状态相同）。
+ */
+struct MasterStateSnapshot
+{
+    uint32_t version = 0;
+    uint32_t soloMask = 0;   // bit n = 通道ID n
+    uint32_t muteMask = 0;
+    bool mono = false;
+
+    static constexpr int MUTE_SHIFT = OSCAddressTable::NUM_CHANNEL_IDS;
+    static constexpr int MONO_SHIFT = MUTE_SHIFT * 2;
+    static constexpr int VERSION_SHIFT = MONO_SHIFT + 1;
+    static constexpr uint64_t CHANNEL_BITS = (uint64_t(1) << OSCAddressTable::NUM_CHANNEL_IDS) - 1;
+    static constexpr uint64_t VERSION_BITS = (uint64_t(1) << (64 - VERSION_SHIFT)) - 1;
+    static_assert(VERSION_SHIFT <= 56, "Snapshot word needs at least 8 version bits");
+
+    uint64_t pack() const noexcept
+    {
+        return (static_cast<uint64_t>(soloMask) & CHANNEL_BITS)
+             | ((static_cast<uint64_t>(muteMask) & CHANNEL_BITS) << MUTE_SHIFT)
+             | (static_cast<uint64_t>(mono ? 1 : 0) << MONO_SHIFT)
+             | ((static_cast<uint64_t>(version) & VERSION_BITS) << VERSION_SHIFT);
+    }
+
+    static MasterStateSnapshot unpack(uint64_t word) noexcept
+    {
+        MasterStateSnapshot snapshot;
+        snapshot.soloMask = static_cast<uint32_t>(word & CHANNEL_BITS);
+        snapshot.muteMask = static_cast<uint32_t>((word >> MUTE_SHIFT) & CHANNEL_BITS);
+        snapshot.mono = ((word >> MONO_SHIFT) & 1) != 0;
+        snapshot.version = static_cast<uint32_t>((word >> VERSION_SHIFT) & VERSION_BITS);
+        return snapshot;
+    }
+};
+
+/**
+ * Master组 - 一个独立的监听控制域（如控制室、录音间、分轨质检）
+ *
+ * 每组一个Master，Slave订阅所在组；状态分片、快照字、成员列表和跨进程链路都按组独立，
+ * 不同组的操作互不争用同一把锁。组名按SharedOSCHub::normaliseGroupName规范化，空字符串为默认组。
+ * 组一经创建便在GlobalPluginState生命周期内保留，插件持有的组句柄始终有效。
+ */
+class MasterGroup {
+public:
+    explicit MasterGroup(const juce::String& groupName) : name(groupName) {}
+    
+    const juce::String& getName() const noexcept { return name; }
+    bool isDefault() const noexcept { return name.isEmpty(); }
+    juce::String getDisplayName() const { return isDefault() ? juce::String("Default") : name; }
+    
+    // 组内状态分片：Master写入即发布快照（O(1)，与Slave数量无关）
+    void setSoloState(const juce::String& channelName, bool state);
+    void setMuteState(const juce::String& channelName, bool state);
+    void setMonoState(bool monoState);
+    bool getSoloState(const juce::String& channelName) const;
+    bool getMuteState(const juce::String& channelName) const;
+    bool getMonoState() const;
+    
+    // Slave在定时器节拍中无锁读取（任意线程可调用）
+    MasterStateSnapshot getSnapshot() const noexcept {
+        return MasterStateSnapshot::unpack(stateWord.load(std::memory_order_acquire));
+    }
+    
+    // 最近一次发布（序号 + 发布时间 + 状态字，seqlock读取，任意线程）
+    MasterPublication getLatestPublication() const noexcept;
+    uint64_t getSequence() const noexcept { return publicationSequence.load(std::memory_order_acquire); }
+    
+    SharedStateLink* getSharedLink() const noexcept { return sharedLink.get(); }
+    uint32_t getPublishCount() const noexcept { return publishCount.load(std::memory_order_relaxed); }
+
+private:
+    friend class GlobalPluginState;
+    
+    // 快照发布：只改动一位，状态未变时不递增版本号（调用方持有stateMutex）
+    void publishBit(int shift, bool state);
+    
+    // 记录一次发布，序号加一（调用方持有stateMutex；本进程发布与远端到达都经过这里）
+    void recordPublication(uint64_t word, juce::int64 publishedTicks) noexcept;
+    
+    const juce::String name;
+    
+    // 状态分片
+    std::map<juce::String, bool> soloStates;
+    std::map<juce::String, bool> muteStates;
+    bool monoState = false;
+    mutable std::mutex stateMutex;
+    
+    // 🚀 Master状态快照（MasterStateSnapshot打包字）
+    std::atomic<uint64_t> stateWord{0};
+    std::atomic<uint32_t> publishCount{0};
+    
+    // 🚀 发布记录（seqlock：publicationLock为奇数时写入中）
+    std::atomic<uint32_t> publicationLock{0};
+    std::atomic<uint64_t> publicationSequence{0};
+    std::atomic<juce::int64> publicationTicks{0};
+    std::atomic<uint64_t> publicationWord{0};
+    
+    // 🚀 跨进程链路：每组一个共享段，组创建时打开，打开失败时只按进程内规则工作
+    std::unique_ptr<SharedStateLink> sharedLink;
+    
+    // 组成员句柄（membersMutex保护；锁顺序：GlobalPluginState::pluginsMutex -> membersMutex -> stateMutex）
+    // 插件注销后句柄自动过期，列表中残留的旧句柄只会解析为nullptr，不会悬空
+    PluginHandle masterHandle;
+    std::vector<PluginHandle> slaveHandles;
+    std::vector<PluginHandle> waitingSlaveHandles;  // 等待Master的Slave插件
+    mutable std::mutex membersMutex;
+    
+    MasterGroup(const MasterGroup&) = delete;
+    MasterGroup& operator=(const MasterGroup&) = delete;
+};
+
 /**
  * 全局插件状态管理器
- * 管理同进程内所有插件实例的Master-Slave通信
+ * 管理同进程内所有插件实例的注册与生命周期，Master-Slave通信按MasterGroup划分
  */
 class GlobalPluginState {
 private:
@@ -42,29 +172,25 @@ private:
     static std::atomic<bool> shuttingDown; // 🛡️ 关闭状态标志
     static std::atomic<int> refCount; // 🚀 引用计数器，确保安全销毁
     
-    // 全局状态存储
-    std::map<juce::String, bool> globalSoloStates;
-    std::map<juce::String, bool> globalMuteStates;
+    // 跨进程链路的共享段名前缀：默认组直接使用，其他组追加 "_<组名>"
+    static juce::String sharedLinkSegmentName;
     
-    // v4.1: 全局总线效果状态
-    bool globalMonoState = false;
-    
-    mutable std::mutex stateMutex;
+    // 🚀 命名Master组：组名 -> 组（只增不删）
+    std::map<juce::String, std::shared_ptr<MasterGroup>> groups;
     
-    // 🚀 生命周期安全：增强的插件实例管理
-    MonitorControllerMaxAudioProcessor* masterPlugin = nullptr;
-    std::vector<MonitorControllerMaxAudioProcessor*> slavePlugins;
-    std::vector<MonitorControllerMaxAudioProcessor*> waitingSlavePlugins;  // 等待Master的Slave插件
-    std::vector<MonitorControllerMaxAudioProcessor*> allPlugins;
-    
-    // 🛡️ 生命周期跟踪系统 - 双重验证机制
-    std::map<MonitorControllerMaxAudioProcessor*, juce::String> pluginIds;  // 插件->唯一ID映射
-    std::map<juce::String, MonitorControllerMaxAudioProcessor*> idToPlugin;  // ID->插件映射
-    std::set<juce::String> validPluginIds;  // 有效插件ID集合
-    std::set<MonitorControllerMaxAudioProcessor*> invalidatedPlugins; // 已失效的插件集合
+    // 🚀 生命周期安全：插件实例以带代号的句柄注册，有效性检查 = 下标 + 代号比较（无锁）
+    // 异步回调捕获注册表的shared_ptr，GlobalPluginState销毁后句柄解析依然安全
+    const std::shared_ptr<PluginHandleRegistry> registry = std::make_shared<PluginHandleRegistry>();
+    std::array<std::shared_ptr<MasterGroup>, PluginHandleRegistry::MAX_PLUGINS> slotGroups;  // 槽位->所属组
     std::atomic<uint32_t> cleanupCounter{0};  // 清理操作计数器
     
-    mutable std::mutex pluginsMutex;
+    // 注册表锁：注册/注销/换组独占；组内Master/Slave操作只取共享锁，再取各组自己的membersMutex
+    mutable std::shared_mutex pluginsMutex;
+    
+    // 🚀 注册表锁竞争统计：先try_lock，失败才计为竞争并计时等待（未竞争时只多一次原子加）
+    mutable std::atomic<uint64_t> pluginsLockAcquisitions{0};
+    mutable std::atomic<uint64_t> pluginsLockContentions{0};
+    mutable std::atomic<juce::int64> pluginsLockWaitTicks{0};
     
     // 连接日志记录
     std::vector<juce::String> connectionLogs;
@@ -78,13 +204,12 @@ private:
         std::atomic<uint32_t> masterPromotions{0};         // Master提升次数
         std::atomic<uint32_t> slaveConnections{0};         // Slave连接次数
         std::atomic<uint32_t> stateChanges{0};             // 状态变化次数
-        std::atomic<uint32_t> broadcastCalls{0};           // 广播调用次数
         std::atomic<uint32_t> exceptionsCaught{0};         // 捕获的异常次数
         std::atomic<uint32_t> lockTimeouts{0};             // 锁超时次数
         std::atomic<uint32_t> invalidPluginCleanups{0};   // 无效插件清理次数
         
-        // 获取健康报告
-        juce::String getHealthReport() const;
+        // 获取健康报告（快照发布次数由各组累计后传入）
+        juce::String getHealthReport(uint32_t snapshotPublishes) const;
     } healthMonitor;
 
 public:
@@ -102,50 +227,45 @@ public:
     static bool isShuttingDown();
     static void releaseReference(); // 🚀 引用计数释放
     
+    // 跨进程链路的共享段名（基准/测试用独立段名，避免加入正在运行的宿主会话）；须在首个插件注册前调用
+    static void setSharedLinkSegmentName(const juce::String& segmentName);
+    
     // 🚀 构造和析构函数（需要public用于std::shared_ptr）
     GlobalPluginState() = default;
-    ~GlobalPluginState() = default;
+    ~GlobalPluginState();
     
-    // 🚀 生命周期安全：增强的插件管理接口
-    void registerPlugin(MonitorControllerMaxAudioProcessor* plugin);
+    // 🚀 生命周期安全：增强的插件管理接口（注册时加入指定组，空为默认组）
+    // 返回插件句柄，由插件保存（getPluginHandle）；注册表已满时返回空句柄，插件只能独立工作
+    PluginHandle registerPlugin(MonitorControllerMaxAudioProcessor* plugin, const juce::String& groupName = {});
     void unregisterPlugin(MonitorControllerMaxAudioProcessor* plugin);
     
-    // Master插件管理
+    // Master组：插件换组前必须已退出Master/Slave角色；返回新组句柄（插件未注册时为空）
+    std::shared_ptr<MasterGroup> setPluginGroup(MonitorControllerMaxAudioProcessor* plugin, const juce::String& groupName);
+    std::shared_ptr<MasterGroup> getPluginGroup(const MonitorControllerMaxAudioProcessor* plugin) const;
+    juce::StringArray getGroupNames() const;
+    
+    // Master插件管理（作用于插件所在组）
     bool setAsMaster(MonitorControllerMaxAudioProcessor* plugin);
     void removeMaster(MonitorControllerMaxAudioProcessor* plugin);
-    bool isMasterPlugin(MonitorControllerMaxAudioProcessor* plugin) const;
+    bool isMasterPlugin(const MonitorControllerMaxAudioProcessor* plugin) const;
     
-    // Slave插件管理
+    // Slave插件管理（作用于插件所在组）
     bool addSlavePlugin(MonitorControllerMaxAudioProcessor* plugin);
     void removeSlavePlugin(MonitorControllerMaxAudioProcessor* plugin);
-    std::vector<MonitorControllerMaxAudioProcessor*> getSlavePlugins() const;
+    std::vector<MonitorControllerMaxAudioProcessor*> getSlavePlugins(MonitorControllerMaxAudioProcessor* plugin) const;
     
-    // 等待Master的Slave管理
-    void addWaitingSlavePlugin(MonitorControllerMaxAudioProcessor* plugin);
-    void removeWaitingSlavePlugin(MonitorControllerMaxAudioProcessor* plugin);
-    void promoteWaitingSlavesToActive();  // 当Master可用时，将等待中的Slave提升为活跃
-    
-    // 状态同步机制
-    void setGlobalSoloState(const juce::String& channelName, bool state);
-    void setGlobalMuteState(const juce::String& channelName, bool state);
-    bool getGlobalSoloState(const juce::String& channelName) const;
-    bool getGlobalMuteState(const juce::String& channelName) const;
-    
-    // 广播机制 - 直接调用，零延迟
-    void broadcastStateToSlaves(const juce::String& channelName, const juce::String& action, bool state);
+    // 新Slave加入时的全量同步（applyMasterSnapshot一次性交接）
     void syncAllStatesToSlave(MonitorControllerMaxAudioProcessor* slavePlugin);
     
-    // v4.1: 总线效果状态管理
-    void setGlobalMonoState(bool monoState);
-    bool getGlobalMonoState() const;
-    void broadcastMonoStateToSlaves(bool monoState);
+    // 状态查询（插件所在组）
+    int getSlaveCount(const MonitorControllerMaxAudioProcessor* plugin) const;
+    int getWaitingSlaveCount(const MonitorControllerMaxAudioProcessor* plugin) const;
+    bool hasMaster(const MonitorControllerMaxAudioProcessor* plugin) const;
+    juce::String getConnectionInfo(const MonitorControllerMaxAudioProcessor* plugin) const;
+    MonitorControllerMaxAudioProcessor* getMasterPlugin(const MonitorControllerMaxAudioProcessor* plugin) const;
     
-    // 状态查询
-    int getSlaveCount() const;
-    int getWaitingSlaveCount() const;
-    bool hasMaster() const;
-    juce::String getConnectionInfo() const;
-    MonitorControllerMaxAudioProcessor* getMasterPlugin() const;
+    // 🚀 传播跟踪（插件所在组）：各Slave已应用/已输出的序号、落后量与"发布 -> 音频输出"延迟直方图
+    PropagationReport getPropagationReport(const MonitorControllerMaxAudioProcessor* plugin) const;
     
     // 连接日志管理
     void addConnectionLog(const juce::String& message);
@@ -156,21 +276,53 @@ public:
     juce::String getHealthReport() const;
     void resetHealthCounters();
     uint32_t getTotalExceptions() const { return healthMonitor.exceptionsCaught.load(); }
+    
+    // 注册表锁竞争（累计值，任意线程读取；resetHealthCounters清零）
+    struct LockStats {
+        uint64_t acquisitions = 0;
+        uint64_t contentions = 0;       // 需要等待的获取次数
+        double waitMs = 0.0;            // 累计等待时间
+    };
+    LockStats getLockStats() const noexcept;
+    
+    // 当前注册的插件实例数（无锁）
+    int getRegisteredPluginCount() const noexcept { return registry->getLiveCount(); }
 
 private:
     // 防止复制
     GlobalPluginState(const GlobalPluginState&) = delete;
     GlobalPluginState& operator=(const GlobalPluginState&) = delete;
     
-    // 🚀 生命周期安全：内部辅助方法
-    void cleanupInvalidPlugins();           // 清理失效的插件指针
-    void performHealthyCleanup();           // 定期健康检查和清理
-    void performSafeCleanup();              // 安全的插件清理（双重验证）
-    juce::String generateUniquePluginId(MonitorControllerMaxAudioProcessor* plugin);  // 生成唯一插件ID
-    bool isPluginValid(MonitorControllerMaxAudioProcessor* plugin) const;  // 检查插件是否有效
-    bool isPluginSafeToAccess(MonitorControllerMaxAudioProcessor* plugin) const; // 双重安全检查
-    void invalidatePlugin(MonitorControllerMaxAudioProcessor* plugin);     // 标记插件为无效
-    void removeFromAllLists(MonitorControllerMaxAudioProcessor* plugin);   // 从所有列表中安全移除
-    void notifySlavePluginsAboutMasterLoss();  // 通知Slave插件Master已丢失
+    // 注册表锁获取（带竞争统计）
+    std::unique_lock<std::shared_mutex> lockPluginsExclusive() const;
+    std::shared_lock<std::shared_mutex> lockPluginsShared() const;
+    
+    // 🚀 生命周期安全：内部辅助方法（在已持有pluginsMutex时调用）
+    void performSafeCleanup();              // 从组内列表剔除过期句柄
+    PluginHandle lookupHandle(const MonitorControllerMaxAudioProcessor* plugin) const noexcept;  // 插件未注册时返回空句柄
     juce::String getCurrentTimeString() const;
+    juce::String formatGroupLog(const MasterGroup& group, const juce::String& message) const;
+    
+    // 组管理（在已持有pluginsMutex时调用）
+    std::shared_ptr<MasterGroup> findGroup(PluginHandle handle) const;
+    std::shared_ptr<MasterGroup> getOrCreateGroup(const juce::String& groupName);   // 需独占pluginsMutex
+    void closeAllGroupLinks();
+    
+    // 组内成员操作（在已持有pluginsMutex与group.membersMutex时调用）
+    void removeFromGroup(MasterGroup& group, PluginHandle handle);
+    void notifySlavePluginsAboutMasterLoss(MasterGroup& group);  // 通知组内Slave插件Master已丢失
+    void moveActiveSlavesToWaiting(MasterGroup& group);
+    void addWaitingSlavePlugin(MasterGroup& group, PluginHandle handle);
+    void removeWaitingSlavePlugin(MasterGroup& group, PluginHandle handle);
+    void promoteWaitingSlavesToActive(MasterGroup& group);  // 当Master可用时，将等待中的Slave提升为活跃
+    void syncSnapshotToSlave(MasterGroup& group, PluginHandle slaveHandle);
+    bool hasLocalMaster(const MasterGroup& group) const;
+    bool hasActiveMaster(const MasterGroup& group) const;      // 本进程有效Master或其他进程Master存活
+    PropagationReport buildPropagationReport(const MasterGroup& group) const;
+    int countValid(const std::vector<PluginHandle>& handles) const;
+    
+    // 跨进程链路
+    void openSharedLink(MasterGroup& group);                    // 组创建时调用
+    void handleRemoteMasterState(MasterGroup& group, uint64_t stateWord);   // 链路回调（消息线程）
+    void handleRemoteMasterChanged(MasterGroup& group, bool active);        // 链路回调（消息线程）
 };
\ No newline at end of file
@@ -0,0 +1,112 @@
+﻿/*
+  ==============================================================================
+
+    LockFreeMPSCQueue.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    固定容量无锁多生产者单消费者队列
+
+    - 预分配环形槽位，push/pop零分配、零锁，可在实时线程调用
+    - 每个槽位带序号（Vyukov有界队列），生产者之间只竞争一次CAS
+    - 队列满时push返回false，由调用方决定丢弃策略
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//==============================================================================
+/**
+ * 无锁MPSC队列
+ *
+ * 要求：
+ * - T必须可平凡拷贝（槽位按值覆盖，不调用析构）
+ * - Capacity必须是2的幂
+ * - pop()只能由同一个消费者线程调用
+ */
+template <typename T, size_t Capacity>
+class LockFreeMPSCQueue
+{
+    static_assert(std::is_trivially_copyable<T>::value, "LockFreeMPSCQueue requires trivially copyable items");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    LockFreeMPSCQueue() noexcept
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // 任意线程：入队，队列满时返回false
+    bool push(const T& item) noexcept
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell& cell = cells[position & INDEX_MASK];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0)
+            {
+                // 槽位空闲：抢占写入位置
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.data = item;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;  // 队列已满
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 消费者线程：出队，队列空时返回false
+    bool pop(T& item) noexcept
+    {
+        Cell& cell = cells[dequeuePosition & INDEX_MASK];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+        if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeuePosition + 1) < 0)
+            return false;
+
+        item = cell.data;
+        cell.sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+    static constexpr size_t getCapacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t INDEX_MASK = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        T data{};
+    };
+
+    // 生产者与消费者位置分开在不同缓存行，避免false sharing
+    alignas(64) std::array<Cell, Capacity> cells;
+    alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+    alignas(64) size_t dequeuePosition = 0;
+
+    LockFreeMPSCQueue(const LockFreeMPSCQueue&) = delete;
+    LockFreeMPSCQueue& operator=(const LockFreeMPSCQueue&) = delete;
+};
@@ -0,0 +1,419 @@
+﻿/*
+  ==============================================================================
+
+    LoudnessMatcher.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    响度匹配比较模式实现 - K加权短期响度测量与补偿Trim发布
+
+  ==============================================================================
+*/
+
+#include "LoudnessMatcher.h"
+#include "DebugLogger.h"
+
+//==============================================================================
+LoudnessMatcher::LoudnessMatcher()
+    : juce::Thread("LoudnessMatcher")
+{
+    for (auto& weight : channelWeights)
+        weight.store(1.0f);
+
+    for (int i = 0; i < MAX_TRACKED_STATES; ++i) {
+        publishedKeys[i].store(0);
+        publishedTrims[i].store(0.0f);
+    }
+}
+
+LoudnessMatcher::~LoudnessMatcher()
+{
+    cancelPendingUpdate();
+    release();
+}
+
+//==============================================================================
+void LoudnessMatcher::prepare(double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    // 重新分配前先停止分析线程（prepareToPlay期间音频线程不会调用pushBlock）
+    release();
+
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    samplesPerGatingBlock = juce::jmax(1, juce::roundToInt(currentSampleRate * 0.1));
+
+    // FIFO容量：至少0.5秒或4个音频块，分析线程每20ms消费一次，足够余量
+    const int fifoSize = juce::jmax(juce::roundToInt(currentSampleRate * 0.5),
+                                    maximumExpectedSamplesPerBlock * 4) + 1;
+    fifoBuffer.setSize(MAX_CHANNELS, fifoSize, false, true, false);
+    sampleFifo.setTotalSize(fifoSize);
+    sampleFifo.reset();
+    tagFifo.reset();
+    pendingTagSamples = 0;
+
+    computeKWeightingCoefficients();
+    resetAnalysis();
+
+    prepared.store(true, std::memory_order_release);
+    startThread(juce::Thread::Priority::low);
+
+    VST3_DBG_DETAIL("LoudnessMatcher: Prepared - sampleRate: " + juce::String(currentSampleRate) +
+                    ", fifo: " + juce::String(fifoSize) + " samples");
+}
+
+void LoudnessMatcher::release()
+{
+    prepared.store(false, std::memory_order_release);
+    stopThread(1000);
+}
+
+//==============================================================================
+void LoudnessMatcher::pushBlock(const juce::AudioBuffer<float>& buffer, int numSamples,
+                                uint32_t comparisonKey, float appliedGainDb) noexcept
+{
+    if (!prepared.load(std::memory_order_acquire) || !active.load(std::memory_order_relaxed))
+        return;
+
+    // FIFO空间不足时整块丢弃（样本和Tag成对写入，保证对齐）
+    if (numSamples <= 0 || tagFifo.getFreeSpace() < 1 || sampleFifo.getFreeSpace() < numSamples) {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), MAX_CHANNELS);
+
+    // 先写样本，再写Tag：分析线程读到Tag时对应样本一定已就绪
+    int start1, size1, start2, size2;
+    sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        if (size1 > 0) fifoBuffer.copyFrom(ch, start1, buffer, ch, 0, size1);
+        if (size2 > 0) fifoBuffer.copyFrom(ch, start2, buffer, ch, size1, size2);
+    }
+    sampleFifo.finishedWrite(size1 + size2);
+
+    tagFifo.prepareToWrite(1, start1, size1, start2, size2);
+    auto& tag = tagBuffer[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+    tag.numSamples = numSamples;
+    tag.comparisonKey = comparisonKey;
+    tag.appliedGainDb = appliedGainDb;
+    tagFifo.finishedWrite(1);
+}
+
+//==============================================================================
+void LoudnessMatcher::setActive(bool shouldBeActive, uint32_t newReferenceKey)
+{
+    referenceKey.store(newReferenceKey, std::memory_order_release);
+    resetRequested.store(true, std::memory_order_release);
+    active.store(shouldBeActive, std::memory_order_release);
+
+    VST3_DBG_IMPORTANT("LoudnessMatcher: " + juce::String(shouldBeActive ? "Enabled" : "Disabled") +
+                       " - reference state 0x" + juce::String::toHexString(static_cast<int>(newReferenceKey)));
+}
+
+void LoudnessMatcher::setChannelWeight(int channelIndex, float weight) noexcept
+{
+    if (channelIndex >= 0 && channelIndex < MAX_CHANNELS)
+        channelWeights[static_cast<size_t>(channelIndex)].store(weight, std::memory_order_relaxed);
+}
+
+float LoudnessMatcher::getChannelWeightForName(const juce::String& channelName)
+{
+    // LFE和SUB不参与响度计算（BS.1770）
+    if (channelName == "LFE" || channelName.contains("SUB"))
+        return 0.0f;
+
+    // 环绕声道权重 +1.5dB
+    static const juce::StringArray surroundChannels{ "LR", "RR", "LSS", "RSS", "LRS", "RRS" };
+    if (surroundChannels.contains(channelName))
+        return 1.41f;
+
+    return 1.0f;
+}
+
+float LoudnessMatcher::getTrimDbForKey(uint32_t comparisonKey) const noexcept
+{
+    if (!active.load(std::memory_order_acquire) || resetRequested.load(std::memory_order_acquire))
+        return 0.0f;
+
+    for (int i = 0; i < MAX_TRACKED_STATES; ++i) {
+        if (publishedKeys[i].load(std::memory_order_acquire) == comparisonKey)
+            return publishedTrims[i].load(std::memory_order_relaxed);
+    }
+
+    return 0.0f;
+}
+
+//==============================================================================
+void LoudnessMatcher::run()
+{
+    while (!threadShouldExit())
+    {
+        if (resetRequested.load(std::memory_order_acquire)) {
+            resetAnalysis();
+            resetRequested.store(false, std::memory_order_release);
+            triggerAsyncUpdate();  // 清空后的Trim（0dB）需要同步到渲染快照
+        }
+
+        processPendingBlocks();
+
+        wait(20);
+    }
+}
+
+void LoudnessMatcher::handleAsyncUpdate()
+{
+    if (onTrimChanged)
+        onTrimChanged();
+}
+
+//==============================================================================
+void LoudnessMatcher::processPendingBlocks()
+{
+    while (!threadShouldExit())
+    {
+        // 取下一个块的Tag
+        if (pendingTagSamples == 0) {
+            if (tagFifo.getNumReady() == 0)
+                break;
+
+            int start1, size1, start2, size2;
+            tagFifo.prepareToRead(1, start1, size1, start2, size2);
+            pendingTag = tagBuffer[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+            tagFifo.finishedRead(1);
+            pendingTagSamples = pendingTag.numSamples;
+        }
+
+        const int toRead = juce::jmin(pendingTagSamples, sampleFifo.getNumReady());
+        if (toRead <= 0)
+            break;
+
+        int start1, size1, start2, size2;
+        sampleFifo.prepareToRead(toRead, start1, size1, start2, size2);
+
+        // 未激活时只消费数据保持样本与Tag对齐，不做分析
+        if (active.load(std::memory_order_acquire)) {
+            if (size1 > 0) analyseSamples(pendingTag, start1, size1);
+            if (size2 > 0) analyseSamples(pendingTag, start2, size2);
+        }
+
+        sampleFifo.finishedRead(size1 + size2);
+        pendingTagSamples -= (size1 + size2);
+    }
+}
+
+void LoudnessMatcher::analyseSamples(const BlockTag& tag, int start, int size)
+{
+    // 比较状态切换：重新开始短期窗口（滤波器状态保持连续）
+    if (tag.comparisonKey != currentKey) {
+        currentKey = tag.comparisonKey;
+        gatingBlockEnergy = 0.0;
+        gatingBlockSamples = 0;
+        shortTermWriteIndex = 0;
+        shortTermCount = 0;
+    }
+
+    // 扣除已应用的补偿和Master电平，测量的是补偿前的响度（避免反馈）
+    const double gainCorrection = std::pow(10.0, -static_cast<double>(tag.appliedGainDb) / 10.0);
+
+    while (size > 0)
+    {
+        const int n = juce::jmin(size, samplesPerGatingBlock - gatingBlockSamples);
+
+        double energy = 0.0;
+        for (int ch = 0; ch < MAX_CHANNELS; ++ch) {
+            const float weight = channelWeights[static_cast<size_t>(ch)].load(std::memory_order_relaxed);
+            if (weight <= 0.0f) continue;
+
+            auto& pre = preFilters[static_cast<size_t>(ch)];
+            auto& rlb = rlbFilters[static_cast<size_t>(ch)];
+            const float* data = fifoBuffer.getReadPointer(ch, start);
+
+            double sumSquares = 0.0;
+            for (int s = 0; s < n; ++s) {
+                const double y = rlb.process(pre.process(static_cast<double>(data[s])));
+                sumSquares += y * y;
+            }
+            energy += weight * sumSquares;
+        }
+
+        gatingBlockEnergy += energy * gainCorrection;
+        gatingBlockSamples += n;
+        start += n;
+        size -= n;
+
+        if (gatingBlockSamples >= samplesPerGatingBlock)
+            finishGatingBlock();
+    }
+}
+
+void LoudnessMatcher::finishGatingBlock()
+{
+    const double meanSquare = gatingBlockEnergy / static_cast<double>(juce::jmax(1, gatingBlockSamples));
+    gatingBlockEnergy = 0.0;
+    gatingBlockSamples = 0;
+
+    // 绝对门限 -70 LUFS：静音块不参与测量
+    if (meanSquare <= 0.0 || -0.691 + 10.0 * std::log10(meanSquare) < -70.0)
+        return;
+
+    shortTermWindow[static_cast<size_t>(shortTermWriteIndex)] = meanSquare;
+    shortTermWriteIndex = (shortTermWriteIndex + 1) % SHORT_TERM_BLOCKS;
+    shortTermCount = juce::jmin(shortTermCount + 1, SHORT_TERM_BLOCKS);
+
+    if (shortTermCount < MIN_BLOCKS_FOR_ESTIMATE)
+        return;
+
+    double sum = 0.0;
+    for (int i = 0; i < shortTermCount; ++i)
+        sum += shortTermWindow[static_cast<size_t>(i)];
+
+    const double shortTermLoudness = -0.691 + 10.0 * std::log10(sum / shortTermCount);
+    updateMeasurement(currentKey, shortTermLoudness);
+}
+
+void LoudnessMatcher::updateMeasurement(uint32_t key, double shortTermLoudness)
+{
+    ++measurementClock;
+
+    // 查找该状态的槽位，没有则替换最久未使用的
+    StateMeasurement* slot = nullptr;
+    for (auto& m : measurements) {
+        if (m.valid && m.key == key) { slot = &m; break; }
+    }
+
+    if (slot == nullptr) {
+        slot = &measurements[0];
+        for (auto& m : measurements) {
+            if (!m.valid) { slot = &m; break; }
+            if (m.lastUsed < slot->lastUsed) slot = &m;
+        }
+        slot->key = key;
+        slot->loudness = shortTermLoudness;
+        slot->valid = true;
+    }
+
+    // 轻度平滑，抑制节目内容本身的短期起伏
+    slot->loudness += 0.2 * (shortTermLoudness - slot->loudness);
+    slot->lastUsed = measurementClock;
+
+    publishTrims();
+}
+
+void LoudnessMatcher::publishTrims()
+{
+    const uint32_t refKey = referenceKey.load(std::memory_order_acquire);
+
+    const StateMeasurement* reference = nullptr;
+    for (const auto& m : measurements) {
+        if (m.valid && m.key == refKey) { reference = &m; break; }
+    }
+
+    if (reference == nullptr)
+        return;
+
+    bool changed = false;
+    for (const auto& m : measurements) {
+        if (!m.valid || m.key == refKey) continue;
+
+        const float trimDb = juce::jlimit(-MAX_TRIM_DB, MAX_TRIM_DB,
+                                          static_cast<float>(reference->loudness - m.loudness));
+
+        const float currentTrim = getTrimDbForKey(m.key);
+        if (std::abs(trimDb - currentTrim) >= TRIM_UPDATE_THRESHOLD_DB) {
+            publishTrim(m.key, trimDb);
+            changed = true;
+        }
+    }
+
+    if (changed)
+        triggerAsyncUpdate();
+}
+
+void LoudnessMatcher::publishTrim(uint32_t key, float trimDb)
+{
+    // 已有槽位：直接更新Trim
+    for (int i = 0; i < MAX_TRACKED_STATES; ++i) {
+        if (publishedKeys[i].load(std::memory_order_relaxed) == key) {
+            publishedTrims[i].store(trimDb, std::memory_order_release);
+            return;
+        }
+    }
+
+    // 新槽位：只发布仍在测量表中的状态，先作废Key再写Trim，避免读到错配的数据
+    int target = 0;
+    for (int i = 0; i < MAX_TRACKED_STATES; ++i) {
+        const uint32_t existing = publishedKeys[i].load(std::memory_order_relaxed);
+        bool stillTracked = false;
+        for (const auto& m : measurements)
+            stillTracked = stillTracked || (m.valid && m.key == existing);
+
+        if (existing == 0 || !stillTracked) { target = i; break; }
+    }
+
+    publishedKeys[target].store(0, std::memory_order_release);
+    publishedTrims[target].store(trimDb, std::memory_order_release);
+    publishedKeys[target].store(key, std::memory_order_release);
+}
+
+void LoudnessMatcher::resetAnalysis()
+{
+    for (auto& f : preFilters) f.reset();
+    for (auto& f : rlbFilters) f.reset();
+
+    gatingBlockEnergy = 0.0;
+    gatingBlockSamples = 0;
+    shortTermWriteIndex = 0;
+    shortTermCount = 0;
+    currentKey = 0;
+
+    for (auto& m : measurements)
+        m = StateMeasurement{};
+
+    for (int i = 0; i < MAX_TRACKED_STATES; ++i) {
+        publishedKeys[i].store(0, std::memory_order_release);
+        publishedTrims[i].store(0.0f, std::memory_order_release);
+    }
+}
+
+//==============================================================================
+void LoudnessMatcher::computeKWeightingCoefficients()
+{
+    // ITU-R BS.1770 K加权滤波器，按实际采样率重新推导（非48kHz时保持正确响应）
+    const double fs = currentSampleRate;
+
+    // 第1级：高架滤波（头部声学效应）
+    {
+        const double f0 = 1681.974450955533;
+        const double G = 3.999843853973347;
+        const double Q = 0.7071752369554196;
+        const double K = std::tan(juce::MathConstants<double>::pi * f0 / fs);
+        const double Vh = std::pow(10.0, G / 20.0);
+        const double Vb = std::pow(Vh, 0.4996667741545416);
+        const double a0 = 1.0 + K / Q + K * K;
+
+        Biquad pre;
+        pre.b0 = (Vh + Vb * K / Q + K * K) / a0;
+        pre.b1 = 2.0 * (K * K - Vh) / a0;
+        pre.b2 = (Vh - Vb * K / Q + K * K) / a0;
+        pre.a1 = 2.0 * (K * K - 1.0) / a0;
+        pre.a2 = (1.0 - K / Q + K * K) / a0;
+
+        preFilters.fill(pre);
+    }
+
+    // 第2级：RLB高通
+    {
+        const double f0 = 38.13547087602444;
+        const double Q = 0.5003270373238773;
+        const double K = std::tan(juce::MathConstants<double>::pi * f0 / fs);
+        const double a0 = 1.0 + K / Q + K * K;
+
+        Biquad rlb;
+        rlb.b0 = 1.0;
+        rlb.b1 = -2.0;
+        rlb.b2 = 1.0;
+        rlb.a1 = 2.0 * (K * K - 1.0) / a0;
+        rlb.a2 = (1.0 - K / Q + K * K) / a0;
+
+        rlbFilters.fill(rlb);
+    }
+}
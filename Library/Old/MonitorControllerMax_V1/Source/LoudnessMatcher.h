@@ -0,0 +1,172 @@
+﻿/*
+  ==============================================================================
+
+    LoudnessMatcher.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    响度匹配比较模式 - 自动电平补偿
+
+    比较Mono与全布局、或不同扬声器组合时，电平差会影响听感判断。
+    本模块在后台线程测量每个比较状态的短期响度（ITU-R BS.1770 K加权，3秒窗口），
+    计算相对参考状态的补偿Trim，由StateManager折算进RenderState的通道增益。
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <array>
+#include <functional>
+
+//==============================================================================
+/**
+ * 响度匹配器
+ *
+ * 线程模型：
+ * - 音频线程：pushBlock() 只把输出块拷贝进无锁FIFO（AbstractFifo），零锁零分配
+ * - 分析线程：低优先级后台线程，K加权滤波 + 100ms块能量 + 3秒短期响度
+ * - 消息线程：通过AsyncUpdater接收Trim变化，触发RenderState重建
+ *
+ * 比较状态用comparisonKey标识（由StateManager根据Mute/Mono状态计算），
+ * 开启匹配时的状态作为参考，其余状态的Trim = 参考响度 - 状态响度。
+ * 音频线程除了已有的通道增益系数外不做任何额外的增益运算。
+ */
+class LoudnessMatcher : private juce::Thread,
+                        private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    LoudnessMatcher();
+    ~LoudnessMatcher() override;
+
+    //==============================================================================
+    // 生命周期（prepareToPlay / releaseResources调用）
+    void prepare(double sampleRate, int maximumExpectedSamplesPerBlock);
+    void release();
+
+    //==============================================================================
+    // 音频线程接口：仅写入FIFO（FIFO满时丢弃该块，分析结果不受影响）
+    // appliedGainDb: 本块已应用的补偿Trim与Master电平之和，分析线程会扣除
+    void pushBlock(const juce::AudioBuffer<float>& buffer, int numSamples,
+                   uint32_t comparisonKey, float appliedGainDb) noexcept;
+
+    //==============================================================================
+    // 消息线程接口
+    void setActive(bool shouldBeActive, uint32_t referenceKey);
+    bool isActive() const noexcept { return active.load(std::memory_order_acquire); }
+
+    // 通道响度权重（BS.1770：环绕声道1.41，LFE/SUB排除）
+    void setChannelWeight(int channelIndex, float weight) noexcept;
+    static float getChannelWeightForName(const juce::String& channelName);
+
+    // 查询某比较状态的补偿Trim（未测量或未激活时返回0dB）
+    float getTrimDbForKey(uint32_t comparisonKey) const noexcept;
+
+    // Trim发生变化时在消息线程回调（用于重建RenderState）
+    std::function<void()> onTrimChanged;
+
+    //==============================================================================
+    // 常量
+    static constexpr int MAX_CHANNELS = 26;
+    static constexpr int MAX_TRACKED_STATES = 16;     // 同时跟踪的比较状态数量
+    static constexpr float MAX_TRIM_DB = 12.0f;       // 补偿范围 ±12dB
+    static constexpr float TRIM_UPDATE_THRESHOLD_DB = 0.2f; // 小于此变化不发布，保证0.5LU内且避免频繁重建
+
+private:
+    //==============================================================================
+    // juce::Thread / juce::AsyncUpdater
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    //==============================================================================
+    // 二阶IIR（Direct Form I），仅分析线程使用
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+
+        inline double process(double x) noexcept
+        {
+            const double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1; x1 = x;
+            y2 = y1; y1 = y;
+            return y;
+        }
+
+        void reset() noexcept { x1 = x2 = y1 = y2 = 0.0; }
+    };
+
+    // FIFO中每个音频块的元数据
+    struct BlockTag
+    {
+        int numSamples = 0;
+        uint32_t comparisonKey = 0;
+        float appliedGainDb = 0.0f;
+    };
+
+    // 分析线程中每个比较状态的测量结果
+    struct StateMeasurement
+    {
+        uint32_t key = 0;
+        double loudness = -100.0;   // 平滑后的短期响度 (LUFS)
+        bool valid = false;
+        uint32_t lastUsed = 0;
+    };
+
+    //==============================================================================
+    // 分析线程方法
+    void processPendingBlocks();
+    void analyseSamples(const BlockTag& tag, int start, int size);
+    void finishGatingBlock();
+    void updateMeasurement(uint32_t key, double shortTermLoudness);
+    void publishTrims();
+    void resetAnalysis();
+    void computeKWeightingCoefficients();
+    void publishTrim(uint32_t key, float trimDb);
+
+    //==============================================================================
+    // 音频线程 -> 分析线程的无锁FIFO
+    juce::AbstractFifo sampleFifo{ 1 };
+    juce::AudioBuffer<float> fifoBuffer;
+    juce::AbstractFifo tagFifo{ 256 };
+    std::array<BlockTag, 256> tagBuffer;
+    int pendingTagSamples = 0;    // 已读取Tag但样本还未消耗完的剩余数
+    BlockTag pendingTag;
+
+    std::atomic<bool> prepared{ false };
+    std::atomic<bool> active{ false };
+    std::atomic<bool> resetRequested{ false };
+    std::atomic<uint32_t> referenceKey{ 0 };
+    std::atomic<uint32_t> droppedBlocks{ 0 };
+    std::array<std::atomic<float>, MAX_CHANNELS> channelWeights;
+
+    //==============================================================================
+    // 分析线程状态
+    double currentSampleRate = 48000.0;
+    std::array<Biquad, MAX_CHANNELS> preFilters;   // K加权第1级：高架
+    std::array<Biquad, MAX_CHANNELS> rlbFilters;   // K加权第2级：RLB高通
+    double gatingBlockEnergy = 0.0;                // 当前100ms块的加权能量和
+    int gatingBlockSamples = 0;
+    int samplesPerGatingBlock = 4800;
+    uint32_t currentKey = 0;
+
+    static constexpr int SHORT_TERM_BLOCKS = 30;   // 3秒 = 30 × 100ms
+    static constexpr int MIN_BLOCKS_FOR_ESTIMATE = 10; // 至少1秒数据才给出估计
+    std::array<double, SHORT_TERM_BLOCKS> shortTermWindow{};
+    int shortTermWriteIndex = 0;
+    int shortTermCount = 0;
+
+    std::array<StateMeasurement, MAX_TRACKED_STATES> measurements;
+    uint32_t measurementClock = 0;
+
+    //==============================================================================
+    // 分析线程 -> 消息线程的发布表（key/trim原子对，key=0表示空槽）
+    std::array<std::atomic<uint32_t>, MAX_TRACKED_STATES> publishedKeys;
+    std::array<std::atomic<float>, MAX_TRACKED_STATES> publishedTrims;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMatcher)
+};
@@ -58,6 +58,11 @@ void MasterBusProcessor::prepare(double sampleRate, int maximumExpectedSamplesPe
 //==============================================================================
 void MasterBusProcessor::process(juce::AudioBuffer<float>& buffer, PluginRole currentRole, const bool* channelIsSUB)
 {
+    // 🚀 只读实时镜像：消息线程setter与OSC接收线程都会写入，本块开始时取一次快照
+    const bool muteNow = realtimeMasterMute.load(std::memory_order_relaxed);
+    const bool monoNow = realtimeMono.load(std::memory_order_relaxed);
+    const bool lowBoostNow = realtimeLowBoost.load(std::memory_order_relaxed);
+    
     // 计算当前Master Level (基于JSFX算法)
     float masterLevel = calculateMasterLevel();
     
@@ -65,7 +70,7 @@ void MasterBusProcessor::process(juce::AudioBuffer<float>& buffer, PluginRole cu
     int numSamples = buffer.getNumSamples();
     
     // v4.1: 检查Master Mute状态 - 如果激活则静音所有通道
-    if (masterMuteActive)
+    if (muteNow)
     {
         // Master Mute激活时，静音所有通道
         for (int channel = 0; channel < totalChannels; ++channel)
@@ -78,7 +83,7 @@ void MasterBusProcessor::process(juce::AudioBuffer<float>& buffer, PluginRole cu
     // v4.1: 处理Mono效果 - 将所有非SUB通道混合成单声道并复制到所有非SUB通道
     // 重要：Mono处理只在Slave/Standalone模式下进行 (pre-calibration)
     // 🚀 稳定性优化：使用预分配缓冲区，消除音频线程中的内存分配
-    if (monoActive && processorPtr && 
+    if (monoNow && processorPtr && 
         (currentRole == PluginRole::Slave || currentRole == PluginRole::Standalone))
     {
         // 边界检查：确保不超过预分配缓冲区大小
@@ -150,7 +155,7 @@ void MasterBusProcessor::process(juce::AudioBuffer<float>& buffer, PluginRole cu
         float channelGain = masterLevel;
         
         // v4.1: 检查是否是SUB通道并应用Low Boost
-        if (lowBoostActive && channelIsSUB != nullptr)
+        if (lowBoostNow && channelIsSUB != nullptr)
         {
             // 使用预计算的SUB映射，避免音频线程中的字符串操作
             bool isSUBChannel = (channel < 26) ? channelIsSUB[channel] : false;
@@ -176,6 +181,7 @@ void MasterBusProcessor::setMasterGainPercent(float gainPercent)
 {
     // 限制范围到0-100%
     masterGainPercent = juce::jlimit(0.0f, 100.0f, gainPercent);
+    realtimeGainPercent.store(masterGainPercent, std::memory_order_relaxed);
     
     if (processorPtr)
     {
@@ -189,6 +195,7 @@ void MasterBusProcessor::setDimActive(bool active)
     if (dimActive != active)
     {
         dimActive = active;
+        realtimeDim.store(active, std::memory_order_relaxed);
         
         if (processorPtr)
         {
@@ -213,6 +220,7 @@ void MasterBusProcessor::setLowBoostActive(bool active)
     if (lowBoostActive != active)
     {
         lowBoostActive = active;
+        realtimeLowBoost.store(active, std::memory_order_relaxed);
         
         if (processorPtr)
         {
@@ -237,6 +245,7 @@ void MasterBusProcessor::setMasterMuteActive(bool active)
     if (masterMuteActive != active)
     {
         masterMuteActive = active;
+        realtimeMasterMute.store(active, std::memory_order_relaxed);
         
         if (processorPtr)
         {
@@ -261,6 +270,7 @@ void MasterBusProcessor::setMonoActive(bool active)
     if (monoActive != active)
     {
         monoActive = active;
+        realtimeMono.store(active, std::memory_order_relaxed);
         
         if (processorPtr)
         {
@@ -270,19 +280,18 @@ void MasterBusProcessor::setMonoActive(bool active)
             // v4.1: 发送OSC Mono状态 (通过PluginProcessor发送，确保角色检查)
             processorPtr->sendMonoOSCState(monoActive);
             
-            // v4.1: Master-Slave状态同步 - 只有Master/Standalone可以控制全局状态
-            if (processorPtr->getCurrentRole() == PluginRole::Master || 
-                processorPtr->getCurrentRole() == PluginRole::Standalone)
+            // v4.1: Master-Slave状态同步 - 只有Master发布组状态，Standalone只改本地状态
+            if (processorPtr->getCurrentRole() == PluginRole::Master)
             {
-                // 更新全局状态
-                auto& globalState = GlobalPluginState::getRef();
-                globalState.setGlobalMonoState(monoActive);
-                
-                // 如果是Master模式，广播状态到所有Slave
-                if (processorPtr->getCurrentRole() == PluginRole::Master)
-                {
-                    globalState.broadcastMonoStateToSlaves(monoActive);
-                }
+                // 更新本组状态（同时发布到Master状态快照，Slave定时拉取）
+                if (auto* group = processorPtr->getMasterGroup())
+                    group->setMonoState(monoActive);
+            }
+            
+            // Mono属于比较状态的一部分，重建渲染快照（响度匹配Trim按状态切换）
+            if (processorPtr->stateManager)
+            {
+                processorPtr->stateManager->refreshRenderState();
             }
         }
         
@@ -403,6 +412,33 @@ void MasterBusProcessor::handleOSCMono(bool monoState)
     }
 }
 
+void MasterBusProcessor::applyRealtimeOSC(OSCAddressTable::MasterControl control, float value) noexcept
+{
+    // 🚀 OSC接收线程调用：只写音频线程读取的实时镜像，下一个音频块立即生效
+    // 内部状态、UI与OSC反馈随后由消息线程通过handleOSC*()同步，这里不记录日志、不分配内存
+    switch (control)
+    {
+        case OSCAddressTable::MasterControl::Volume:
+            realtimeGainPercent.store(juce::jlimit(0.0f, 100.0f, value), std::memory_order_relaxed);
+            break;
+        case OSCAddressTable::MasterControl::Dim:
+            realtimeDim.store(value > 0.5f, std::memory_order_relaxed);
+            break;
+        case OSCAddressTable::MasterControl::LowBoost:
+            realtimeLowBoost.store(value > 0.5f, std::memory_order_relaxed);
+            break;
+        case OSCAddressTable::MasterControl::Mute:
+            realtimeMasterMute.store(value > 0.5f, std::memory_order_relaxed);
+            break;
+        case OSCAddressTable::MasterControl::Mono:
+            realtimeMono.store(value > 0.5f, std::memory_order_relaxed);
+            break;
+        case OSCAddressTable::MasterControl::NumControls:
+        default:
+            break;
+    }
+}
+
 //==============================================================================
 float MasterBusProcessor::getCurrentMasterLevel() const
 {
@@ -442,8 +478,8 @@ float MasterBusProcessor::calculateMasterLevel() const
     // 基于JSFX算法: Level_Master = (slider99 * scale) * (Dim_Master ? 0.16 : 1)
     // 其中 scale = 0.01, slider99 = 0-100
     
-    float baseLevel = masterGainPercent * SCALE_FACTOR;  // 0-100% -> 0.0-1.0
-    float dimFactor = dimActive ? DIM_FACTOR : 1.0f;     // Dim时衰减到16%
+    float baseLevel = realtimeGainPercent.load(std::memory_order_relaxed) * SCALE_FACTOR;  // 0-100% -> 0.0-1.0
+    float dimFactor = realtimeDim.load(std::memory_order_relaxed) ? DIM_FACTOR : 1.0f;      // Dim时衰减到16%
     
     return baseLevel * dimFactor;
 }
\ No newline at end of file
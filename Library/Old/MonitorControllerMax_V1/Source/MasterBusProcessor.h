@@ -15,6 +15,8 @@
 
 #include <JuceHeader.h>
 #include "DebugLogger.h"
+#include "OSCAddressTable.h"
+#include <atomic>
 
 // 前向声明避免循环引用
 class MonitorControllerMaxAudioProcessor;
@@ -82,6 +84,9 @@ public:
     void handleOSCMasterMute(bool masterMuteState);
     void handleOSCMono(bool monoState);
     
+    // 🚀 OSC接收线程的实时路径：value为Volume百分比(0-100)或开关值(>0.5为ON)
+    void applyRealtimeOSC(OSCAddressTable::MasterControl control, float value) noexcept;
+    
     //==============================================================================
     // 状态查询
     float getCurrentMasterLevel() const;
@@ -118,6 +123,13 @@ private:
     bool masterMuteActive = false;      // Master Mute状态 (内部状态，不持久化)
     bool monoActive = false;            // Mono状态 (内部状态，不持久化)
     
+    // 🚀 音频线程读取的实时镜像：setter同步写入，OSC接收线程可提前写入（不等消息线程）
+    std::atomic<float> realtimeGainPercent{ 100.0f };
+    std::atomic<bool> realtimeDim{ false };
+    std::atomic<bool> realtimeLowBoost{ false };
+    std::atomic<bool> realtimeMasterMute{ false };
+    std::atomic<bool> realtimeMono{ false };
+    
     //==============================================================================
     // 音频处理常量 (基于JSFX实现)
     static constexpr float DIM_FACTOR = 0.16f;  // Dim时的衰减因子 (16%)
@@ -0,0 +1,519 @@
+﻿/*
+  ==============================================================================
+
+    OSCAddressTable.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC地址表实现 - 编译期完美哈希 + 按段分发的入站解析 + 地址模式匹配
+
+  ==============================================================================
+*/
+
+#include "OSCAddressTable.h"
+#include <cstring>
+
+namespace
+{
+    //==============================================================================
+    // 已知语义通道（与Speaker_Config.json一致；旧版"SUB_L"等经'_'->空格归一后即为"SUB L"）
+    // 数组下标即通道ID
+    constexpr const char* channelNameLiterals[OSCAddressTable::NUM_CHANNEL_IDS] = {
+        // 主声道
+        "L", "R", "C", "LFE", "LR", "RR",
+        "LSS", "RSS", "LRS", "RRS",
+        "LTF", "RTF", "LTB", "RTB",
+        "LBF", "RBF", "LBB", "RBB",
+        // SUB通道
+        "SUB F", "SUB B", "SUB L", "SUB R", "SUB M"
+    };
+
+    constexpr size_t literalLength(const char* text) noexcept
+    {
+        size_t length = 0;
+        while (text[length] != '\0')
+            ++length;
+        return length;
+    }
+
+    //==============================================================================
+    // 完美哈希：FNV-1a（'_'按空格计算）取模64，种子离线搜索得到，static_assert保证无冲突
+    constexpr uint32_t HASH_SEED = 7;
+    constexpr uint32_t HASH_TABLE_SIZE = 64;
+
+    constexpr char normaliseChannelChar(char c) noexcept
+    {
+        return c == '_' ? ' ' : c;
+    }
+
+    constexpr uint32_t hashChannelName(const char* name, size_t length) noexcept
+    {
+        uint32_t hash = 2166136261u ^ HASH_SEED;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<uint8_t>(normaliseChannelChar(name[i]));
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    constexpr uint32_t slotForChannelId(int channelId) noexcept
+    {
+        const char* name = channelNameLiterals[channelId];
+        return hashChannelName(name, literalLength(name)) % HASH_TABLE_SIZE;
+    }
+
+    constexpr bool isHashCollisionFree() noexcept
+    {
+        bool used[HASH_TABLE_SIZE] = {};
+        for (int id = 0; id < OSCAddressTable::NUM_CHANNEL_IDS; ++id)
+        {
+            const uint32_t slot = slotForChannelId(id);
+            if (used[slot])
+                return false;
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    static_assert(isHashCollisionFree(), "Channel name hash collides - search a new HASH_SEED");
+
+    struct HashSlots
+    {
+        int8_t channelIds[HASH_TABLE_SIZE];
+    };
+
+    constexpr HashSlots buildHashSlots() noexcept
+    {
+        HashSlots slots{};
+        for (uint32_t i = 0; i < HASH_TABLE_SIZE; ++i)
+            slots.channelIds[i] = static_cast<int8_t>(OSCAddressTable::INVALID_CHANNEL_ID);
+
+        for (int id = 0; id < OSCAddressTable::NUM_CHANNEL_IDS; ++id)
+            slots.channelIds[slotForChannelId(id)] = static_cast<int8_t>(id);
+
+        return slots;
+    }
+
+    constexpr HashSlots hashSlots = buildHashSlots();
+
+    //==============================================================================
+    // 地址段比较（不构造字符串）
+    template <size_t N>
+    bool segmentEquals(const char* segment, size_t length, const char (&literal)[N]) noexcept
+    {
+        return length == N - 1 && std::memcmp(segment, literal, N - 1) == 0;
+    }
+
+    //==============================================================================
+    // OSC 1.0 地址模式匹配（单个地址段内）：'_'与空格等价
+    bool matchPattern(const char* pattern, size_t patternLength, const char* name, size_t nameLength) noexcept
+    {
+        size_t p = 0;
+        size_t n = 0;
+
+        while (p < patternLength)
+        {
+            const char c = pattern[p];
+
+            if (c == '*')
+            {
+                while (p < patternLength && pattern[p] == '*')
+                    ++p;
+
+                if (p == patternLength)
+                    return true;
+
+                for (size_t k = n; k <= nameLength; ++k)
+                    if (matchPattern(pattern + p, patternLength - p, name + k, nameLength - k))
+                        return true;
+
+                return false;
+            }
+
+            if (c == '{')
+            {
+                const auto* close = static_cast<const char*>(std::memchr(pattern + p, '}', patternLength - p));
+                if (close == nullptr)
+                    return false;
+
+                const size_t closeIndex = static_cast<size_t>(close - pattern);
+                const char* rest = close + 1;
+                const size_t restLength = patternLength - closeIndex - 1;
+
+                // 逐个尝试备选项，每个备选项后接模式剩余部分
+                size_t optionStart = p + 1;
+                for (size_t q = p + 1; q <= closeIndex; ++q)
+                {
+                    if (q != closeIndex && pattern[q] != ',')
+                        continue;
+
+                    const size_t optionLength = q - optionStart;
+                    bool optionMatches = n + optionLength <= nameLength;
+                    for (size_t i = 0; optionMatches && i < optionLength; ++i)
+                        optionMatches = normaliseChannelChar(pattern[optionStart + i]) == normaliseChannelChar(name[n + i]);
+
+                    if (optionMatches && matchPattern(rest, restLength, name + n + optionLength, nameLength - n - optionLength))
+                        return true;
+
+                    optionStart = q + 1;
+                }
+
+                return false;
+            }
+
+            if (n >= nameLength)
+                return false;
+
+            const char current = normaliseChannelChar(name[n]);
+
+            if (c == '[')
+            {
+                size_t q = p + 1;
+                const bool negate = q < patternLength && pattern[q] == '!';
+                if (negate)
+                    ++q;
+
+                bool inSet = false;
+                while (q < patternLength && pattern[q] != ']')
+                {
+                    if (q + 2 < patternLength && pattern[q + 1] == '-' && pattern[q + 2] != ']')
+                    {
+                        inSet = inSet || (normaliseChannelChar(pattern[q]) <= current && current <= normaliseChannelChar(pattern[q + 2]));
+                        q += 3;
+                    }
+                    else
+                    {
+                        inSet = inSet || normaliseChannelChar(pattern[q]) == current;
+                        ++q;
+                    }
+                }
+
+                if (q >= patternLength || inSet == negate)
+                    return false;  // 未闭合，或字符不在集合中
+
+                p = q + 1;
+                ++n;
+                continue;
+            }
+
+            if (c != '?' && normaliseChannelChar(c) != current)
+                return false;
+
+            ++p;
+            ++n;
+        }
+
+        return n == nameLength;
+    }
+
+    uint32_t compileChannelPattern(const char* pattern, size_t length) noexcept
+    {
+        uint32_t mask = 0;
+        for (int id = 0; id < OSCAddressTable::NUM_CHANNEL_IDS; ++id)
+        {
+            const char* name = channelNameLiterals[id];
+            if (matchPattern(pattern, length, name, literalLength(name)))
+                mask |= (1u << id);
+        }
+        return mask;
+    }
+
+    // 模式缓存：直接映射，每个线程一份（只有共享OSC接收线程和基准测试会用到），无锁无分配
+    constexpr size_t PATTERN_CACHE_SIZE = 32;
+    constexpr size_t MAX_CACHED_PATTERN_BYTES = 48;
+
+    struct PatternCacheEntry
+    {
+        uint32_t hash = 0;
+        uint32_t mask = 0;
+        uint8_t length = 0;
+        char pattern[MAX_CACHED_PATTERN_BYTES] = {};
+    };
+
+    thread_local std::array<PatternCacheEntry, PATTERN_CACHE_SIZE> patternCache{};
+
+    constexpr char ADDRESS_PREFIX[] = "/Monitor/";
+    constexpr size_t ADDRESS_PREFIX_LENGTH = sizeof(ADDRESS_PREFIX) - 1;
+
+    // 旧的字符串拼接/解析方式，只用于基准对比
+    juce::String formatWithStrings(const juce::String& action, const juce::String& channelName)
+    {
+        return "/Monitor/" + action + "/" + channelName.replaceCharacter(' ', '_');
+    }
+
+    juce::String parseWithStrings(const juce::String& address)
+    {
+        if (!address.startsWith("/Monitor/"))
+            return {};
+
+        const juce::String content = address.substring(9);
+        const int slashPos = content.indexOf("/");
+        return slashPos < 0 ? juce::String() : content.substring(slashPos + 1).replaceCharacter('_', ' ');
+    }
+}
+
+//==============================================================================
+void OSCAddressTable::rebuild(const juce::StringArray& layoutChannelNames)
+{
+    for (auto& addresses : channelAddresses)
+        for (auto& address : addresses)
+            address = juce::String();
+
+    layoutChannelMask = 0;
+
+    for (const auto& channelName : layoutChannelNames)
+    {
+        const int channelId = findChannelId(channelName);
+        if (channelId == INVALID_CHANNEL_ID)
+            continue;
+
+        layoutChannelMask |= (1u << channelId);
+
+        const juce::String oscChannelName = getChannelName(channelId).replaceCharacter(' ', '_');
+        for (int action = 0; action < static_cast<int>(Action::NumActions); ++action)
+        {
+            channelAddresses[static_cast<size_t>(action)][static_cast<size_t>(channelId)] =
+                "/Monitor/" + getActionName(static_cast<Action>(action)) + "/" + oscChannelName;
+        }
+    }
+}
+
+const juce::String& OSCAddressTable::getChannelAddress(Action action, int channelId) const noexcept
+{
+    static const juce::String empty;
+
+    if (action >= Action::NumActions || !juce::isPositiveAndBelow(channelId, NUM_CHANNEL_IDS))
+        return empty;
+
+    return channelAddresses[static_cast<size_t>(action)][static_cast<size_t>(channelId)];
+}
+
+const juce::String& OSCAddressTable::getMasterAddress(MasterControl control) noexcept
+{
+    static const juce::String addresses[] = {
+        "/Monitor/Master/Volume",
+        "/Monitor/Master/Dim",
+        "/Monitor/Master/Effect/Low_Boost",
+        "/Monitor/Master/Mute",
+        "/Monitor/Master/Effect/Mono"
+    };
+    static_assert(sizeof(addresses) / sizeof(addresses[0]) == static_cast<size_t>(MasterControl::NumControls),
+                  "Master address table out of sync with MasterControl");
+
+    return addresses[static_cast<size_t>(juce::jmin(control, MasterControl::Mono))];
+}
+
+//==============================================================================
+int OSCAddressTable::findChannelId(const char* name, size_t length) noexcept
+{
+    if (name == nullptr || length == 0)
+        return INVALID_CHANNEL_ID;
+
+    const int channelId = hashSlots.channelIds[hashChannelName(name, length) % HASH_TABLE_SIZE];
+    if (channelId == INVALID_CHANNEL_ID)
+        return INVALID_CHANNEL_ID;
+
+    // 哈希只保证已知名称互不冲突，未知名称必须逐字符确认
+    const char* candidate = channelNameLiterals[channelId];
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (candidate[i] == '\0' || normaliseChannelChar(name[i]) != candidate[i])
+            return INVALID_CHANNEL_ID;
+    }
+
+    return candidate[length] == '\0' ? channelId : INVALID_CHANNEL_ID;
+}
+
+int OSCAddressTable::findChannelId(const juce::String& channelName) noexcept
+{
+    return findChannelId(channelName.toRawUTF8(), channelName.getNumBytesAsUTF8());
+}
+
+const juce::String& OSCAddressTable::getChannelName(int channelId) noexcept
+{
+    // 静态字符串只构造一次，回调传引用不再分配
+    static const auto names = []
+    {
+        std::array<juce::String, NUM_CHANNEL_IDS> result;
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = channelNameLiterals[i];
+        return result;
+    }();
+    static const juce::String empty;
+
+    return juce::isPositiveAndBelow(channelId, NUM_CHANNEL_IDS) ? names[static_cast<size_t>(channelId)] : empty;
+}
+
+const juce::String& OSCAddressTable::getActionName(Action action) noexcept
+{
+    static const juce::String names[] = { "Solo", "Mute" };
+    return names[action == Action::Mute ? 1 : 0];
+}
+
+//==============================================================================
+OSCAddressTable::ParsedAddress OSCAddressTable::parse(const char* address, size_t length) noexcept
+{
+    ParsedAddress result;
+
+    // 期望格式: /Monitor/{Action}/{Channel} 或 /Monitor/Master/...
+    if (address == nullptr || length <= ADDRESS_PREFIX_LENGTH
+        || std::memcmp(address, ADDRESS_PREFIX, ADDRESS_PREFIX_LENGTH) != 0)
+    {
+        return result;
+    }
+
+    const char* action = address + ADDRESS_PREFIX_LENGTH;
+    const size_t remaining = length - ADDRESS_PREFIX_LENGTH;
+    const auto* slash = static_cast<const char*>(std::memchr(action, '/', remaining));
+    if (slash == nullptr)
+        return result;
+
+    const size_t actionLength = static_cast<size_t>(slash - action);
+    const char* target = slash + 1;
+    const size_t targetLength = remaining - actionLength - 1;
+
+    // Master总线：固定地址集合
+    if (segmentEquals(action, actionLength, "Master"))
+    {
+        if (segmentEquals(target, targetLength, "Volume"))                 result.control = MasterControl::Volume;
+        else if (segmentEquals(target, targetLength, "Dim"))               result.control = MasterControl::Dim;
+        else if (segmentEquals(target, targetLength, "Mute"))              result.control = MasterControl::Mute;
+        else if (segmentEquals(target, targetLength, "Effect/Low_Boost"))  result.control = MasterControl::LowBoost;
+        else if (segmentEquals(target, targetLength, "Effect/Mono"))       result.control = MasterControl::Mono;
+        else return result;
+
+        result.kind = ParsedAddress::Kind::Master;
+        return result;
+    }
+
+    // 通道动作
+    if (segmentEquals(action, actionLength, "Solo"))
+        result.action = Action::Solo;
+    else if (segmentEquals(action, actionLength, "Mute"))
+        result.action = Action::Mute;
+    else
+        return result;
+
+    // 🚀 地址模式：/Monitor/Mute/{LTF,RTF,LTB,RTB}、/Monitor/Solo/SUB* 一条消息作用于多个通道
+    if (isPattern(target, targetLength))
+    {
+        result.channelMask = matchChannelPattern(target, targetLength);
+        if (result.channelMask != 0)
+            result.kind = ParsedAddress::Kind::ChannelSet;
+
+        return result;
+    }
+
+    result.channelId = findChannelId(target, targetLength);
+    if (result.channelId != INVALID_CHANNEL_ID)
+    {
+        result.kind = ParsedAddress::Kind::Channel;
+        result.channelMask = 1u << result.channelId;
+    }
+
+    return result;
+}
+
+bool OSCAddressTable::isPattern(const char* segment, size_t length) noexcept
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        const char c = segment[i];
+        if (c == '*' || c == '?' || c == '[' || c == '{')
+            return true;
+    }
+    return false;
+}
+
+uint32_t OSCAddressTable::matchChannelPattern(const char* pattern, size_t length) noexcept
+{
+    if (pattern == nullptr || length == 0)
+        return 0;
+
+    // 过长的模式不缓存（实际控制器不会发送）
+    if (length > MAX_CACHED_PATTERN_BYTES)
+        return compileChannelPattern(pattern, length);
+
+    const uint32_t hash = hashChannelName(pattern, length);
+    auto& entry = patternCache[hash % PATTERN_CACHE_SIZE];
+
+    if (entry.length == length && entry.hash == hash && std::memcmp(entry.pattern, pattern, length) == 0)
+        return entry.mask;
+
+    entry.hash = hash;
+    entry.mask = compileChannelPattern(pattern, length);
+    entry.length = static_cast<uint8_t>(length);
+    std::memcpy(entry.pattern, pattern, length);
+    return entry.mask;
+}
+
+//==============================================================================
+OSCAddressTable::BenchmarkResult OSCAddressTable::runBenchmark(int iterations)
+{
+    BenchmarkResult result;
+    result.iterations = juce::jmax(1, iterations);
+
+    juce::StringArray allChannels;
+    for (int id = 0; id < NUM_CHANNEL_IDS; ++id)
+        allChannels.add(getChannelName(id));
+
+    OSCAddressTable table;
+    table.rebuild(allChannels);
+
+    // 入站样本：预先生成，计时只覆盖解析本身
+    std::array<juce::String, NUM_CHANNEL_IDS> incoming;
+    for (int id = 0; id < NUM_CHANNEL_IDS; ++id)
+        incoming[static_cast<size_t>(id)] = table.getChannelAddress(Action::Mute, id);
+
+    volatile size_t sink = 0;
+    auto messagesPerSecond = [&result](juce::int64 startTicks)
+    {
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return seconds > 0.0 ? static_cast<double>(result.iterations) / seconds : 0.0;
+    };
+
+    auto start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < result.iterations; ++i)
+    {
+        const juce::String address = table.getChannelAddress(Action::Solo, i % NUM_CHANNEL_IDS);
+        sink = sink + static_cast<size_t>(address.length());
+    }
+    result.tableLookupsPerSecond = messagesPerSecond(start);
+
+    start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < result.iterations; ++i)
+    {
+        const juce::String address = formatWithStrings("Solo", getChannelName(i % NUM_CHANNEL_IDS));
+        sink = sink + static_cast<size_t>(address.length());
+    }
+    result.stringFormatsPerSecond = messagesPerSecond(start);
+
+    start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < result.iterations; ++i)
+    {
+        const auto& address = incoming[static_cast<size_t>(i % NUM_CHANNEL_IDS)];
+        sink = sink + static_cast<size_t>(parse(address.toRawUTF8(), address.getNumBytesAsUTF8()).channelId);
+    }
+    result.parsesPerSecond = messagesPerSecond(start);
+
+    start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < result.iterations; ++i)
+    {
+        sink = sink + static_cast<size_t>(parseWithStrings(incoming[static_cast<size_t>(i % NUM_CHANNEL_IDS)]).length());
+    }
+    result.stringParsesPerSecond = messagesPerSecond(start);
+
+    // 模式解析：首次编译后命中线程缓存
+    static const char* const patterns[] = { "/Monitor/Mute/{LTF,RTF,LTB,RTB}", "/Monitor/Solo/SUB*", "/Monitor/Mute/[LR]?S" };
+    start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < result.iterations; ++i)
+    {
+        const char* pattern = patterns[i % 3];
+        sink = sink + static_cast<size_t>(parse(pattern, std::strlen(pattern)).channelMask);
+    }
+    result.patternParsesPerSecond = messagesPerSecond(start);
+
+    juce::ignoreUnused(sink);
+    return result;
+}
@@ -0,0 +1,118 @@
+﻿/*
+  ==============================================================================
+
+    OSCAddressTable.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC地址表 - 预计算出站地址 + 零分配入站解析
+
+    - 出站：每个(Action, 通道ID)的完整地址在布局变化时预先生成，发送时只做引用计数拷贝
+    - 入站：/Monitor/... 命名空间按段分发，通道名通过编译期验证的完美哈希查找，
+      解析过程不构造任何临时字符串
+    - 通道名中的'_'与空格等价（"SUB_F" == "SUB F"）
+    - 通道段支持OSC 1.0地址模式（* ? [..] {a,b}），匹配结果为通道位掩码，
+      按线程缓存，同一模式只编译（匹配全部通道）一次
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * OSC地址表
+ *
+ * 线程模型：
+ * - rebuild() 只在消息线程调用（布局变化）
+ * - getChannelAddress() 在消息线程发送路径调用
+ * - 所有static方法无状态、无锁、无分配，可在任意线程调用
+ */
+class OSCAddressTable
+{
+public:
+    //==============================================================================
+    enum class Action : uint8_t
+    {
+        Solo = 0,
+        Mute = 1,
+        NumActions = 2
+    };
+
+    enum class MasterControl : uint8_t
+    {
+        Volume = 0,     // /Monitor/Master/Volume
+        Dim,            // /Monitor/Master/Dim
+        LowBoost,       // /Monitor/Master/Effect/Low_Boost
+        Mute,           // /Monitor/Master/Mute
+        Mono,           // /Monitor/Master/Effect/Mono
+        NumControls
+    };
+
+    static constexpr int NUM_CHANNEL_IDS = 23;
+    static constexpr int INVALID_CHANNEL_ID = -1;
+    static_assert(NUM_CHANNEL_IDS <= 32, "Channel masks are 32-bit");
+
+    struct ParsedAddress
+    {
+        // Channel: 单个通道；ChannelSet: 地址模式匹配到的通道集合（channelMask）
+        enum class Kind : uint8_t { Invalid, Channel, ChannelSet, Master };
+
+        Kind kind = Kind::Invalid;
+        Action action = Action::Solo;
+        int channelId = INVALID_CHANNEL_ID;
+        uint32_t channelMask = 0;   // bit n = 通道ID n
+        MasterControl control = MasterControl::Volume;
+    };
+
+    //==============================================================================
+    OSCAddressTable() = default;
+
+    // 布局变化时重建出站地址表（只生成当前布局中的通道）
+    void rebuild(const juce::StringArray& layoutChannelNames);
+
+    // 出站地址：通道不在当前布局中时返回空字符串，调用方回退到动态格式化
+    const juce::String& getChannelAddress(Action action, int channelId) const noexcept;
+    uint32_t getLayoutChannelMask() const noexcept { return layoutChannelMask; }
+    static const juce::String& getMasterAddress(MasterControl control) noexcept;
+
+    //==============================================================================
+    // 通道名 <-> 通道ID（完美哈希）
+    static int findChannelId(const char* name, size_t length) noexcept;
+    static int findChannelId(const juce::String& channelName) noexcept;
+    static const juce::String& getChannelName(int channelId) noexcept;
+    static const juce::String& getActionName(Action action) noexcept;
+
+    // 入站解析：不分配内存，失败时返回Kind::Invalid
+    static ParsedAddress parse(const char* address, size_t length) noexcept;
+
+    // 通道段地址模式 -> 匹配的通道位掩码（按线程缓存，不分配内存）
+    static uint32_t matchChannelPattern(const char* pattern, size_t length) noexcept;
+    static bool isPattern(const char* segment, size_t length) noexcept;
+
+    //==============================================================================
+    // 微基准：单线程（单核）每秒可完成的地址格式化/解析次数，并与旧的字符串拼接方式对比
+    struct BenchmarkResult
+    {
+        int iterations = 0;
+        double tableLookupsPerSecond = 0.0;
+        double stringFormatsPerSecond = 0.0;
+        double parsesPerSecond = 0.0;
+        double stringParsesPerSecond = 0.0;
+        double patternParsesPerSecond = 0.0;
+    };
+
+    static BenchmarkResult runBenchmark(int iterations);
+
+private:
+    //==============================================================================
+    std::array<std::array<juce::String, NUM_CHANNEL_IDS>, static_cast<size_t>(Action::NumActions)> channelAddresses;
+    uint32_t layoutChannelMask = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCAddressTable)
+};
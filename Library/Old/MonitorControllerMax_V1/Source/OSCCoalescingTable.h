@@ -0,0 +1,157 @@
+﻿/*
+  ==============================================================================
+
+    OSCCoalescingTable.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    出站OSC状态合并表 - 按地址ID预分配槽位 + 每优先级原子脏位图
+
+    - 每个出站状态地址（Solo/Mute × 通道ID、Master控制）对应一个固定槽位
+    - set() 任意线程调用：写入最新值并在对应优先级的位图上置位，无锁、无分配
+    - drain() 单消费者：按优先级从高到低逐位取出，同一地址只发送最新值，无需排序
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "OSCAddressTable.h"
+
+#if defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+//==============================================================================
+/**
+ * OSC状态合并表
+ *
+ * 内存顺序：生产者先写值（relaxed）再置位（release）；消费者先清位（acquire）再读值，
+ * 读到的值不会比置位时旧。清位后到读值之间的新写入会再次置位，最多多发送一次最新值。
+ */
+class OSCCoalescingTable
+{
+public:
+    static constexpr int NUM_PRIORITIES = 3;   // 0 = 高优先级, 1 = 中等, 2 = 低优先级
+    static constexpr int NUM_CHANNEL_SLOTS = static_cast<int>(OSCAddressTable::Action::NumActions) * OSCAddressTable::NUM_CHANNEL_IDS;
+    static constexpr int NUM_SLOTS = NUM_CHANNEL_SLOTS + static_cast<int>(OSCAddressTable::MasterControl::NumControls);
+    static constexpr int INVALID_SLOT = -1;
+
+    static_assert(NUM_SLOTS <= 64, "Dirty bitmaps are 64-bit");
+
+    OSCCoalescingTable() noexcept
+    {
+        for (auto& value : values)
+            value.store(0.0f, std::memory_order_relaxed);
+        for (auto& bits : dirty)
+            bits.store(0, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    // 地址ID <-> 槽位
+    static int getChannelSlot(OSCAddressTable::Action action, int channelId) noexcept
+    {
+        if (action >= OSCAddressTable::Action::NumActions || channelId < 0 || channelId >= OSCAddressTable::NUM_CHANNEL_IDS)
+            return INVALID_SLOT;
+
+        return static_cast<int>(action) * OSCAddressTable::NUM_CHANNEL_IDS + channelId;
+    }
+
+    static int getMasterSlot(OSCAddressTable::MasterControl control) noexcept
+    {
+        if (control >= OSCAddressTable::MasterControl::NumControls)
+            return INVALID_SLOT;
+
+        return NUM_CHANNEL_SLOTS + static_cast<int>(control);
+    }
+
+    static bool isChannelSlot(int slot) noexcept { return slot >= 0 && slot < NUM_CHANNEL_SLOTS; }
+
+    static OSCAddressTable::Action getSlotAction(int slot) noexcept
+    {
+        return static_cast<OSCAddressTable::Action>(slot / OSCAddressTable::NUM_CHANNEL_IDS);
+    }
+
+    static int getSlotChannelId(int slot) noexcept { return slot % OSCAddressTable::NUM_CHANNEL_IDS; }
+
+    static OSCAddressTable::MasterControl getSlotMasterControl(int slot) noexcept
+    {
+        return static_cast<OSCAddressTable::MasterControl>(slot - NUM_CHANNEL_SLOTS);
+    }
+
+    //==============================================================================
+    // 任意线程：写入最新值并标记为待发送
+    bool set(int slot, float value, int priority) noexcept
+    {
+        if (slot < 0 || slot >= NUM_SLOTS)
+            return false;
+
+        values[static_cast<size_t>(slot)].store(value, std::memory_order_relaxed);
+
+        const int clampedPriority = priority < 0 ? 0 : (priority >= NUM_PRIORITIES ? NUM_PRIORITIES - 1 : priority);
+        dirty[static_cast<size_t>(clampedPriority)].fetch_or(uint64_t(1) << slot, std::memory_order_release);
+        return true;
+    }
+
+    bool hasPending() const noexcept
+    {
+        for (const auto& bits : dirty)
+            if (bits.load(std::memory_order_relaxed) != 0)
+                return true;
+
+        return false;
+    }
+
+    // 单消费者：按优先级顺序回调 callback(slot, value)，返回取出的槽位数
+    template <typename Callback>
+    int drain(Callback&& callback) noexcept
+    {
+        uint64_t emitted = 0;
+        int count = 0;
+
+        for (auto& priorityBits : dirty)
+        {
+            // 同一槽位若在多个优先级上都被标记，只在最高优先级发送一次
+            uint64_t bits = priorityBits.exchange(0, std::memory_order_acquire) & ~emitted;
+            emitted |= bits;
+
+            while (bits != 0)
+            {
+                const int slot = countTrailingZeros(bits);
+                bits &= bits - 1;
+
+                callback(slot, values[static_cast<size_t>(slot)].load(std::memory_order_relaxed));
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    void clear() noexcept
+    {
+        for (auto& bits : dirty)
+            bits.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static int countTrailingZeros(uint64_t bits) noexcept
+    {
+       #if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+       #else
+        return __builtin_ctzll(bits);
+       #endif
+    }
+
+    std::array<std::atomic<float>, NUM_SLOTS> values;
+    std::array<std::atomic<uint64_t>, NUM_PRIORITIES> dirty;
+
+    OSCCoalescingTable(const OSCCoalescingTable&) = delete;
+    OSCCoalescingTable& operator=(const OSCCoalescingTable&) = delete;
+};
@@ -2,6 +2,9 @@
 #include "SemanticChannelState.h"
 #include "PhysicalChannelMapper.h"
 #include "PluginProcessor.h"
+#include "ChannelAnalyser.h"
+#include "ChannelMeter.h"
+#include "PropagationStats.h"
 #include "DebugLogger.h"
 
 // OSC类专用角色日志宏
@@ -18,9 +21,8 @@ OSCCommunicator::OSCCommunicator()
 {
     OSC_DBG_ROLE("OSCCommunicator: Initialize OSC communication system");
     
-    // 创建OSC发送和接收组件
-    sender = std::make_unique<juce::OSCSender>();
-    receiver = std::make_unique<juce::OSCReceiver>();
+    // 批次上限即合并表槽位数（溢出队列极少使用）
+    batchScratch.reserve(static_cast<size_t>(OSCCoalescingTable::NUM_SLOTS));
 }
 
 void OSCCommunicator::setProcessor(MonitorControllerMaxAudioProcessor* processor)
@@ -38,40 +40,24 @@ bool OSCCommunicator::initialize()
 {
     OSC_DBG_ROLE("OSCCommunicator: Initialize OSC connections");
     
-    bool success = true;
+    // 🚀 共享OSC中心：第一个实例创建套接字和发送目标，之后的实例只注册端点
+    hub = SharedOSCHub::acquire();
+    hub->registerEndpoint(this, addressGroup);
     
-    // 初始化OSC发送器
-    if (sender->connect(TARGET_IP, TARGET_PORT))
-    {
-        senderConnected.store(true);
-        OSC_DBG_ROLE("OSCCommunicator: OSC Sender connected to " + juce::String(TARGET_IP) + ":" + juce::String(TARGET_PORT));
-    }
-    else
-    {
-        senderConnected.store(false);
-        OSC_DBG_ROLE("OSCCommunicator: Failed to connect OSC Sender to " + juce::String(TARGET_IP) + ":" + juce::String(TARGET_PORT));
-        success = false;
-    }
+    const bool success = hub->isSending() && hub->isReceiving();
+    isInitialized.store(success);
     
-    // 初始化OSC接收器
-    if (receiver->connect(RECEIVE_PORT))
-    {
-        receiver->addListener(this);
-        receiverConnected.store(true);
-        OSC_DBG_ROLE("OSCCommunicator: OSC Receiver listening on port " + juce::String(RECEIVE_PORT));
-    }
-    else
-    {
-        receiverConnected.store(false);
-        OSC_DBG_ROLE("OSCCommunicator: Failed to start OSC Receiver on port " + juce::String(RECEIVE_PORT));
-        success = false;
-    }
+    // 已建立的TCP连接不触发重新同步（初始化后由调用方广播初始状态）
+    lastStreamConnections = hub->getStreamConnectionCount();
+    ticksSinceStreamCheck = 0;
     
-    isInitialized.store(success);
+    // 固定间隔批量发送（生产者只写合并表）
+    startTimer(BATCH_INTERVAL_MS);
     
     if (success)
     {
-        OSC_DBG_ROLE("OSCCommunicator: OSC communication system initialized successfully");
+        OSC_DBG_ROLE("OSCCommunicator: OSC communication system initialized successfully - group '" + addressGroup + 
+                     "', " + juce::String(hub->getNumEndpoints()) + " instances sharing OSC hub");
     }
     else
     {
@@ -85,128 +71,196 @@ void OSCCommunicator::shutdown()
 {
     OSC_DBG_ROLE("OSCCommunicator: Shutdown OSC communication");
     
-    if (receiver && receiverConnected.load())
+    isInitialized.store(false);
+    stopTimer();
+    stateTable.clear();
+    
     {
-        receiver->removeListener(this);
-        receiver->disconnect();
-        receiverConnected.store(false);
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflowMessages.clear();
     }
     
-    if (sender && senderConnected.load())
+    if (hub != nullptr)
     {
-        sender->disconnect();
-        senderConnected.store(false);
+        // 注销返回后共享接收线程不会再回调本实例；最后一个实例释放时中心随之关闭
+        hub->unregisterEndpoint(this);
+        hub.reset();
     }
     
-    isInitialized.store(false);
+    discardPendingCommands();
+    
     OSC_DBG_ROLE("OSCCommunicator: OSC communication shutdown complete");
 }
 
 bool OSCCommunicator::isConnected() const
 {
-    return isInitialized.load() && senderConnected.load();
+    return isInitialized.load() && hub != nullptr && hub->isSending();
 }
 
-void OSCCommunicator::sendSoloState(const juce::String& channelName, bool state)
+OSCCommunicator::ReceiveStats OSCCommunicator::getReceiveStats() const noexcept
 {
-    // 检查连接状态
-    if (!isConnected())
+    ReceiveStats stats;
+    stats.receivedMessages = receivedMessages.load(std::memory_order_relaxed);
+    stats.dispatchedCommands = dispatchedCommands.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void OSCCommunicator::setAddressGroup(const juce::String& groupName)
+{
+    const juce::String group = SharedOSCHub::normaliseGroupName(groupName);
+    if (group == addressGroup)
     {
         return;
     }
     
-    juce::String address = formatOSCAddress("Solo", channelName);
-    float value = state ? 1.0f : 0.0f;
+    OSC_DBG_ROLE("OSCCommunicator: OSC group changed - '" + addressGroup + "' -> '" + group + "'");
+    addressGroup = group;
     
-    // 🚀 优化：使用消息队列，优先级1（中等）
-    queueOSCMessage(address, value, 1);
+    // 已注册时立即切换接收组
+    if (hub != nullptr)
+    {
+        hub->registerEndpoint(this, addressGroup);
+    }
 }
 
-void OSCCommunicator::sendMuteState(const juce::String& channelName, bool state)
+//==============================================================================
+// 网络配置与发送
+//==============================================================================
+
+OSCNetworkConfig OSCCommunicator::getNetworkConfig() const
 {
-    // 检查连接状态
-    if (!isConnected())
+    return hub != nullptr ? hub->getNetworkConfig() : OSCNetworkConfig::load();
+}
+
+bool OSCCommunicator::setNetworkConfig(const OSCNetworkConfig& newConfig, bool saveToUserFile)
+{
+    // 未初始化时只保存配置，下次创建共享中心时生效
+    if (hub == nullptr)
+    {
+        return !saveToUserFile || newConfig.save();
+    }
+    
+    const bool success = hub->setNetworkConfig(newConfig, saveToUserFile);
+    isInitialized.store(success);
+    return success;
+}
+
+void OSCCommunicator::sendToTargets(const std::vector<juce::OSCMessage>& messages)
+{
+    if (hub != nullptr)
+    {
+        hub->send(messages, addressGroup);
+    }
+}
+
+void OSCCommunicator::sendSoloState(const juce::String& channelName, bool state)
+{
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
     {
         return;
     }
     
-    juce::String address = formatOSCAddress("Mute", channelName);
-    float value = state ? 1.0f : 0.0f;
+    // 🚀 合并表：同一通道只发送最新值，优先级1（中等）
+    queueChannelState(OSCAddressTable::Action::Solo, channelName, state ? 1.0f : 0.0f);
+}
+
+void OSCCommunicator::sendMuteState(const juce::String& channelName, bool state)
+{
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
+    {
+        return;
+    }
     
-    // 🚀 优化：使用消息队列，优先级1（中等）
-    queueOSCMessage(address, value, 1);
+    // 🚀 合并表：同一通道只发送最新值，优先级1（中等）
+    queueChannelState(OSCAddressTable::Action::Mute, channelName, state ? 1.0f : 0.0f);
 }
 
 void OSCCommunicator::sendMasterVolume(float volumePercent)
 {
-    // 检查连接状态
-    if (!isConnected())
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
     {
         return;
     }
     
     // v4.1: 发送Master Volume状态 (地址: /Monitor/Master/Volume)
-    juce::String address = "/Monitor/Master/Volume";
+    const auto control = OSCAddressTable::MasterControl::Volume;
 
     // 关键修改：将内部的 0-100 百分比转换为OSC标准的 0.0-1.0 范围
     float oscValue = volumePercent / 100.0f;
     oscValue = juce::jlimit(0.0f, 1.0f, oscValue); // 确保值在0.0和1.0之间
     
-    if (sender->send(address, oscValue))
-    {
-        OSC_DBG_ROLE("OSCCommunicator: Sent Master Volume - " + address + " = " + juce::String(oscValue) + " (from " + juce::String(volumePercent) + "%)");
-    }
-    else
-    {
-        OSC_DBG_ROLE("OSCCommunicator: Failed to send Master Volume - " + address);
-    }
+    // 高优先级入队：与通道状态一起打包进同一批OSC Bundle
+    queueMasterState(control, oscValue);
 }
 
 void OSCCommunicator::sendMasterDim(bool dimState)
 {
-    // 检查连接状态
-    if (!isConnected())
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
     {
         return;
     }
     
     // v4.1: 发送Master Dim状态 (地址: /Monitor/Master/Dim)
-    juce::String address = "/Monitor/Master/Dim";
+    const auto control = OSCAddressTable::MasterControl::Dim;
     float value = dimState ? 1.0f : 0.0f;
     
-    if (sender->send(address, value))
-    {
-        OSC_DBG_ROLE("OSCCommunicator: Sent Master Dim - " + address + " = " + juce::String(value) + " (" + (dimState ? "ON" : "OFF") + ")");
-    }
-    else
-    {
-        OSC_DBG_ROLE("OSCCommunicator: Failed to send Master Dim - " + address);
-    }
+    // 高优先级入队：与通道状态一起打包进同一批OSC Bundle
+    queueMasterState(control, value);
 }
 
 void OSCCommunicator::sendMasterLowBoost(bool lowBoostState)
 {
-    // 检查连接状态
-    if (!isConnected())
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
     {
         return;
     }
     
     // v4.1: 发送Master Low Boost状态 (地址: /Monitor/Master/Effect/Low_Boost)
-    juce::String address = "/Monitor/Master/Effect/Low_Boost";
+    const auto control = OSCAddressTable::MasterControl::LowBoost;
     float value = lowBoostState ? 1.0f : 0.0f;
     
-    if (sender->send(address, value))
+    // 高优先级入队：与通道状态一起打包进同一批OSC Bundle
+    queueMasterState(control, value);
+}
+
+void OSCCommunicator::sendMasterMute(bool masterMuteState)
+{
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
     {
-        OSC_DBG_ROLE("OSCCommunicator: Sent Master Low Boost - " + address + " = " + juce::String(value) + " (" + (lowBoostState ? "ON" : "OFF") + ")");
+        return;
     }
-    else
+    
+    // v4.1: 发送Master Mute状态 (地址: /Monitor/Master/Mute)
+    const auto control = OSCAddressTable::MasterControl::Mute;
+    float value = masterMuteState ? 1.0f : 0.0f;
+    
+    // 高优先级入队：与通道状态一起打包进同一批OSC Bundle
+    queueMasterState(control, value);
+}
+
+void OSCCommunicator::sendMasterMono(bool monoState)
+{
+    // 任意线程可调用：只检查原子初始化标志
+    if (!isInitialized.load(std::memory_order_relaxed))
     {
-        OSC_DBG_ROLE("OSCCommunicator: Failed to send Master Low Boost - " + address);
+        return;
     }
+    
+    // v4.1: 发送Master Mono状态 (地址: /Monitor/Master/Effect/Mono)
+    const auto control = OSCAddressTable::MasterControl::Mono;
+    float value = monoState ? 1.0f : 0.0f;
+    
+    // 高优先级入队：与通道状态一起打包进同一批OSC Bundle
+    queueMasterState(control, value);
 }
 
-void OSCCommunicator::sendMasterMute(bool masterMuteState)
+void OSCCommunicator::sendAnalyserSnapshot(const AnalyserSnapshot& snapshot, const juce::StringArray& channelNames)
 {
     // 检查连接状态
     if (!isConnected())
@@ -214,21 +268,47 @@ void OSCCommunicator::sendMasterMute(bool masterMuteState)
         return;
     }
     
-    // v4.1: 发送Master Mute状态 (地址: /Monitor/Master/Mute)
-    juce::String address = "/Monitor/Master/Mute";
-    float value = masterMuteState ? 1.0f : 0.0f;
+    // 连续测量数据：不进入状态队列，直接打包发送，失败不重试（下一帧会覆盖）
+    auto getOSCChannelName = [&channelNames](int channelIndex)
+    {
+        return juce::isPositiveAndBelow(channelIndex, channelNames.size())
+            ? channelNames[channelIndex].replace(" ", "_")
+            : juce::String();
+    };
     
-    if (sender->send(address, value))
+    std::vector<juce::OSCMessage> messages;
+    messages.reserve(static_cast<size_t>(AnalyserSnapshot::MAX_CHANNELS + snapshot.numPairs));
+    
+    for (int ch = 0; ch < AnalyserSnapshot::MAX_CHANNELS; ++ch)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Sent Master Mute - " + address + " = " + juce::String(value) + " (" + (masterMuteState ? "ON" : "OFF") + ")");
+        const juce::String channelName = getOSCChannelName(ch);
+        if (!snapshot.channelActive[static_cast<size_t>(ch)] || channelName.isEmpty())
+            continue;
+        
+        juce::OSCMessage message("/Monitor/Analyser/Spectrum/" + channelName);
+        for (const float bandDb : snapshot.spectrumDb[static_cast<size_t>(ch)])
+            message.addFloat32(bandDb);
+        
+        messages.push_back(std::move(message));
     }
-    else
+    
+    for (int p = 0; p < snapshot.numPairs; ++p)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Failed to send Master Mute - " + address);
+        const auto& pair = snapshot.pairs[static_cast<size_t>(p)];
+        const juce::String leftName = getOSCChannelName(pair.leftChannel);
+        const juce::String rightName = getOSCChannelName(pair.rightChannel);
+        if (leftName.isEmpty() || rightName.isEmpty())
+            continue;
+        
+        messages.emplace_back("/Monitor/Analyser/Correlation/" + leftName + "_" + rightName, pair.correlation);
     }
+    
+    // 一帧分析数据交给各目标，由目标发送线程打包为同一时间标签的Bundle
+    // 删除垃圾日志 - 10Hz连续数据不记录
+    sendToTargets(messages);
 }
 
-void OSCCommunicator::sendMasterMono(bool monoState)
+void OSCCommunicator::sendMeterSnapshot(const MeterSnapshot& snapshot, const juce::StringArray& channelNames, int frameRateHz)
 {
     // 检查连接状态
     if (!isConnected())
@@ -236,18 +316,67 @@ void OSCCommunicator::sendMasterMono(bool monoState)
         return;
     }
     
-    // v4.1: 发送Master Mono状态 (地址: /Monitor/Master/Effect/Mono)
-    juce::String address = "/Monitor/Master/Effect/Mono";
-    float value = monoState ? 1.0f : 0.0f;
+    // 🚀 一帧一条消息：26通道 × 2个float ≈ 280字节，加上通道描述也远小于一个数据报
+    juce::OSCMessage meter("/Monitor/Meter");
+    juce::StringArray meterChannels;
     
-    if (sender->send(address, value))
+    const int numChannels = juce::jmin(channelNames.size(), MeterSnapshot::MAX_CHANNELS);
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Sent Master Mono - " + address + " = " + juce::String(value) + " (" + (monoState ? "ON" : "OFF") + ")");
+        if (channelNames[ch].isEmpty())
+            continue;
+        
+        meter.addFloat32(snapshot.peakDb[static_cast<size_t>(ch)]);
+        meter.addFloat32(snapshot.rmsDb[static_cast<size_t>(ch)]);
+        meterChannels.add(channelNames[ch].replace(" ", "_"));
     }
-    else
+    
+    if (meterChannels.isEmpty())
+    {
+        return;
+    }
+    
+    std::vector<juce::OSCMessage> messages;
+    
+    // 通道描述：布局变化时立即发送，之后每秒重发一次供后连接的控制器使用
+    const juce::String layout = meterChannels.joinIntoString(",");
+    if (layout != lastMeterLayout || ++framesSinceMeterLayout >= juce::jmax(1, frameRateHz))
+    {
+        juce::OSCMessage channels("/Monitor/Meter/Channels");
+        for (const auto& name : meterChannels)
+            channels.addString(name);
+        
+        messages.push_back(std::move(channels));
+        lastMeterLayout = layout;
+        framesSinceMeterLayout = 0;
+    }
+    
+    messages.push_back(std::move(meter));
+    
+    // 删除垃圾日志 - 60Hz连续数据不记录
+    sendToTargets(messages);
+}
+
+void OSCCommunicator::sendPropagationReport(const PropagationReport& report)
+{
+    if (!isConnected())
     {
-        OSC_DBG_ROLE("OSCCommunicator: Failed to send Master Mono - " + address);
+        return;
     }
+    
+    // OSC 1.0只有32位整数：序号与计数按int发送（溢出前早已足够诊断）
+    juce::OSCMessage propagation("/Monitor/Sync/Propagation");
+    propagation.addInt32(static_cast<juce::int32>(report.sequence));
+    propagation.addInt32(static_cast<juce::int32>(report.slaves.size()));
+    propagation.addInt32(static_cast<juce::int32>(report.maxLag));
+    propagation.addFloat32(static_cast<float>(report.latency.getPercentileUs(50.0) / 1000.0));
+    propagation.addFloat32(static_cast<float>(report.latency.getPercentileUs(99.0) / 1000.0));
+    propagation.addFloat32(static_cast<float>(report.latency.maxUs / 1000.0));
+    propagation.addInt32(static_cast<juce::int32>(report.latency.samples));
+    
+    std::vector<juce::OSCMessage> messages;
+    messages.push_back(std::move(propagation));
+    sendToTargets(messages);
 }
 
 void OSCCommunicator::broadcastAllStates(const SemanticChannelState& semanticState, 
@@ -275,331 +404,349 @@ void OSCCommunicator::broadcastAllStates(const SemanticChannelState& semanticSta
         sendMuteState(channelName, muteState);
     }
     
+    // Master总线状态一起入队，完整状态转储打包为少量Bundle数据报
+    if (processorPtr != nullptr)
+    {
+        const auto& masterBus = processorPtr->masterBusProcessor;
+        sendMasterVolume(masterBus.getMasterGainPercent());
+        sendMasterDim(masterBus.isDimActive());
+        sendMasterLowBoost(masterBus.isLowBoostActive());
+        sendMasterMute(masterBus.isMasterMuteActive());
+        sendMasterMono(masterBus.isMonoActive());
+    }
+    
     OSC_DBG_ROLE("OSCCommunicator: Broadcast complete - " + juce::String(activeChannels.size()) + " channels");
 }
 
-void OSCCommunicator::oscMessageReceived(const juce::OSCMessage& message)
+void OSCCommunicator::handleHubMessage(const juce::OSCMessage& message, const char* address, size_t length) noexcept
 {
-    handleIncomingOSCMessage(message);
-}
-
-void OSCCommunicator::handleIncomingOSCMessage(const juce::OSCMessage& message)
-{
-    juce::String address = message.getAddressPattern().toString();
+    // 🚀 共享OSC接收线程：解码为固定大小命令，Master音频控制立即写入实时状态，其余转交消息线程
+    OSCControlCommand command;
+    command.receivedTicks = juce::Time::getHighResolutionTicks();
+    receivedMessages.fetch_add(1, std::memory_order_relaxed);
     
-    // v4.1: 处理Master总线消息
-    if (address == "/Monitor/Master/Dim" || address == "/Monitor/Master/Volume" || address == "/Monitor/Master/Effect/Low_Boost" || address == "/Monitor/Master/Mute" || address == "/Monitor/Master/Effect/Mono")
+    if (!decodeOSCCommand(message, address, length, command))
     {
-        handleMasterBusOSCMessage(address, message);
+        // 接收线程不写日志（DebugLogger非线程安全），计数后交给消息线程汇总
+        rejectedMessages.fetch_add(1, std::memory_order_relaxed);
+        triggerAsyncUpdate();
         return;
     }
     
-    // 常规通道消息处理
-    // 解析OSC地址
-    auto [action, channelName] = parseOSCAddress(address);
-    
-    if (action.isEmpty() || channelName.isEmpty())
+    // 先入队：队列满时整条命令丢弃，实时状态也不能改，否则可听状态与状态模型/参数/UI不一致
+    if (!messageThreadCommands.push(command))
     {
-        OSC_DBG_ROLE("OSCCommunicator: Invalid OSC address format - " + address);
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        triggerAsyncUpdate();
         return;
     }
     
-    if (!isValidChannelName(channelName))
+    if (command.address.kind == OSCAddressTable::ParsedAddress::Kind::Master && onRealtimeMasterControl)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Invalid channel name - " + channelName);
-        return;
+        onRealtimeMasterControl(command.address.control, command.value);
     }
     
-    // 获取值
-    if (message.size() < 1)
-    {
-        OSC_DBG_ROLE("OSCCommunicator: OSC message has no arguments");
-        return;
-    }
+    triggerAsyncUpdate();
+}
+
+bool OSCCommunicator::decodeOSCCommand(const juce::OSCMessage& message, const char* address, size_t length,
+                                       OSCControlCommand& command) noexcept
+{
+    // 🚀 零分配解析：地址按段分发，通道名走完美哈希（组前缀已由共享中心去除）
+    command.address = OSCAddressTable::parse(address, length);
     
-    float value = 0.0f;
-    if (message[0].isFloat32())
+    // 地址无效，或参数缺失/非数值
+    if (command.address.kind == OSCAddressTable::ParsedAddress::Kind::Invalid
+        || !getNumericArgument(message, command.value))
     {
-        value = message[0].getFloat32();
-    }
-    else if (message[0].isInt32())
-    {
-        value = static_cast<float>(message[0].getInt32());
-    }
-    else
-    {
-        OSC_DBG_ROLE("OSCCommunicator: OSC message argument is not numeric");
-        return;
+        return false;
     }
     
-    bool state = (value > 0.5f);
-    
-    OSC_DBG_ROLE("OSCCommunicator: Parsed OSC - action:" + action + " channel:" + channelName + " state:" + (state ? "ON" : "OFF"));
-    
-    // 调用处理函数来更新对应的状态
-    if (onExternalStateChange)
+    // 关键修改：将OSC的 0.0-1.0 范围转换为内部使用的 0-100 百分比范围，并限制到0-100%
+    if (command.address.kind == OSCAddressTable::ParsedAddress::Kind::Master
+        && command.address.control == OSCAddressTable::MasterControl::Volume)
     {
-        // 传递action类型、通道名和状态值
-        onExternalStateChange(action, channelName, state);
+        command.value = juce::jlimit(0.0f, 100.0f, command.value * 100.0f);
     }
+    
+    return true;
 }
 
-void OSCCommunicator::handleMasterBusOSCMessage(const juce::String& address, const juce::OSCMessage& message)
+void OSCCommunicator::handleAsyncUpdate()
 {
-    OSC_DBG_ROLE("OSCCommunicator: Handling Master bus OSC message - " + address);
-    
-    // 获取值
-    if (message.size() < 1)
+    // 消息线程：更新语义状态、VST3参数、UI，并触发OSC状态反馈
+    OSCControlCommand command;
+    while (messageThreadCommands.pop(command))
     {
-        OSC_DBG_ROLE("OSCCommunicator: Master OSC message has no arguments");
-        return;
+        dispatchOnMessageThread(command);
+        dispatchedCommands.fetch_add(1, std::memory_order_relaxed);
+        
+        if (onCommandDispatched)
+        {
+            onCommandDispatched(command, juce::Time::getHighResolutionTicks());
+        }
     }
     
-    float value = 0.0f;
-    if (message[0].isFloat32())
+    const int dropped = droppedCommands.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
     {
-        value = message[0].getFloat32();
+        OSC_DBG_ROLE("OSCCommunicator: Command queue full - dropped " + juce::String(dropped) + " incoming OSC messages");
     }
-    else if (message[0].isInt32())
+    
+    const int rejected = rejectedMessages.exchange(0, std::memory_order_relaxed);
+    if (rejected > 0)
     {
-        value = static_cast<float>(message[0].getInt32());
+        OSC_DBG_ROLE("OSCCommunicator: Ignored " + juce::String(rejected) + " OSC messages with invalid address or non-numeric argument");
     }
-    else
+}
+
+void OSCCommunicator::dispatchOnMessageThread(const OSCControlCommand& command)
+{
+    // v4.1: 处理Master总线消息
+    if (command.address.kind == OSCAddressTable::ParsedAddress::Kind::Master)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Master OSC message argument is not numeric");
+        handleMasterBusOSCMessage(command.address.control, command.value);
         return;
     }
     
-    // v4.1: 处理Master Volume消息 (/Monitor/Master/Volume)
-    if (address == "/Monitor/Master/Volume")
-    {
-        // 关键修改：将OSC的 0.0-1.0 范围转换为内部使用的 0-100 百分比范围
-        float volumePercent = value * 100.0f;
-        
-        // 限制范围到0-100%
-        volumePercent = juce::jlimit(0.0f, 100.0f, volumePercent);
-        
-        OSC_DBG_ROLE("OSCCommunicator: Received Master Volume OSC - value: " + juce::String(value) + " -> " + juce::String(volumePercent) + "%");
-        
-        if (onMasterVolumeOSC)
-        {
-            onMasterVolumeOSC(volumePercent);
-        }
-    }
-    // v4.1: 处理Master Dim消息 (/Monitor/Master/Dim)
-    else if (address == "/Monitor/Master/Dim")
+    // 🚀 地址模式：匹配到的通道按当前布局过滤后一次性交给处理方
+    if (command.address.kind == OSCAddressTable::ParsedAddress::Kind::ChannelSet)
     {
-        bool dimState = (value > 0.5f);
-        
-        OSC_DBG_ROLE("OSCCommunicator: Received Master Dim OSC - " + juce::String(dimState ? "ON" : "OFF"));
+        const uint32_t channelMask = command.address.channelMask & addressTable.getLayoutChannelMask();
+        const juce::String& actionName = OSCAddressTable::getActionName(command.address.action);
+        const bool state = command.value > 0.5f;
         
-        if (onMasterDimOSC)
+        juce::StringArray channelNames;
+        for (int channelId = 0; channelId < OSCAddressTable::NUM_CHANNEL_IDS; ++channelId)
         {
-            onMasterDimOSC(dimState);
+            if ((channelMask & (1u << channelId)) != 0)
+                channelNames.add(OSCAddressTable::getChannelName(channelId));
         }
-    }
-    // v4.1: 处理Master Low Boost消息 (/Monitor/Master/Effect/Low_Boost)
-    else if (address == "/Monitor/Master/Effect/Low_Boost")
-    {
-        bool lowBoostState = (value > 0.5f);
         
-        OSC_DBG_ROLE("OSCCommunicator: Received Master Low Boost OSC - " + juce::String(lowBoostState ? "ON" : "OFF"));
-        
-        if (onMasterLowBoostOSC)
+        if (channelNames.isEmpty())
         {
-            onMasterLowBoostOSC(lowBoostState);
+            return;
         }
-    }
-    // v4.1: 处理Master Mute消息 (/Monitor/Master/Mute)
-    else if (address == "/Monitor/Master/Mute")
-    {
-        bool masterMuteState = (value > 0.5f);
         
-        OSC_DBG_ROLE("OSCCommunicator: Received Master Mute OSC - " + juce::String(masterMuteState ? "ON" : "OFF"));
-        
-        if (onMasterMuteOSC)
+        if (onExternalBatchStateChange)
         {
-            onMasterMuteOSC(masterMuteState);
+            onExternalBatchStateChange(actionName, channelNames, state);
         }
-    }
-    // v4.1: 处理Master Mono消息 (/Monitor/Master/Effect/Mono)
-    else if (address == "/Monitor/Master/Effect/Mono")
-    {
-        bool monoState = (value > 0.5f);
-        
-        OSC_DBG_ROLE("OSCCommunicator: Received Master Mono OSC - " + juce::String(monoState ? "ON" : "OFF"));
-        
-        if (onMasterMonoOSC)
+        else if (onExternalStateChange)
         {
-            onMasterMonoOSC(monoState);
+            for (const auto& channelName : channelNames)
+                onExternalStateChange(actionName, channelName, state);
         }
+        return;
     }
-    else
+    
+    // 常规通道消息：传递action类型、通道名和状态值（引用静态字符串，不分配）
+    if (onExternalStateChange)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Unknown Master bus OSC address - " + address);
+        onExternalStateChange(OSCAddressTable::getActionName(command.address.action),
+                              OSCAddressTable::getChannelName(command.address.channelId),
+                              command.value > 0.5f);
     }
 }
 
-juce::String OSCCommunicator::formatOSCAddress(const juce::String& action, const juce::String& channelName) const
+void OSCCommunicator::discardPendingCommands()
 {
-    // 将通道名中的空格替换为下划线
-    juce::String sanitizedChannelName = channelName.replaceCharacter(' ', '_');
-    return "/Monitor/" + action + "/" + sanitizedChannelName;
+    cancelPendingUpdate();
+    
+    // 清空残留命令（此时已从共享中心注销，不再有生产者）
+    OSCControlCommand command;
+    while (messageThreadCommands.pop(command)) {}
 }
 
-std::pair<juce::String, juce::String> OSCCommunicator::parseOSCAddress(const juce::String& address) const
+void OSCCommunicator::handleMasterBusOSCMessage(OSCAddressTable::MasterControl control, float value)
 {
-    // 期望格式: /Monitor/{Action}/{Channel}
-    
-    if (!address.startsWith("/Monitor/"))
-    {
-        return {"", ""};
-    }
-    
-    // 移除前缀
-    juce::String content = address.substring(9); // 移除"/Monitor/"
-    
-    // 查找第一个斜杠分隔符
-    int slashPos = content.indexOf("/");
-    if (slashPos == -1)
+    switch (control)
     {
-        return {"", ""};
+        // v4.1: 处理Master Volume消息 (/Monitor/Master/Volume)，解码时已换算为0-100%
+        case OSCAddressTable::MasterControl::Volume:
+            if (onMasterVolumeOSC)
+                onMasterVolumeOSC(value);
+            break;
+        
+        // v4.1: 处理Master Dim消息 (/Monitor/Master/Dim)
+        case OSCAddressTable::MasterControl::Dim:
+            if (onMasterDimOSC)
+                onMasterDimOSC(value > 0.5f);
+            break;
+        
+        // v4.1: 处理Master Low Boost消息 (/Monitor/Master/Effect/Low_Boost)
+        case OSCAddressTable::MasterControl::LowBoost:
+            if (onMasterLowBoostOSC)
+                onMasterLowBoostOSC(value > 0.5f);
+            break;
+        
+        // v4.1: 处理Master Mute消息 (/Monitor/Master/Mute)
+        case OSCAddressTable::MasterControl::Mute:
+            if (onMasterMuteOSC)
+                onMasterMuteOSC(value > 0.5f);
+            break;
+        
+        // v4.1: 处理Master Mono消息 (/Monitor/Master/Effect/Mono)
+        case OSCAddressTable::MasterControl::Mono:
+            if (onMasterMonoOSC)
+                onMasterMonoOSC(value > 0.5f);
+            break;
+        
+        case OSCAddressTable::MasterControl::NumControls:
+        default:
+            OSC_DBG_ROLE("OSCCommunicator: Unknown Master bus OSC control - " + juce::String(static_cast<int>(control)));
+            break;
     }
-    
-    juce::String action = content.substring(0, slashPos);
-    juce::String channelName = content.substring(slashPos + 1);
-    
-    // 将下划线替换回空格（如果需要）
-    channelName = channelName.replaceCharacter('_', ' ');
-    
-    return {action, channelName};
 }
 
-bool OSCCommunicator::isValidChannelName(const juce::String& channelName) const
+bool OSCCommunicator::getNumericArgument(const juce::OSCMessage& message, float& value) noexcept
 {
-    // 验证语义通道名称 - 更新为匹配配置文件中的实际通道名
-    static const std::vector<juce::String> validChannels = {
-        // 主声道
-        "L", "R", "C", "LFE", "LR", "RR",
-        "LSS", "RSS", "LRS", "RRS",
-        "LTF", "RTF", "LTB", "RTB",
-        "LBF", "RBF", "LBB", "RBB",
-        // SUB通道 (匹配Speaker_Config.json中的名称)
-        "SUB F", "SUB B", "SUB L", "SUB R",
-        // 旧版SUB通道名（保持兼容性）
-        "SUB_L", "SUB_R", "SUB_M"
-    };
+    if (message.size() < 1)
+        return false;
     
-    for (const auto& validChannel : validChannels)
+    if (message[0].isFloat32())
     {
-        if (channelName == validChannel)
-        {
-            return true;
-        }
+        value = message[0].getFloat32();
+        return true;
+    }
+    
+    if (message[0].isInt32())
+    {
+        value = static_cast<float>(message[0].getInt32());
+        return true;
     }
     
     return false;
 }
 
+void OSCCommunicator::updateAddressTable(const juce::StringArray& layoutChannelNames)
+{
+    addressTable.rebuild(layoutChannelNames);
+}
+
+juce::String OSCCommunicator::formatOSCAddress(const juce::String& action, const juce::String& channelName) const
+{
+    // 将通道名中的空格替换为下划线
+    juce::String sanitizedChannelName = channelName.replaceCharacter(' ', '_');
+    return "/Monitor/" + action + "/" + sanitizedChannelName;
+}
+
 //==============================================================================
 // 🚀 性能优化：OSC消息队列系统实现
 //==============================================================================
 
-void OSCCommunicator::queueOSCMessage(const juce::String& address, float value, int priority)
+void OSCCommunicator::queueChannelState(OSCAddressTable::Action action, const juce::String& channelName, float value)
 {
-    std::lock_guard<std::mutex> lock(messageQueueMutex);
-    
-    // 🚀 消息合并优化：检查是否已有相同地址的消息
-    auto existingIt = addressToQueueIndex.find(address);
-    if (existingIt != addressToQueueIndex.end())
+    // 🚀 已知通道：完美哈希得到地址ID，写入合并表（无锁、无分配）
+    const int slot = OSCCoalescingTable::getChannelSlot(action, OSCAddressTable::findChannelId(channelName));
+    if (stateTable.set(slot, value, 1))
     {
-        // 更新现有消息的值，避免重复发送
-        size_t index = existingIt->second;
-        if (index < messageQueue.size())
-        {
-            messageQueue[index].value = value;
-            messageQueue[index].timestamp = juce::Time::getCurrentTime().toMilliseconds();
-            messageQueue[index].priority = juce::jmin(messageQueue[index].priority, priority); // 使用更高优先级
-            OSC_DBG_ROLE("OSCCommunicator: Message merged - " + address + " = " + juce::String(value));
-            return;
-        }
+        return;
     }
     
-    // 添加新消息到队列
-    messageQueue.emplace_back(address, value, priority);
-    addressToQueueIndex[address] = messageQueue.size() - 1;
+    // 自定义通道名（不在通道表中）：少见路径，加锁合并到溢出队列
+    const juce::String address = formatOSCAddress(OSCAddressTable::getActionName(action), channelName);
     
-    OSC_DBG_ROLE("OSCCommunicator: Message queued - " + address + " = " + juce::String(value) + " (priority: " + juce::String(priority) + ")");
+    std::lock_guard<std::mutex> lock(overflowMutex);
     
-    // 🚀 自适应批量发送：根据队列大小调整发送频率
-    if (messageQueue.size() >= 5) {
-        // 队列较满时，立即触发发送
-        if (!isTimerRunning()) {
-            startTimer(1); // 1ms后立即发送
+    for (auto& pending : overflowMessages)
+    {
+        if (pending.first == address)
+        {
+            pending.second = value;
+            return;
         }
-    } else if (!isTimerRunning()) {
-        // 正常情况下，每10ms批量发送一次
-        startTimer(10);
     }
+    
+    overflowMessages.emplace_back(address, value);
+}
+
+void OSCCommunicator::queueMasterState(OSCAddressTable::MasterControl control, float value)
+{
+    // 高优先级入队：与通道状态一起打包进同一批OSC Bundle
+    stateTable.set(OSCCoalescingTable::getMasterSlot(control), value, 0);
 }
 
 void OSCCommunicator::timerCallback()
 {
-    // 🚀 批量发送定时器回调
+    // 🚀 固定间隔批量发送：生产者只置脏位，不再各自启动定时器
     processBatchSend();
-    stopTimer(); // 单次触发，处理完成后停止
+    
+    if (++ticksSinceStreamCheck >= STREAM_CHECK_TICKS)
+    {
+        ticksSinceStreamCheck = 0;
+        checkStreamConnections();
+    }
 }
 
-void OSCCommunicator::processBatchSend()
+void OSCCommunicator::checkStreamConnections()
 {
-    std::lock_guard<std::mutex> lock(messageQueueMutex);
-    
-    if (messageQueue.empty() || !isConnected())
+    if (!isConnected())
     {
         return;
     }
     
-    // 🚀 优先级排序：高优先级消息优先发送
-    std::sort(messageQueue.begin(), messageQueue.end(), 
-        [](const OSCMessage& a, const OSCMessage& b) {
-            if (a.priority != b.priority) return a.priority < b.priority; // 数字小 = 优先级高
-            return a.timestamp < b.timestamp; // 同优先级按时间顺序
-        });
-    
-    // 批量发送所有消息
-    size_t successCount = 0;
-    for (const auto& msg : messageQueue)
+    const juce::int64 connections = hub->getStreamConnectionCount();
+    if (connections == lastStreamConnections)
     {
-        if (sendQueuedMessage(msg))
-        {
-            successCount++;
-        }
+        return;
     }
     
-    OSC_DBG_ROLE("OSCCommunicator: Batch sent " + juce::String(successCount) + "/" + juce::String(messageQueue.size()) + " messages");
+    // 计数减少说明目标被重建（网络配置修改），同样视为新连接
+    lastStreamConnections = connections;
     
-    // 清空队列和索引映射
-    messageQueue.clear();
-    addressToQueueIndex.clear();
+    if (connections > 0 && onStreamTargetConnected)
+    {
+        OSC_DBG_ROLE("OSCCommunicator: TCP OSC target connected - resending full state");
+        onStreamTargetConnected();
+    }
 }
 
-bool OSCCommunicator::sendQueuedMessage(const OSCMessage& msg)
+void OSCCommunicator::processBatchSend()
 {
-    if (!sender || !isConnected())
+    if (!isConnected())
     {
-        return false;
+        return;
     }
     
-    bool success = sender->send(msg.address, msg.value);
+    batchScratch.clear();
     
-    if (success)
+    // 🚀 按优先级顺序取出脏槽位：无排序，同一地址只发送最新值
+    stateTable.drain([this](int slot, float value)
     {
-        OSC_DBG_ROLE("OSCCommunicator: Sent queued message - " + msg.address + " = " + juce::String(msg.value));
+        if (OSCCoalescingTable::isChannelSlot(slot))
+        {
+            const auto action = OSCCoalescingTable::getSlotAction(slot);
+            const int channelId = OSCCoalescingTable::getSlotChannelId(slot);
+            const auto& address = addressTable.getChannelAddress(action, channelId);
+            
+            // 不在当前布局中的通道（布局切换前入队）回退到动态格式化
+            batchScratch.emplace_back(address.isNotEmpty() ? address
+                                                           : formatOSCAddress(OSCAddressTable::getActionName(action),
+                                                                              OSCAddressTable::getChannelName(channelId)),
+                                      value);
+        }
+        else
+        {
+            batchScratch.emplace_back(OSCAddressTable::getMasterAddress(OSCCoalescingTable::getSlotMasterControl(slot)), value);
+        }
+    });
+    
+    {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        for (const auto& pending : overflowMessages)
+        {
+            batchScratch.emplace_back(pending.first, pending.second);
+        }
+        overflowMessages.clear();
     }
-    else
+    
+    if (batchScratch.empty())
     {
-        OSC_DBG_ROLE("OSCCommunicator: Failed to send queued message - " + msg.address);
+        return;
     }
     
-    return success;
+    // 由共享目标的发送线程打包为MTU大小、共享时间标签的Bundle
+    // 删除垃圾日志 - 批量发送每10ms触发
+    sendToTargets(batchScratch);
 }
\ No newline at end of file
@@ -3,11 +3,29 @@
 #include <JuceHeader.h>
 #include <memory>
 #include <atomic>
+#include "OSCAddressTable.h"
+#include "LockFreeMPSCQueue.h"
+#include "OSCCoalescingTable.h"
+#include "SharedOSCHub.h"
 
 // Forward declarations
 class SemanticChannelState;
 class PhysicalChannelMapper;
 class MonitorControllerMaxAudioProcessor;
+struct AnalyserSnapshot;
+struct MeterSnapshot;
+struct PropagationReport;
+
+/**
+ * OSC控制命令 - 接收线程解码后的固定大小结构，经无锁队列在线程间传递
+ * Master的Volume值已换算为0-100百分比，其余为原始值（>0.5为ON）
+ */
+struct OSCControlCommand
+{
+    OSCAddressTable::ParsedAddress address;
+    float value = 0.0f;
+    juce::int64 receivedTicks = 0;  // 到达时刻（高精度ticks），用于延迟统计
+};
 
 /**
  * OSC通信管理器 - 处理监听控制器的OSC双向通信
@@ -22,17 +40,21 @@ class MonitorControllerMaxAudioProcessor;
  * 值: 1.0f (ON) / 0.0f (OFF)
  * 示例: /Monitor/Solo/L 1.0, /Monitor/Mute/SUB_B 0.0
  * 注：通道名中的空格会自动转换为下划线
+ * 地址模式（仅接收）：通道段支持OSC 1.0的 * ? [..] {a,b}，作为一个状态事务应用
+ * 示例: /Monitor/Mute/{LTF,RTF,LTB,RTB} 1.0, /Monitor/Solo/SUB* 1.0
  * 
  * 双向同步：
  * - 接收外部控制消息并更新内部状态
  * - 对所有状态变化发送确认反馈
  * - 实现控制器与插件的真正双向状态同步
  */
-// 🚀 稳定性修复：从RealtimeCallback改为MessageLoopCallback
-// 避免在实时线程中触发UI更新，严格遵循JUCE线程模型
 // 🚀 v4.2: 增加Timer支持实现批量发送优化
-class OSCCommunicator : public juce::OSCReceiver::Listener<juce::OSCReceiver::MessageLoopCallback>,
-                       public juce::Timer
+// 🚀 实时接收路径：共享接收线程只解码，不触碰状态和UI
+//   SharedOSCHub接收线程（Master音频控制立即写入实时状态）--MPSC--> 消息线程（状态模型/参数/UI/反馈）
+// 🚀 套接字、接收线程和发送目标由进程内所有实例共享（SharedOSCHub），实例之间按组前缀区分
+class OSCCommunicator : public juce::Timer,
+                       private SharedOSCHub::Endpoint,
+                       private juce::AsyncUpdater
 {
 public:
     OSCCommunicator();
@@ -45,6 +67,23 @@ public:
     bool initialize();
     void shutdown();
     bool isConnected() const;
+    
+    // 实例组：空字符串为默认组（/Monitor/...），否则收发地址为 /<组名>/Monitor/...
+    void setAddressGroup(const juce::String& groupName);
+    const juce::String& getAddressGroup() const { return addressGroup; }
+    
+    // 发送目标配置（消息线程）：对进程内所有实例生效，可选保存到用户目录
+    OSCNetworkConfig getNetworkConfig() const;
+    bool setNetworkConfig(const OSCNetworkConfig& newConfig, bool saveToUserFile = true);
+    
+    // 入站统计（诊断与基准测试）：累计值，任意线程读取
+    struct ReceiveStats
+    {
+        juce::int64 receivedMessages = 0;     // 接收线程收到的本组消息
+        juce::int64 dispatchedCommands = 0;   // 消息线程已分发的命令
+    };
+    
+    ReceiveStats getReceiveStats() const noexcept;
 
     // 发送状态到外部设备
     void sendSoloState(const juce::String& channelName, bool state);
@@ -57,16 +96,41 @@ public:
     void sendMasterMute(bool masterMuteState);
     void sendMasterMono(bool monoState);
     
+    // 分析器数据输出（10Hz）：/Monitor/Analyser/Spectrum/{ch} 频带dB，/Monitor/Analyser/Correlation/{L_R} 相关系数
+    void sendAnalyserSnapshot(const AnalyserSnapshot& snapshot, const juce::StringArray& channelNames);
+    
+    // 电平表输出（10-60Hz）：/Monitor/Meter 每通道 [峰值dBFS, RMS dBFS] 浮点数组，按物理通道顺序；
+    // 通道顺序由 /Monitor/Meter/Channels（通道名字符串）描述，布局变化时及每秒发送一次
+    void sendMeterSnapshot(const MeterSnapshot& snapshot, const juce::StringArray& channelNames, int frameRateHz);
+    
+    // Master传播报告（1Hz，仅Master）：/Monitor/Sync/Propagation
+    // [序号, Slave数, 最大落后次数, p50 ms, p99 ms, 最大 ms, 样本数]
+    void sendPropagationReport(const PropagationReport& report);
+    
+    // 布局变化时重建预计算的出站地址表（消息线程）
+    void updateAddressTable(const juce::StringArray& layoutChannelNames);
+    
     // 状态反馈机制 - 广播所有当前状态
     void broadcastAllStates(const SemanticChannelState& semanticState, 
                            const PhysicalChannelMapper& physicalMapper);
     
-    // OSC接收处理 (来自juce::OSCReceiver::Listener)
-    void oscMessageReceived(const juce::OSCMessage& message) override;
+    // 🚀 接收线程回调：Master音频控制（Volume/Dim/Low Boost/Mute/Mono）不经消息线程，下一音频块生效
+    // 必须无锁、无分配；消息线程随后仍会收到对应的onMaster*OSC回调
+    std::function<void(OSCAddressTable::MasterControl control, float value)> onRealtimeMasterControl;
     
     // 设置状态更新回调 (用于接收外部OSC控制时更新语义状态)
     std::function<void(const juce::String& action, const juce::String& channelName, bool state)> onExternalStateChange;
     
+    // 地址模式批量控制（/Monitor/Mute/{LTF,RTF}、/Monitor/Solo/SUB*）：已按当前布局过滤，作为一个状态事务应用
+    std::function<void(const juce::String& action, const juce::StringArray& channelNames, bool state)> onExternalBatchStateChange;
+    
+    // 消息线程：一条命令分发完成（语义状态与RenderState均已更新）后回调，
+    // completedTicks与command.receivedTicks同为高精度ticks，差值即到达->发布延迟；未设置时无开销
+    std::function<void(const OSCControlCommand& command, juce::int64 completedTicks)> onCommandDispatched;
+    
+    // TCP目标（重新）建立连接（消息线程）：对端可能刚启动，需要广播全部状态
+    std::function<void()> onStreamTargetConnected;
+    
     // v4.1: Master总线OSC控制回调
     std::function<void(float volumePercent)> onMasterVolumeOSC;
     std::function<void(bool dimState)> onMasterDimOSC;
@@ -75,55 +139,68 @@ public:
     std::function<void(bool monoState)> onMasterMonoOSC;
 
 private:
-    // OSC通信组件
-    std::unique_ptr<juce::OSCSender> sender;
-    std::unique_ptr<juce::OSCReceiver> receiver;
+    // 进程级共享OSC中心（initialize()时获取，shutdown()时释放）
+    std::shared_ptr<SharedOSCHub> hub;
+    juce::String addressGroup;
     
-    // 硬编码配置
-    static constexpr const char* TARGET_IP = "127.0.0.1";
-    static constexpr int TARGET_PORT = 7444;
-    static constexpr int RECEIVE_PORT = 7445;
+    // 电平表通道描述（消息线程）
+    juce::String lastMeterLayout;
+    int framesSinceMeterLayout = 0;
     
     // 连接状态
     std::atomic<bool> isInitialized{false};
-    std::atomic<bool> senderConnected{false};
-    std::atomic<bool> receiverConnected{false};
     
     // Processor指针用于角色日志
     MonitorControllerMaxAudioProcessor* processorPtr = nullptr;
     
-    // 🚀 性能优化：消息队列系统
-    struct OSCMessage {
-        juce::String address;
-        float value;
-        int priority;  // 0 = 高优先级, 1 = 中等, 2 = 低优先级
-        juce::int64 timestamp;
-        
-        OSCMessage(const juce::String& addr, float val, int prio = 1) 
-            : address(addr), value(val), priority(prio)
-            , timestamp(juce::Time::getCurrentTime().toMilliseconds()) {}
-    };
+    // 🚀 预计算出站地址 + 零分配入站解析
+    OSCAddressTable addressTable;
+    
+    // 🚀 出站状态合并表：生产者无锁（任意线程），消息线程定时按优先级取出
+    OSCCoalescingTable stateTable;
+    std::vector<juce::OSCMessage> batchScratch;   // 预留容量，批次之间复用
+    static constexpr int BATCH_INTERVAL_MS = 10;
     
-    mutable std::mutex messageQueueMutex;
-    std::vector<OSCMessage> messageQueue;
+    // TCP目标连接计数（每STREAM_CHECK_TICKS个批次检查一次）
+    static constexpr int STREAM_CHECK_TICKS = 50;
+    juce::int64 lastStreamConnections = 0;
+    int ticksSinceStreamCheck = 0;
+    void checkStreamConnections();
     
-    // 消息合并优化
-    std::map<juce::String, size_t> addressToQueueIndex;  // 地址到队列索引的映射
+    // 不在通道表中的自定义通道名：少见路径，加锁合并
+    std::mutex overflowMutex;
+    std::vector<std::pair<juce::String, float>> overflowMessages;
     
     // 🚀 队列处理方法
-    void queueOSCMessage(const juce::String& address, float value, int priority = 1);
+    void queueChannelState(OSCAddressTable::Action action, const juce::String& channelName, float value);
+    void queueMasterState(OSCAddressTable::MasterControl control, float value);
     void processBatchSend();  // 批量发送处理
-    bool sendQueuedMessage(const OSCMessage& msg);  // 返回发送是否成功
+    
+    // 🚀 多目标扇出：只入队，Bundle打包和网络I/O由共享OSCTarget的发送线程完成
+    void sendToTargets(const std::vector<juce::OSCMessage>& messages);
     
     // Timer回调 (继承自juce::Timer)
     void timerCallback() override;
     
+    // 🚀 实时接收路径
+    static constexpr size_t COMMAND_QUEUE_CAPACITY = 1024;
+    LockFreeMPSCQueue<OSCControlCommand, COMMAND_QUEUE_CAPACITY> messageThreadCommands;  // 接收线程 -> 消息线程
+    std::atomic<int> droppedCommands{0};    // 队列满丢弃的命令数
+    std::atomic<int> rejectedMessages{0};   // 无法解码的消息数
+    std::atomic<juce::int64> receivedMessages{0};
+    std::atomic<juce::int64> dispatchedCommands{0};
+    
+    void handleHubMessage(const juce::OSCMessage& message, const char* address, size_t length) noexcept override;  // 共享接收线程
+    void handleAsyncUpdate() override;   // 消息线程 (继承自juce::AsyncUpdater)
+    void discardPendingCommands();
+    
     // 内部工具方法
-    void handleIncomingOSCMessage(const juce::OSCMessage& message);
-    void handleMasterBusOSCMessage(const juce::String& address, const juce::OSCMessage& message);  // v4.1: Master总线OSC处理
+    static bool decodeOSCCommand(const juce::OSCMessage& message, const char* address, size_t length,
+                                 OSCControlCommand& command) noexcept;
+    void dispatchOnMessageThread(const OSCControlCommand& command);
+    void handleMasterBusOSCMessage(OSCAddressTable::MasterControl control, float value);  // v4.1: Master总线OSC处理
+    static bool getNumericArgument(const juce::OSCMessage& message, float& value) noexcept;
     juce::String formatOSCAddress(const juce::String& action, const juce::String& channelName) const;
-    std::pair<juce::String, juce::String> parseOSCAddress(const juce::String& address) const;
-    bool isValidChannelName(const juce::String& channelName) const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCCommunicator)
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+﻿/*
+  ==============================================================================
+
+    OSCSlipCodec.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC包编码与SLIP帧实现
+
+  ==============================================================================
+*/
+
+#include "OSCSlipCodec.h"
+
+namespace
+{
+    void writePaddedBytes(juce::MemoryOutputStream& out, const void* data, size_t size, bool nullTerminated)
+    {
+        out.write(data, size);
+
+        // 字符串至少一个结尾0；整体补齐到4字节
+        size_t written = size;
+        if (nullTerminated)
+        {
+            out.writeByte(0);
+            ++written;
+        }
+
+        while ((written & 3) != 0)
+        {
+            out.writeByte(0);
+            ++written;
+        }
+    }
+
+    void writeOSCString(juce::MemoryOutputStream& out, const juce::String& text)
+    {
+        writePaddedBytes(out, text.toRawUTF8(), text.getNumBytesAsUTF8(), true);
+    }
+}
+
+//==============================================================================
+void OSCSlipCodec::writeMessage(juce::MemoryOutputStream& out, const juce::OSCMessage& message)
+{
+    writeOSCString(out, message.getAddressPattern().toString());
+
+    // 类型标签 ",fis..."
+    juce::String typeTags(",");
+    for (const auto& argument : message)
+        typeTags += juce::String::charToString(static_cast<juce::juce_wchar>(argument.getType()));
+    writeOSCString(out, typeTags);
+
+    for (const auto& argument : message)
+    {
+        if (argument.isFloat32())
+        {
+            out.writeFloatBigEndian(argument.getFloat32());
+        }
+        else if (argument.isInt32())
+        {
+            out.writeIntBigEndian(argument.getInt32());
+        }
+        else if (argument.isString())
+        {
+            writeOSCString(out, argument.getString());
+        }
+        else if (argument.isBlob())
+        {
+            const auto& blob = argument.getBlob();
+            out.writeIntBigEndian(static_cast<int>(blob.getSize()));
+            writePaddedBytes(out, blob.getData(), blob.getSize(), false);
+        }
+        else if (argument.isColour())
+        {
+            out.writeIntBigEndian(static_cast<int>(argument.getColour().toInt32()));
+        }
+    }
+}
+
+void OSCSlipCodec::writeBundle(juce::MemoryOutputStream& out, const juce::OSCMessage* messages, size_t count,
+                               juce::OSCTimeTag timeTag)
+{
+    writePaddedBytes(out, "#bundle", 7, true);
+    out.writeInt64BigEndian(static_cast<juce::int64>(timeTag.getRawTimeTag()));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        // 元素大小在写完后回填，避免对每条消息编码两次
+        const auto sizePosition = out.getPosition();
+        out.writeIntBigEndian(0);
+
+        writeMessage(out, messages[i]);
+
+        const auto endPosition = out.getPosition();
+        out.setPosition(sizePosition);
+        out.writeIntBigEndian(static_cast<int>(endPosition - sizePosition - 4));
+        out.setPosition(endPosition);
+    }
+}
+
+void OSCSlipCodec::appendFrame(juce::MemoryOutputStream& out, const void* packet, size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(packet);
+
+    out.writeByte(static_cast<char>(END));
+
+    // 按无需转义的连续区间整段写入
+    size_t runStart = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (bytes[i] != END && bytes[i] != ESC)
+            continue;
+
+        out.write(bytes + runStart, i - runStart);
+        out.writeByte(static_cast<char>(ESC));
+        out.writeByte(static_cast<char>(bytes[i] == END ? ESC_END : ESC_ESC));
+        runStart = i + 1;
+    }
+
+    out.write(bytes + runStart, size - runStart);
+    out.writeByte(static_cast<char>(END));
+}
@@ -0,0 +1,111 @@
+﻿/*
+  ==============================================================================
+
+    OSCSlipCodec.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC 1.1 流式传输编解码 - OSC包编码 + SLIP帧（RFC 1055，双END定界）
+
+    - juce::OSCSender只支持UDP，TCP目标需要自行把消息/Bundle编码为OSC包字节
+    - SLIP：END(0xC0)界定帧，数据中的END/ESC转义为 ESC ESC_END / ESC ESC_ESC
+    - Decoder用于回环测试对端：按任意分片喂入字节，逐帧回调
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+/**
+ * OSC包编码 + SLIP帧编解码（无状态静态方法 + 有状态Decoder）
+ */
+struct OSCSlipCodec
+{
+    static constexpr uint8_t END = 0xC0;
+    static constexpr uint8_t ESC = 0xDB;
+    static constexpr uint8_t ESC_END = 0xDC;
+    static constexpr uint8_t ESC_ESC = 0xDD;
+
+    //==============================================================================
+    // OSC包编码（大端，字符串/Blob补齐到4字节）
+    static void writeMessage(juce::MemoryOutputStream& out, const juce::OSCMessage& message);
+    static void writeBundle(juce::MemoryOutputStream& out, const juce::OSCMessage* messages, size_t count,
+                            juce::OSCTimeTag timeTag);
+
+    // 把一个完整OSC包追加为SLIP帧：END + 转义后的包 + END
+    static void appendFrame(juce::MemoryOutputStream& out, const void* packet, size_t size);
+
+    //==============================================================================
+    /**
+     * SLIP解码器 - 单线程使用
+     *
+     * 连续的END（双END定界产生的空帧）被忽略；超过maxFrameBytes的帧整帧丢弃。
+     */
+    class Decoder
+    {
+    public:
+        explicit Decoder(size_t maxFrameBytes = 1 << 20) : maxBytes(maxFrameBytes) {}
+
+        // callback(const uint8_t* packet, size_t size)，每个完整帧回调一次
+        template <typename Callback>
+        void feed(const void* data, size_t size, Callback&& callback)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                uint8_t byte = bytes[i];
+
+                if (byte == END)
+                {
+                    if (!frame.empty() && !overflowed)
+                        callback(frame.data(), frame.size());
+
+                    frame.clear();
+                    escaped = false;
+                    overflowed = false;
+                    continue;
+                }
+
+                if (escaped)
+                {
+                    escaped = false;
+                    if (byte == ESC_END)      byte = END;
+                    else if (byte == ESC_ESC) byte = ESC;
+                    // 非法转义：按OSC 1.1建议原样保留
+                }
+                else if (byte == ESC)
+                {
+                    escaped = true;
+                    continue;
+                }
+
+                if (frame.size() >= maxBytes)
+                {
+                    overflowed = true;
+                    continue;
+                }
+
+                frame.push_back(byte);
+            }
+        }
+
+        void reset() noexcept
+        {
+            frame.clear();
+            escaped = false;
+            overflowed = false;
+        }
+
+    private:
+        std::vector<uint8_t> frame;
+        const size_t maxBytes;
+        bool escaped = false;
+        bool overflowed = false;
+    };
+};
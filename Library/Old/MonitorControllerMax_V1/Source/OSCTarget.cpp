@@ -0,0 +1,651 @@
+﻿/*
+  ==============================================================================
+
+    OSCTarget.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC发送目标实现 - 配置加载/保存、独立发送线程、令牌桶限速、Bundle打包、TCP/SLIP传输
+
+  ==============================================================================
+*/
+
+#include "OSCTarget.h"
+#include "DebugLogger.h"
+#include "BinaryData.h"
+#include "OSCSlipCodec.h"
+
+#if ! JUCE_WINDOWS
+ #include <sys/socket.h>
+ #include <cerrno>
+#endif
+
+namespace
+{
+    // 写入全部字节；POSIX上对端关闭时不能触发SIGPIPE（默认会终止宿主进程）
+    bool writeFully(juce::StreamingSocket& socket, const void* data, int size)
+    {
+       #if defined(MSG_NOSIGNAL)
+        const auto* bytes = static_cast<const char*>(data);
+        int written = 0;
+
+        while (written < size)
+        {
+            const auto result = ::send(socket.getRawSocketHandle(), bytes + written,
+                                       static_cast<size_t>(size - written), MSG_NOSIGNAL);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false;
+
+            written += static_cast<int>(result);
+        }
+
+        return true;
+       #else
+        return socket.write(data, size) == size;
+       #endif
+    }
+
+    void disableSigPipe(juce::StreamingSocket& socket)
+    {
+       #if defined(SO_NOSIGPIPE)
+        int enabled = 1;
+        ::setsockopt(socket.getRawSocketHandle(), SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+       #else
+        juce::ignoreUnused(socket);
+       #endif
+    }
+}
+
+//==============================================================================
+// OSCTargetConfig
+//==============================================================================
+
+juce::var OSCTargetConfig::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("name", name);
+    object->setProperty("host", host);
+    object->setProperty("port", port);
+    object->setProperty("enabled", enabled);
+    object->setProperty("coalesce", coalesce);
+    object->setProperty("maxMessagesPerSecond", maxMessagesPerSecond);
+    object->setProperty("transport", transport == Transport::TCP ? "tcp" : "udp");
+    return juce::var(object);
+}
+
+OSCTargetConfig OSCTargetConfig::fromVar(const juce::var& value)
+{
+    OSCTargetConfig result;
+    result.name = value.getProperty("name", result.name).toString();
+    result.host = value.getProperty("host", result.host).toString().trim();
+    result.port = juce::jlimit(1, 65535, static_cast<int>(value.getProperty("port", result.port)));
+    result.enabled = static_cast<bool>(value.getProperty("enabled", result.enabled));
+    result.coalesce = static_cast<bool>(value.getProperty("coalesce", result.coalesce));
+    result.maxMessagesPerSecond = juce::jmax(0, static_cast<int>(value.getProperty("maxMessagesPerSecond", result.maxMessagesPerSecond)));
+    result.transport = value.getProperty("transport", "udp").toString().trim().equalsIgnoreCase("tcp") ? Transport::TCP
+                                                                                                      : Transport::UDP;
+
+    if (result.name.isEmpty())
+        result.name = result.host + ":" + juce::String(result.port);
+
+    return result;
+}
+
+juce::String OSCTargetConfig::getDescription() const
+{
+    juce::String description = name + " (" + host + ":" + juce::String(port);
+    if (transport == Transport::TCP)
+        description += ", TCP";
+    if (maxMessagesPerSecond > 0)
+        description += ", " + juce::String(maxMessagesPerSecond) + " msg/s";
+    if (!coalesce)
+        description += ", no coalescing";
+    return description + ")";
+}
+
+//==============================================================================
+// OSCNetworkConfig
+//==============================================================================
+
+OSCNetworkConfig OSCNetworkConfig::createDefault()
+{
+    OSCNetworkConfig result;
+    OSCTargetConfig controller;
+    controller.name = "Controller";
+    result.targets.add(controller);
+    return result;
+}
+
+OSCNetworkConfig OSCNetworkConfig::fromJSON(const juce::String& jsonText, bool& ok)
+{
+    OSCNetworkConfig result;
+    ok = false;
+
+    // 兼容带BOM的UTF-8文件
+    juce::String text = jsonText;
+    if (text.startsWithChar(static_cast<juce::juce_wchar>(0xfeff)))
+        text = text.substring(1);
+
+    juce::var parsed;
+    if (juce::JSON::parse(text, parsed).failed() || !parsed.isObject())
+        return result;
+
+    result.receivePort = juce::jlimit(1, 65535, static_cast<int>(parsed.getProperty("receivePort", DEFAULT_RECEIVE_PORT)));
+
+    const juce::var targetList = parsed.getProperty("targets", juce::var());
+    if (const auto* targetArray = targetList.getArray())
+    {
+        for (const auto& target : *targetArray)
+        {
+            if (target.isObject())
+                result.targets.add(OSCTargetConfig::fromVar(target));
+        }
+    }
+
+    ok = true;
+    return result;
+}
+
+OSCNetworkConfig OSCNetworkConfig::load()
+{
+    bool ok = false;
+
+    // 1. 用户目录（运行时修改后保存的位置）
+    const auto userFile = getUserConfigFile();
+    if (userFile.existsAsFile())
+    {
+        auto result = fromJSON(userFile.loadFileAsString(), ok);
+        if (ok)
+        {
+            VST3_DBG("OSCNetworkConfig: Loaded " + juce::String(result.targets.size()) + " targets from " + userFile.getFullPathName());
+            return result;
+        }
+
+        VST3_DBG("OSCNetworkConfig: Failed to parse " + userFile.getFullPathName() + " - using built-in defaults");
+    }
+
+    // 2. 内置默认配置
+    if (BinaryData::OSC_Targets_json != nullptr)
+    {
+        auto result = fromJSON(juce::String::fromUTF8(BinaryData::OSC_Targets_json, BinaryData::OSC_Targets_jsonSize), ok);
+        if (ok)
+            return result;
+    }
+
+    // 3. 优雅降级：硬编码默认值（与旧版本行为一致）
+    VST3_DBG("OSCNetworkConfig: Built-in OSC_Targets.json unavailable - using hardcoded defaults");
+    return createDefault();
+}
+
+juce::File OSCNetworkConfig::getUserConfigFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("MonitorControllerMax")
+               .getChildFile("OSC_Targets.json");
+}
+
+juce::String OSCNetworkConfig::toJSON() const
+{
+    auto* root = new juce::DynamicObject();
+    root->setProperty("receivePort", receivePort);
+
+    juce::Array<juce::var> targetList;
+    for (const auto& target : targets)
+        targetList.add(target.toVar());
+    root->setProperty("targets", targetList);
+
+    return juce::JSON::toString(juce::var(root));
+}
+
+bool OSCNetworkConfig::save() const
+{
+    const auto userFile = getUserConfigFile();
+    const auto result = userFile.getParentDirectory().createDirectory();
+
+    if (result.failed() || !userFile.replaceWithText(toJSON()))
+    {
+        VST3_DBG("OSCNetworkConfig: Failed to save " + userFile.getFullPathName());
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+// OSCTarget
+//==============================================================================
+
+OSCTarget::OSCTarget(const OSCTargetConfig& targetConfig)
+    : juce::Thread("OSC Target " + targetConfig.name),
+      config(targetConfig)
+{
+    pending.reserve(64);
+}
+
+OSCTarget::~OSCTarget()
+{
+    stop();
+}
+
+bool OSCTarget::start()
+{
+    // UDP connect只创建套接字并记录目标地址，不会阻塞；
+    // TCP连接在发送线程中建立（可能阻塞），这里只启动线程
+    if (config.transport == OSCTargetConfig::Transport::TCP)
+        connected.store(true, std::memory_order_relaxed);
+    else
+        connected.store(sender.connect(config.host, config.port), std::memory_order_relaxed);
+
+    if (isConnected())
+    {
+        tokens = static_cast<double>(juce::jmax(1, config.maxMessagesPerSecond / 5));
+        lastRefillSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
+        startThread(juce::Thread::Priority::normal);
+    }
+
+    return isConnected();
+}
+
+void OSCTarget::stop()
+{
+    if (isThreadRunning())
+    {
+        signalThreadShouldExit();
+
+        // 关闭TCP套接字以打断阻塞中的connect/write
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            if (streamSocket != nullptr)
+                streamSocket->close();
+        }
+
+        notify();
+        stopThread(1000);
+    }
+
+    closeStream();
+
+    if (connected.exchange(false) && config.transport == OSCTargetConfig::Transport::UDP)
+        sender.disconnect();
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending.clear();
+    pendingIndex.clear();
+}
+
+void OSCTarget::enqueue(const std::vector<juce::OSCMessage>& messages)
+{
+    if (messages.empty() || !isConnected())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+
+        for (const auto& message : messages)
+        {
+            if (config.coalesce)
+            {
+                // 合并：同一地址只保留最新值，保持首次入队的位置
+                const auto address = message.getAddressPattern().toString();
+                const auto existing = pendingIndex.find(address);
+                if (existing != pendingIndex.end())
+                {
+                    pending[existing->second] = message;
+                    coalescedMessages.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (pending.size() >= static_cast<size_t>(MAX_PENDING_MESSAGES))
+                {
+                    droppedMessages.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                pendingIndex[address] = pending.size();
+                pending.push_back(message);
+            }
+            else if (pending.size() < static_cast<size_t>(MAX_PENDING_MESSAGES))
+            {
+                pending.push_back(message);
+            }
+            else
+            {
+                // 慢速目标积压：丢弃新消息而不是阻塞生产者
+                droppedMessages.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    notify();
+}
+
+OSCTarget::Stats OSCTarget::getStats() const noexcept
+{
+    Stats stats;
+    stats.sentMessages = sentMessages.load(std::memory_order_relaxed);
+    stats.sentDatagrams = sentDatagrams.load(std::memory_order_relaxed);
+    stats.failedDatagrams = failedDatagrams.load(std::memory_order_relaxed);
+    stats.coalescedMessages = coalescedMessages.load(std::memory_order_relaxed);
+    stats.droppedMessages = droppedMessages.load(std::memory_order_relaxed);
+    stats.streamConnections = streamConnections.load(std::memory_order_relaxed);
+    return stats;
+}
+
+//==============================================================================
+void OSCTarget::run()
+{
+    std::vector<juce::OSCMessage> outgoing;
+    outgoing.reserve(64);
+
+    const bool isStream = config.transport == OSCTargetConfig::Transport::TCP;
+
+    while (!threadShouldExit())
+    {
+        // TCP未连接：消息留在合并队列中，按间隔重试连接
+        if (isStream && !ensureStreamConnected())
+        {
+            wait(STREAM_RECONNECT_INTERVAL_MS);
+            continue;
+        }
+
+        const int budget = refillSendBudget();
+        bool hasBacklog = false;
+
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+
+            const size_t count = juce::jmin(pending.size(), static_cast<size_t>(budget));
+            if (count > 0)
+            {
+                outgoing.assign(std::make_move_iterator(pending.begin()),
+                                std::make_move_iterator(pending.begin() + static_cast<std::ptrdiff_t>(count)));
+                pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count));
+
+                if (config.coalesce)
+                    rebuildPendingIndex();
+            }
+
+            hasBacklog = !pending.empty();
+        }
+
+        if (!outgoing.empty())
+        {
+            if (config.maxMessagesPerSecond > 0)
+                tokens -= static_cast<double>(outgoing.size());
+
+            if (isStream)
+            {
+                if (!sendOverStream(outgoing))
+                    requeueUnsent(outgoing);
+            }
+            else
+            {
+                sendAsBundles(outgoing);
+            }
+
+            outgoing.clear();
+            continue;
+        }
+
+        // 无消息：等待enqueue唤醒；有积压但无令牌：等到下一个令牌
+        wait(hasBacklog ? getMillisecondsUntilNextToken() : 100);
+    }
+}
+
+int OSCTarget::refillSendBudget() noexcept
+{
+    if (config.maxMessagesPerSecond <= 0)
+        return MAX_PENDING_MESSAGES;
+
+    // 令牌桶：容量为200ms的配额，允许状态转储时的小突发
+    const double rate = static_cast<double>(config.maxMessagesPerSecond);
+    const double capacity = juce::jmax(1.0, rate / 5.0);
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+
+    tokens = juce::jmin(capacity, tokens + (now - lastRefillSeconds) * rate);
+    lastRefillSeconds = now;
+
+    return static_cast<int>(tokens);
+}
+
+int OSCTarget::getMillisecondsUntilNextToken() const noexcept
+{
+    if (config.maxMessagesPerSecond <= 0)
+        return 1;
+
+    const double missing = juce::jmax(0.0, 1.0 - tokens);
+    return juce::jmax(1, static_cast<int>(std::ceil(missing * 1000.0 / static_cast<double>(config.maxMessagesPerSecond))));
+}
+
+void OSCTarget::rebuildPendingIndex()
+{
+    pendingIndex.clear();
+    for (size_t i = 0; i < pending.size(); ++i)
+        pendingIndex[pending[i].getAddressPattern().toString()] = i;
+}
+
+void OSCTarget::sendAsBundles(const std::vector<juce::OSCMessage>& messages)
+{
+    // 发送线程不写日志（DebugLogger非线程安全），结果记入统计
+    auto recordDatagram = [this](bool success, size_t messageCount)
+    {
+        if (success)
+        {
+            sentDatagrams.fetch_add(1, std::memory_order_relaxed);
+            sentMessages.fetch_add(static_cast<juce::int64>(messageCount), std::memory_order_relaxed);
+        }
+        else
+        {
+            failedDatagrams.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // 单条消息不需要Bundle开销
+    if (messages.size() == 1)
+    {
+        recordDatagram(sender.send(messages.front()), 1);
+        return;
+    }
+
+    // 同一批次所有Bundle共享"立即执行"时间标签：不依赖收发双方时钟同步（墙钟时间会让时钟落后的接收端延迟执行）
+    const juce::OSCTimeTag timeTag = juce::OSCTimeTag::immediately;
+    size_t first = 0;
+
+    while (first < messages.size())
+    {
+        // 贪心切分：Bundle头 + 每个元素(4字节长度 + 消息体)不超过单个数据报上限
+        int bundleBytes = BUNDLE_HEADER_BYTES;
+        size_t last = first;
+        while (last < messages.size())
+        {
+            const int elementBytes = 4 + getEncodedMessageSize(messages[last]);
+            if (last > first && bundleBytes + elementBytes > MAX_DATAGRAM_BYTES)
+                break;
+
+            bundleBytes += elementBytes;
+            ++last;
+        }
+
+        juce::OSCBundle bundle(timeTag);
+        for (size_t i = first; i < last; ++i)
+            bundle.addElement(messages[i]);
+
+        recordDatagram(sender.send(bundle), last - first);
+        first = last;
+    }
+}
+
+int OSCTarget::getEncodedMessageSize(const juce::OSCMessage& message)
+{
+    // OSC字符串：内容 + 结尾0，补齐到4字节
+    auto paddedStringSize = [](int numBytes) { return (numBytes + 4) & ~3; };
+
+    int size = paddedStringSize(message.getAddressPattern().toString().getNumBytesAsUTF8());
+    size += paddedStringSize(1 + message.size());  // 类型标签 ",fff..."
+
+    for (const auto& argument : message)
+    {
+        if (argument.isString())
+            size += paddedStringSize(argument.getString().getNumBytesAsUTF8());
+        else if (argument.isBlob())
+            size += 4 + ((static_cast<int>(argument.getBlob().getSize()) + 3) & ~3);
+        else
+            size += 4;  // int32 / float32 / colour
+    }
+
+    return size;
+}
+
+//==============================================================================
+// TCP/SLIP传输
+//==============================================================================
+
+bool OSCTarget::ensureStreamConnected()
+{
+    if (streamSocket != nullptr && streamSocket->isConnected())
+        return true;
+
+    closeStream();
+
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    if (now < nextConnectAttemptMs)
+        return false;
+
+    nextConnectAttemptMs = now + STREAM_RECONNECT_INTERVAL_MS;
+
+    auto socket = std::make_unique<juce::StreamingSocket>();
+
+    {
+        // 先登记再连接：stop()可以关闭仍在连接中的套接字
+        std::lock_guard<std::mutex> lock(streamMutex);
+        streamSocket = std::move(socket);
+    }
+
+    // JUCE的StreamingSocket::connect()在连接成功后设置TCP_NODELAY（禁用Nagle），
+    // 每批状态只有一次write，不会产生小包延迟
+    if (threadShouldExit() || !streamSocket->connect(config.host, config.port, STREAM_CONNECT_TIMEOUT_MS))
+    {
+        closeStream();
+        return false;
+    }
+
+    disableSigPipe(*streamSocket);
+
+    streamConnections.fetch_add(1, std::memory_order_relaxed);
+    streamConnected.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void OSCTarget::closeStream()
+{
+    std::unique_ptr<juce::StreamingSocket> oldSocket;
+
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        oldSocket = std::move(streamSocket);
+    }
+
+    streamConnected.store(false, std::memory_order_relaxed);
+
+    if (oldSocket != nullptr)
+        oldSocket->close();
+}
+
+bool OSCTarget::sendOverStream(const std::vector<juce::OSCMessage>& messages)
+{
+    // 🚀 整批编码到复用缓冲区，一次write：TCP无MTU限制，只限制单帧大小
+    streamFrames.reset();
+
+    auto appendPacketFrame = [this]
+    {
+        OSCSlipCodec::appendFrame(streamFrames, streamPacket.getData(), streamPacket.getDataSize());
+    };
+
+    if (messages.size() == 1)
+    {
+        streamPacket.reset();
+        OSCSlipCodec::writeMessage(streamPacket, messages.front());
+        appendPacketFrame();
+    }
+    else
+    {
+        const juce::OSCTimeTag timeTag = juce::OSCTimeTag::immediately;
+        size_t first = 0;
+
+        while (first < messages.size())
+        {
+            int bundleBytes = BUNDLE_HEADER_BYTES;
+            size_t last = first;
+            while (last < messages.size())
+            {
+                const int elementBytes = 4 + getEncodedMessageSize(messages[last]);
+                if (last > first && bundleBytes + elementBytes > MAX_STREAM_BUNDLE_BYTES)
+                    break;
+
+                bundleBytes += elementBytes;
+                ++last;
+            }
+
+            streamPacket.reset();
+            OSCSlipCodec::writeBundle(streamPacket, messages.data() + first, last - first, timeTag);
+            appendPacketFrame();
+            first = last;
+        }
+    }
+
+    const int frameBytes = static_cast<int>(streamFrames.getDataSize());
+    const bool success = streamSocket != nullptr
+                      && writeFully(*streamSocket, streamFrames.getData(), frameBytes);
+
+    if (success)
+    {
+        sentDatagrams.fetch_add(1, std::memory_order_relaxed);
+        sentMessages.fetch_add(static_cast<juce::int64>(messages.size()), std::memory_order_relaxed);
+    }
+    else
+    {
+        // 对端断开：下一轮重连，本批消息由调用方重新入队
+        failedDatagrams.fetch_add(1, std::memory_order_relaxed);
+        closeStream();
+    }
+
+    return success;
+}
+
+void OSCTarget::requeueUnsent(std::vector<juce::OSCMessage>& messages)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex);
+
+    // 未写出的消息放回队首；合并模式下队列中已有同地址的新值则丢弃旧值
+    std::vector<juce::OSCMessage> merged;
+    merged.reserve(messages.size() + pending.size());
+
+    for (auto& message : messages)
+    {
+        if (config.coalesce && pendingIndex.count(message.getAddressPattern().toString()) > 0)
+        {
+            coalescedMessages.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        merged.push_back(std::move(message));
+    }
+
+    for (auto& message : pending)
+    {
+        if (merged.size() >= static_cast<size_t>(MAX_PENDING_MESSAGES))
+        {
+            droppedMessages.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        merged.push_back(std::move(message));
+    }
+
+    pending.swap(merged);
+
+    if (config.coalesce)
+        rebuildPendingIndex();
+}
@@ -0,0 +1,172 @@
+﻿/*
+  ==============================================================================
+
+    OSCTarget.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    OSC发送目标 - 多目标扇出，每个目标独立线程、队列与限速
+
+    - 目标列表来自OSC_Targets.json（用户目录覆盖内置默认），运行时可修改并保存
+    - 每个目标拥有自己的OSCSender和发送线程：慢速或不可达目标不会拖慢其他目标和插件
+    - 合并策略：状态类目标只保留同一地址的最新值；日志类目标按顺序全部发送
+    - 令牌桶限速：maxMessagesPerSecond为0时不限速
+    - 传输：默认UDP；"tcp"目标使用持久TCP连接 + SLIP帧（OSC 1.1），整批一次写入，
+      断线自动重连，未写出的消息重新入队，适合无损的全量状态同步
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+/**
+ * 单个OSC目标的配置
+ */
+struct OSCTargetConfig
+{
+    enum class Transport
+    {
+        UDP,    // 每批拆分为MTU大小的Bundle数据报
+        TCP     // SLIP帧流，OSC 1.1
+    };
+
+    juce::String name;
+    juce::String host = "127.0.0.1";
+    int port = 7444;
+    bool enabled = true;
+    bool coalesce = true;             // true: 同一地址只发送最新值；false: 按顺序全部发送
+    int maxMessagesPerSecond = 0;     // 0 = 不限速
+    Transport transport = Transport::UDP;
+
+    juce::var toVar() const;
+    static OSCTargetConfig fromVar(const juce::var& value);
+    juce::String getDescription() const;
+};
+
+//==============================================================================
+/**
+ * OSC网络配置 - 接收端口 + 目标列表
+ *
+ * 加载顺序：用户目录OSC_Targets.json -> 内置BinaryData默认配置 -> 硬编码默认值
+ */
+struct OSCNetworkConfig
+{
+    static constexpr int DEFAULT_RECEIVE_PORT = 7445;
+
+    int receivePort = DEFAULT_RECEIVE_PORT;
+    juce::Array<OSCTargetConfig> targets;
+
+    static OSCNetworkConfig load();
+    static OSCNetworkConfig fromJSON(const juce::String& jsonText, bool& ok);
+    static OSCNetworkConfig createDefault();
+    static juce::File getUserConfigFile();
+
+    juce::String toJSON() const;
+    bool save() const;
+};
+
+//==============================================================================
+/**
+ * OSC发送目标
+ *
+ * 线程模型：
+ * - enqueue() 任意线程调用：只做内存操作（短暂持锁），不做任何网络I/O
+ * - 发送线程：按令牌桶预算取出消息，打包为MTU大小的Bundle发送
+ *   （TCP目标：建立/重建连接，整批编码为SLIP帧后一次写入）
+ * - start()/stop() 只在消息线程调用
+ *
+ * TCP目标的isConnected()表示目标已启动并接受入队；对端不可达时消息在合并队列中等待重连。
+ */
+class OSCTarget : private juce::Thread
+{
+public:
+    //==============================================================================
+    explicit OSCTarget(const OSCTargetConfig& targetConfig);
+    ~OSCTarget() override;
+
+    bool start();
+    void stop();
+    bool isConnected() const noexcept { return connected.load(std::memory_order_relaxed); }
+    bool isStreamConnected() const noexcept { return streamConnected.load(std::memory_order_relaxed); }
+    const OSCTargetConfig& getConfig() const noexcept { return config; }
+
+    // 任意线程：消息入队（批次内顺序保持不变）
+    void enqueue(const std::vector<juce::OSCMessage>& messages);
+
+    struct Stats
+    {
+        juce::int64 sentMessages = 0;
+        juce::int64 sentDatagrams = 0;
+        juce::int64 failedDatagrams = 0;
+        juce::int64 coalescedMessages = 0;
+        juce::int64 droppedMessages = 0;
+        juce::int64 streamConnections = 0;   // TCP：成功建立连接的次数
+    };
+
+    Stats getStats() const noexcept;
+
+    //==============================================================================
+    static int getEncodedMessageSize(const juce::OSCMessage& message);
+
+    static constexpr int MAX_PENDING_MESSAGES = 4096;
+    static constexpr int MAX_DATAGRAM_BYTES = 1400;  // 低于以太网MTU(1500) - IP/UDP头，避免分片
+    static constexpr int BUNDLE_HEADER_BYTES = 16;   // "#bundle\0" + 8字节时间标签
+    static constexpr int MAX_STREAM_BUNDLE_BYTES = 65536;  // TCP：单个SLIP帧内Bundle上限
+    static constexpr int STREAM_CONNECT_TIMEOUT_MS = 1000;
+    static constexpr int STREAM_RECONNECT_INTERVAL_MS = 1000;
+
+private:
+    //==============================================================================
+    void run() override;
+
+    int refillSendBudget() noexcept;
+    int getMillisecondsUntilNextToken() const noexcept;
+    void sendAsBundles(const std::vector<juce::OSCMessage>& messages);
+    void rebuildPendingIndex();
+
+    // TCP传输（只在发送线程调用）
+    bool ensureStreamConnected();
+    void closeStream();
+    bool sendOverStream(const std::vector<juce::OSCMessage>& messages);
+    void requeueUnsent(std::vector<juce::OSCMessage>& messages);
+
+    //==============================================================================
+    const OSCTargetConfig config;
+    juce::OSCSender sender;
+    std::atomic<bool> connected{ false };
+
+    // TCP连接：发送线程创建/销毁，stop()持锁close()以打断阻塞中的写入
+    std::unique_ptr<juce::StreamingSocket> streamSocket;
+    std::mutex streamMutex;
+    std::atomic<bool> streamConnected{ false };
+    juce::MemoryOutputStream streamPacket;    // 单个OSC包（复用）
+    juce::MemoryOutputStream streamFrames;    // 整批SLIP帧（复用）
+    double nextConnectAttemptMs = 0.0;
+
+    // 待发送队列（合并模式下按地址索引）
+    std::mutex pendingMutex;
+    std::vector<juce::OSCMessage> pending;
+    std::map<juce::String, size_t> pendingIndex;
+
+    // 令牌桶（只在发送线程访问）
+    double tokens = 0.0;
+    double lastRefillSeconds = 0.0;
+
+    std::atomic<juce::int64> sentMessages{ 0 };
+    std::atomic<juce::int64> sentDatagrams{ 0 };
+    std::atomic<juce::int64> failedDatagrams{ 0 };
+    std::atomic<juce::int64> coalescedMessages{ 0 };
+    std::atomic<juce::int64> droppedMessages{ 0 };
+    std::atomic<juce::int64> streamConnections{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCTarget)
+};
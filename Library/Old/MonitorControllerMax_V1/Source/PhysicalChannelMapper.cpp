@@ -185,6 +185,43 @@ int PhysicalChannelMapper::getChannelCount() const
     return static_cast<int>(semanticToPhysical.size());
 }
 
+std::vector<std::pair<int, int>> PhysicalChannelMapper::getStereoPairs(const Layout& layout)
+{
+    std::vector<std::pair<int, int>> pairs;
+
+    for (const auto& leftInfo : layout.channels)
+    {
+        const juce::String partnerName = getStereoPartnerName(leftInfo.name);
+        if (partnerName.isEmpty())
+            continue;
+
+        for (const auto& rightInfo : layout.channels)
+        {
+            if (rightInfo.name == partnerName)
+            {
+                pairs.push_back({ leftInfo.channelIndex, rightInfo.channelIndex });
+                break;
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+juce::String PhysicalChannelMapper::getStereoPartnerName(const juce::String& leftName)
+{
+    // SUB通道的左右写在后缀上
+    if (leftName == "SUB L")  return "SUB R";
+    if (leftName == "SUB_L")  return "SUB_R";
+
+    // 其余左声道以L开头（L、LR、LSS、LRS、LTF...），LFE不是左声道
+    if (leftName.startsWith("L") && leftName != "LFE")
+        return "R" + leftName.substring(1);
+
+    return {};
+}
+
 std::pair<int, int> PhysicalChannelMapper::getGridPosition(const juce::String& semanticName) const
 {
     auto it = gridPositions.find(semanticName);
@@ -36,6 +36,10 @@ public:
     std::vector<std::pair<juce::String, int>> getAllMappings() const;
     int getChannelCount() const;
 
+    // 立体声通道对（L/R、LSS/RSS、LTF/RTF、SUB L/SUB R...），返回按左声道排序的通道索引对
+    static std::vector<std::pair<int, int>> getStereoPairs(const Layout& layout);
+    static juce::String getStereoPartnerName(const juce::String& leftName);
+
     // Preserve existing grid position system
     std::pair<int, int> getGridPosition(const juce::String& semanticName) const;
     bool hasGridPosition(const juce::String& semanticName) const;
@@ -11,9 +11,22 @@
 #include "DebugLogger.h"
 #include "SafeUICallback.h"
 
+namespace
+{
+    // 本地Trim菜单的档位（dB），范围在maxLocalTrimDb之内
+    constexpr float localTrimStepsDb[] = { 6.0f, 3.0f, 1.0f, 0.5f, 0.0f, -0.5f, -1.0f, -3.0f, -6.0f, -12.0f };
+
+    enum LocalOverrideMenuId
+    {
+        localMuteMenuId = 1,
+        clearLocalOverridesMenuId = 2,
+        localTrimMenuIdBase = 100
+    };
+}
+
 //==============================================================================
 MonitorControllerMaxAudioProcessorEditor::MonitorControllerMaxAudioProcessorEditor (MonitorControllerMaxAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p), configManager(p.configManager), effectsPanel(p)
+    : AudioProcessorEditor (&p), audioProcessor (p), configManager(p.configManager), effectsPanel(p), analyserPanel(p)
 {
     addAndMakeVisible(globalMuteButton);
     globalMuteButton.setButtonText("MUTE");
@@ -79,6 +92,7 @@ MonitorControllerMaxAudioProcessorEditor::MonitorControllerMaxAudioProcessorEdit
     
     // v4.2: 设置Effects面板按钮 (替代原Low Boost和Mono按钮)
     setupEffectsPanel();
+    setupAnalyserPanel();
     
     // v4.2: 设置Effects面板按钮状态同步回调 (用于OSC控制时更新) (SafeUICallback重构)
     audioProcessor.masterBusProcessor.onLowBoostStateChanged = SAFE_UI_CALLBACK_SIMPLE(this, [this]()
@@ -187,6 +201,7 @@ MonitorControllerMaxAudioProcessorEditor::MonitorControllerMaxAudioProcessorEdit
     
     // 设置角色选择器
     setupRoleSelector();
+    setupGroupSelector();
     
     // 设置debug日志窗口
     addAndMakeVisible(debugLogLabel);
@@ -211,8 +226,8 @@ MonitorControllerMaxAudioProcessorEditor::MonitorControllerMaxAudioProcessorEdit
     setLookAndFeel(&customLookAndFeel);
     setSize (800, 600);
     
-    // 初始化已知的通道数
-    lastKnownChannelCount = audioProcessor.getTotalNumInputChannels();
+    // 初始化已知的通道数（只计主输入总线，侧链Stem/Reference不影响布局）
+    lastKnownChannelCount = audioProcessor.getMainBusNumInputChannels();
     
     // 设置处理器的布局自动切换回调 (SafeUICallback完整应用)
     // 🚀 稳定性优化：使用SafeUICallback保护，防止循环引用和悬空指针
@@ -254,9 +269,8 @@ MonitorControllerMaxAudioProcessorEditor::MonitorControllerMaxAudioProcessorEdit
     };
     audioProcessor.setLayoutChangeCallback(layoutChangeCallback);
     
-    // 🚀 稳定性优化：降低Timer频率从30Hz到10Hz，遵循JUCE最佳实践
-    // 10Hz已足够处理UI状态更新，同时减少CPU占用和竞态条件
-    startTimerHz(10);
+    // 🚀 按帧刷新：空闲帧只有一次原子交换，状态变化在下一帧内显示
+    startTimerHz(uiFrameRateHz);
     
     // 🚀 关键修复：直接在构造函数中完成UI初始化，避免异步回调的死锁风险
     try {
@@ -310,6 +324,7 @@ MonitorControllerMaxAudioProcessorEditor::~MonitorControllerMaxAudioProcessorEdi
     dimButton.setLookAndFeel(nullptr);
     masterMuteButton.setLookAndFeel(nullptr);
     effectsPanelButton.setLookAndFeel(nullptr);
+    analyserPanelButton.setLookAndFeel(nullptr);
     
     // 清理所有语义通道按钮的LookAndFeel引用
     for (auto& [channelName, buttonPair] : semanticChannelButtons)
@@ -380,6 +395,9 @@ void MonitorControllerMaxAudioProcessorEditor::resized()
     // v4.2: 添加Effects面板按钮
     sidebarFlex.items.add(juce::FlexItem(effectsPanelButton).withHeight(50).withMargin(5));
     
+    // 分析器面板按钮
+    sidebarFlex.items.add(juce::FlexItem(analyserPanelButton).withHeight(50).withMargin(5));
+    
     sidebarFlex.performLayout(sidebarBounds);
 
     // 3. 在主区域内进一步划分布局
@@ -394,6 +412,8 @@ void MonitorControllerMaxAudioProcessorEditor::resized()
     selectorFlex.justifyContent = juce::FlexBox::JustifyContent::flexEnd; // 靠右对齐
     selectorFlex.items.add(juce::FlexItem(roleLabel).withWidth(40).withHeight(30).withMargin(5));
     selectorFlex.items.add(juce::FlexItem(roleSelector).withWidth(100).withHeight(30).withMargin(5));
+    selectorFlex.items.add(juce::FlexItem(groupLabel).withWidth(45).withHeight(30).withMargin(5));
+    selectorFlex.items.add(juce::FlexItem(groupSelector).withWidth(110).withHeight(30).withMargin(5));
     selectorFlex.items.add(juce::FlexItem(speakerLayoutSelector).withWidth(150).withHeight(30).withMargin(5));
     selectorFlex.items.add(juce::FlexItem(subLayoutSelector).withWidth(100).withHeight(30).withMargin(5));
     selectorFlex.performLayout(selectorBounds);
@@ -418,6 +438,7 @@ void MonitorControllerMaxAudioProcessorEditor::mouseDown(const juce::MouseEvent&
 {
     // v4.2: 处理Effects面板外部点击关闭
     handleEffectsPanelOutsideClick(event);
+    handleAnalyserPanelOutsideClick(event);
     
     // 调用基类处理
     juce::Component::mouseDown(event);
@@ -433,7 +454,7 @@ void MonitorControllerMaxAudioProcessorEditor::updateLayout()
     const auto& currentLayout = audioProcessor.getCurrentLayout();
     
     // 获取当前通道数用于下拉框同步
-    int currentChannelCount = audioProcessor.getTotalNumInputChannels();
+    int currentChannelCount = audioProcessor.getMainBusNumInputChannels();
     
     // 根据当前总通道数找到最合适的配置并设置下拉框
     juce::String expectedSpeaker = "2.0";
@@ -550,7 +571,12 @@ void MonitorControllerMaxAudioProcessorEditor::updateLayout()
     {
         if (channelButtons.find(chanInfo.channelIndex) == channelButtons.end())
         {
-            channelButtons[chanInfo.channelIndex] = std::make_unique<juce::TextButton>(chanInfo.name);
+            auto channelButton = std::make_unique<ChannelGridButton>(chanInfo.name);
+            channelButton->onPopupMenu = [this, channelIndex = chanInfo.channelIndex]
+            {
+                showLocalOverrideMenu(channelIndex);
+            };
+            channelButtons[chanInfo.channelIndex] = std::move(channelButton);
             channelGridContainer.addAndMakeVisible(*channelButtons[chanInfo.channelIndex]);
             
             auto* button = channelButtons[chanInfo.channelIndex].get();
@@ -606,6 +632,7 @@ void MonitorControllerMaxAudioProcessorEditor::updateLayout()
         channelGrid.items.add(item);
 
     channelGrid.performLayout(channelGridContainer.getLocalBounds());
+    channelButtonViews.clear();  // 按钮对应的通道可能已变化，全量刷新一次
     updateChannelButtonStates(); // Ensure button states are updated immediately
     
     // NEW: Create semantic channel buttons based on current mapping - TEMPORARILY DISABLED
@@ -663,7 +690,12 @@ void MonitorControllerMaxAudioProcessorEditor::updateLayoutWithoutSelectorOverri
     {
         if (channelButtons.find(chanInfo.channelIndex) == channelButtons.end())
         {
-            channelButtons[chanInfo.channelIndex] = std::make_unique<juce::TextButton>(chanInfo.name);
+            auto channelButton = std::make_unique<ChannelGridButton>(chanInfo.name);
+            channelButton->onPopupMenu = [this, channelIndex = chanInfo.channelIndex]
+            {
+                showLocalOverrideMenu(channelIndex);
+            };
+            channelButtons[chanInfo.channelIndex] = std::move(channelButton);
             channelGridContainer.addAndMakeVisible(*channelButtons[chanInfo.channelIndex]);
             
             auto* button = channelButtons[chanInfo.channelIndex].get();
@@ -719,6 +751,7 @@ void MonitorControllerMaxAudioProcessorEditor::updateLayoutWithoutSelectorOverri
         channelGrid.items.add(item);
 
     channelGrid.performLayout(channelGridContainer.getLocalBounds());
+    channelButtonViews.clear();  // 按钮对应的通道可能已变化，全量刷新一次
     updateChannelButtonStates();
 }
 
@@ -726,7 +759,7 @@ void MonitorControllerMaxAudioProcessorEditor::timerCallback()
 {
     // 🚀 修复static变量竞争：使用实例级原子计数器
     const uint32_t currentCall = timerCallCount.fetch_add(1, std::memory_order_acq_rel);
-    if (currentCall % 100 == 1) {  // 每10秒记录一次（10Hz * 100）
+    if (currentCall % (uiFrameRateHz * 10) == 1) {  // 每10秒记录一次
         VST3_DBG("Timer callback running - count: " + juce::String(currentCall) + 
                 ", uiInitComplete: " + (uiInitializationComplete.load(std::memory_order_acquire) ? "true" : "false") + 
                 ", safeToUpdate: " + (safeToUpdateUI.load(std::memory_order_acquire) ? "true" : "false"));
@@ -739,7 +772,7 @@ void MonitorControllerMaxAudioProcessorEditor::timerCallback()
     
     try {
         // 检查总线布局是否发生变化
-        int currentChannelCount = audioProcessor.getTotalNumInputChannels();
+        int currentChannelCount = audioProcessor.getMainBusNumInputChannels();
         if (currentChannelCount != lastKnownChannelCount && currentChannelCount > 0)
         {
             lastKnownChannelCount = currentChannelCount;
@@ -752,12 +785,13 @@ void MonitorControllerMaxAudioProcessorEditor::timerCallback()
             updateLayout();
         }
         
-        // Update button states to reflect current parameter values
-        // This is essential since parameter listener mechanism isn't working properly
-        updateChannelButtonStates();
+        // 🚀 合并刷新：本帧内任意次数的状态变化只刷新一次
+        if (audioProcessor.consumeUIStateDirty()) {
+            updateChannelButtonStates();
+        }
         
-        // 🚀 稳定性优化：降低Debug日志更新频率 - 10Hz Timer下每秒更新一次
-        if (currentCall % 10 == 0) { // 10Hz Timer下每秒更新1次
+        // 🚀 稳定性优化：Debug日志每秒更新一次
+        if (currentCall % uiFrameRateHz == 0) {
             updateDebugLogDisplay();
         }
     }
@@ -792,7 +826,7 @@ void MonitorControllerMaxAudioProcessorEditor::updateChannelButtonStates()
     const uint32_t updateCount = updateButtonStatesCount.fetch_add(1, std::memory_order_acq_rel);
     VST3_DBG("PluginEditor: updateChannelButtonStates called - count: " + juce::String(updateCount));
     
-    // 1. 更新每个通道按钮（基于StateManager的线程安全查询）
+    // 1. 更新每个通道按钮（基于StateManager的线程安全查询），只触碰与上次显示不同的按钮
     for (auto const& [index, button] : channelButtons)
     {
         if (!button->isVisible() || index < 0) continue;
@@ -806,13 +840,22 @@ void MonitorControllerMaxAudioProcessorEditor::updateChannelButtonStates()
         
         // 获取Solo状态以决定按钮的toggle状态
         bool soloState = stateManager->getChannelSoloStateForUI(semanticChannelName);
-        bool muteState = stateManager->getChannelMuteStateForUI(semanticChannelName);
         bool shouldBeActive = soloState;  // 只有Solo时按钮才显示为激活状态
         
-        // 调试输出
+        auto& view = channelButtonViews[index];
+        if (view.channelName == semanticChannelName && view.active == shouldBeActive &&
+            view.colourARGB == buttonColor.getARGB() && button->getToggleState() == shouldBeActive) {
+            continue;
+        }
+        
+        view.channelName = semanticChannelName;
+        view.active = shouldBeActive;
+        view.colourARGB = buttonColor.getARGB();
+        
+        // 调试输出（只在按钮变化时）
         VST3_DBG("UI Update - Channel: " + semanticChannelName + 
                  ", Solo: " + (soloState ? "ON" : "OFF") + 
-                 ", Mute: " + (muteState ? "ON" : "OFF") +
+                 ", Mute: " + (stateManager->getChannelMuteStateForUI(semanticChannelName) ? "ON" : "OFF") +
                  ", Color: 0x" + buttonColor.toDisplayString(false));
         
         // 更新按钮toggle状态
@@ -832,37 +875,24 @@ void MonitorControllerMaxAudioProcessorEditor::updateChannelButtonStates()
     bool soloButtonActive = audioProcessor.isSoloButtonActive();
     bool muteButtonActive = audioProcessor.isMuteButtonActive();
     
-    // 更新Solo按钮
-    if (globalSoloButton.getToggleState() != soloButtonActive) {
-        globalSoloButton.setToggleState(soloButtonActive, juce::dontSendNotification);
-    }
-    
-    if (soloButtonActive) {
-        globalSoloButton.setColour(juce::TextButton::buttonOnColourId, customLookAndFeel.getSoloColour());
-        globalSoloButton.setColour(juce::TextButton::buttonColourId, customLookAndFeel.getSoloColour());
-    } else {
-        globalSoloButton.setColour(juce::TextButton::buttonOnColourId, 
-                                  getLookAndFeel().findColour(juce::TextButton::buttonColourId));
-        globalSoloButton.setColour(juce::TextButton::buttonColourId, 
-                                  getLookAndFeel().findColour(juce::TextButton::buttonColourId));
-    }
-    globalSoloButton.repaint();
-    
-    // 更新Mute按钮
-    if (globalMuteButton.getToggleState() != muteButtonActive) {
-        globalMuteButton.setToggleState(muteButtonActive, juce::dontSendNotification);
-    }
+    // 主控按钮同样只在状态位或颜色变化时更新
+    auto updateGlobalButton = [this](juce::TextButton& button, bool active, juce::Colour activeColour)
+    {
+        const juce::Colour colour = active ? activeColour
+                                           : getLookAndFeel().findColour(juce::TextButton::buttonColourId);
+        
+        if (button.getToggleState() == active && button.findColour(juce::TextButton::buttonColourId) == colour) {
+            return;
+        }
+        
+        button.setToggleState(active, juce::dontSendNotification);
+        button.setColour(juce::TextButton::buttonOnColourId, colour);
+        button.setColour(juce::TextButton::buttonColourId, colour);
+        button.repaint();
+    };
     
-    if (muteButtonActive) {
-        globalMuteButton.setColour(juce::TextButton::buttonOnColourId, customLookAndFeel.getMuteColour());
-        globalMuteButton.setColour(juce::TextButton::buttonColourId, customLookAndFeel.getMuteColour());
-    } else {
-        globalMuteButton.setColour(juce::TextButton::buttonOnColourId, 
-                                  getLookAndFeel().findColour(juce::TextButton::buttonColourId));
-        globalMuteButton.setColour(juce::TextButton::buttonColourId, 
-                                  getLookAndFeel().findColour(juce::TextButton::buttonColourId));
-    }
-    globalMuteButton.repaint();
+    updateGlobalButton(globalSoloButton, soloButtonActive, customLookAndFeel.getSoloColour());
+    updateGlobalButton(globalMuteButton, muteButtonActive, customLookAndFeel.getMuteColour());
     
     // 3. Solo优先规则处理
     bool muteButtonEnabled = audioProcessor.isMuteButtonEnabled();
@@ -1081,10 +1111,115 @@ void MonitorControllerMaxAudioProcessorEditor::handleRoleChange()
     VST3_DBG_ROLE(&audioProcessor, "PluginEditor: Role change completed");
 }
 
+void MonitorControllerMaxAudioProcessorEditor::setupGroupSelector()
+{
+    addAndMakeVisible(groupLabel);
+    groupLabel.setText("Group:", juce::dontSendNotification);
+    groupLabel.setFont(juce::Font(12.0f));
+    
+    addAndMakeVisible(groupSelector);
+    groupSelector.setEditableText(true);
+    groupSelector.setTooltip("Master group and OSC address group - type a name to create a new group");
+    refreshGroupSelector();
+    
+    groupSelector.onChange = [this] { handleGroupChange(); };
+    
+    VST3_DBG_ROLE(&audioProcessor, "Group selector setup complete");
+}
+
+void MonitorControllerMaxAudioProcessorEditor::handleGroupChange()
+{
+    // 🚀 一个组名同时决定Master-Slave分组和OSC地址前缀，"Default"对应默认组
+    juce::String groupName = groupSelector.getText().trim();
+    if (groupName.equalsIgnoreCase("Default"))
+        groupName = {};
+    
+    audioProcessor.setMasterGroupName(groupName);
+    audioProcessor.setOSCGroup(audioProcessor.getMasterGroupName());
+    
+    // 显示规范化后的组名，并把新建的组加入列表
+    refreshGroupSelector();
+    
+    VST3_DBG_ROLE(&audioProcessor, "PluginEditor: Group changed to " + groupSelector.getText());
+}
+
+void MonitorControllerMaxAudioProcessorEditor::refreshGroupSelector()
+{
+    const juce::String currentGroup = audioProcessor.getMasterGroupName();
+    
+    juce::StringArray names = GlobalPluginState::getRef().getGroupNames();
+    names.removeEmptyStrings();
+    names.removeString("Default", true);
+    names.addIfNotAlreadyThere(currentGroup);
+    names.removeEmptyStrings();
+    names.sortNatural();
+    
+    groupSelector.clear(juce::dontSendNotification);
+    groupSelector.addItem("Default", 1);
+    for (int i = 0; i < names.size(); ++i)
+        groupSelector.addItem(names[i], i + 2);
+    
+    if (currentGroup.isEmpty())
+        groupSelector.setSelectedId(1, juce::dontSendNotification);
+    else
+        groupSelector.setText(currentGroup, juce::dontSendNotification);
+}
+
+void MonitorControllerMaxAudioProcessorEditor::showLocalOverrideMenu(int channelIndex)
+{
+    const juce::String channelName = audioProcessor.getPhysicalMapper().getSemanticName(channelIndex);
+    if (channelName.isEmpty())
+        return;
+    
+    // 本地覆盖只叠加在Master层之上：Slave继续镜像Master的Solo/Mute
+    const float currentTrimDb = audioProcessor.getLocalTrimOffset(channelName);
+    
+    juce::PopupMenu trimMenu;
+    for (int i = 0; i < static_cast<int>(std::size(localTrimStepsDb)); ++i)
+    {
+        const float stepDb = localTrimStepsDb[i];
+        const juce::String label = stepDb == 0.0f ? juce::String("0 dB") : juce::String(stepDb, 1) + " dB";
+        trimMenu.addItem(localTrimMenuIdBase + i, stepDb > 0.0f ? "+" + label : label, true, currentTrimDb == stepDb);
+    }
+    
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Local " + channelName);
+    menu.addItem(localMuteMenuId, "Local Mute", true, audioProcessor.getLocalMuteOverride(channelName));
+    menu.addSubMenu("Local Trim (" + juce::String(currentTrimDb, 1) + " dB)", trimMenu);
+    menu.addSeparator();
+    menu.addItem(clearLocalOverridesMenuId, "Clear All Local Overrides", audioProcessor.hasLocalOverrides());
+    
+    juce::Component* target = nullptr;
+    if (auto it = channelButtons.find(channelIndex); it != channelButtons.end())
+        target = it->second.get();
+    
+    auto safeThis = juce::Component::SafePointer<MonitorControllerMaxAudioProcessorEditor>(this);
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(target),
+                       [safeThis, channelName](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+        
+        auto& processor = safeThis->audioProcessor;
+        
+        if (result == localMuteMenuId)
+            processor.setLocalMuteOverride(channelName, !processor.getLocalMuteOverride(channelName));
+        else if (result == clearLocalOverridesMenuId)
+            processor.clearLocalOverrides();
+        else if (result >= localTrimMenuIdBase && result < localTrimMenuIdBase + static_cast<int>(std::size(localTrimStepsDb)))
+            processor.setLocalTrimOffset(channelName, localTrimStepsDb[result - localTrimMenuIdBase]);
+        
+        safeThis->updateChannelButtonStates();
+    });
+}
+
 void MonitorControllerMaxAudioProcessorEditor::updateUIBasedOnRole()
 {
     PluginRole currentRole = audioProcessor.getCurrentRole();
     
+    // 角色切换可能改变已存在的组
+    refreshGroupSelector();
+    
     // 根据角色调整UI可用性
     bool isSlaveMode = (currentRole == PluginRole::Slave);
     
@@ -1164,7 +1299,7 @@ void MonitorControllerMaxAudioProcessorEditor::updateDebugLogDisplay()
     
     // 添加当前连接状态摘要
     logText += "=== Connection Status ===\n";
-    logText += globalState.getConnectionInfo() + "\n";
+    logText += globalState.getConnectionInfo(&audioProcessor) + "\n";
     logText += "Current Role: ";
     
     switch (audioProcessor.getCurrentRole())
@@ -1174,6 +1309,12 @@ void MonitorControllerMaxAudioProcessorEditor::updateDebugLogDisplay()
         case PluginRole::Slave: logText += "Slave"; break;
     }
     
+    // Master -> Slave 传播：组序号、最慢Slave落后的发布次数、发布到音频输出的延迟
+    if (audioProcessor.getCurrentRole() != PluginRole::Standalone)
+    {
+        logText += "\nPropagation: " + globalState.getPropagationReport(&audioProcessor).toString();
+    }
+    
     logText += "\n\n=== Connection Logs ===\n";
     
     // 显示最新的日志条目
@@ -1246,6 +1387,12 @@ void MonitorControllerMaxAudioProcessorEditor::handleEffectsPanelButtonClick()
                               channelGridBounds.getWidth(), 
                               channelGridBounds.getHeight());
         
+        // 两个覆盖面板占用同一区域，互斥显示
+        if (analyserPanel.isPanelVisible()) {
+            analyserPanel.hidePanel();
+            analyserPanelButton.setToggleState(false, juce::dontSendNotification);
+        }
+        
         effectsPanel.showPanel();
         effectsPanelButton.setToggleState(true, juce::dontSendNotification);
         VST3_DBG_ROLE(&audioProcessor, "Effects panel shown via button");
@@ -1263,3 +1410,57 @@ void MonitorControllerMaxAudioProcessorEditor::handleEffectsPanelOutsideClick(co
         VST3_DBG_ROLE(&audioProcessor, "Effects panel hidden via outside click");
     }
 }
+
+//==============================================================================
+// 分析器面板管理方法
+
+void MonitorControllerMaxAudioProcessorEditor::setupAnalyserPanel()
+{
+    // 设置分析器面板按钮 (与EFFECT按钮一致)
+    addAndMakeVisible(analyserPanelButton);
+    analyserPanelButton.setButtonText("ANALYSER");
+    analyserPanelButton.setClickingTogglesState(true);
+    analyserPanelButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::green);
+    
+    analyserPanelButton.onClick = [this]()
+    {
+        handleAnalyserPanelButtonClick();
+    };
+    
+    // 添加分析器面板为子组件但初始隐藏（隐藏时不注册视图，分析线程空闲）
+    addAndMakeVisible(analyserPanel);
+    analyserPanel.setVisible(false);
+    
+    VST3_DBG_ROLE(&audioProcessor, "PluginEditor: Analyser panel setup complete");
+}
+
+void MonitorControllerMaxAudioProcessorEditor::handleAnalyserPanelButtonClick()
+{
+    // 分析器只读，Slave模式同样允许打开
+    if (analyserPanel.isPanelVisible()) {
+        analyserPanel.hidePanel();
+        analyserPanelButton.setToggleState(false, juce::dontSendNotification);
+        VST3_DBG_ROLE(&audioProcessor, "Analyser panel hidden via button");
+    } else {
+        if (effectsPanel.isPanelVisible()) {
+            effectsPanel.hidePanel();
+            effectsPanelButton.setToggleState(false, juce::dontSendNotification);
+        }
+        
+        // 设置面板位置 (完全覆盖通道网格区域)
+        analyserPanel.setBounds(channelGridContainer.getBounds());
+        analyserPanel.showPanel();
+        analyserPanelButton.setToggleState(true, juce::dontSendNotification);
+        VST3_DBG_ROLE(&audioProcessor, "Analyser panel shown via button");
+    }
+}
+
+void MonitorControllerMaxAudioProcessorEditor::handleAnalyserPanelOutsideClick(const juce::MouseEvent& event)
+{
+    if (analyserPanel.isPanelVisible() && !analyserPanel.getBounds().contains(event.getPosition()))
+    {
+        analyserPanel.hidePanel();
+        analyserPanelButton.setToggleState(false, juce::dontSendNotification);
+        VST3_DBG_ROLE(&audioProcessor, "Analyser panel hidden via outside click");
+    }
+}
@@ -13,6 +13,7 @@
 #include "ConfigManager.h"
 #include "SemanticChannelButton.h"
 #include "EffectsPanel.h"
+#include "AnalyserPanel.h"
 #include <map>
 
 //==============================================================================
@@ -103,6 +104,30 @@ private:
     juce::Colour muteColour;
 };
 
+//==============================================================================
+/**
+ * 通道网格按钮：右键（弹出菜单手势）打开本地覆盖菜单，不触发Solo/Mute点击
+ * 禁用状态（Slave模式）下同样可以打开菜单：本地覆盖正是Slave的个人监听调整
+ */
+class ChannelGridButton : public juce::TextButton
+{
+public:
+    using juce::TextButton::TextButton;
+
+    std::function<void()> onPopupMenu;
+
+    void mouseDown(const juce::MouseEvent& event) override
+    {
+        if (event.mods.isPopupMenu() && onPopupMenu != nullptr)
+        {
+            onPopupMenu();
+            return;
+        }
+
+        juce::TextButton::mouseDown(event);
+    }
+};
+
 //==============================================================================
 /**
 */
@@ -161,6 +186,10 @@ private:
     // v4.2: 弹出式总线效果面板
     EffectsPanel effectsPanel;
     
+    // 弹出式频谱/相位相关分析器面板（只读，所有角色可用）
+    juce::TextButton analyserPanelButton{ "ANALYSER" };
+    AnalyserPanel analyserPanel;
+    
     // v4.1: Master Gain旋钮控件
     juce::Slider masterGainSlider;
     juce::Label masterGainLabel;
@@ -172,6 +201,10 @@ private:
     juce::ComboBox roleSelector;
     juce::Label roleLabel;
     
+    // 🚀 Master组 / OSC地址组选择器（可输入新组名）
+    juce::ComboBox groupSelector;
+    juce::Label groupLabel;
+    
     // Debug连接日志窗口
     juce::TextEditor debugLogDisplay;
     juce::Label debugLogLabel;
@@ -185,6 +218,15 @@ private:
     std::map<int, std::unique_ptr<juce::TextButton>> channelButtons;
     std::map<int, std::unique_ptr<ButtonAttachment>> channelButtonAttachments;
     
+    // 每个按钮上次显示的状态：刷新时只改动状态位或颜色变化的按钮（布局变化时清空）
+    struct ChannelButtonView
+    {
+        juce::String channelName;
+        bool active = false;
+        juce::uint32 colourARGB = 0;
+    };
+    std::map<int, ChannelButtonView> channelButtonViews;
+    
     // v4.1: Master Gain参数连接
     using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
     std::unique_ptr<SliderAttachment> masterGainSliderAttachment;
@@ -203,6 +245,9 @@ private:
     std::atomic<bool> safeToUpdateUI{true};  // UI更新安全标志
     std::atomic<uint32_t> timerCallCount{0};  // 🚀 实例级Timer计数器，避免static竞争
     std::atomic<uint32_t> updateButtonStatesCount{0};  // 🚀 实例级按钮更新计数器
+    
+    // 🚀 UI帧率：每帧最多一次合并刷新（处理器脏标志），通道数检查与日志按帧计数降频
+    static constexpr int uiFrameRateHz = 30;
 
     // Private function declarations
     void updatePluginConfiguration(); // Update plugin configuration and notify host immediately
@@ -211,6 +256,13 @@ private:
     // Master-Slave UI管理  
     void setupRoleSelector();
     void handleRoleChange();
+    void setupGroupSelector();
+    void handleGroupChange();
+    void refreshGroupSelector();
+    
+    // 通道本地覆盖（本地静音 / 本地Trim）右键菜单
+    void showLocalOverrideMenu(int channelIndex);
+    
     void updateDebugLogDisplay();
     void clearDebugLog();
     
@@ -218,6 +270,11 @@ private:
     void setupEffectsPanel();
     void handleEffectsPanelButtonClick();
     void handleEffectsPanelOutsideClick(const juce::MouseEvent& event);
+    
+    // 分析器面板管理
+    void setupAnalyserPanel();
+    void handleAnalyserPanelButtonClick();
+    void handleAnalyserPanelOutsideClick(const juce::MouseEvent& event);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MonitorControllerMaxAudioProcessorEditor)
 };
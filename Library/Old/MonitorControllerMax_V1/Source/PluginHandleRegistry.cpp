@@ -0,0 +1,89 @@
+﻿/*
+  ==============================================================================
+
+    PluginHandleRegistry.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    插件实例注册表实现
+
+  ==============================================================================
+*/
+
+#include "PluginHandleRegistry.h"
+
+//==============================================================================
+PluginHandle PluginHandleRegistry::add(MonitorControllerMaxAudioProcessor* plugin)
+{
+    if (plugin == nullptr)
+        return {};
+
+    uint32_t index = PluginHandle::INVALID_INDEX;
+
+    if (!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else if (usedSlots < MAX_PLUGINS)
+    {
+        index = usedSlots++;
+    }
+    else
+    {
+        return {};
+    }
+
+    auto& slot = slots[index];
+
+    // 先写指针再发布代号：读者看到新代号时指针必然已就位
+    slot.plugin.store(plugin, std::memory_order_release);
+    const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+    slot.generation.store(generation, std::memory_order_release);
+
+    liveCount.fetch_add(1, std::memory_order_relaxed);
+    return { index, generation };
+}
+
+bool PluginHandleRegistry::remove(PluginHandle handle)
+{
+    if (!isValid(handle))
+        return false;
+
+    auto& slot = slots[handle.index];
+
+    // 先作废代号再清指针：读者两次代号比较之间读到的指针总是注册时的那个
+    slot.generation.store(handle.generation + 1, std::memory_order_release);
+    slot.plugin.store(nullptr, std::memory_order_release);
+
+    freeSlots.push_back(handle.index);
+    liveCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PluginHandleRegistry::clear()
+{
+    for (uint32_t index = 0; index < usedSlots; ++index)
+    {
+        auto& slot = slots[index];
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+
+        if ((generation & 1u) != 0)
+            remove({ index, generation });
+    }
+}
+
+MonitorControllerMaxAudioProcessor* PluginHandleRegistry::resolve(PluginHandle handle) const noexcept
+{
+    if (handle.index >= MAX_PLUGINS)
+        return nullptr;
+
+    const auto& slot = slots[handle.index];
+
+    if (slot.generation.load(std::memory_order_acquire) != handle.generation)
+        return nullptr;
+
+    // 指针以release写入：读到复用后的新指针时，必然也能看到之前的代号变化
+    auto* plugin = slot.plugin.load(std::memory_order_acquire);
+    return slot.generation.load(std::memory_order_acquire) == handle.generation ? plugin : nullptr;
+}
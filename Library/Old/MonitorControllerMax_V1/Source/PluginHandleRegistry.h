@@ -0,0 +1,110 @@
+﻿/*
+  ==============================================================================
+
+    PluginHandleRegistry.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    插件实例注册表 - 带代号的句柄（slot map）
+
+    - 固定容量槽位数组，注册时分配槽位，句柄 = (槽位下标, 代号)
+    - 代号奇数表示槽位在用，注销时代号加一立即作废所有旧句柄；槽位复用后旧句柄依然无效
+    - 有效性检查 = 一次数组下标 + 一次代号比较，无锁、无分配、无字符串
+    - 槽位数组永不重新分配，读者在注册/注销进行中也不会看到悬空内存
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class MonitorControllerMaxAudioProcessor;
+
+//==============================================================================
+/**
+ * 插件句柄：值类型，可随意拷贝进异步回调；过期句柄只会解析为nullptr
+ */
+struct PluginHandle
+{
+    static constexpr uint32_t INVALID_INDEX = 0xffffffffu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;        // 注册时的代号（奇数）
+
+    bool isNull() const noexcept { return index == INVALID_INDEX; }
+
+    bool operator==(const PluginHandle& other) const noexcept
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const PluginHandle& other) const noexcept { return !(*this == other); }
+
+    // 日志用ID：槽位.第几次使用
+    juce::String toString() const
+    {
+        return isNull() ? juce::String("Plugin_none")
+                        : "Plugin_" + juce::String(index) + "." + juce::String(generation / 2 + 1);
+    }
+};
+
+//==============================================================================
+/**
+ * 插件句柄注册表
+ *
+ * 线程模型：
+ * - add/remove/clear 为写端，由调用方串行化（GlobalPluginState在独占pluginsMutex时调用）
+ * - isValid/resolve/getLiveCount 为读端，任意线程无锁调用，不受写端阻塞
+ *
+ * resolve()只保证读取时刻句柄有效；返回的指针在使用期间是否存活由调用方保证
+ * （例如在消息线程解析：插件的析构与注销也在消息线程）。
+ */
+class PluginHandleRegistry
+{
+public:
+    //==============================================================================
+    static constexpr uint32_t MAX_PLUGINS = 1024;
+
+    PluginHandleRegistry() = default;
+
+    //==============================================================================
+    // 写端：注册表已满时返回空句柄
+    PluginHandle add(MonitorControllerMaxAudioProcessor* plugin);
+    bool remove(PluginHandle handle);
+    void clear();
+
+    //==============================================================================
+    // 读端（无锁）
+    bool isValid(PluginHandle handle) const noexcept
+    {
+        return handle.index < MAX_PLUGINS
+            && slots[handle.index].generation.load(std::memory_order_acquire) == handle.generation;
+    }
+
+    MonitorControllerMaxAudioProcessor* resolve(PluginHandle handle) const noexcept;
+
+    int getLiveCount() const noexcept { return liveCount.load(std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    struct Slot
+    {
+        std::atomic<uint32_t> generation{ 0 };     // 偶数 = 空闲
+        std::atomic<MonitorControllerMaxAudioProcessor*> plugin{ nullptr };
+    };
+
+    std::array<Slot, MAX_PLUGINS> slots;
+
+    // 写端状态
+    std::vector<uint32_t> freeSlots;                // 已释放、可复用的槽位
+    uint32_t usedSlots = 0;                         // 从未使用过的槽位从这里开始
+    std::atomic<int> liveCount{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginHandleRegistry)
+};
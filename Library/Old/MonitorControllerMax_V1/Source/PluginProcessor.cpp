@@ -16,6 +16,7 @@ static std::atomic<int>& getInstanceCount() {
 }
 #include "DebugLogger.h"
 #include "MasterBusProcessor.h"
+#include "SharedOSCHub.h"
 
 //==============================================================================
 MonitorControllerMaxAudioProcessor::MonitorControllerMaxAudioProcessor()
@@ -24,8 +25,11 @@ MonitorControllerMaxAudioProcessor::MonitorControllerMaxAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::discreteChannels(26), true)
+                       .withInput  ("Stem",      juce::AudioChannelSet::discreteChannels(26), false)
+                       .withInput  ("Reference", juce::AudioChannelSet::discreteChannels(26), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::discreteChannels(26), true)
+                       .withOutput ("Cue",    juce::AudioChannelSet::stereo(), false)
                      #endif
                        ),
       apvts (*this, nullptr, "Parameters", createParameterLayout())
@@ -68,6 +72,30 @@ MonitorControllerMaxAudioProcessor::MonitorControllerMaxAudioProcessor()
     masterBusProcessor.setProcessor(this);
     VST3_DBG_ROLE(this, "MasterBusProcessor initialized");
     
+    // 响度匹配：Trim更新时在消息线程重建渲染快照
+    loudnessMatcher.onTrimChanged = [this]()
+    {
+        if (stateManager) {
+            stateManager->refreshRenderState();
+        }
+    };
+    
+    // 分析器OSC输出（消息线程，10Hz）：只有Master/Standalone发送，与其他状态反馈一致
+    channelAnalyser.onSnapshotForOSC = [this](const AnalyserSnapshot& snapshot)
+    {
+        if (currentRole == PluginRole::Master || currentRole == PluginRole::Standalone) {
+            oscCommunicator.sendAnalyserSnapshot(snapshot, analyserChannelNames);
+        }
+    };
+    
+    // 电平表OSC输出（消息线程，10-60Hz）：与分析器共用通道名表
+    channelMeter.onSnapshotForOSC = [this](const MeterSnapshot& snapshot)
+    {
+        if (currentRole == PluginRole::Master || currentRole == PluginRole::Standalone) {
+            oscCommunicator.sendMeterSnapshot(snapshot, analyserChannelNames, channelMeter.getOSCRateHz());
+        }
+    };
+    
     // JUCE架构重构：初始化状态管理器
     stateManager = std::make_unique<StateManager>(*this);
     stateManager->initialize();  // 启动监听器和状态收集
@@ -84,6 +112,16 @@ MonitorControllerMaxAudioProcessor::MonitorControllerMaxAudioProcessor()
         }
     };
     
+    // OSC地址模式批量控制：作为一个语义状态事务应用
+    oscCommunicator.onExternalBatchStateChange = [this](const juce::String& action, const juce::StringArray& channelNames, bool state)
+    {
+        if (currentRole == PluginRole::Master || currentRole == PluginRole::Standalone) {
+            handleExternalOSCBatchControl(action, channelNames, state);
+        } else {
+            VST3_DBG_ROLE(this, "OSC control ignored - Slave mode does not process OSC");
+        }
+    };
+    
     // v4.1: 设置Master总线OSC控制回调
     oscCommunicator.onMasterVolumeOSC = [this](float volumePercent)
     {
@@ -147,6 +185,24 @@ MonitorControllerMaxAudioProcessor::MonitorControllerMaxAudioProcessor()
         }
     };
     
+    // 🚀 实时路径：OSC接收线程直接写入Master总线实时状态，下一个音频块生效（不等待消息线程）
+    // 状态模型、VST3参数和UI仍由上面的消息线程回调同步；这里不记录日志、不分配内存
+    oscCommunicator.onRealtimeMasterControl = [this](OSCAddressTable::MasterControl control, float value)
+    {
+        const PluginRole role = currentRole.load(std::memory_order_acquire);
+        if (role == PluginRole::Master || role == PluginRole::Standalone) {
+            masterBusProcessor.applyRealtimeOSC(control, value);
+        }
+    };
+    
+    // TCP目标（重新）连接：对端可能丢失了之前的状态，全量同步一次
+    oscCommunicator.onStreamTargetConnected = [this]()
+    {
+        if (currentRole == PluginRole::Master || currentRole == PluginRole::Standalone) {
+            oscCommunicator.broadcastAllStates(semanticState, physicalMapper);
+        }
+    };
+    
     // 重要：OSC系统将在角色确定后初始化（在setStateInformation或UI初始化完成后）
     VST3_DBG_ROLE(this, "OSC initialization deferred until role is determined");
     
@@ -162,6 +218,17 @@ MonitorControllerMaxAudioProcessor::~MonitorControllerMaxAudioProcessor()
 {
     VST3_DBG_ROLE(this, "Destructor - cleaning up resources");
     
+    // 停止Slave跟随定时器
+    stopTimer();
+    
+    // 停止响度分析线程（在StateManager之前，避免回调访问已关闭的状态）
+    loudnessMatcher.onTrimChanged = nullptr;
+    loudnessMatcher.release();
+    channelAnalyser.onSnapshotForOSC = nullptr;
+    channelMeter.onSnapshotForOSC = nullptr;
+    channelMeter.setOSCRateHz(0);
+    channelAnalyser.release();
+    
     // JUCE架构重构：清理状态管理器
     if (stateManager) {
         stateManager->shutdown();
@@ -264,8 +331,24 @@ void MonitorControllerMaxAudioProcessor::prepareToPlay (double sampleRate, int s
         masterBusProcessor.prepare(sampleRate, samplesPerBlock);
         VST3_DBG_ROLE(this, "MasterBusProcessor prepared with preallocated buffers - sampleRate: " << sampleRate << ", maxBlockSize: " << samplesPerBlock);
         
-        // 根据当前总线布局自动选择合适的配置
-        int currentChannelCount = getTotalNumInputChannels();
+        // 响度匹配FIFO和K加权滤波器按采样率预分配
+        loudnessMatcher.prepare(sampleRate, samplesPerBlock);
+        
+        // 分析器环形缓冲和FFT预分配（无视图时工作线程空闲）
+        channelAnalyser.prepare(sampleRate, samplesPerBlock);
+        
+        // 校准信号发生器：输出缓冲区和噪声归一化系数按采样率预计算
+        signalGenerator.prepare(sampleRate, samplesPerBlock);
+        
+        // 输入源交叉淡化和Cue暂存区预分配（音频线程零分配）
+        inputFadeLengthSamples = juce::jmax(1, juce::roundToInt(sampleRate * inputSourceCrossfadeSeconds));
+        inputFadeSamplesRemaining = 0;
+        roleFadeLengthSamples = juce::jmax(1, juce::roundToInt(sampleRate * roleTransitionFadeSeconds));
+        roleFadeSamplesRemaining = 0;
+        cueScratchBuffer.setSize(2, samplesPerBlock, false, true, false);
+        
+        // 根据当前主输入总线自动选择合适的配置（启用的侧链总线不计入）
+        int currentChannelCount = getMainBusNumInputChannels();
         if (currentChannelCount > 0)
         {
             autoSelectLayoutForChannelCount(currentChannelCount);
@@ -296,6 +379,9 @@ void MonitorControllerMaxAudioProcessor::releaseResources()
         // When playback stops, you can use this as an opportunity to free up any
         // spare memory, etc.
         VST3_DBG_ROLE(this, "releaseResources - cleaning up audio resources");
+        
+        loudnessMatcher.release();
+        channelAnalyser.release();
     }
     catch (const std::exception& e) {
         // 🚨 资源清理异常：记录但不传播
@@ -314,6 +400,22 @@ bool MonitorControllerMaxAudioProcessor::isBusesLayoutSupported (const BusesLayo
     juce::ignoreUnused (layouts);
     return true;
   #else
+    // 侧链输入源（Stem/Reference）：关闭或与主输入通道数一致
+    for (int bus = static_cast<int>(InputSource::Stem); bus < layouts.inputBuses.size(); ++bus)
+    {
+        const auto& sourceSet = layouts.inputBuses[bus];
+        if (!sourceSet.isDisabled() && sourceSet != layouts.getMainInputChannelSet())
+            return false;
+    }
+    
+    // Cue总线：关闭或立体声
+    if (layouts.outputBuses.size() > cueBusIndex)
+    {
+        const auto& cueSet = layouts.outputBuses[cueBusIndex];
+        if (!cueSet.isDisabled() && cueSet != juce::AudioChannelSet::stereo())
+            return false;
+    }
+    
     // 检查输入输出总线是否匹配
     if (layouts.getMainInputChannelSet() == layouts.getMainOutputChannelSet()
         && !layouts.getMainInputChannelSet().isDisabled())
@@ -343,10 +445,11 @@ void MonitorControllerMaxAudioProcessor::processBlock (juce::AudioBuffer<float>&
         const int numSamples = buffer.getNumSamples();
         if (numSamples == 0) return;
         
-        // 清除未使用的输出通道（音频线程安全）
-        const int totalNumInputChannels = getTotalNumInputChannels();
-        const int totalNumOutputChannels = getTotalNumOutputChannels();
-        for (int i = totalNumInputChannels; i < totalNumOutputChannels; ++i) {
+        // 清除主输出中没有对应主输入的通道（音频线程安全）
+        // 只按主总线计数：侧链输入与Cue输出共用缓冲区后部的通道，不能在这里清除
+        const int mainNumInputChannels = getMainBusNumInputChannels();
+        const int mainNumOutputChannels = juce::jmin(getMainBusNumOutputChannels(), buffer.getNumChannels());
+        for (int i = mainNumInputChannels; i < mainNumOutputChannels; ++i) {
             buffer.clear(i, 0, numSamples);
         }
         
@@ -357,12 +460,124 @@ void MonitorControllerMaxAudioProcessor::processBlock (juce::AudioBuffer<float>&
             return;
         }
         
-        // 应用预计算的状态（高度优化的内联函数，零分配）
-        renderState->applyToBuffer(buffer, numSamples);
+        // 主总线视图（Cue总线启用时缓冲区尾部是Cue通道，主处理不能触及）
+        auto mainBuffer = getBusBuffer(buffer, false, 0);
+        
+        // 输入源切换：只切换读指针（直接引用宿主缓冲区中的输入总线），宿主关闭的源回退到主输入
+        int targetSource = renderState->activeInputSource;
+        if (!isInputSourceAvailable(static_cast<InputSource>(targetSource))) {
+            targetSource = static_cast<int>(InputSource::Main);
+        }
+        if (targetSource != currentInputSource) {
+            fadeFromInputSource = currentInputSource;
+            currentInputSource = targetSource;
+            inputFadeSamplesRemaining = isInputSourceAvailable(static_cast<InputSource>(fadeFromInputSource))
+                                            ? inputFadeLengthSamples : 0;
+        }
+        
+        // AFL/PFL：在通道增益之前从当前输入源取Solo通道（稀疏混音核），先写入暂存区
+        const auto* cueBus = getBus(false, cueBusIndex);
+        const bool cueEnabled = cueBus != nullptr && cueBus->isEnabled()
+                                && numSamples <= cueScratchBuffer.getNumSamples();
+        if (cueEnabled) {
+            renderState->applyCueToBuffer(getBusBuffer(buffer, true, currentInputSource), cueScratchBuffer, numSamples);
+        }
+        
+        // 角色切换淡化：快照带来新的切换序号时，通道增益在roleTransitionFadeSeconds内从旧角色过渡到新角色
+        if (renderState->roleTransitionSerial != audibleRoleTransitionSerial) {
+            audibleRoleTransitionSerial = renderState->roleTransitionSerial;
+            roleFadeSamplesRemaining = roleFadeLengthSamples;
+        }
+        
+        float transitionStart = 1.0f, transitionEnd = 1.0f;
+        if (roleFadeSamplesRemaining > 0) {
+            transitionStart = 1.0f - static_cast<float>(roleFadeSamplesRemaining) / static_cast<float>(roleFadeLengthSamples);
+            roleFadeSamplesRemaining = juce::jmax(0, roleFadeSamplesRemaining - numSamples);
+            transitionEnd = 1.0f - static_cast<float>(roleFadeSamplesRemaining) / static_cast<float>(roleFadeLengthSamples);
+        }
+        
+        // 应用预计算的状态（Solo/Mute/个人增益），未激活的输入源完全不读取
+        if (inputFadeSamplesRemaining > 0) {
+            // 交叉淡化：主输入必须先原地渲染，之后才能叠加侧链源
+            const float fadeOutStart = static_cast<float>(inputFadeSamplesRemaining) / static_cast<float>(inputFadeLengthSamples);
+            inputFadeSamplesRemaining = juce::jmax(0, inputFadeSamplesRemaining - numSamples);
+            const float fadeOutEnd = static_cast<float>(inputFadeSamplesRemaining) / static_cast<float>(inputFadeLengthSamples);
+            
+            const auto fromBuffer = getBusBuffer(buffer, true, fadeFromInputSource);
+            const auto toBuffer = getBusBuffer(buffer, true, currentInputSource);
+            
+            if (currentInputSource == static_cast<int>(InputSource::Main)) {
+                renderState->renderFromSource(toBuffer, mainBuffer, numSamples, 1.0f - fadeOutStart, 1.0f - fadeOutEnd, false,
+                                              transitionStart, transitionEnd);
+                renderState->renderFromSource(fromBuffer, mainBuffer, numSamples, fadeOutStart, fadeOutEnd, true,
+                                              transitionStart, transitionEnd);
+            } else {
+                renderState->renderFromSource(fromBuffer, mainBuffer, numSamples, fadeOutStart, fadeOutEnd, false,
+                                              transitionStart, transitionEnd);
+                renderState->renderFromSource(toBuffer, mainBuffer, numSamples, 1.0f - fadeOutStart, 1.0f - fadeOutEnd, true,
+                                              transitionStart, transitionEnd);
+            }
+        } else {
+            renderState->renderFromSource(getBusBuffer(buffer, true, currentInputSource), mainBuffer, numSamples, 1.0f, 1.0f, false,
+                                          transitionStart, transitionEnd);
+        }
+        
+        // 写出Cue总线（主输出已渲染完，侧链输入不再需要）
+        if (cueEnabled) {
+            auto cueBuffer = getBusBuffer(buffer, false, cueBusIndex);
+            for (int ch = 0; ch < juce::jmin(2, cueBuffer.getNumChannels()); ++ch) {
+                cueBuffer.copyFrom(ch, 0, cueScratchBuffer, ch, 0, numSamples);
+            }
+        } else if (cueBus != nullptr && cueBus->isEnabled()) {
+            auto cueBuffer = getBusBuffer(buffer, false, cueBusIndex);
+            cueBuffer.clear();
+        }
+        
+        // 校准信号发生器：与路由通道的节目信号交叉淡化（系数含GAIN_n与Solo/Mute），随后同样经过Master总线
+        // 路由清空或关闭后仍需渲染，直到所有通道都淡回节目信号
+        bool generatorActive = false;
+        if (signalGenerator.isProducingOutput()) {
+            generatorActive = signalGenerator.render(numSamples, renderState->generatorChannelIndices,
+                                                     renderState->generatorGain, renderState->generatorChannelCount);
+            if (generatorActive) {
+                signalGenerator.mixInto(mainBuffer, numSamples);
+            }
+        }
         
         // CRITICAL: 应用MasterBusProcessor的复杂总线效果（Mono混音等）
-        // 传递预计算的SUB映射，避免音频线程中的字符串操作
-        masterBusProcessor.process(buffer, currentRole, renderState->channelIsSUB);
+        // 传递预计算的SUB映射，避免音频线程中的字符串操作；角色取自快照，与通道状态同时切换
+        masterBusProcessor.process(mainBuffer, static_cast<PluginRole>(renderState->role), renderState->channelIsSUB);
+        
+        // Master传播跟踪：首个使用新发布序号的块记录 发布 -> 输出 延迟（只有原子操作）
+        if (renderState->masterSequence != audibleMasterSequence.load(std::memory_order_relaxed)) {
+            audibleMasterSequence.store(renderState->masterSequence, std::memory_order_relaxed);
+            
+            if (renderState->masterSequence != 0 && renderState->masterPublishedTicks != 0) {
+                const double latencyUs = juce::Time::highResolutionTicksToSeconds(
+                    juce::Time::getHighResolutionTicks() - renderState->masterPublishedTicks) * 1.0e6;
+                lastPropagationUs.store(latencyUs, std::memory_order_relaxed);
+                masterPropagation.record(juce::jmax(0.0, latencyUs));
+            }
+        }
+        
+        // 响度匹配：只把输出块推入无锁FIFO，测量在后台线程完成（校准信号不计入节目响度）
+        if (loudnessMatcher.isActive() && !masterBusProcessor.isMasterMuteActive() && !generatorActive) {
+            const float masterLevel = masterBusProcessor.getCurrentMasterLevel();
+            if (masterLevel > 0.001f) {
+                loudnessMatcher.pushBlock(mainBuffer, numSamples, renderState->comparisonKey,
+                                          renderState->loudnessTrimDb + juce::Decibels::gainToDecibels(masterLevel));
+            }
+        }
+        
+        // 分析器：只在有视图或OSC输出时写入无等待环形缓冲，FFT在后台线程完成
+        if (channelAnalyser.isRunning()) {
+            channelAnalyser.pushBlock(mainBuffer, numSamples);
+        }
+        
+        // 电平表：只在OSC输出开启时累加峰值/能量（原子累加，无锁）
+        if (channelMeter.isRunning()) {
+            channelMeter.process(mainBuffer, numSamples);
+        }
         
         // 完成 - 总共20行代码，功能完整
     }
@@ -400,14 +615,41 @@ void MonitorControllerMaxAudioProcessor::getStateInformation (juce::MemoryBlock&
     state.setProperty("currentSubLayout", userSelectedSubLayout, nullptr);
     
     // 保存角色信息
-    state.setProperty("pluginRole", static_cast<int>(currentRole), nullptr);
+    state.setProperty("pluginRole", static_cast<int>(currentRole.load()), nullptr);
+    
+    // 保存Solo监听模式（房间配置，与Solo/Mute状态本身不同，需要持久化）
+    state.setProperty("soloMode", static_cast<int>(semanticState.getSoloMode()), nullptr);
+    state.setProperty("inputSource", selectedInputSource.load(), nullptr);
+    state.setProperty("analyserOSC", channelAnalyser.isOSCStreamingEnabled(), nullptr);
+    state.setProperty("meterOSCRate", channelMeter.getOSCRateHz(), nullptr);
+    state.setProperty("oscGroup", getOSCGroup(), nullptr);
+    state.setProperty("masterGroup", masterGroupName, nullptr);
+    
+    // 校准信号配置（类型不保存：重新加载工程时不自动输出测试信号）
+    state.setProperty("generatorRouting", generatorRouting.joinIntoString(","), nullptr);
+    state.setProperty("generatorLevelDb", signalGenerator.getLevelDb(), nullptr);
+    state.setProperty("generatorSineHz", signalGenerator.getSineFrequency(), nullptr);
+    state.setProperty("generatorSweep", juce::String(signalGenerator.getSweepStartHz()) + ","
+                                        + juce::String(signalGenerator.getSweepEndHz()) + ","
+                                        + juce::String(signalGenerator.getSweepSeconds()), nullptr);
+    
+    // 本地覆盖层属于本实例的Stem质检配置（不是Master状态），与Solo/Mute不同，需要持久化
+    juce::StringArray localTrims;
+    for (int channelId = 0; channelId < OSCAddressTable::NUM_CHANNEL_IDS; ++channelId) {
+        const float trimDb = localTrimDb[static_cast<size_t>(channelId)];
+        if (trimDb != 0.0f) {
+            localTrims.add(OSCAddressTable::getChannelName(channelId) + "=" + juce::String(trimDb, 2));
+        }
+    }
+    state.setProperty("localMuteMask", static_cast<int>(localMuteMask), nullptr);
+    state.setProperty("localTrims", localTrims.joinIntoString(";"), nullptr);
     
     // 🎯 用户需求：完全移除Solo/Mute状态的持久化保存
     // 只保留Gain参数、角色、布局配置的持久化，确保插件重新加载时Solo/Mute状态为干净初始状态
     // Note: Solo/Mute状态在DAW会话期间（窗口关闭/重开）仍然通过内存对象维持
     
     VST3_DBG_DETAIL("PluginProcessor: Saving complete state - Layout: " + userSelectedSpeakerLayout + " + " + userSelectedSubLayout + 
-             ", Role: " + juce::String(static_cast<int>(currentRole)) + 
+             ", Role: " + juce::String(static_cast<int>(currentRole.load())) + 
              " (Solo/Mute states NOT saved - clean startup policy)");
     
     auto xml = state.createXml();
@@ -426,6 +668,35 @@ void MonitorControllerMaxAudioProcessor::setStateInformation (const void* data,
             auto state = juce::ValueTree::fromXml(*xmlState);
             apvts.replaceState(state);
             
+            // 恢复OSC实例组（先于角色恢复，角色切换时按此组注册到共享OSC中心）
+            if (state.hasProperty("oscGroup")) {
+                setOSCGroup(state.getProperty("oscGroup").toString());
+            }
+            
+            // 恢复Master组（先于角色恢复，角色切换时在该组内竞选Master/订阅Master）
+            if (state.hasProperty("masterGroup")) {
+                setMasterGroupName(state.getProperty("masterGroup").toString());
+            }
+            
+            // 恢复本地覆盖层（先于角色恢复，角色切换发布的快照即包含本地层）
+            if (state.hasProperty("localMuteMask") || state.hasProperty("localTrims")) {
+                const uint32_t validMask = (1u << OSCAddressTable::NUM_CHANNEL_IDS) - 1u;
+                localMuteMask = static_cast<uint32_t>(static_cast<int>(state.getProperty("localMuteMask", 0))) & validMask;
+                localTrimDb.fill(0.0f);
+                
+                for (const auto& entry : juce::StringArray::fromTokens(state.getProperty("localTrims").toString(), ";", "")) {
+                    const int channelId = OSCAddressTable::findChannelId(entry.upToFirstOccurrenceOf("=", false, false).trim());
+                    if (channelId == OSCAddressTable::INVALID_CHANNEL_ID) continue;
+                    
+                    const float trimDb = entry.fromFirstOccurrenceOf("=", false, false).getFloatValue();
+                    localTrimDb[static_cast<size_t>(channelId)] = juce::jlimit(-maxLocalTrimDb, maxLocalTrimDb, trimDb);
+                }
+                
+                if (stateManager) {
+                    stateManager->onLocalLayerChanged();
+                }
+            }
+            
             // 恢复角色信息
             if (state.hasProperty("pluginRole")) {
                 int savedRoleInt = state.getProperty("pluginRole", 0);
@@ -450,6 +721,47 @@ void MonitorControllerMaxAudioProcessor::setStateInformation (const void* data,
                 VST3_DBG_ROLE(this, "Plugin role restoration complete - connection logic triggered");
             }
             
+            // 恢复输入源选择
+            if (state.hasProperty("inputSource")) {
+                const int savedSource = juce::jlimit(0, 2, static_cast<int>(state.getProperty("inputSource", 0)));
+                setInputSource(static_cast<InputSource>(savedSource));
+            }
+            
+            // 恢复分析器OSC输出开关
+            if (state.hasProperty("analyserOSC")) {
+                setAnalyserOSCStreaming(static_cast<bool>(state.getProperty("analyserOSC", false)));
+            }
+            
+            // 恢复电平表OSC输出帧率
+            if (state.hasProperty("meterOSCRate")) {
+                setMeterOSCRate(static_cast<int>(state.getProperty("meterOSCRate", 0)));
+            }
+            
+            // 恢复校准信号配置
+            if (state.hasProperty("generatorRouting")) {
+                auto routing = juce::StringArray::fromTokens(state.getProperty("generatorRouting").toString(), ",", "");
+                routing.removeEmptyStrings();
+                setGeneratorRouting(routing.isEmpty() ? juce::StringArray{ "ALL" } : routing);
+            }
+            if (state.hasProperty("generatorLevelDb")) {
+                setGeneratorLevelDb(static_cast<float>(state.getProperty("generatorLevelDb", SignalGenerator::DEFAULT_LEVEL_DB)));
+            }
+            if (state.hasProperty("generatorSineHz")) {
+                setGeneratorSineFrequency(static_cast<float>(state.getProperty("generatorSineHz", 1000.0f)));
+            }
+            if (state.hasProperty("generatorSweep")) {
+                const auto sweep = juce::StringArray::fromTokens(state.getProperty("generatorSweep").toString(), ",", "");
+                if (sweep.size() == 3) {
+                    setGeneratorSweepRange(sweep[0].getFloatValue(), sweep[1].getFloatValue(), sweep[2].getFloatValue());
+                }
+            }
+            
+            // 恢复Solo监听模式
+            if (state.hasProperty("soloMode")) {
+                const int savedSoloMode = juce::jlimit(0, 2, static_cast<int>(state.getProperty("soloMode", 0)));
+                setSoloMode(static_cast<SoloMode>(savedSoloMode));
+            }
+            
             // 恢复用户选择的布局配置（如果存在）
             if (state.hasProperty("currentSpeakerLayout") && state.hasProperty("currentSubLayout"))
             {
@@ -464,13 +776,16 @@ void MonitorControllerMaxAudioProcessor::setStateInformation (const void* data,
                 userSelectedSubLayout = savedSub;
                 
                 // 延迟应用布局，让UI有时间初始化
-                juce::MessageManager::callAsync([this, savedSpeaker, savedSub]()
+                juce::MessageManager::callAsync([safeThis = juce::WeakReference<MonitorControllerMaxAudioProcessor>(this), savedSpeaker, savedSub]()
                 {
-                    VST3_DBG_ROLE(this, "Applying restored layout after UI initialization");
-                    setCurrentLayout(savedSpeaker, savedSub);
+                    auto* self = safeThis.get();
+                    if (self == nullptr) return;
+                    
+                    VST3_DBG_ROLE(self, "Applying restored layout after UI initialization");
+                    self->setCurrentLayout(savedSpeaker, savedSub);
                     
                     // 🎯 用户需求：不再恢复Solo/Mute状态，确保干净启动
-                    VST3_DBG_ROLE(this, "Layout restored - Solo/Mute states remain clean for fresh start");
+                    VST3_DBG_ROLE(self, "Layout restored - Solo/Mute states remain clean for fresh start");
                 });
             }
         }
@@ -488,8 +803,8 @@ void MonitorControllerMaxAudioProcessor::setStateInformation (const void* data,
 // 返回: 对应的声道名称（如"LFE"）或默认名称
 const juce::String MonitorControllerMaxAudioProcessor::getInputChannelName(int channelIndex) const
 {
-    // 获取当前输入总线的通道数
-    int totalChannels = getTotalNumInputChannels();
+    // 获取主输入总线的通道数（侧链总线不参与声道命名）
+    int totalChannels = getMainBusNumInputChannels();
     
     // 检查通道索引是否有效
     if (channelIndex >= 0 && channelIndex < totalChannels)
@@ -550,6 +865,14 @@ const juce::String MonitorControllerMaxAudioProcessor::getInputChannelName(int c
 // 返回: 对应的声道名称（如"LFE"）或默认名称
 const juce::String MonitorControllerMaxAudioProcessor::getOutputChannelName(int channelIndex) const
 {
+    // Cue总线通道（位于主输出通道之后）
+    if (isCueBusEnabled())
+    {
+        const int mainOutputs = getMainBusNumOutputChannels();
+        if (channelIndex == mainOutputs)     return "Cue L";
+        if (channelIndex == mainOutputs + 1) return "Cue R";
+    }
+    
     // 复用输入通道名称逻辑，但替换前缀
     auto inputName = getInputChannelName(channelIndex);
     
@@ -578,6 +901,15 @@ void MonitorControllerMaxAudioProcessor::setCurrentLayout(const juce::String& sp
     VST3_DBG_ROLE(this, "Update physical channel mapping");
     physicalMapper.updateMapping(currentLayout);
     
+    updateLoudnessChannelWeights();
+    updateAnalyserChannels();
+    
+    // 🚀 重建OSC出站地址表（只包含当前布局的通道）
+    juce::StringArray layoutChannelNames;
+    for (const auto& channelInfo : currentLayout.channels)
+        layoutChannelNames.add(channelInfo.name);
+    oscCommunicator.updateAddressTable(layoutChannelNames);
+    
     // JUCE架构重构：通知StateManager布局已改变
     if (stateManager) {
         stateManager->onLayoutChanged();
@@ -603,14 +935,14 @@ void MonitorControllerMaxAudioProcessor::setCurrentLayout(const juce::String& sp
     updateHostDisplay();
     
     // 为REAPER等DAW添加延迟的额外刷新 - 某些DAW需要多次通知
-    juce::Timer::callAfterDelay(50, [this]()
+    juce::Timer::callAfterDelay(50, [safeThis = juce::WeakReference<MonitorControllerMaxAudioProcessor>(this)]()
     {
-        updateHostDisplay();
+        if (auto* self = safeThis.get()) self->updateHostDisplay();
     });
     
-    juce::Timer::callAfterDelay(200, [this]()
+    juce::Timer::callAfterDelay(200, [safeThis = juce::WeakReference<MonitorControllerMaxAudioProcessor>(this)]()
     {
-        updateHostDisplay();
+        if (auto* self = safeThis.get()) self->updateHostDisplay();
     });
 }
 
@@ -621,7 +953,7 @@ const Layout& MonitorControllerMaxAudioProcessor::getCurrentLayout() const
 
 int MonitorControllerMaxAudioProcessor::getAvailableChannels() const
 {
-    return getTotalNumInputChannels();
+    return getMainBusNumInputChannels();
 }
 
 // 根据通道数自动选择最合适的布局配置
@@ -1019,6 +1351,42 @@ void MonitorControllerMaxAudioProcessor::handleExternalOSCControl(const juce::St
     }
 }
 
+void MonitorControllerMaxAudioProcessor::handleExternalOSCBatchControl(const juce::String& action, const juce::StringArray& channelNames, bool state)
+{
+    VST3_DBG_ROLE(this, "Handle external OSC pattern control - action: " + action + 
+             ", channels: " + channelNames.joinIntoString(",") + ", state: " + (state ? "ON" : "OFF"));
+    
+    if (action != "Solo" && action != "Mute")
+    {
+        VST3_DBG_ROLE(this, "Unknown OSC action - " + action);
+        return;
+    }
+    
+    // 只保留当前映射中存在的通道
+    std::vector<SemanticChannelState::ChannelStateChange> changes;
+    for (const auto& channelName : channelNames)
+    {
+        if (physicalMapper.hasSemanticChannel(channelName))
+        {
+            changes.push_back({ channelName, action == "Solo", state });
+        }
+    }
+    
+    if (changes.empty())
+    {
+        VST3_DBG_ROLE(this, "OSC pattern control matched no mapped channels");
+        return;
+    }
+    
+    // 🚀 一个事务：Solo联动计算一次、RenderState重建一次
+    semanticState.applyStateTransaction(changes);
+    
+    // 通知StateManager处理外部状态变化，确保UI更新（选择模式只需判断一次）
+    if (stateManager) {
+        stateManager->onExternalStateChange(changes.front().channelName, action == "Solo" ? "solo" : "mute", state);
+    }
+}
+
 void MonitorControllerMaxAudioProcessor::sendDimOSCState(bool dimState)
 {
     // v4.1: 发送Dim状态OSC消息 (只有Master/Standalone发送)
@@ -1043,6 +1411,244 @@ void MonitorControllerMaxAudioProcessor::sendMasterMuteOSCState(bool masterMuteS
     }
 }
 
+void MonitorControllerMaxAudioProcessor::setLoudnessMatchActive(bool shouldBeActive)
+{
+    // 以当前渲染状态作为参考，其他比较状态补偿到同一响度
+    const RenderState* renderState = stateManager ? stateManager->getCurrentRenderState() : nullptr;
+    const uint32_t referenceKey = renderState != nullptr ? renderState->comparisonKey : 0;
+    
+    loudnessMatcher.setActive(shouldBeActive, referenceKey);
+    
+    if (stateManager) {
+        stateManager->refreshRenderState();
+    }
+    
+    VST3_DBG_ROLE(this, "Loudness match " << (shouldBeActive ? "ON" : "OFF"));
+}
+
+void MonitorControllerMaxAudioProcessor::setSoloMode(SoloMode newMode)
+{
+    // SemanticChannelState广播全局模式变化，StateManager随之重建渲染快照和UI缓存
+    semanticState.setSoloMode(newMode);
+    
+    VST3_DBG_ROLE(this, "Solo listen mode: " << SemanticChannelState::getSoloModeName(newMode));
+}
+
+bool MonitorControllerMaxAudioProcessor::isCueBusEnabled() const
+{
+    const auto* cueBus = getBus(false, cueBusIndex);
+    return cueBus != nullptr && cueBus->isEnabled();
+}
+
+void MonitorControllerMaxAudioProcessor::setInputSource(InputSource newSource)
+{
+    if (selectedInputSource.exchange(static_cast<int>(newSource)) == static_cast<int>(newSource))
+        return;
+    
+    // 渲染快照只记录源索引，音频线程据此切换读指针并交叉淡化
+    if (stateManager) {
+        stateManager->refreshRenderState();
+    }
+    
+    VST3_DBG_ROLE(this, "Input source: " << getInputSourceName(newSource)
+                  << (isInputSourceAvailable(newSource) ? "" : " (bus disabled in host - falling back to main input)"));
+}
+
+bool MonitorControllerMaxAudioProcessor::isInputSourceAvailable(InputSource source) const
+{
+    if (source == InputSource::Main)
+        return true;
+    
+    const auto* bus = getBus(true, static_cast<int>(source));
+    return bus != nullptr && bus->isEnabled();
+}
+
+juce::String MonitorControllerMaxAudioProcessor::getInputSourceName(InputSource source)
+{
+    switch (source)
+    {
+        case InputSource::Stem:      return "STEM";
+        case InputSource::Reference: return "REF";
+        case InputSource::Main:
+        default:                     return "MAIN";
+    }
+}
+
+void MonitorControllerMaxAudioProcessor::updateLoudnessChannelWeights()
+{
+    for (int i = 0; i < LoudnessMatcher::MAX_CHANNELS; ++i) {
+        loudnessMatcher.setChannelWeight(i, 0.0f);
+    }
+    
+    for (const auto& channelInfo : currentLayout.channels) {
+        loudnessMatcher.setChannelWeight(channelInfo.channelIndex,
+                                         LoudnessMatcher::getChannelWeightForName(channelInfo.name));
+    }
+}
+
+void MonitorControllerMaxAudioProcessor::setGeneratorType(SignalGenerator::Type newType)
+{
+    signalGenerator.setType(newType);
+    
+    VST3_DBG_ROLE(this, "Signal generator: " << SignalGenerator::getTypeName(newType)
+                  << " @ " << signalGenerator.getLevelDb() << " dBFS RMS -> " << generatorRouting.joinIntoString(", "));
+}
+
+void MonitorControllerMaxAudioProcessor::setGeneratorRouting(const juce::StringArray& channelsOrGroups)
+{
+    generatorRouting = channelsOrGroups;
+    
+    // 路由变化只影响渲染快照中的通道索引表
+    if (stateManager) {
+        stateManager->refreshRenderState();
+    }
+    
+    VST3_DBG_ROLE(this, "Signal generator routing: " << generatorRouting.joinIntoString(", "));
+}
+
+void MonitorControllerMaxAudioProcessor::setGeneratorLevelDb(float rmsDbFS)
+{
+    // 电平只是原子参数，音频线程下一块生效，无需重建渲染快照
+    signalGenerator.setLevelDb(rmsDbFS);
+    VST3_DBG_ROLE(this, "Signal generator level: " << signalGenerator.getLevelDb() << " dBFS RMS");
+}
+
+void MonitorControllerMaxAudioProcessor::setGeneratorSineFrequency(float frequencyHz)
+{
+    signalGenerator.setSineFrequency(frequencyHz);
+    VST3_DBG_ROLE(this, "Signal generator sine: " << signalGenerator.getSineFrequency() << " Hz");
+}
+
+void MonitorControllerMaxAudioProcessor::setGeneratorSweepRange(float startHz, float endHz, float durationSeconds)
+{
+    signalGenerator.setSweepRange(startHz, endHz, durationSeconds);
+    VST3_DBG_ROLE(this, "Signal generator sweep: " << signalGenerator.getSweepStartHz() << " - "
+                  << signalGenerator.getSweepEndHz() << " Hz, " << signalGenerator.getSweepSeconds() << " s");
+}
+
+bool MonitorControllerMaxAudioProcessor::isChannelRoutedToGenerator(const juce::String& channelName) const
+{
+    for (const auto& target : generatorRouting) {
+        if (target == "ALL" || target == channelName)
+            return true;
+        
+        const bool isSUB = semanticState.isSUBChannel(channelName);
+        if ((target == "SUB" && isSUB) || (target == "MAIN" && !isSUB))
+            return true;
+    }
+    
+    return false;
+}
+
+void MonitorControllerMaxAudioProcessor::setLocalMuteOverride(const juce::String& channelName, bool shouldMute)
+{
+    const int channelId = OSCAddressTable::findChannelId(channelName);
+    if (channelId == OSCAddressTable::INVALID_CHANNEL_ID)
+        return;
+    
+    const uint32_t bit = 1u << channelId;
+    const uint32_t newMask = shouldMute ? (localMuteMask | bit) : (localMuteMask & ~bit);
+    if (newMask == localMuteMask)
+        return;
+    
+    localMuteMask = newMask;
+    
+    // 只重建本地层：Master层（Solo/Mute镜像）不重新收集
+    if (stateManager) {
+        stateManager->onLocalLayerChanged();
+    }
+    
+    VST3_DBG_ROLE(this, "Local mute override " << channelName << " " << (shouldMute ? "ON" : "OFF"));
+}
+
+bool MonitorControllerMaxAudioProcessor::getLocalMuteOverride(const juce::String& channelName) const
+{
+    const int channelId = OSCAddressTable::findChannelId(channelName);
+    return channelId != OSCAddressTable::INVALID_CHANNEL_ID && (localMuteMask & (1u << channelId)) != 0;
+}
+
+void MonitorControllerMaxAudioProcessor::setLocalTrimOffset(const juce::String& channelName, float offsetDb)
+{
+    const int channelId = OSCAddressTable::findChannelId(channelName);
+    if (channelId == OSCAddressTable::INVALID_CHANNEL_ID)
+        return;
+    
+    const float clampedDb = juce::jlimit(-maxLocalTrimDb, maxLocalTrimDb, offsetDb);
+    auto& trimDb = localTrimDb[static_cast<size_t>(channelId)];
+    if (trimDb == clampedDb)
+        return;
+    
+    trimDb = clampedDb;
+    
+    if (stateManager) {
+        stateManager->onLocalLayerChanged();
+    }
+    
+    VST3_DBG_ROLE(this, "Local trim " << channelName << " " << juce::String(clampedDb, 1) << " dB");
+}
+
+float MonitorControllerMaxAudioProcessor::getLocalTrimOffset(const juce::String& channelName) const
+{
+    const int channelId = OSCAddressTable::findChannelId(channelName);
+    return channelId != OSCAddressTable::INVALID_CHANNEL_ID ? localTrimDb[static_cast<size_t>(channelId)] : 0.0f;
+}
+
+void MonitorControllerMaxAudioProcessor::clearLocalOverrides()
+{
+    if (!hasLocalOverrides())
+        return;
+    
+    localMuteMask = 0;
+    localTrimDb.fill(0.0f);
+    
+    if (stateManager) {
+        stateManager->onLocalLayerChanged();
+    }
+    
+    VST3_DBG_ROLE(this, "Local overrides cleared");
+}
+
+bool MonitorControllerMaxAudioProcessor::hasLocalOverrides() const noexcept
+{
+    if (localMuteMask != 0)
+        return true;
+    
+    return std::any_of(localTrimDb.begin(), localTrimDb.end(), [](float trimDb) { return trimDb != 0.0f; });
+}
+
+void MonitorControllerMaxAudioProcessor::setAnalyserOSCStreaming(bool shouldStream)
+{
+    if (channelAnalyser.isOSCStreamingEnabled() == shouldStream)
+        return;
+    
+    channelAnalyser.setOSCStreamingEnabled(shouldStream);
+    VST3_DBG_ROLE(this, "Analyser OSC streaming " << (shouldStream ? "ON" : "OFF"));
+}
+
+void MonitorControllerMaxAudioProcessor::setMeterOSCRate(int rateHz)
+{
+    channelMeter.setOSCRateHz(rateHz);
+    VST3_DBG_ROLE(this, "Meter OSC streaming " << (channelMeter.getOSCRateHz() > 0 ? juce::String(channelMeter.getOSCRateHz()) + " Hz" : juce::String("OFF")));
+}
+
+void MonitorControllerMaxAudioProcessor::updateAnalyserChannels()
+{
+    analyserChannelNames.clear();
+    for (int i = 0; i < AnalyserSnapshot::MAX_CHANNELS; ++i) {
+        channelAnalyser.setChannelActive(i, false);
+        analyserChannelNames.add({});
+    }
+    
+    for (const auto& channelInfo : currentLayout.channels) {
+        if (juce::isPositiveAndBelow(channelInfo.channelIndex, AnalyserSnapshot::MAX_CHANNELS)) {
+            channelAnalyser.setChannelActive(channelInfo.channelIndex, true);
+            analyserChannelNames.set(channelInfo.channelIndex, channelInfo.name);
+        }
+    }
+    
+    channelAnalyser.setStereoPairs(PhysicalChannelMapper::getStereoPairs(currentLayout));
+}
+
 void MonitorControllerMaxAudioProcessor::sendMonoOSCState(bool monoState)
 {
     // v4.1: 发送Mono状态OSC消息 (只有Master/Standalone发送)
@@ -1056,7 +1662,9 @@ void MonitorControllerMaxAudioProcessor::sendMonoOSCState(bool monoState)
 
 void MonitorControllerMaxAudioProcessor::registerToGlobalState() {
     if (!isRegisteredToGlobalState) {
-        GlobalPluginState::getRef().registerPlugin(this);
+        auto& globalState = GlobalPluginState::getRef();
+        pluginHandle = globalState.registerPlugin(this, masterGroupName);
+        masterGroup = globalState.getPluginGroup(this);
         isRegisteredToGlobalState = true;
         VST3_DBG_ROLE(this, "Plugin registered to GlobalPluginState");
     }
@@ -1065,11 +1673,34 @@ void MonitorControllerMaxAudioProcessor::registerToGlobalState() {
 void MonitorControllerMaxAudioProcessor::unregisterFromGlobalState() {
     if (isRegisteredToGlobalState) {
         GlobalPluginState::getRef().unregisterPlugin(this);
+        pluginHandle = {};
+        masterGroup.reset();
         isRegisteredToGlobalState = false;
         VST3_DBG_ROLE(this, "Plugin unregistered from GlobalPluginState");
     }
 }
 
+void MonitorControllerMaxAudioProcessor::setMasterGroupName(const juce::String& groupName) {
+    const juce::String normalised = SharedOSCHub::normaliseGroupName(groupName);
+    if (normalised == masterGroupName) return;
+    
+    masterGroupName = normalised;
+    if (!isRegisteredToGlobalState) return;
+    
+    // 角色只在组内有意义：先退出旧组的Master/Slave，换组后在新组内按原角色重新加入
+    const PluginRole roleToRestore = currentRole;
+    switchToStandalone();
+    
+    masterGroup = GlobalPluginState::getRef().setPluginGroup(this, masterGroupName);
+    VST3_DBG_ROLE(this, "Master group changed to: " + (masterGroupName.isEmpty() ? juce::String("Default") : masterGroupName));
+    
+    if (roleToRestore == PluginRole::Master) {
+        switchToMaster();
+    } else if (roleToRestore == PluginRole::Slave) {
+        switchToSlave();
+    }
+}
+
 void MonitorControllerMaxAudioProcessor::switchToStandalone() {
     if (currentRole == PluginRole::Standalone) return;
     
@@ -1098,16 +1729,14 @@ void MonitorControllerMaxAudioProcessor::switchToMaster() {
         handleRoleTransition(PluginRole::Master);
         VST3_DBG_ROLE(this, "Successfully switched to Master mode");
         
-        // 同步当前状态到所有Slave
-        auto activeChannels = physicalMapper.getActiveSemanticChannels();
-        for (const auto& channelName : activeChannels) {
-            bool soloState = semanticState.getSoloState(channelName);
-            bool muteState = semanticState.getMuteState(channelName);
-            
-            globalState.setGlobalSoloState(channelName, soloState);
-            globalState.setGlobalMuteState(channelName, muteState);
-            globalState.broadcastStateToSlaves(channelName, "solo", soloState);
-            globalState.broadcastStateToSlaves(channelName, "mute", muteState);
+        // 发布当前状态到本组的Master状态快照，Slave在下一个定时器节拍拉取
+        if (masterGroup) {
+            auto activeChannels = physicalMapper.getActiveSemanticChannels();
+            for (const auto& channelName : activeChannels) {
+                masterGroup->setSoloState(channelName, semanticState.getSoloState(channelName));
+                masterGroup->setMuteState(channelName, semanticState.getMuteState(channelName));
+            }
+            masterGroup->setMonoState(masterBusProcessor.isMonoActive());
         }
     } else {
         VST3_DBG_ROLE(this, "Failed to switch to Master - another Master exists");
@@ -1122,10 +1751,8 @@ void MonitorControllerMaxAudioProcessor::switchToSlave() {
     }
     
     if (globalState.addSlavePlugin(this)) {
+        // Master状态在handleRoleTransition内与角色一起安装，只发布一次RenderState
         handleRoleTransition(PluginRole::Slave);
-        
-        // 同步Master状态到本地
-        globalState.syncAllStatesToSlave(this);
         VST3_DBG_ROLE(this, "Successfully switched to Slave mode");
     } else {
         VST3_DBG_ROLE(this, "Failed to switch to Slave - no Master available");
@@ -1135,17 +1762,48 @@ void MonitorControllerMaxAudioProcessor::switchToSlave() {
 
 void MonitorControllerMaxAudioProcessor::handleRoleTransition(PluginRole newRole) {
     PluginRole oldRole = currentRole;
-    currentRole = newRole;
-    savedRole = newRole;  // 保存角色用于状态持久化
     
     VST3_DBG_ROLE(this, "Role transition: " + getRoleString(oldRole) + " -> " + getRoleString(newRole));
     
-    // 重要：角色变化时重新初始化OSC系统
+    // 🚀 分阶段切换：新角色的完整状态（Slave含Master快照）在一个事务内准备好，只发布一次RenderState
+    // 音频线程只会看到旧角色快照或新角色快照，不存在半应用状态；切换本身由音频线程短时淡化
+    {
+        std::unique_ptr<StateManager::ScopedTransaction> transaction;
+        if (stateManager) {
+            transaction = std::make_unique<StateManager::ScopedTransaction>(*stateManager);
+        }
+        
+        currentRole = newRole;
+        savedRole = newRole;  // 保存角色用于状态持久化
+        
+        if (newRole == PluginRole::Slave) {
+            hasAppliedMasterState = false;
+            masterPropagation.reset();
+            
+            // 同步Master状态到本地（快照变化合并进本事务）
+            GlobalPluginState::getRef().syncAllStatesToSlave(this);
+        }
+        
+        if (stateManager) {
+            stateManager->stageRoleTransition();
+        }
+    }
+    
+    // Slave跟随Master状态快照；未能安装快照时首个节拍无条件全量应用。Master用同一定时器低频发送传播报告
+    if (newRole == PluginRole::Slave) {
+        startTimer(masterFollowIntervalMs);
+    } else if (newRole == PluginRole::Master) {
+        startTimer(propagationReportIntervalMs);
+    } else {
+        stopTimer();
+    }
+    
+    // 重要：角色变化时重新初始化OSC系统（在新快照发布之后，音频切换不等待OSC注册）
     initializeOSCForRole();
     
     // 异步更新UI
-    juce::MessageManager::callAsync([this]() {
-        updateUIFromRole();
+    juce::MessageManager::callAsync([safeThis = juce::WeakReference<MonitorControllerMaxAudioProcessor>(this)]() {
+        if (auto* self = safeThis.get()) self->updateUIFromRole();
     });
 }
 
@@ -1155,66 +1813,104 @@ void MonitorControllerMaxAudioProcessor::updateUIFromRole() {
     }
 }
 
-void MonitorControllerMaxAudioProcessor::receiveMasterState(const juce::String& channelName, const juce::String& action, bool state) {
+// 一次性安装Master状态快照：全部Solo/Mute + 总线状态在一个事务内应用，只发布一次RenderState
+void MonitorControllerMaxAudioProcessor::applyMasterSnapshot(const MasterStateSnapshot& snapshot) {
     if (currentRole != PluginRole::Slave) return;
     
+    // 只收集当前布局中与快照不一致的通道
+    std::vector<SemanticChannelState::ChannelStateChange> changes;
+    for (int channelId = 0; channelId < OSCAddressTable::NUM_CHANNEL_IDS; ++channelId) {
+        const auto& channelName = OSCAddressTable::getChannelName(channelId);
+        if (!physicalMapper.hasSemanticChannel(channelName)) continue;
+        
+        const uint32_t bit = 1u << channelId;
+        const bool solo = (snapshot.soloMask & bit) != 0;
+        const bool mute = (snapshot.muteMask & bit) != 0;
+        if (semanticState.getSoloState(channelName) != solo) {
+            changes.push_back({ channelName, true, solo });
+        }
+        if (semanticState.getMuteState(channelName) != mute) {
+            changes.push_back({ channelName, false, mute });
+        }
+    }
+    
+    const bool monoChanged = masterBusProcessor.isMonoActive() != snapshot.mono;
+    
+    appliedMasterState = snapshot;
+    hasAppliedMasterState = true;
+    
+    // 传播跟踪：组发布记录先于状态字写入，状态字一致时即为本次应用的发布
+    bool sequenceChanged = false;
+    if (masterGroup) {
+        const auto publication = masterGroup->getLatestPublication();
+        if (publication.stateWord == snapshot.pack() &&
+            publication.sequence != appliedMasterSequence.load(std::memory_order_relaxed)) {
+            appliedMasterPublishedTicks.store(publication.publishedTicks, std::memory_order_relaxed);
+            appliedMasterSequence.store(publication.sequence, std::memory_order_relaxed);
+            sequenceChanged = true;
+        }
+    }
+    
+    if (changes.empty() && !monoChanged) {
+        // 没有可听变化也发布一次渲染快照，让音频线程确认该序号（落后量归零）
+        if (sequenceChanged && stateManager) {
+            stateManager->refreshRenderState();
+        }
+        return;
+    }
+    
     // 防止循环回调
     suppressStateChange = true;
     
-    try {
-        // 应用Master状态到本地语义状态
-        if (action == "solo") {
-            semanticState.setSoloState(channelName, state);
-        } else if (action == "mute") {
-            semanticState.setMuteState(channelName, state);
+    {
+        // 🚀 通道事务与Mono切换合并为一次RenderState发布
+        std::unique_ptr<StateManager::ScopedTransaction> transaction;
+        if (stateManager) {
+            transaction = std::make_unique<StateManager::ScopedTransaction>(*stateManager);
         }
         
-        VST3_DBG_ROLE(this, "Slave received Master state: " + action + " " + channelName + " = " + (state ? "true" : "false"));
-        
-        // 异步通知UI更新
-        juce::MessageManager::callAsync([this]() {
-            if (auto* editor = dynamic_cast<MonitorControllerMaxAudioProcessorEditor*>(getActiveEditor())) {
-                editor->updateChannelButtonStates();
-            }
-        });
+        semanticState.applyStateTransaction(changes);
         
-    } catch (const std::exception& e) {
-        VST3_DBG_ROLE(this, "Error receiving Master state: " + juce::String(e.what()));
+        if (monoChanged) {
+            masterBusProcessor.setMonoActive(snapshot.mono);
+        }
     }
     
-    // 重新启用回调
     suppressStateChange = false;
+    
+    VST3_DBG_ROLE(this, "Slave applied Master snapshot v" + juce::String(static_cast<int>(snapshot.version)) + 
+                  " - " + juce::String(static_cast<int>(changes.size())) + " channel changes" + (monoChanged ? ", mono" : ""));
+    
+    // UI由编辑器下一帧合并刷新（Solo连发时也只刷新一次）
+    markUIStateDirty();
 }
 
-// v4.1: 接收Master总线效果状态 - 用于Master-Slave同步
-void MonitorControllerMaxAudioProcessor::receiveMasterBusState(const juce::String& busEffect, bool state) {
-    if (currentRole != PluginRole::Slave) return;
+void MonitorControllerMaxAudioProcessor::timerCallback() {
+    if (currentRole == PluginRole::Slave) {
+        followMasterState();
+    } else if (currentRole == PluginRole::Master) {
+        if (isRegisteredToGlobalState && oscCommunicator.isConnected()) {
+            oscCommunicator.sendPropagationReport(GlobalPluginState::getRef().getPropagationReport(this));
+        }
+    } else {
+        stopTimer();
+    }
+}
+
+// Slave拉取Master状态快照：版本未变时只有一次原子读取
+void MonitorControllerMaxAudioProcessor::followMasterState() {
+    if (currentRole != PluginRole::Slave) {
+        return;
+    }
     
-    // 防止循环回调
-    suppressStateChange = true;
+    if (!masterGroup) return;
     
-    try {
-        // 应用Master总线效果状态到本地MasterBusProcessor
-        if (busEffect == "mono") {
-            masterBusProcessor.setMonoActive(state);
-        }
-        // 未来可以添加其他总线效果，如dim、lowBoost等
-        
-        VST3_DBG_ROLE(this, "Slave received Master bus state: " + busEffect + " = " + (state ? "ON" : "OFF"));
-        
-        // 异步通知UI更新
-        juce::MessageManager::callAsync([this]() {
-            if (auto* editor = dynamic_cast<MonitorControllerMaxAudioProcessorEditor*>(getActiveEditor())) {
-                editor->updateChannelButtonStates();
-            }
-        });
-        
-    } catch (const std::exception& e) {
-        VST3_DBG_ROLE(this, "Error receiving Master bus state: " + juce::String(e.what()));
+    const auto snapshot = masterGroup->getSnapshot();
+    if (hasAppliedMasterState && snapshot.pack() == appliedMasterState.pack()) {
+        return;
     }
     
-    // 重新启用回调
-    suppressStateChange = false;
+    applyMasterSnapshot(snapshot);
 }
 
 void MonitorControllerMaxAudioProcessor::onMasterDisconnected() {
@@ -1232,16 +1928,16 @@ void MonitorControllerMaxAudioProcessor::onMasterConnected() {
 }
 
 bool MonitorControllerMaxAudioProcessor::isMasterWithSlaves() const {
-    return currentRole == PluginRole::Master && GlobalPluginState::getRef().getSlaveCount() > 0;
+    return currentRole == PluginRole::Master && GlobalPluginState::getRef().getSlaveCount(this) > 0;
 }
 
 bool MonitorControllerMaxAudioProcessor::isSlaveConnected() const {
-    return currentRole == PluginRole::Slave && GlobalPluginState::getRef().hasMaster();
+    return currentRole == PluginRole::Slave && GlobalPluginState::getRef().hasMaster(this);
 }
 
 int MonitorControllerMaxAudioProcessor::getConnectedSlaveCount() const {
     if (currentRole == PluginRole::Master) {
-        return GlobalPluginState::getRef().getSlaveCount();
+        return GlobalPluginState::getRef().getSlaveCount(this);
     }
     return 0;
 }
@@ -1249,19 +1945,19 @@ int MonitorControllerMaxAudioProcessor::getConnectedSlaveCount() const {
 juce::String MonitorControllerMaxAudioProcessor::getConnectionStatusText() const {
     auto& globalState = GlobalPluginState::getRef();
     
-    switch (currentRole) {
+    switch (currentRole.load()) {
         case PluginRole::Standalone:
             return "Standalone";
             
         case PluginRole::Master:
-            if (globalState.getSlaveCount() > 0) {
-                return "Master (" + juce::String(globalState.getSlaveCount()) + " slaves)";
+            if (globalState.getSlaveCount(this) > 0) {
+                return "Master (" + juce::String(globalState.getSlaveCount(this)) + " slaves)";
             } else {
                 return "Master (no slaves)";
             }
             
         case PluginRole::Slave:
-            if (globalState.hasMaster()) {
+            if (globalState.hasMaster(this)) {
                 return "Slave (connected)";
             } else {
                 return "Slave (no master)";
@@ -1311,19 +2007,13 @@ void MonitorControllerMaxAudioProcessor::onSemanticStateChanged(const juce::Stri
         }
     }
     
-    // 新增主从同步（最小侵入）
-    if (currentRole == PluginRole::Master) {
-        auto& globalState = GlobalPluginState::getRef();
-        
-        // 更新全局状态
+    // 主从同步：更新本组状态即发布快照，O(1)，与Slave数量无关
+    if (currentRole == PluginRole::Master && masterGroup) {
         if (action == "solo") {
-            globalState.setGlobalSoloState(channelName, state);
+            masterGroup->setSoloState(channelName, state);
         } else if (action == "mute") {
-            globalState.setGlobalMuteState(channelName, state);
+            masterGroup->setMuteState(channelName, state);
         }
-        
-        // 广播给所有Slave
-        globalState.broadcastStateToSlaves(channelName, action, state);
     }
 }
 
@@ -1357,8 +2047,10 @@ void MonitorControllerMaxAudioProcessor::initializeOSCForRole() {
 void MonitorControllerMaxAudioProcessor::shutdownOSC() {
     if (oscCommunicator.isConnected()) {
         VST3_DBG_ROLE(this, "Shutting down OSC communication");
-        oscCommunicator.shutdown();
     }
+    
+    // 初始化失败时也要从共享OSC中心注销，shutdown()可重复调用
+    oscCommunicator.shutdown();
 }
 
 juce::String MonitorControllerMaxAudioProcessor::getRoleString(PluginRole role) const {
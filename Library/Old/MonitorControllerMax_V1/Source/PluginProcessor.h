@@ -20,20 +20,43 @@
 #include "OSCCommunicator.h"
 #include "GlobalPluginState.h"
 #include "MasterBusProcessor.h"
+#include "LoudnessMatcher.h"
+#include "ChannelAnalyser.h"
+#include "ChannelMeter.h"
+#include "SignalGenerator.h"
 #include "StateManager.h"
 #include "RenderState.h"
 
 //==============================================================================
 
+// 可选输入源（数值即输入总线索引）
+enum class InputSource {
+    Main = 0,        // 主输入（宿主插入点的混音）
+    Stem = 1,        // Stem侧链总线
+    Reference = 2    // 外部参考侧链总线
+};
+
+//==============================================================================
+
 class MonitorControllerMaxAudioProcessor  : public juce::AudioProcessor,
                                           public juce::AudioProcessorValueTreeState::Listener,
-                                          public SemanticChannelState::StateChangeListener
+                                          public SemanticChannelState::StateChangeListener,
+                                          private juce::Timer
 {
 public:
     //==============================================================================
     // A constant for the number of channels we'll manage.
     static constexpr int numManagedChannels = 26;
     
+    // AFL/PFL Cue总线（第二个输出总线，立体声，默认关闭由宿主启用）
+    static constexpr int cueBusIndex = 1;
+    
+    // 输入源切换交叉淡化时长
+    static constexpr double inputSourceCrossfadeSeconds = 0.01;
+    
+    // 角色切换时通道增益从旧角色淡化到新角色的时长
+    static constexpr double roleTransitionFadeSeconds = 0.02;
+    
     // This struct will be used for state synchronization between instances.
     struct MuteSoloState
     {
@@ -50,11 +73,10 @@ public:
     void switchToStandalone();
     void switchToMaster();
     void switchToSlave();
-    PluginRole getCurrentRole() const { return currentRole; }
+    PluginRole getCurrentRole() const { return currentRole.load(std::memory_order_acquire); }
     
-    // 状态同步接口（供GlobalPluginState调用）
-    void receiveMasterState(const juce::String& channelName, const juce::String& action, bool state);
-    void receiveMasterBusState(const juce::String& busEffect, bool state);  // v4.1: 接收总线效果状态
+    // 状态同步接口（供GlobalPluginState调用，消息线程）：一次事务安装Master的全部Solo/Mute/总线状态
+    void applyMasterSnapshot(const MasterStateSnapshot& snapshot);
     void onMasterDisconnected();
     void onMasterConnected();
     
@@ -112,6 +134,7 @@ public:
     
     // OSC external control handler
     void handleExternalOSCControl(const juce::String& action, const juce::String& channelName, bool state);
+    void handleExternalOSCBatchControl(const juce::String& action, const juce::StringArray& channelNames, bool state);
     
     // v4.1: Master总线OSC发送接口
     void sendDimOSCState(bool dimState);
@@ -119,6 +142,74 @@ public:
     void sendMasterMuteOSCState(bool masterMuteState);
     void sendMonoOSCState(bool monoState);
     
+    // 响度匹配比较模式：开启时的当前状态作为参考电平
+    void setLoudnessMatchActive(bool shouldBeActive);
+    bool isLoudnessMatchActive() const { return loudnessMatcher.isActive(); }
+    
+    // Solo监听模式：SIP（主输出Solo）/ AFL / PFL（Solo送入Cue总线，主输出不受影响）
+    void setSoloMode(SoloMode newMode);
+    SoloMode getSoloMode() const { return semanticState.getSoloMode(); }
+    bool isCueBusEnabled() const;
+    
+    // 输入源选择：渲染快照中切换读指针，音频线程做短交叉淡化
+    void setInputSource(InputSource newSource);
+    InputSource getInputSource() const { return static_cast<InputSource>(selectedInputSource.load()); }
+    bool isInputSourceAvailable(InputSource source) const;
+    static juce::String getInputSourceName(InputSource source);
+    
+    // 校准信号发生器：路由为语义通道名或组（ALL / MAIN / SUB），信号经GAIN_n与Solo/Mute后与节目交叉淡化
+    // 路由、电平、正弦频率与扫频范围随工程保存；信号类型不保存（重新加载工程不自动输出测试信号）
+    void setGeneratorType(SignalGenerator::Type newType);
+    SignalGenerator::Type getGeneratorType() const { return signalGenerator.getType(); }
+    void setGeneratorRouting(const juce::StringArray& channelsOrGroups);
+    const juce::StringArray& getGeneratorRouting() const { return generatorRouting; }
+    bool isChannelRoutedToGenerator(const juce::String& channelName) const;
+    void setGeneratorLevelDb(float rmsDbFS);
+    float getGeneratorLevelDb() const { return signalGenerator.getLevelDb(); }
+    void setGeneratorSineFrequency(float frequencyHz);
+    float getGeneratorSineFrequency() const { return signalGenerator.getSineFrequency(); }
+    void setGeneratorSweepRange(float startHz, float endHz, float durationSeconds);
+    
+    // 本地覆盖层（Stem质检）：叠加在Solo/Mute之上的额外静音与Trim偏移，按语义通道保存并随工程持久化
+    // 任何角色都生效；Slave跟随Master时保留。变化只重建渲染快照的本地层
+    static constexpr float maxLocalTrimDb = 24.0f;
+    void setLocalMuteOverride(const juce::String& channelName, bool shouldMute);
+    bool getLocalMuteOverride(const juce::String& channelName) const;
+    void setLocalTrimOffset(const juce::String& channelName, float offsetDb);
+    float getLocalTrimOffset(const juce::String& channelName) const;
+    void clearLocalOverrides();
+    bool hasLocalOverrides() const noexcept;
+    
+    // 频谱/相位相关分析器：编辑器视图注册后才开始分析，OSC输出可选
+    void setAnalyserOSCStreaming(bool shouldStream);
+    bool isAnalyserOSCStreaming() const { return channelAnalyser.isOSCStreamingEnabled(); }
+    
+    // 电平表OSC输出帧率：0 = 关闭，10-60Hz
+    void setMeterOSCRate(int rateHz);
+    int getMeterOSCRate() const { return channelMeter.getOSCRateHz(); }
+    
+    // OSC实例组：同进程多实例共用一个OSC端口，按 /<组名>/Monitor/... 区分；空为默认组
+    void setOSCGroup(const juce::String& groupName) { oscCommunicator.setAddressGroup(groupName); }
+    const juce::String& getOSCGroup() const { return oscCommunicator.getAddressGroup(); }
+    
+    // Master组：同组内一个Master带若干Slave，不同组互相独立；空为默认组。换组时暂时退出Master/Slave角色
+    void setMasterGroupName(const juce::String& groupName);
+    const juce::String& getMasterGroupName() const { return masterGroupName; }
+    MasterGroup* getMasterGroup() const { return masterGroup.get(); }
+    
+    // GlobalPluginState注册句柄（未注册时为空句柄）；其他实例与异步回调只保存句柄，不保存本对象指针
+    PluginHandle getPluginHandle() const noexcept { return pluginHandle; }
+    
+    // Master传播跟踪（任意线程读取）：已应用 = 消息线程装入状态模型，已输出 = 音频线程用到该快照
+    uint64_t getAppliedMasterSequence() const noexcept { return appliedMasterSequence.load(std::memory_order_relaxed); }
+    uint64_t getAudibleMasterSequence() const noexcept { return audibleMasterSequence.load(std::memory_order_relaxed); }
+    double getLastPropagationUs() const noexcept { return lastPropagationUs.load(std::memory_order_relaxed); }
+    PropagationHistogram::Counts getMasterPropagation() const noexcept { return masterPropagation.getCounts(); }
+    
+    // UI刷新合并：状态变化在任意线程只置脏标志，编辑器每帧取走一次并只刷新变化的按钮
+    void markUIStateDirty() noexcept { uiStateDirty.store(true, std::memory_order_release); }
+    bool consumeUIStateDirty() noexcept { return uiStateDirty.exchange(false, std::memory_order_acq_rel); }
+    
     // 状态同步时的回调处理（整合到现有回调中）
     void onSemanticStateChanged(const juce::String& channelName, const juce::String& action, bool state);
 
@@ -179,6 +270,11 @@ public:
     PhysicalChannelMapper physicalMapper;
     OSCCommunicator oscCommunicator;
     MasterBusProcessor masterBusProcessor;  // v4.1: 总线效果处理器
+    LoudnessMatcher loudnessMatcher;        // 响度匹配比较（后台分析线程）
+    ChannelAnalyser channelAnalyser;        // 频谱与相位相关分析（后台分析线程）
+    ChannelMeter channelMeter;              // 每通道峰值/RMS电平表（OSC输出）
+    juce::StringArray analyserChannelNames; // 按通道索引的名称（OSC地址用，仅消息线程）
+    SignalGenerator signalGenerator;        // 校准信号发生器（音频线程渲染）
     
     // JUCE架构重构：状态管理器
     std::unique_ptr<StateManager> stateManager;
@@ -188,15 +284,63 @@ private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     //==============================================================================
     // Master-Slave角色管理
-    PluginRole currentRole = PluginRole::Standalone;
+    // 消息线程写入；共享OSC接收线程的实时路径同时读取，必须是原子量
+    std::atomic<PluginRole> currentRole{ PluginRole::Standalone };
     bool isRegisteredToGlobalState = false;
+    PluginHandle pluginHandle;
+    juce::String masterGroupName;                   // 规范化后的组名
+    std::shared_ptr<MasterGroup> masterGroup;       // 注册后有效，组在GlobalPluginState生命周期内保留
     bool suppressStateChange = false;  // 防止循环回调
     
+    // Slave跟随Master：定时拉取GlobalPluginState的状态快照，版本变化时一次事务应用（仅消息线程）
+    static constexpr int masterFollowIntervalMs = 10;
+    MasterStateSnapshot appliedMasterState;
+    bool hasAppliedMasterState = false;
+    
+    // Master传播跟踪：消息线程写入已应用的发布（StateManager收集到渲染快照），音频线程记录输出序号与延迟
+    static constexpr int propagationReportIntervalMs = 1000;   // Master的OSC传播报告周期
+    std::atomic<uint64_t> appliedMasterSequence{ 0 };
+    std::atomic<juce::int64> appliedMasterPublishedTicks{ 0 };
+    std::atomic<uint64_t> audibleMasterSequence{ 0 };
+    std::atomic<double> lastPropagationUs{ 0.0 };
+    PropagationHistogram masterPropagation;
+    
+    // UI脏标志：不论一帧内有多少次状态变化，消息队列上都不产生额外消息
+    std::atomic<bool> uiStateDirty{ true };
+    
+    // 输入源选择（消息线程写入，StateManager收集到渲染快照）
+    std::atomic<int> selectedInputSource{ static_cast<int>(InputSource::Main) };
+    
+    // 输入源交叉淡化状态（仅音频线程访问）
+    int currentInputSource = static_cast<int>(InputSource::Main);
+    int fadeFromInputSource = static_cast<int>(InputSource::Main);
+    int inputFadeSamplesRemaining = 0;
+    int inputFadeLengthSamples = 480;
+    
+    // 角色切换淡化状态（仅音频线程访问）
+    uint32_t audibleRoleTransitionSerial = 0;
+    int roleFadeSamplesRemaining = 0;
+    int roleFadeLengthSamples = 960;
+    
+    // Cue总线暂存区：侧链输入与Cue输出可能共用宿主缓冲区通道，先混到暂存区再写出
+    juce::AudioBuffer<float> cueScratchBuffer;
+    
+    // 校准信号发生器路由（仅消息线程，StateManager据此生成通道索引表）
+    juce::StringArray generatorRouting{ "ALL" };
+    
+    // 本地覆盖层（仅消息线程，按OSCAddressTable语义通道ID；StateManager映射到物理通道）
+    uint32_t localMuteMask = 0;
+    std::array<float, OSCAddressTable::NUM_CHANNEL_IDS> localTrimDb{};
+    
     // 角色管理方法
     void registerToGlobalState();
     void unregisterFromGlobalState();
     void handleRoleTransition(PluginRole newRole);
+    void timerCallback() override;
+    void followMasterState();
     void updateUIFromRole();
+    void updateLoudnessChannelWeights();
+    void updateAnalyserChannels();
     
     // OSC系统角色管理
     void initializeOSCForRole();
@@ -214,6 +358,8 @@ private:
     void updateAllStates();
     void validateStateConsistency();
 
+    // 延迟回调（callAsync/callAfterDelay）经弱引用访问本对象：实例在回调执行前销毁时回调直接跳过
+    JUCE_DECLARE_WEAK_REFERENCEABLE (MonitorControllerMaxAudioProcessor)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MonitorControllerMaxAudioProcessor)
 };
 
@@ -0,0 +1,185 @@
+﻿/*
+  ==============================================================================
+
+    PropagationStats.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    Master -> Slave 传播跟踪 - 发布序号、发布时间戳与"发布 -> Slave音频输出"延迟直方图
+
+    - Master每次发布状态都分配单调递增的序号并记录发布时间（高精度ticks）
+    - Slave应用时把序号与发布时间写入RenderState，音频线程首次用到该快照时记录延迟
+    - 直方图按对数分桶，记录端只有原子加法，可在音频线程调用
+    - 报告（PropagationReport）由GlobalPluginState按组汇总，供UI、OSC与健康报告使用
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+/**
+ * Master的一次发布：状态字（MasterStateSnapshot打包字）+ 序号 + 发布时间
+ */
+struct MasterPublication
+{
+    uint64_t sequence = 0;              // 组内单调递增，0 = 尚未发布
+    juce::int64 publishedTicks = 0;     // juce::Time::getHighResolutionTicks()
+    uint64_t stateWord = 0;
+};
+
+//==============================================================================
+/**
+ * 传播延迟直方图（微秒）
+ *
+ * 桶i的上界为 FIRST_BUCKET_US * 2^i，最后一个桶收纳更大的值；
+ * 百分位按桶上界返回（最大误差一个桶宽），均值与最大值精确。
+ */
+class PropagationHistogram
+{
+public:
+    //==============================================================================
+    static constexpr int NUM_BUCKETS = 16;
+    static constexpr double FIRST_BUCKET_US = 50.0;     // 50us .. 1.6s
+
+    static double getBucketUpperBoundUs(int bucket) noexcept
+    {
+        return FIRST_BUCKET_US * static_cast<double>(uint64_t(1) << bucket);
+    }
+
+    // 汇总结果（普通值，可拷贝、可合并）
+    struct Counts
+    {
+        std::array<uint64_t, NUM_BUCKETS> buckets{};
+        uint64_t samples = 0;
+        double totalUs = 0.0;
+        double maxUs = 0.0;
+
+        void merge(const Counts& other) noexcept
+        {
+            for (int i = 0; i < NUM_BUCKETS; ++i)
+                buckets[static_cast<size_t>(i)] += other.buckets[static_cast<size_t>(i)];
+
+            samples += other.samples;
+            totalUs += other.totalUs;
+            maxUs = juce::jmax(maxUs, other.maxUs);
+        }
+
+        double getMeanUs() const noexcept { return samples > 0 ? totalUs / static_cast<double>(samples) : 0.0; }
+
+        double getPercentileUs(double percentile) const noexcept
+        {
+            if (samples == 0)
+                return 0.0;
+
+            const auto target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(samples)));
+            uint64_t seen = 0;
+
+            for (int i = 0; i < NUM_BUCKETS; ++i)
+            {
+                seen += buckets[static_cast<size_t>(i)];
+                if (seen >= target)
+                    return juce::jmin(getBucketUpperBoundUs(i), maxUs);
+            }
+
+            return maxUs;
+        }
+    };
+
+    //==============================================================================
+    PropagationHistogram() noexcept { reset(); }
+
+    // 任意线程（含音频线程）：无锁、无分配
+    void record(double latencyUs) noexcept
+    {
+        int bucket = 0;
+        while (bucket < NUM_BUCKETS - 1 && latencyUs > getBucketUpperBoundUs(bucket))
+            ++bucket;
+
+        buckets[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+
+        const auto us = static_cast<juce::int64>(latencyUs);
+        totalUs.fetch_add(us, std::memory_order_relaxed);
+
+        auto currentMax = maxUs.load(std::memory_order_relaxed);
+        while (us > currentMax && !maxUs.compare_exchange_weak(currentMax, us, std::memory_order_relaxed)) {}
+    }
+
+    Counts getCounts() const noexcept
+    {
+        Counts counts;
+        for (int i = 0; i < NUM_BUCKETS; ++i)
+            counts.buckets[static_cast<size_t>(i)] = buckets[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+
+        counts.samples = samples.load(std::memory_order_relaxed);
+        counts.totalUs = static_cast<double>(totalUs.load(std::memory_order_relaxed));
+        counts.maxUs = static_cast<double>(maxUs.load(std::memory_order_relaxed));
+        return counts;
+    }
+
+    void reset() noexcept
+    {
+        for (auto& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        samples.store(0, std::memory_order_relaxed);
+        totalUs.store(0, std::memory_order_relaxed);
+        maxUs.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets;
+    std::atomic<uint64_t> samples;
+    std::atomic<juce::int64> totalUs;
+    std::atomic<juce::int64> maxUs;
+
+    JUCE_DECLARE_NON_COPYABLE(PropagationHistogram)
+};
+
+//==============================================================================
+/**
+ * 一个Master组的传播报告（GlobalPluginState::getPropagationReport生成）
+ */
+struct PropagationReport
+{
+    struct Slave
+    {
+        juce::String id;                    // 插件句柄ID
+        uint64_t appliedSequence = 0;       // 消息线程已应用的序号
+        uint64_t audibleSequence = 0;       // 音频线程已输出的序号
+        uint64_t lag = 0;                   // 组序号 - 已输出序号（落后的发布次数）
+        double lastLatencyUs = 0.0;         // 最近一次 发布 -> 音频输出
+    };
+
+    juce::String groupName;
+    uint64_t sequence = 0;                  // 组最新发布序号
+    std::vector<Slave> slaves;
+    uint64_t maxLag = 0;
+    PropagationHistogram::Counts latency;   // 组内所有Slave合并
+
+    juce::String toString() const
+    {
+        juce::String text;
+        text << "Seq " << juce::String(static_cast<juce::int64>(sequence))
+             << " | Slaves " << juce::String(static_cast<int>(slaves.size()))
+             << " | Max lag " << juce::String(static_cast<juce::int64>(maxLag));
+
+        if (latency.samples > 0)
+        {
+            text << " | Latency p50 " << juce::String(latency.getPercentileUs(50.0) / 1000.0, 2)
+                 << " ms, p99 " << juce::String(latency.getPercentileUs(99.0) / 1000.0, 2)
+                 << " ms, max " << juce::String(latency.maxUs / 1000.0, 2)
+                 << " ms (" << juce::String(static_cast<juce::int64>(latency.samples)) << ")";
+        }
+
+        return text;
+    }
+};
@@ -38,8 +38,36 @@ struct alignas(64) RenderState  // 🚀 64字节缓存行对齐
     uint8_t monoChannelCount;                             // 参与Mono的通道数量
     uint8_t monoChannelIndices[MAX_CHANNELS];             // 参与Mono的通道索引表
     
+    //=== 输入源选择（0=主输入，1=Stem，2=Reference；对应输入总线索引）===
+    uint8_t activeInputSource;                            // 当前应送到扬声器的输入源
+    
+    //=== AFL/PFL Cue总线稀疏混音核（只包含Solo通道，开销与Solo通道数成正比）===
+    bool cueActive;                                       // Cue总线是否有输出（AFL/PFL且有Solo）
+    uint8_t cueChannelCount;                              // 送入Cue的通道数量
+    uint8_t cueChannelIndices[MAX_CHANNELS];              // 送入Cue的通道索引表
+    alignas(16) float cueGainL[MAX_CHANNELS];             // 预计算的左声道系数（声像 × AFL通道增益）
+    alignas(16) float cueGainR[MAX_CHANNELS];             // 预计算的右声道系数
+    
+    //=== 校准信号发生器路由（由SignalGenerator与节目交叉淡化，系数含GAIN_n与Solo/Mute，不含响度Trim）===
+    uint8_t generatorChannelCount;                        // 路由到发生器的通道数量
+    uint8_t generatorChannelIndices[MAX_CHANNELS];        // 路由到发生器的通道索引表
+    alignas(16) float generatorGain[MAX_CHANNELS];        // 按索引表条目的通道系数（静音通道为0）
+    
+    //=== 响度匹配比较数据（已折算进channelFinalGain，音频线程仅用于分析标记）===
+    uint32_t comparisonKey;                               // 当前比较状态标识（Mute/Mono组合哈希）
+    float loudnessTrimDb;                                 // 当前状态的响度补偿Trim
+    
+    //=== Master传播跟踪（Slave：本快照包含的Master发布序号与发布时间，0 = 非Master状态）===
+    uint64_t masterSequence;                              // 音频线程首次用到新序号时记录传播延迟
+    juce::int64 masterPublishedTicks;                     // juce::Time::getHighResolutionTicks()
+    
+    //=== 角色与角色切换淡化（新角色的完整状态随同一快照发布，音频线程不读processor的角色成员）===
+    uint8_t role;                                         // PluginRole，Master总线处理按快照中的角色
+    uint32_t roleTransitionSerial;                        // 每次角色切换+1，音频线程见到新值时开始淡化
+    alignas(16) float roleTransitionFromGain[MAX_CHANNELS]; // 切换前正在输出的快照的有效通道增益
+    
     //=== 🚀 版本控制区域（独立缓存行，避免写竞争）===
-    alignas(64) mutable std::atomic<uint64_t> version{0}; // ABA问题防护
+    alignas(64) mutable std::atomic<uint64_t> version{0}; // ABA问题防护；奇数 = 消息线程正在写入（seqlock）
     
     //=== 构造函数：初始化为安全默认值 ===
     RenderState() noexcept
@@ -51,34 +79,108 @@ struct alignas(64) RenderState  // 🚀 64字节缓存行对齐
             channelIsActive[i] = false;
             channelIsSUB[i] = false;
             monoChannelIndices[i] = 0;
+            cueChannelIndices[i] = 0;
+            cueGainL[i] = 0.0f;
+            cueGainR[i] = 0.0f;
+            generatorChannelIndices[i] = 0;
+            generatorGain[i] = 0.0f;
+            roleTransitionFromGain[i] = 1.0f;
         }
         
         // 初始化Master总线为默认状态
         monoActive = false;
         monoChannelCount = 0;
+        activeInputSource = 0;
+        cueActive = false;
+        cueChannelCount = 0;
+        generatorChannelCount = 0;
+        comparisonKey = 0;
+        loudnessTrimDb = 0.0f;
+        masterSequence = 0;
+        masterPublishedTicks = 0;
+        role = 0;
+        roleTransitionSerial = 0;
+    }
+    
+    // 通道的有效增益：静音为0，非激活通道原地直通为1（角色切换淡化的起点）
+    float getEffectiveGain(int ch) const noexcept
+    {
+        if (!channelIsActive[ch]) return 1.0f;
+        return channelShouldMute[ch] ? 0.0f : channelFinalGain[ch];
     }
     
     //=== 音频处理方法（高度优化，内联，符合JUCE规范）===
-    void applyToBuffer(juce::AudioBuffer<float>& buffer, int numSamples) const noexcept
+    
+    // Cue总线混音：必须在renderFromSource之前调用（PFL取推子前信号，AFL系数已含通道增益）
+    // source为主总线输入，cue为Cue输出总线（立体声）
+    void applyCueToBuffer(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& cue,
+                          int numSamples) const noexcept
     {
-        const int numChannels = juce::jmin(buffer.getNumChannels(), MAX_CHANNELS);
+        cue.clear(0, numSamples);
+        
+        if (!cueActive || cue.getNumChannels() < 2) return;
+        
+        const int numSourceChannels = source.getNumChannels();
+        
+        // 稀疏遍历：只处理Solo通道
+        for (int i = 0; i < cueChannelCount; ++i) {
+            const int ch = cueChannelIndices[i];
+            if (ch >= numSourceChannels) continue;
+            
+            const float* src = source.getReadPointer(ch);
+            if (cueGainL[i] != 0.0f) cue.addFrom(0, 0, src, numSamples, cueGainL[i]);
+            if (cueGainR[i] != 0.0f) cue.addFrom(1, 0, src, numSamples, cueGainR[i]);
+        }
+    }
+    
+    // 从指定输入源渲染到主输出：音频线程唯一的通道渲染入口（Solo/Mute/个人增益）
+    // - 源就是主输出缓冲区（主输入）时原地处理，零拷贝
+    // - 侧链源：增益与拷贝在一次遍历中完成，不额外复制缓冲区
+    // - rampStart/rampEnd用于切换输入源时的交叉淡化；addToOutput用于叠加第二个源
+    // - transitionStart/transitionEnd为角色切换淡化进度（0 = roleTransitionFromGain，1 = 本快照增益）
+    void renderFromSource(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& out,
+                          int numSamples, float rampStart, float rampEnd, bool addToOutput,
+                          float transitionStart = 1.0f, float transitionEnd = 1.0f) const noexcept
+    {
+        const int numChannels = juce::jmin(out.getNumChannels(), MAX_CHANNELS);
+        const int numSourceChannels = source.getNumChannels();
+        const bool inPlace = numSourceChannels > 0 && numChannels > 0
+                             && source.getReadPointer(0) == out.getReadPointer(0);
+        const bool inTransition = transitionStart < 1.0f;
         
-        // 通道处理（编译器自动向量化友好的循环）- 只处理Solo/Mute/个人增益
         for (int ch = 0; ch < numChannels; ++ch) {
-            // 跳过非激活通道
-            if (!channelIsActive[ch]) continue;
+            // 非激活通道：主输入原地直通，侧链源时不输出
+            if (!channelIsActive[ch]) {
+                if (!inPlace && !addToOutput) out.clear(ch, 0, numSamples);
+                continue;
+            }
             
-            if (channelShouldMute[ch]) {
-                // 静音通道：直接清零
-                buffer.clear(ch, 0, numSamples);
+            // 角色切换淡化期间静音通道也要渲染：从旧增益淡到0
+            const float gain = channelShouldMute[ch] ? 0.0f : channelFinalGain[ch];
+            float gainStart = gain, gainEnd = gain;
+            if (inTransition) {
+                const float from = roleTransitionFromGain[ch];
+                gainStart = from + (gain - from) * transitionStart;
+                gainEnd = from + (gain - from) * transitionEnd;
+            }
+            
+            if ((gainStart == 0.0f && gainEnd == 0.0f) || ch >= numSourceChannels) {
+                if (!addToOutput) out.clear(ch, 0, numSamples);
+                continue;
+            }
+            
+            gainStart *= rampStart;
+            gainEnd *= rampEnd;
+            
+            if (inPlace) {
+                if (gainStart != gainEnd)
+                    out.applyGainRamp(ch, 0, numSamples, gainStart, gainEnd);
+                else if (std::abs(gainStart - 1.0f) > 0.001f)
+                    out.applyGain(ch, 0, numSamples, gainStart);
+            } else if (addToOutput) {
+                out.addFromWithRamp(ch, 0, source.getReadPointer(ch), numSamples, gainStart, gainEnd);
             } else {
-                // 仅应用个人通道增益（Master总线效果由MasterBusProcessor处理）
-                const float channelGain = channelFinalGain[ch];
-                
-                // 只有在增益不为1.0时才应用（避免不必要的计算）
-                if (std::abs(channelGain - 1.0f) > 0.001f) {
-                    buffer.applyGain(ch, 0, numSamples, channelGain);
-                }
+                out.copyFromWithRamp(ch, 0, source.getReadPointer(ch), numSamples, gainStart, gainEnd);
             }
         }
     }
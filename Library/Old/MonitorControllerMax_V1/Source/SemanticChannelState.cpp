@@ -69,6 +69,48 @@ void SemanticChannelState::setMuteState(const juce::String& channelName, bool st
     notifyStateChange(channelName, "mute", state);
 }
 
+void SemanticChannelState::applyStateTransaction(const std::vector<ChannelStateChange>& changes)
+{
+    if (changes.empty())
+        return;
+    
+    SEMANTIC_DBG_ROLE("SemanticChannelState: Apply state transaction - " + juce::String(static_cast<int>(changes.size())) + " changes");
+    
+    // 写锁保护：整个事务对音频线程原子可见
+    juce::ScopedWriteLock lock(stateLock);
+    
+    bool previousGlobalMode = globalSoloModeActive;
+    
+    notifyTransactionBegin();
+    
+    for (const auto& change : changes)
+    {
+        if (change.isSolo)
+        {
+            soloStates[change.channelName] = change.state;
+            notifyStateChange(change.channelName, "solo", change.state);
+        }
+        else
+        {
+            muteStates[change.channelName] = change.state;
+            notifyStateChange(change.channelName, "mute", change.state);
+        }
+    }
+    
+    // Solo联动只在事务末尾计算一次
+    updateGlobalSoloMode();
+    calculateSoloModeLinkage();
+    
+    // 全局模式变化也在事务内通知，与通道变化合并为一次RenderState重建
+    if (previousGlobalMode != globalSoloModeActive)
+    {
+        SEMANTIC_DBG_ROLE("SemanticChannelState: Global Solo mode changed - " + juce::String(globalSoloModeActive ? "ACTIVE" : "OFF"));
+        notifyGlobalModeChange();
+    }
+    
+    notifyTransactionEnd();
+}
+
 bool SemanticChannelState::getSoloState(const juce::String& channelName) const
 {
     // 读锁保护：音频线程安全读取，避免UI线程修改时的迭代器失效
@@ -93,7 +135,8 @@ bool SemanticChannelState::getFinalMuteState(const juce::String& channelName) co
     juce::ScopedReadLock lock(stateLock);
     
     // SUB channel logic based on original JSFX script
-    if (globalSoloModeActive)
+    // AFL/PFL模式下Solo只送Cue总线，主输出保持用户Mute
+    if (globalSoloModeActive && soloMode == SoloMode::InPlace)
     {
         bool isChannelSUB = isSUBChannel(channelName);
         
@@ -178,6 +221,7 @@ void SemanticChannelState::calculateSoloModeLinkage()
 {
     // Preserve existing complex solo logic
     // When solo mode is active, non-solo channels should be auto-muted
+    // (SoloMode::InPlace only - AFL/PFL route solos to the cue bus instead)
     
     // This function now only does logic calculation, no callbacks sent
     // Actual state notification handled by global mode change
@@ -195,6 +239,38 @@ void SemanticChannelState::calculateSoloModeLinkage()
     }
 }
 
+void SemanticChannelState::setSoloMode(SoloMode newMode)
+{
+    // 写锁保护：与getFinalMuteState读取的模式保持一致
+    juce::ScopedWriteLock lock(stateLock);
+    
+    if (soloMode == newMode)
+        return;
+    
+    soloMode = newMode;
+    SEMANTIC_DBG_ROLE("SemanticChannelState: Solo mode changed to " + getSoloModeName(newMode));
+    
+    // 模式切换会改变所有通道的最终Mute状态，复用全局模式广播
+    notifyGlobalModeChange();
+}
+
+SoloMode SemanticChannelState::getSoloMode() const
+{
+    juce::ScopedReadLock lock(stateLock);
+    return soloMode;
+}
+
+juce::String SemanticChannelState::getSoloModeName(SoloMode mode)
+{
+    switch (mode)
+    {
+        case SoloMode::AFL: return "AFL";
+        case SoloMode::PFL: return "PFL";
+        case SoloMode::InPlace:
+        default:            return "SIP";
+    }
+}
+
 bool SemanticChannelState::hasAnySoloActive() const
 {
     // 读锁保护：防止遍历时map被修改
@@ -406,6 +482,7 @@ void SemanticChannelState::logCurrentState() const
     // 使用DETAIL级别 - 重复内容会被智能过滤
     VST3_DBG_DETAIL("SemanticChannelState: === Current state overview ===");
     VST3_DBG_DETAIL("  Global Solo mode: " + juce::String(globalSoloModeActive ? "ACTIVE" : "OFF"));
+    VST3_DBG_DETAIL("  Solo listen mode: " + getSoloModeName(soloMode));
     
     VST3_DBG_DETAIL("  Solo states:");
     for (const auto& [channelName, soloState] : soloStates)
@@ -425,7 +502,7 @@ void SemanticChannelState::logCurrentState() const
         // 注意：getFinalMuteState会尝试获取锁，但我们已经持有读锁
         // 这里需要避免递归锁调用，直接计算finalMute
         bool finalMute = false;
-        if (globalSoloModeActive)
+        if (globalSoloModeActive && soloMode == SoloMode::InPlace)
         {
             bool isChannelSUB = isSUBChannel(channelName);
             auto soloIt = soloStates.find(channelName);
@@ -491,6 +568,16 @@ void SemanticChannelState::notifyStateChange(const juce::String& channelName, co
     }
 }
 
+void SemanticChannelState::notifyTransactionBegin()
+{
+    stateChangeListeners.call([](StateChangeListener& l) { l.onStateTransactionBegin(); });
+}
+
+void SemanticChannelState::notifyTransactionEnd()
+{
+    stateChangeListeners.call([](StateChangeListener& l) { l.onStateTransactionEnd(); });
+}
+
 void SemanticChannelState::notifyGlobalModeChange()
 {
     // 注意：此方法假设调用者已经持有写锁（通常从setSoloState调用）
@@ -511,7 +598,7 @@ void SemanticChannelState::notifyGlobalModeChange()
         bool finalMuteState = false;
         
         // 直接实现final mute逻辑，避免递归锁
-        if (globalSoloModeActive)
+        if (globalSoloModeActive && soloMode == SoloMode::InPlace)
         {
             bool isChannelSUB = isSUBChannel(channelName);
             auto soloIt = soloStates.find(channelName);
@@ -8,6 +8,13 @@
 // Forward declaration
 class MonitorControllerMaxAudioProcessor;
 
+// Solo监听模式
+enum class SoloMode {
+    InPlace = 0,   // SIP：Solo时主输出自动静音其他通道（默认）
+    AFL = 1,       // 推子后监听：主输出不受Solo影响，Solo通道（含通道增益）送入Cue总线
+    PFL = 2        // 推子前监听：同AFL，但取通道增益之前的信号
+};
+
 class SemanticChannelState
 {
 public:
@@ -18,6 +25,18 @@ public:
         virtual void onSoloStateChanged(const juce::String& channelName, bool state) = 0;
         virtual void onMuteStateChanged(const juce::String& channelName, bool state) = 0;
         virtual void onGlobalModeChanged() = 0;
+        
+        // 批量事务：begin/end之间的单通道回调可只做标记，end时统一重建
+        virtual void onStateTransactionBegin() {}
+        virtual void onStateTransactionEnd() {}
+    };
+    
+    // 批量事务中的一项通道变化
+    struct ChannelStateChange
+    {
+        juce::String channelName;
+        bool isSolo = true;   // true: Solo, false: Mute
+        bool state = false;
     };
 
     SemanticChannelState();
@@ -32,6 +51,9 @@ public:
     bool getSoloState(const juce::String& channelName) const;
     bool getMuteState(const juce::String& channelName) const;
     bool getFinalMuteState(const juce::String& channelName) const;
+    
+    // 🚀 批量事务：一次写锁内应用所有变化，全局Solo模式只重算一次，监听器只重建一次
+    void applyStateTransaction(const std::vector<ChannelStateChange>& changes);
 
     // Solo mode linkage logic (preserve existing complex logic)
     void calculateSoloModeLinkage();
@@ -39,6 +61,11 @@ public:
     bool hasAnyMuteActive() const;
     bool isGlobalSoloModeActive() const { return globalSoloModeActive; }
     
+    // Solo监听模式（SIP/AFL/PFL）- AFL/PFL时Solo只作用于Cue总线
+    void setSoloMode(SoloMode newMode);
+    SoloMode getSoloMode() const;
+    static juce::String getSoloModeName(SoloMode mode);
+    
     // SUB channel logic (based on original JSFX script)
     bool isSUBChannel(const juce::String& channelName) const;
     bool hasAnyNonSUBSoloActive() const;
@@ -76,6 +103,7 @@ private:
     
     bool globalSoloModeActive = false;
     bool previousGlobalSoloMode = false;
+    SoloMode soloMode = SoloMode::InPlace;
     
     juce::ListenerList<StateChangeListener> stateChangeListeners;
     
@@ -85,6 +113,8 @@ private:
     // Internal helper methods
     void notifyStateChange(const juce::String& channelName, const juce::String& action, bool state);
     void notifyGlobalModeChange();
+    void notifyTransactionBegin();
+    void notifyTransactionEnd();
     void updateGlobalSoloMode();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SemanticChannelState)
@@ -0,0 +1,362 @@
+﻿/*
+  ==============================================================================
+
+    SharedOSCHub.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    共享OSC中心实现 - 引用计数生命周期、按组前缀分发入站消息、出站扇出
+
+  ==============================================================================
+*/
+
+#include "SharedOSCHub.h"
+#include "DebugLogger.h"
+#include <algorithm>
+#include <cstring>
+
+std::weak_ptr<SharedOSCHub> SharedOSCHub::instance;
+std::mutex SharedOSCHub::instanceMutex;
+
+namespace
+{
+    constexpr char defaultNamespace[] = "/Monitor/";
+    constexpr size_t defaultNamespaceLength = sizeof(defaultNamespace) - 1;
+}
+
+//==============================================================================
+std::shared_ptr<SharedOSCHub> SharedOSCHub::acquire()
+{
+    std::lock_guard<std::mutex> lock(instanceMutex);
+
+    // 🚀 已有实例则共享：整个进程只有一个接收套接字和一组发送目标
+    if (auto existing = instance.lock())
+        return existing;
+
+    std::shared_ptr<SharedOSCHub> hub(new SharedOSCHub());
+    instance = hub;
+    return hub;
+}
+
+SharedOSCHub::SharedOSCHub()
+{
+    VST3_DBG("SharedOSCHub: Create process-wide OSC hub");
+
+    networkConfig = OSCNetworkConfig::load();
+    startTargets();
+    startReceiver();
+}
+
+SharedOSCHub::~SharedOSCHub()
+{
+    // 最后一个实例释放：先停接收再停目标
+    stopReceiver();
+    stopTargets();
+
+    VST3_DBG("SharedOSCHub: OSC hub destroyed");
+}
+
+//==============================================================================
+// 端点注册
+//==============================================================================
+
+void SharedOSCHub::registerEndpoint(Endpoint* endpoint, const juce::String& groupName)
+{
+    jassert(endpoint != nullptr);
+
+    const juce::String group = normaliseGroupName(groupName);
+
+    Registration registration;
+    registration.endpoint = endpoint;
+    registration.groupLength = juce::jmin(group.getNumBytesAsUTF8(), MAX_GROUP_NAME_BYTES);
+    std::memcpy(registration.group, group.toRawUTF8(), registration.groupLength);
+
+    std::lock_guard<std::mutex> lock(endpointsMutex);
+
+    // 重复注册视为修改组名
+    for (auto& existing : endpoints)
+    {
+        if (existing.endpoint == endpoint)
+        {
+            existing = registration;
+            return;
+        }
+    }
+
+    endpoints.push_back(registration);
+}
+
+void SharedOSCHub::unregisterEndpoint(Endpoint* endpoint)
+{
+    // 接收线程分发时持有同一把锁，返回后不会再有进行中的回调
+    std::lock_guard<std::mutex> lock(endpointsMutex);
+
+    endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(),
+                                   [endpoint](const Registration& r) { return r.endpoint == endpoint; }),
+                    endpoints.end());
+}
+
+int SharedOSCHub::getNumEndpoints() const
+{
+    std::lock_guard<std::mutex> lock(endpointsMutex);
+    return static_cast<int>(endpoints.size());
+}
+
+juce::String SharedOSCHub::normaliseGroupName(const juce::String& groupName)
+{
+    // 只保留OSC地址中合法且无通配含义的字符
+    juce::String group = groupName.trim()
+                                  .replaceCharacter(' ', '_')
+                                  .removeCharacters("#*,/?[]{}!");
+
+    // "Monitor"会与默认命名空间冲突，视为默认组
+    if (group == "Monitor")
+        return {};
+
+    while (group.getNumBytesAsUTF8() > MAX_GROUP_NAME_BYTES)
+        group = group.dropLastCharacters(1);
+
+    return group;
+}
+
+//==============================================================================
+// 入站：按组前缀分发
+//==============================================================================
+
+void SharedOSCHub::oscMessageReceived(const juce::OSCMessage& message)
+{
+    // 🚀 唯一的OSC接收线程：只做字节比较，不分配、不写日志
+    const juce::String addressString = message.getAddressPattern().toString();
+    const char* address = addressString.toRawUTF8();
+    const size_t length = addressString.getNumBytesAsUTF8();
+
+    const char* group = nullptr;
+    size_t groupLength = 0;
+    const char* remainder = address;
+    size_t remainderLength = length;
+
+    // /<组名>/Monitor/... -> 组名 + /Monitor/...；/Monitor/... 属于默认组
+    if (length < defaultNamespaceLength || std::memcmp(address, defaultNamespace, defaultNamespaceLength) != 0)
+    {
+        const void* slash = length > 1 ? std::memchr(address + 1, '/', length - 1) : nullptr;
+        if (slash == nullptr || address[0] != '/')
+        {
+            unroutedMessages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        group = address + 1;
+        remainder = static_cast<const char*>(slash);
+        groupLength = static_cast<size_t>(remainder - group);
+        remainderLength = length - static_cast<size_t>(remainder - address);
+    }
+
+    bool delivered = false;
+
+    {
+        std::lock_guard<std::mutex> lock(endpointsMutex);
+
+        for (const auto& registration : endpoints)
+        {
+            if (registration.groupLength == groupLength
+                && (groupLength == 0 || std::memcmp(registration.group, group, groupLength) == 0))
+            {
+                registration.endpoint->handleHubMessage(message, remainder, remainderLength);
+                delivered = true;
+            }
+        }
+    }
+
+    if (!delivered)
+        unroutedMessages.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+// 出站：所有实例共用同一组目标
+//==============================================================================
+
+void SharedOSCHub::send(const std::vector<juce::OSCMessage>& messages, const juce::String& groupName)
+{
+    if (messages.empty())
+        return;
+
+    // 默认组原样入队；其他组加上 /<组名> 前缀
+    std::vector<juce::OSCMessage> prefixed;
+    if (groupName.isNotEmpty())
+    {
+        prefixed.reserve(messages.size());
+        for (const auto& message : messages)
+            prefixed.push_back(withGroupPrefix(message, groupName));
+    }
+
+    const auto& batch = groupName.isEmpty() ? messages : prefixed;
+
+    // 🚀 只做内存入队：各实例的消息在目标发送线程中合并打包为共享Bundle
+    std::lock_guard<std::mutex> lock(targetsMutex);
+
+    for (auto& target : targets)
+    {
+        target->enqueue(batch);
+    }
+}
+
+juce::OSCMessage SharedOSCHub::withGroupPrefix(const juce::OSCMessage& message, const juce::String& groupName)
+{
+    juce::OSCMessage result(juce::OSCAddressPattern("/" + groupName + message.getAddressPattern().toString()));
+
+    for (const auto& argument : message)
+        result.addArgument(argument);
+
+    return result;
+}
+
+juce::int64 SharedOSCHub::getStreamConnectionCount() const
+{
+    std::lock_guard<std::mutex> lock(targetsMutex);
+
+    juce::int64 count = 0;
+    for (const auto& target : targets)
+        count += target->getStats().streamConnections;
+
+    return count;
+}
+
+//==============================================================================
+// 网络配置
+//==============================================================================
+
+OSCNetworkConfig SharedOSCHub::getNetworkConfig() const
+{
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    return networkConfig;
+}
+
+bool SharedOSCHub::setNetworkConfig(const OSCNetworkConfig& newConfig, bool saveToUserFile)
+{
+    VST3_DBG("SharedOSCHub: Apply OSC network config - " + juce::String(newConfig.targets.size()) +
+             " targets, receive port " + juce::String(newConfig.receivePort));
+
+    const bool receivePortChanged = newConfig.receivePort != getNetworkConfig().receivePort;
+
+    // 运行时修改：先停旧目标再按新配置启动，接收端口变化时才重建接收器
+    stopTargets();
+
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex);
+        networkConfig = newConfig;
+    }
+
+    bool success = startTargets();
+
+    if (receivePortChanged)
+    {
+        stopReceiver();
+        success = startReceiver() && success;
+    }
+    else
+    {
+        success = isReceiving() && success;
+    }
+
+    if (saveToUserFile)
+    {
+        newConfig.save();
+    }
+
+    return success;
+}
+
+//==============================================================================
+// 发送目标与接收器管理
+//==============================================================================
+
+bool SharedOSCHub::startTargets()
+{
+    std::vector<std::unique_ptr<OSCTarget>> newTargets;
+    const OSCNetworkConfig config = getNetworkConfig();
+
+    for (const auto& targetConfig : config.targets)
+    {
+        if (!targetConfig.enabled)
+        {
+            VST3_DBG("SharedOSCHub: OSC target disabled - " + targetConfig.getDescription());
+            continue;
+        }
+
+        auto target = std::make_unique<OSCTarget>(targetConfig);
+        if (target->start())
+        {
+            VST3_DBG("SharedOSCHub: OSC target connected - " + targetConfig.getDescription());
+            newTargets.push_back(std::move(target));
+        }
+        else
+        {
+            VST3_DBG("SharedOSCHub: Failed to connect OSC target - " + targetConfig.getDescription());
+        }
+    }
+
+    const bool anyConnected = !newTargets.empty();
+
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex);
+        targets = std::move(newTargets);
+    }
+
+    senderConnected.store(anyConnected);
+    return anyConnected;
+}
+
+void SharedOSCHub::stopTargets()
+{
+    std::vector<std::unique_ptr<OSCTarget>> oldTargets;
+
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex);
+        oldTargets.swap(targets);
+    }
+
+    senderConnected.store(false);
+
+    // 在锁外停止发送线程，避免阻塞其他线程的入队
+    for (auto& target : oldTargets)
+    {
+        const auto stats = target->getStats();
+        VST3_DBG("SharedOSCHub: OSC target stopped - " + target->getConfig().getDescription() +
+                 " sent " + juce::String(stats.sentMessages) + " msgs / " + juce::String(stats.sentDatagrams) + " datagrams, " +
+                 "failed " + juce::String(stats.failedDatagrams) + ", coalesced " + juce::String(stats.coalescedMessages) +
+                 ", dropped " + juce::String(stats.droppedMessages));
+        target->stop();
+    }
+}
+
+bool SharedOSCHub::startReceiver()
+{
+    const int receivePort = getNetworkConfig().receivePort;
+
+    if (receiver.connect(receivePort))
+    {
+        receiver.addListener(this);
+        receiverConnected.store(true);
+        VST3_DBG("SharedOSCHub: OSC Receiver listening on port " + juce::String(receivePort));
+        return true;
+    }
+
+    receiverConnected.store(false);
+    VST3_DBG("SharedOSCHub: Failed to start OSC Receiver on port " + juce::String(receivePort));
+    return false;
+}
+
+void SharedOSCHub::stopReceiver()
+{
+    if (receiverConnected.exchange(false))
+    {
+        receiver.removeListener(this);
+        receiver.disconnect();
+    }
+
+    const auto unrouted = unroutedMessages.exchange(0, std::memory_order_relaxed);
+    if (unrouted > 0)
+    {
+        VST3_DBG("SharedOSCHub: Ignored " + juce::String(unrouted) + " OSC messages without a matching instance group");
+    }
+}
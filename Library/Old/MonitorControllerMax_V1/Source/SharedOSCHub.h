@@ -0,0 +1,120 @@
+﻿/*
+  ==============================================================================
+
+    SharedOSCHub.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    进程级共享OSC中心 - 所有插件实例共用一个接收端口、一个接收线程和一组发送目标
+
+    - 与GlobalPluginState相同的引用计数单例：第一个实例acquire()时创建，最后一个释放时销毁
+    - 入站按组前缀分发：/Monitor/... 属于默认组，/<组名>/Monitor/... 属于对应组
+    - 出站：各实例的消息进入同一组OSCTarget，由目标发送线程合并打包为共享Bundle
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "OSCTarget.h"
+
+//==============================================================================
+/**
+ * 共享OSC中心
+ *
+ * 线程模型：
+ * - acquire()/registerEndpoint()/unregisterEndpoint()/setNetworkConfig() 在消息线程调用
+ * - send() 任意线程调用：只做内存入队
+ * - Endpoint::handleHubMessage() 在唯一的OSC接收线程调用
+ */
+class SharedOSCHub : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+{
+public:
+    //==============================================================================
+    /**
+     * 接收端点 - 每个插件实例一个
+     */
+    class Endpoint
+    {
+    public:
+        virtual ~Endpoint() = default;
+
+        // 接收线程：address指向去掉组前缀后的 /Monitor/... 部分（不以'\0'结尾）
+        // 实现必须无锁、无分配、不写日志
+        virtual void handleHubMessage(const juce::OSCMessage& message, const char* address, size_t length) noexcept = 0;
+    };
+
+    //==============================================================================
+    static std::shared_ptr<SharedOSCHub> acquire();
+    ~SharedOSCHub() override;
+
+    // 注册/注销端点：unregisterEndpoint()返回后该端点不会再收到任何回调
+    void registerEndpoint(Endpoint* endpoint, const juce::String& groupName);
+    void unregisterEndpoint(Endpoint* endpoint);
+    int getNumEndpoints() const;
+
+    // 出站：非默认组的地址自动加上 /<组名> 前缀
+    void send(const std::vector<juce::OSCMessage>& messages, const juce::String& groupName);
+
+    // 网络配置对进程内所有实例生效
+    OSCNetworkConfig getNetworkConfig() const;
+    bool setNetworkConfig(const OSCNetworkConfig& newConfig, bool saveToUserFile);
+
+    bool isSending() const noexcept { return senderConnected.load(std::memory_order_relaxed); }
+    bool isReceiving() const noexcept { return receiverConnected.load(std::memory_order_relaxed); }
+
+    // TCP目标累计建立连接次数：变化说明有对端（重新）连接，需要全量状态同步
+    juce::int64 getStreamConnectionCount() const;
+
+    //==============================================================================
+    // 组名规范化：去掉首尾空白和'/'，空格转为'_'；空字符串表示默认组
+    static juce::String normaliseGroupName(const juce::String& groupName);
+
+    static constexpr size_t MAX_GROUP_NAME_BYTES = 32;
+
+private:
+    //==============================================================================
+    SharedOSCHub();
+
+    void oscMessageReceived(const juce::OSCMessage& message) override;
+
+    bool startTargets();
+    void stopTargets();
+    bool startReceiver();
+    void stopReceiver();
+
+    static juce::OSCMessage withGroupPrefix(const juce::OSCMessage& message, const juce::String& groupName);
+
+    //==============================================================================
+    static std::weak_ptr<SharedOSCHub> instance;
+    static std::mutex instanceMutex;
+
+    // 端点注册表：组名存为定长字节，接收线程比较时不分配
+    struct Registration
+    {
+        Endpoint* endpoint = nullptr;
+        char group[MAX_GROUP_NAME_BYTES] = {};
+        size_t groupLength = 0;
+    };
+
+    std::vector<Registration> endpoints;
+    mutable std::mutex endpointsMutex;
+
+    // 发送目标 + 接收器，targetsMutex同时保护targets和networkConfig
+    std::vector<std::unique_ptr<OSCTarget>> targets;
+    juce::OSCReceiver receiver;
+    OSCNetworkConfig networkConfig;
+    mutable std::mutex targetsMutex;
+
+    std::atomic<bool> senderConnected{ false };
+    std::atomic<bool> receiverConnected{ false };
+    std::atomic<juce::int64> unroutedMessages{ 0 };  // 没有匹配组的入站消息
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedOSCHub)
+};
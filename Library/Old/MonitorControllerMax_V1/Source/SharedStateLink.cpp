@@ -0,0 +1,548 @@
+﻿/*
+  ==============================================================================
+
+    SharedStateLink.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    跨进程Master/Slave链路实现 - 共享段映射、seqlock状态块、事件环、futex唤醒
+
+  ==============================================================================
+*/
+
+#include "SharedStateLink.h"
+#include "DebugLogger.h"
+#include <thread>
+
+#if JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+#if JUCE_LINUX
+ #include <climits>
+ #include <ctime>
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
+namespace
+{
+    // 共享段布局标识："MCM1"，布局变化时递增，不同版本的插件不会互相误读
+    constexpr uint32_t SEGMENT_MAGIC = 0x4D434D31;
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free
+                  && std::atomic<juce::int64>::is_always_lock_free,
+                  "Shared memory atomics must be lock-free (address-free across processes)");
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+
+    uint64_t makeProcessToken()
+    {
+       #if JUCE_WINDOWS
+        const auto processId = static_cast<uint64_t>(GetCurrentProcessId());
+       #else
+        const auto processId = static_cast<uint64_t>(getpid());
+       #endif
+
+        juce::Random random;
+        random.setSeedRandomly();
+
+        // 进程号 + 随机数：同一进程重新打开链路也得到新令牌；最低位置1保证非0
+        return (processId << 32) | (static_cast<uint32_t>(random.nextInt()) | 1u);
+    }
+}
+
+//==============================================================================
+// 共享段布局：全零即为合法的初始状态（无Master、空事件环），创建者无需额外初始化
+struct SharedStateLink::SharedBlock
+{
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> attachedProcesses;
+
+    // Master归属
+    std::atomic<uint64_t> masterToken;          // 0 = 无Master
+    std::atomic<uint32_t> masterHeartbeatMs;    // juce::Time::getMillisecondCounter()，系统范围单调
+
+    // 唤醒：发布时递增，Linux读者在此futex字上睡眠
+    std::atomic<uint32_t> eventCounter;
+    std::atomic<uint32_t> waiters;
+
+    // 状态块（seqlock：奇数 = 写入中）
+    std::atomic<uint32_t> stateSequence;
+    std::atomic<uint64_t> stateWord;
+    std::atomic<juce::int64> stateTicks;
+
+    // 事件环（单写者：持有Master令牌的进程）
+    std::atomic<uint64_t> writeIndex;
+
+    struct Event
+    {
+        std::atomic<uint64_t> sequence;         // 2*index+1 写入中，2*index+2 完成
+        std::atomic<uint64_t> stateWord;
+        std::atomic<juce::int64> publishedTicks;
+    };
+
+    Event ring[RING_SIZE];
+};
+
+static_assert((SharedStateLink::RING_SIZE & (SharedStateLink::RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+//==============================================================================
+SharedStateLink::SharedStateLink(const juce::String& segmentName)
+    : juce::Thread("MCM Shared State Link"),
+      name(segmentName),
+      ownToken(makeProcessToken())
+{
+}
+
+SharedStateLink::~SharedStateLink()
+{
+    close();
+}
+
+bool SharedStateLink::open()
+{
+    if (block != nullptr)
+        return true;
+
+    if (!mapSegment())
+    {
+        VST3_DBG("SharedStateLink: Failed to map shared segment " + name + " - cross-process link disabled");
+        return false;
+    }
+
+    // 全零段由本进程认领；已认领的段必须是同一布局
+    uint32_t expected = 0;
+    if (!block->magic.compare_exchange_strong(expected, SEGMENT_MAGIC) && expected != SEGMENT_MAGIC)
+    {
+        VST3_DBG("SharedStateLink: Incompatible shared segment layout - cross-process link disabled");
+        unmapSegment();
+        return false;
+    }
+
+    block->attachedProcesses.fetch_add(1);
+    hasReadIndex = false;
+
+    // 链路线程启动前先判断一次：调用方打开后立即就能知道是否已有远端Master
+    updateRemoteMaster();
+
+    startThread();
+
+    VST3_DBG("SharedStateLink: Attached to " + name + " (processes: " + juce::String(getAttachedProcessCount()) + ")");
+    return true;
+}
+
+void SharedStateLink::close()
+{
+    if (block == nullptr)
+        return;
+
+    releaseMaster();
+
+    // 唤醒可能睡在futex上的链路线程
+    signalThreadShouldExit();
+    block->eventCounter.fetch_add(1);
+    wakeWaiters();
+    stopThread(1000);
+
+    cancelPendingUpdate();
+
+    block->attachedProcesses.fetch_sub(1);
+    remoteMasterActive.store(false, std::memory_order_release);
+    unmapSegment();
+}
+
+//==============================================================================
+bool SharedStateLink::claimMaster(uint64_t initialStateWord)
+{
+    if (block == nullptr)
+        return true;    // 链路不可用：只按进程内规则
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    uint64_t token = block->masterToken.load(std::memory_order_acquire);
+    if (token != ownToken)
+    {
+        const uint32_t now = juce::Time::getMillisecondCounter();
+        if (token != 0 && now - block->masterHeartbeatMs.load(std::memory_order_acquire) < MASTER_TIMEOUT_MS)
+            return false;
+
+        // 先写心跳再抢令牌：抢到后其他进程不会在心跳写入前误判超时
+        block->masterHeartbeatMs.store(now, std::memory_order_release);
+        if (!block->masterToken.compare_exchange_strong(token, ownToken, std::memory_order_acq_rel))
+            return false;
+    }
+
+    localMaster.store(true, std::memory_order_release);
+
+    // 本进程成为Master：远端Master状态归零，消息线程的已通知状态随之复位
+    if (remoteMasterActive.exchange(false, std::memory_order_acq_rel))
+    {
+        masterChangePending.store(true, std::memory_order_release);
+        triggerAsyncUpdate();
+    }
+
+    // 立即发布完整状态，跟随者从这一刻开始与本进程同步
+    publishLocked(initialStateWord);
+    return true;
+}
+
+void SharedStateLink::releaseMaster()
+{
+    if (block == nullptr)
+    {
+        localMaster.store(false, std::memory_order_release);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    if (!localMaster.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    uint64_t expected = ownToken;
+    block->masterToken.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+
+    // 让跟随者立即发现Master离开，而不是等心跳超时
+    block->eventCounter.fetch_add(1);
+    wakeWaiters();
+}
+
+void SharedStateLink::publishState(uint64_t stateWord)
+{
+    if (block == nullptr || !isLocalMaster())
+        return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (isLocalMaster())
+        publishLocked(stateWord);
+}
+
+void SharedStateLink::publishLocked(uint64_t stateWord) noexcept
+{
+    const juce::int64 ticks = juce::Time::getHighResolutionTicks();
+
+    // 状态块：seqlock写入
+    const uint32_t sequence = block->stateSequence.load(std::memory_order_relaxed);
+    block->stateSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    block->stateWord.store(stateWord, std::memory_order_relaxed);
+    block->stateTicks.store(ticks, std::memory_order_relaxed);
+    block->stateSequence.store(sequence + 2, std::memory_order_release);
+
+    // 事件环：先写槽位，再推进写索引
+    const uint64_t index = block->writeIndex.load(std::memory_order_relaxed);
+    auto& event = block->ring[index & (RING_SIZE - 1)];
+    event.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.stateWord.store(stateWord, std::memory_order_relaxed);
+    event.publishedTicks.store(ticks, std::memory_order_relaxed);
+    event.sequence.store(index * 2 + 2, std::memory_order_release);
+    block->writeIndex.store(index + 1, std::memory_order_release);
+
+    block->eventCounter.fetch_add(1);
+    wakeWaiters();
+
+    publishedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool SharedStateLink::readState(uint64_t& stateWord, juce::int64& publishedTicks) const noexcept
+{
+    if (block == nullptr)
+        return false;
+
+    for (int attempt = 0; attempt < 1000; ++attempt)
+    {
+        const uint32_t sequence = block->stateSequence.load(std::memory_order_acquire);
+        if ((sequence & 1) == 0)
+        {
+            stateWord = block->stateWord.load(std::memory_order_relaxed);
+            publishedTicks = block->stateTicks.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (block->stateSequence.load(std::memory_order_relaxed) == sequence)
+                return true;
+        }
+
+        seqlockRetryCount.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::yield();
+    }
+
+    return false;
+}
+
+int SharedStateLink::getAttachedProcessCount() const noexcept
+{
+    return block != nullptr ? static_cast<int>(block->attachedProcesses.load(std::memory_order_relaxed)) : 0;
+}
+
+SharedStateLink::Stats SharedStateLink::getStats() const noexcept
+{
+    Stats stats;
+    stats.published = publishedCount.load(std::memory_order_relaxed);
+    stats.received = receivedCount.load(std::memory_order_relaxed);
+    stats.resyncs = resyncCount.load(std::memory_order_relaxed);
+    stats.seqlockRetries = seqlockRetryCount.load(std::memory_order_relaxed);
+
+    const double ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / 1.0e6;
+    if (stats.received > 0)
+        stats.meanDeliveryUs = static_cast<double>(deliveryTicksTotal.load(std::memory_order_relaxed))
+                               / ticksPerMicrosecond / static_cast<double>(stats.received);
+    stats.maxDeliveryUs = static_cast<double>(deliveryTicksMax.load(std::memory_order_relaxed)) / ticksPerMicrosecond;
+    return stats;
+}
+
+//==============================================================================
+void SharedStateLink::run()
+{
+    while (!threadShouldExit())
+    {
+        // 先取计数再处理：处理期间到达的事件会让下面的等待立即返回
+        const uint32_t seenCounter = block->eventCounter.load();
+
+        if (isLocalMaster())
+        {
+            writeHeartbeat();
+        }
+        else
+        {
+            updateRemoteMaster();
+            if (isRemoteMasterActive())
+                drainEvents();
+        }
+
+        waitForEvents(seenCounter, HEARTBEAT_INTERVAL_MS);
+    }
+}
+
+void SharedStateLink::handleAsyncUpdate()
+{
+    // 先镜像状态，再通知Master出现：提升等待中的Slave时已能拿到远端状态
+    if (statePending.exchange(false, std::memory_order_acq_rel) && isRemoteMasterActive() && onRemoteState)
+        onRemoteState(latestStateWord.load(std::memory_order_acquire));
+
+    if (masterChangePending.exchange(false, std::memory_order_acq_rel))
+    {
+        const bool active = isRemoteMasterActive();
+        if (active != deliveredMasterActive)
+        {
+            deliveredMasterActive = active;
+            if (onRemoteMasterChanged)
+                onRemoteMasterChanged(active);
+        }
+    }
+}
+
+void SharedStateLink::writeHeartbeat() noexcept
+{
+    // 令牌被接管（本进程曾长时间停顿导致心跳超时）：停止发布
+    if (block->masterToken.load(std::memory_order_acquire) != ownToken)
+    {
+        localMaster.store(false, std::memory_order_release);
+        return;
+    }
+
+    block->masterHeartbeatMs.store(juce::Time::getMillisecondCounter(), std::memory_order_release);
+}
+
+void SharedStateLink::updateRemoteMaster() noexcept
+{
+    const uint64_t token = block->masterToken.load(std::memory_order_acquire);
+    const uint32_t heartbeat = block->masterHeartbeatMs.load(std::memory_order_acquire);
+    const bool active = token != 0 && token != ownToken
+                     && juce::Time::getMillisecondCounter() - heartbeat < MASTER_TIMEOUT_MS;
+
+    if (active == isRemoteMasterActive())
+        return;
+
+    // Master出现或消失：下次读取从状态块重新同步
+    remoteMasterActive.store(active, std::memory_order_release);
+    hasReadIndex = false;
+    masterChangePending.store(true, std::memory_order_release);
+    triggerAsyncUpdate();
+}
+
+void SharedStateLink::drainEvents() noexcept
+{
+    const uint64_t writeIndex = block->writeIndex.load(std::memory_order_acquire);
+
+    if (!hasReadIndex || writeIndex - readIndex > static_cast<uint64_t>(RING_SIZE))
+    {
+        if (hasReadIndex)
+            resyncCount.fetch_add(1, std::memory_order_relaxed);
+
+        readIndex = writeIndex;
+        hasReadIndex = true;
+        resyncFromStateBlock();
+        return;
+    }
+
+    while (readIndex != writeIndex)
+    {
+        const auto& event = block->ring[readIndex & (RING_SIZE - 1)];
+        const uint64_t expected = readIndex * 2 + 2;
+
+        bool valid = event.sequence.load(std::memory_order_acquire) == expected;
+        uint64_t stateWord = 0;
+        juce::int64 publishedTicks = 0;
+        if (valid)
+        {
+            stateWord = event.stateWord.load(std::memory_order_relaxed);
+            publishedTicks = event.publishedTicks.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            valid = event.sequence.load(std::memory_order_relaxed) == expected;
+        }
+
+        if (!valid)
+        {
+            // 槽位已被写者覆盖：跳到最新写索引，状态块至少与之一样新
+            resyncCount.fetch_add(1, std::memory_order_relaxed);
+            readIndex = block->writeIndex.load(std::memory_order_acquire);
+            resyncFromStateBlock();
+            return;
+        }
+
+        deliverState(stateWord);
+
+        // 高精度计时在同一台机器上跨进程可比（单调时钟）；只有链路线程写入
+        const juce::int64 delay = juce::Time::getHighResolutionTicks() - publishedTicks;
+        deliveryTicksTotal.store(deliveryTicksTotal.load(std::memory_order_relaxed) + delay, std::memory_order_relaxed);
+        if (delay > deliveryTicksMax.load(std::memory_order_relaxed))
+            deliveryTicksMax.store(delay, std::memory_order_relaxed);
+
+        receivedCount.fetch_add(1, std::memory_order_relaxed);
+        ++readIndex;
+    }
+}
+
+void SharedStateLink::resyncFromStateBlock() noexcept
+{
+    uint64_t stateWord = 0;
+    juce::int64 ticks = 0;
+    if (readState(stateWord, ticks))
+        deliverState(stateWord);
+}
+
+void SharedStateLink::deliverState(uint64_t stateWord) noexcept
+{
+    // 状态是绝对值：消息线程只需要最新一个
+    latestStateWord.store(stateWord, std::memory_order_release);
+    statePending.store(true, std::memory_order_release);
+    triggerAsyncUpdate();
+}
+
+void SharedStateLink::waitForEvents(uint32_t seenCounter, int timeoutMs)
+{
+   #if JUCE_LINUX
+    if (!isLocalMaster())
+    {
+        block->waiters.fetch_add(1);
+
+        // futex在内核中原子地比较计数：发布发生在fetch_add之后也不会丢失唤醒
+        if (block->eventCounter.load() == seenCounter && !threadShouldExit())
+        {
+            timespec timeout{ timeoutMs / 1000, static_cast<long>(timeoutMs % 1000) * 1000000L };
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&block->eventCounter), FUTEX_WAIT, seenCounter, &timeout, nullptr, 0);
+        }
+
+        block->waiters.fetch_sub(1);
+        return;
+    }
+   #else
+    juce::ignoreUnused(seenCounter);
+   #endif
+
+    // 其他平台：有远端Master时按1ms轮询，否则按心跳间隔检查
+    wait(!isLocalMaster() && isRemoteMasterActive() ? 1 : timeoutMs);
+}
+
+void SharedStateLink::wakeWaiters() noexcept
+{
+   #if JUCE_LINUX
+    if (block->waiters.load() > 0)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&block->eventCounter), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+   #endif
+}
+
+//==============================================================================
+bool SharedStateLink::mapSegment()
+{
+    const size_t size = sizeof(SharedBlock);
+
+   #if JUCE_WINDOWS
+    // 页面文件支持的命名映射，创建时内容为零；最后一个句柄关闭后自动释放
+    const juce::String mappingName = "Local\\" + name;
+    HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                       static_cast<DWORD>(size), mappingName.toWideCharPointer());
+    if (handle == nullptr)
+        return false;
+
+    void* address = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (address == nullptr)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+
+    mappingHandle = handle;
+   #else
+    // 共享段不主动shm_unlink：进程随时可能加入，删除会导致新旧进程各用一个段
+    const juce::String shmName = "/" + name;
+    const int fd = shm_open(shmName.toRawUTF8(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+        return false;
+
+    // 多个进程同时扩展到相同大小是幂等的，新增部分为零
+    struct stat info {};
+    if (fstat(fd, &info) != 0
+        || (static_cast<size_t>(info.st_size) < size && ftruncate(fd, static_cast<off_t>(size)) != 0))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+        return false;
+   #endif
+
+    block = static_cast<SharedBlock*>(address);
+    mappedSize = size;
+    return true;
+}
+
+void SharedStateLink::removeSegment(const juce::String& segmentName)
+{
+   #if JUCE_WINDOWS
+    juce::ignoreUnused(segmentName);    // 命名映射随最后一个句柄关闭自动释放
+   #else
+    shm_unlink(("/" + segmentName).toRawUTF8());
+   #endif
+}
+
+void SharedStateLink::unmapSegment()
+{
+    if (block == nullptr)
+        return;
+
+   #if JUCE_WINDOWS
+    UnmapViewOfFile(block);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    mappingHandle = nullptr;
+   #else
+    munmap(block, mappedSize);
+   #endif
+
+    block = nullptr;
+    mappedSize = 0;
+}
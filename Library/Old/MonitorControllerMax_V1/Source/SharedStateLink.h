@@ -0,0 +1,142 @@
+﻿/*
+  ==============================================================================
+
+    SharedStateLink.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    跨进程Master/Slave链路 - 共享内存（POSIX shm_open/mmap，Windows命名文件映射）
+
+    - 宿主把插件沙箱化到不同进程时，进程内的GlobalPluginState找不到Master；
+      本链路让其他进程的Slave跟随Master，不经过任何套接字
+    - 状态块：MasterStateSnapshot打包字 + 发布时间戳，seqlock保护（读端无锁）
+    - 事件环：单写者多读者的无锁环，每次发布一个事件；读者落后超过环长时从状态块重新同步
+    - Master归属：共享令牌 + 心跳，Master进程崩溃后心跳超时即可被其他进程接管
+    - 唤醒：Linux上读者在futex上睡眠，发布即唤醒（亚毫秒）；其他平台按1ms轮询
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+//==============================================================================
+/**
+ * 跨进程状态链路（每进程一个，由GlobalPluginState持有）
+ *
+ * 线程模型：
+ * - claimMaster/releaseMaster/publishState 在消息线程调用（本进程内有写锁保护）
+ * - 链路线程：Master进程写心跳；其他进程等待事件、读取状态
+ * - onRemoteMasterChanged/onRemoteState 经AsyncUpdater在消息线程回调（多次发布合并为最新状态）
+ * - readState/isRemoteMasterActive 可在任意线程调用
+ */
+class SharedStateLink : private juce::Thread,
+                        private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    static constexpr int RING_SIZE = 256;                   // 2的幂
+    static constexpr uint32_t MASTER_TIMEOUT_MS = 1000;     // 心跳超过该时长视为Master已消失
+    static constexpr int HEARTBEAT_INTERVAL_MS = 100;
+
+    static const char* getDefaultSegmentName() noexcept { return "MonitorControllerMax_Link"; }
+
+    // 删除共享段名（基准/测试结束时清理独立段；已附加的进程不受影响）
+    static void removeSegment(const juce::String& segmentName);
+
+    struct Stats
+    {
+        uint64_t published = 0;         // 本进程作为Master的发布次数
+        uint64_t received = 0;          // 本进程读取到的远端事件数
+        uint64_t resyncs = 0;           // 事件环溢出/被覆盖后从状态块重新同步的次数
+        uint64_t seqlockRetries = 0;
+        double meanDeliveryUs = 0.0;    // 事件发布 -> 本进程链路线程读到（不含消息线程应用）
+        double maxDeliveryUs = 0.0;
+    };
+
+    //==============================================================================
+    explicit SharedStateLink(const juce::String& segmentName = getDefaultSegmentName());
+    ~SharedStateLink() override;
+
+    // 创建或附加共享段并启动链路线程；失败时链路不可用（插件退回进程内模式）
+    bool open();
+    void close();
+    bool isOpen() const noexcept { return block != nullptr; }
+
+    //==============================================================================
+    // Master侧（消息线程）
+    bool claimMaster(uint64_t initialStateWord);    // 其他进程的Master仍存活时返回false
+    void releaseMaster();
+    bool isLocalMaster() const noexcept { return localMaster.load(std::memory_order_acquire); }
+    void publishState(uint64_t stateWord);          // 非本进程Master时忽略
+
+    //==============================================================================
+    // 跟随侧（任意线程）
+    bool isRemoteMasterActive() const noexcept { return remoteMasterActive.load(std::memory_order_acquire); }
+    bool readState(uint64_t& stateWord, juce::int64& publishedTicks) const noexcept;
+
+    // 附加到共享段的进程数（含本进程；崩溃的进程不会减计数，仅作诊断）
+    int getAttachedProcessCount() const noexcept;
+    Stats getStats() const noexcept;
+
+    // 消息线程回调
+    std::function<void(bool active)> onRemoteMasterChanged;
+    std::function<void(uint64_t stateWord)> onRemoteState;
+
+private:
+    //==============================================================================
+    struct SharedBlock;
+
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    void publishLocked(uint64_t stateWord) noexcept;     // 调用方持有writerMutex
+    void writeHeartbeat() noexcept;
+    void updateRemoteMaster() noexcept;
+    void drainEvents() noexcept;
+    void resyncFromStateBlock() noexcept;
+    void deliverState(uint64_t stateWord) noexcept;
+    void waitForEvents(uint32_t seenCounter, int timeoutMs);
+    void wakeWaiters() noexcept;
+
+    bool mapSegment();
+    void unmapSegment();
+
+    //==============================================================================
+    const juce::String name;
+    SharedBlock* block = nullptr;
+    size_t mappedSize = 0;
+
+   #if JUCE_WINDOWS
+    void* mappingHandle = nullptr;
+   #endif
+
+    const uint64_t ownToken;
+    std::atomic<bool> localMaster{ false };
+    std::mutex writerMutex;
+
+    // 跟随侧状态（链路线程写入）
+    std::atomic<bool> remoteMasterActive{ false };
+    bool deliveredMasterActive = false;             // 仅消息线程
+    uint64_t readIndex = 0;
+    bool hasReadIndex = false;
+
+    std::atomic<uint64_t> latestStateWord{ 0 };
+    std::atomic<bool> statePending{ false };
+    std::atomic<bool> masterChangePending{ false };
+
+    std::atomic<uint64_t> publishedCount{ 0 };
+    std::atomic<uint64_t> receivedCount{ 0 };
+    std::atomic<uint64_t> resyncCount{ 0 };
+    mutable std::atomic<uint64_t> seqlockRetryCount{ 0 };
+    std::atomic<juce::int64> deliveryTicksTotal{ 0 };
+    std::atomic<juce::int64> deliveryTicksMax{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedStateLink)
+};
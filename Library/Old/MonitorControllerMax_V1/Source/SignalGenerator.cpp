@@ -0,0 +1,411 @@
+﻿/*
+  ==============================================================================
+
+    SignalGenerator.cpp
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    内置校准信号发生器实现 - 向量化噪声生成、粉红/带限滤波、正弦与扫频
+
+  ==============================================================================
+*/
+
+#include "SignalGenerator.h"
+#include "DebugLogger.h"
+#include <cstring>
+
+namespace
+{
+    // xorshift32输出转换为[-1, 1)均匀分布：取高23位作为尾数，无除法无分支
+    inline float uniformFromBits(uint32_t x) noexcept
+    {
+        const uint32_t bits = (x >> 9) | 0x40000000u;   // [2, 4)
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value - 3.0f;
+    }
+}
+
+//==============================================================================
+SignalGenerator::SignalGenerator()
+{
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        seedChannel(ch);
+}
+
+void SignalGenerator::prepare(double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    fadeStepPerSample = static_cast<float>(1.0 / (FADE_SECONDS * currentSampleRate));
+
+    outputBuffer.setSize(MAX_CHANNELS, maximumExpectedSamplesPerBlock, false, true, false);
+    toneBuffer.setSize(1, maximumExpectedSamplesPerBlock, false, true, false);
+
+    setButterworth(bandHighPassPrototype, currentSampleRate, 500.0, true);
+    setButterworth(bandLowPassPrototype, currentSampleRate, 2000.0, false);
+
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        seedChannel(ch);
+
+    // 实测滤波后的RMS，使所有噪声类型在同一电平设置下都是准确的RMS dBFS
+    pinkNormalisation = 1.0f;
+    bandPinkNormalisation = 1.0f;
+    const float pinkRms = measureNoiseRms(false);
+    const float bandPinkRms = measureNoiseRms(true);
+    pinkNormalisation = pinkRms > 0.0f ? 1.0f / pinkRms : 1.0f;
+    bandPinkNormalisation = bandPinkRms > 0.0f ? 1.0f / bandPinkRms : 1.0f;
+
+    renderType = Type::Off;
+    currentGain = 0.0f;
+    channelMix.fill(0.0f);
+    channelGain.fill(0.0f);
+    blockChannelCount = 0;
+    mixActive = false;
+    resetRenderState();
+
+    VST3_DBG_DETAIL("SignalGenerator: Prepared - sampleRate: " + juce::String(currentSampleRate) +
+                    ", pink norm: " + juce::String(pinkNormalisation, 3) +
+                    ", band pink norm: " + juce::String(bandPinkNormalisation, 3));
+}
+
+//==============================================================================
+void SignalGenerator::setType(Type newType) noexcept
+{
+    type.store(static_cast<int>(newType), std::memory_order_relaxed);
+}
+
+void SignalGenerator::setLevelDb(float rmsDbFS) noexcept
+{
+    levelDb.store(juce::jlimit(MIN_LEVEL_DB, MAX_LEVEL_DB, rmsDbFS), std::memory_order_relaxed);
+}
+
+void SignalGenerator::setSineFrequency(float frequencyHz) noexcept
+{
+    sineFrequency.store(juce::jlimit(10.0f, 22000.0f, frequencyHz), std::memory_order_relaxed);
+}
+
+void SignalGenerator::setSweepRange(float startHz, float endHz, float durationSeconds) noexcept
+{
+    sweepStartHz.store(juce::jlimit(10.0f, 22000.0f, startHz), std::memory_order_relaxed);
+    sweepEndHz.store(juce::jlimit(10.0f, 22000.0f, endHz), std::memory_order_relaxed);
+    sweepSeconds.store(juce::jlimit(0.5f, 120.0f, durationSeconds), std::memory_order_relaxed);
+}
+
+juce::String SignalGenerator::getTypeName(Type generatorType)
+{
+    switch (generatorType)
+    {
+        case Type::PinkNoise:     return "PINK";
+        case Type::BandPinkNoise: return "PINK BL";
+        case Type::Sine:          return "SINE";
+        case Type::Sweep:         return "SWEEP";
+        case Type::Off:
+        default:                  return "OFF";
+    }
+}
+
+//==============================================================================
+bool SignalGenerator::isProducingOutput() const noexcept
+{
+    return getType() != Type::Off || mixActive;
+}
+
+bool SignalGenerator::render(int numSamples, const uint8_t* channelIndices, const float* channelGains, int numChannels) noexcept
+{
+    blockChannelCount = 0;
+
+    if (numSamples <= 0 || numSamples > outputBuffer.getNumSamples())
+        return false;
+
+    const Type requestedType = getType();
+    const bool enabled = requestedType != Type::Off;
+    const float requestedGain = juce::Decibels::decibelsToGain(getLevelDb());
+
+    // 所有通道都已回到节目信号时直接切换类型，淡入由干/湿淡化完成
+    if (!mixActive && requestedType != renderType) {
+        renderType = requestedType;
+        resetRenderState();
+        currentGain = enabled ? requestedGain : 0.0f;
+    }
+
+    if (renderType == Type::Off) {
+        currentGain = 0.0f;
+        return false;
+    }
+
+    // 开启状态下切换类型：节目保持被替换，发生器电平先淡出到0再切换（滤波器/相位从干净状态开始）
+    float targetGain = requestedGain;
+    if (enabled && requestedType != renderType) {
+        if (currentGain <= 0.0f) {
+            renderType = requestedType;
+            resetRenderState();
+        } else {
+            targetGain = 0.0f;
+        }
+    }
+
+    const float maxDelta = fadeStepPerSample * static_cast<float>(numSamples);
+    const float startGain = currentGain;
+    const float endGain = startGain + juce::jlimit(-maxDelta, maxDelta, targetGain - startGain);
+    currentGain = endGain;
+
+    // 路由表 -> 每通道目标湿度；关闭或移出路由表的通道淡回节目信号
+    std::array<bool, MAX_CHANNELS> routed{};
+    for (int i = 0; i < numChannels; ++i) {
+        const int ch = channelIndices[i];
+        if (ch >= MAX_CHANNELS) continue;
+        routed[static_cast<size_t>(ch)] = true;
+        channelGain[static_cast<size_t>(ch)] = channelGains[i];
+    }
+
+    mixActive = false;
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch) {
+        const auto index = static_cast<size_t>(ch);
+        const float targetMix = (enabled && routed[index]) ? 1.0f : 0.0f;
+        const float mixStart = channelMix[index];
+        const float mixEnd = mixStart + juce::jlimit(-maxDelta, maxDelta, targetMix - mixStart);
+        channelMix[index] = mixEnd;
+
+        if (mixStart <= 0.0f && mixEnd <= 0.0f) continue;
+
+        mixActive = mixActive || mixEnd > 0.0f;
+        blockMixStart[index] = mixStart;
+        blockMixEnd[index] = mixEnd;
+        blockChannels[static_cast<size_t>(blockChannelCount++)] = static_cast<uint8_t>(ch);
+    }
+
+    if (blockChannelCount == 0)
+        return false;
+
+    // 相干信号只生成一次
+    const bool isTone = (renderType == Type::Sine || renderType == Type::Sweep);
+    if (isTone)
+        renderTone(renderType, numSamples);
+
+    for (int i = 0; i < blockChannelCount; ++i) {
+        const int ch = blockChannels[static_cast<size_t>(i)];
+        const auto index = static_cast<size_t>(ch);
+
+        // 湿信号 = 电平 × 通道系数 × 湿度（湿度为0的一端即与节目交叉淡化的起点/终点）
+        const float rampStart = startGain * channelGain[index] * blockMixStart[index];
+        const float rampEnd = endGain * channelGain[index] * blockMixEnd[index];
+
+        if (rampStart == 0.0f && rampEnd == 0.0f) {
+            outputBuffer.clear(ch, 0, numSamples);
+            continue;
+        }
+
+        float* destination = outputBuffer.getWritePointer(ch);
+
+        if (isTone)
+            juce::FloatVectorOperations::copy(destination, toneBuffer.getReadPointer(0), numSamples);
+        else
+            renderNoise(ch, destination, numSamples, renderType == Type::BandPinkNoise);
+
+        if (rampStart != rampEnd)
+            outputBuffer.applyGainRamp(ch, 0, numSamples, rampStart, rampEnd);
+        else
+            juce::FloatVectorOperations::multiply(destination, rampEnd, numSamples);
+    }
+
+    return true;
+}
+
+void SignalGenerator::mixInto(juce::AudioBuffer<float>& programme, int numSamples) const noexcept
+{
+    const int numProgrammeChannels = programme.getNumChannels();
+
+    for (int i = 0; i < blockChannelCount; ++i) {
+        const int ch = blockChannels[static_cast<size_t>(i)];
+        if (ch >= numProgrammeChannels) continue;
+
+        // 节目按(1 - 湿度)渐变，与发生器的湿度渐变使用同一组起止值
+        const float dryStart = 1.0f - blockMixStart[static_cast<size_t>(ch)];
+        const float dryEnd = 1.0f - blockMixEnd[static_cast<size_t>(ch)];
+
+        if (dryStart <= 0.0f && dryEnd <= 0.0f)
+            programme.clear(ch, 0, numSamples);
+        else if (dryStart != dryEnd)
+            programme.applyGainRamp(ch, 0, numSamples, dryStart, dryEnd);
+        else if (dryEnd < 1.0f)
+            programme.applyGain(ch, 0, numSamples, dryEnd);
+
+        programme.addFrom(ch, 0, outputBuffer, ch, 0, numSamples);
+    }
+}
+
+//==============================================================================
+void SignalGenerator::seedChannel(int channel) noexcept
+{
+    // 每个通道、每一路使用不同种子，保证各扬声器噪声互不相关
+    for (int lane = 0; lane < NOISE_LANES; ++lane) {
+        uint32_t seed = static_cast<uint32_t>(channel + 1) * 0x9E3779B9u ^ static_cast<uint32_t>(lane + 1) * 0x85EBCA6Bu;
+        seed ^= seed >> 16;
+        seed *= 0x7FEB352Du;
+        seed ^= seed >> 15;
+        noiseStates[static_cast<size_t>(channel)].lanes[lane] = seed != 0 ? seed : 0x6D2B79F5u;
+    }
+}
+
+void SignalGenerator::generateWhite(int channel, float* destination, int numSamples) noexcept
+{
+    auto& state = noiseStates[static_cast<size_t>(channel)];
+
+    alignas(16) uint32_t lanes[NOISE_LANES];
+    std::memcpy(lanes, state.lanes, sizeof(lanes));
+
+    // 4路并行：内层循环无依赖，可生成SSE/NEON向量指令
+    int i = 0;
+    for (; i + NOISE_LANES <= numSamples; i += NOISE_LANES) {
+        for (int lane = 0; lane < NOISE_LANES; ++lane) {
+            uint32_t x = lanes[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            lanes[lane] = x;
+            destination[i + lane] = uniformFromBits(x);
+        }
+    }
+
+    for (int lane = 0; i < numSamples; ++i, ++lane) {
+        uint32_t x = lanes[lane];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        lanes[lane] = x;
+        destination[i] = uniformFromBits(x);
+    }
+
+    std::memcpy(state.lanes, lanes, sizeof(lanes));
+}
+
+void SignalGenerator::renderNoise(int channel, float* destination, int numSamples, bool bandLimited) noexcept
+{
+    generateWhite(channel, destination, numSamples);
+
+    // 粉红滤波：递归结构无法跨样本向量化，状态保存在寄存器中逐样本处理
+    auto& pink = pinkStates[static_cast<size_t>(channel)];
+    float b0 = pink.b0, b1 = pink.b1, b2 = pink.b2;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float white = destination[i];
+        b0 = 0.99765f * b0 + white * 0.0990460f;
+        b1 = 0.96300f * b1 + white * 0.2965164f;
+        b2 = 0.57000f * b2 + white * 1.0526913f;
+        destination[i] = b0 + b1 + b2 + white * 0.1848f;
+    }
+
+    pink.b0 = b0;
+    pink.b1 = b1;
+    pink.b2 = b2;
+
+    if (bandLimited) {
+        processBiquad(bandHighPass[static_cast<size_t>(channel)], destination, numSamples);
+        processBiquad(bandLowPass[static_cast<size_t>(channel)], destination, numSamples);
+        juce::FloatVectorOperations::multiply(destination, bandPinkNormalisation, numSamples);
+    } else {
+        juce::FloatVectorOperations::multiply(destination, pinkNormalisation, numSamples);
+    }
+}
+
+void SignalGenerator::renderTone(Type toneType, int numSamples) noexcept
+{
+    // 单位RMS：峰值√2
+    constexpr double peak = 1.4142135623730951;
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+    float* destination = toneBuffer.getWritePointer(0);
+
+    if (toneType == Type::Sine) {
+        const double increment = twoPi * sineFrequency.load(std::memory_order_relaxed) / currentSampleRate;
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = static_cast<float>(peak * std::sin(tonePhase));
+            tonePhase += increment;
+        }
+    } else {
+        // 对数扫频：f(t) = f0 × (f1/f0)^(t/T)，到达终点后从头循环
+        const double startHz = sweepStartHz.load(std::memory_order_relaxed);
+        const double endHz = sweepEndHz.load(std::memory_order_relaxed);
+        const double duration = sweepSeconds.load(std::memory_order_relaxed);
+        const double ratio = endHz / startHz;
+        const double secondsPerSample = 1.0 / currentSampleRate;
+
+        for (int i = 0; i < numSamples; ++i) {
+            const double frequency = startHz * std::pow(ratio, sweepPosition / duration);
+            destination[i] = static_cast<float>(peak * std::sin(tonePhase));
+            tonePhase += twoPi * frequency * secondsPerSample;
+
+            sweepPosition += secondsPerSample;
+            if (sweepPosition >= duration)
+                sweepPosition -= duration;
+        }
+    }
+
+    // 防止长时间运行后相位精度下降
+    tonePhase = std::fmod(tonePhase, twoPi);
+}
+
+void SignalGenerator::resetRenderState() noexcept
+{
+    tonePhase = 0.0;
+    sweepPosition = 0.0;
+
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch) {
+        pinkStates[static_cast<size_t>(ch)] = {};
+        bandHighPass[static_cast<size_t>(ch)] = bandHighPassPrototype;
+        bandLowPass[static_cast<size_t>(ch)] = bandLowPassPrototype;
+    }
+}
+
+float SignalGenerator::measureNoiseRms(bool bandLimited)
+{
+    // 只在prepare中调用：用1秒噪声（跳过前0.25秒滤波器建立时间）测量RMS
+    resetRenderState();
+
+    const int warmup = static_cast<int>(currentSampleRate * 0.25);
+    const int length = static_cast<int>(currentSampleRate);
+    std::vector<float> samples(static_cast<size_t>(warmup + length));
+    renderNoise(0, samples.data(), warmup + length, bandLimited);
+
+    double sumSquares = 0.0;
+    for (int i = warmup; i < warmup + length; ++i)
+        sumSquares += static_cast<double>(samples[static_cast<size_t>(i)]) * samples[static_cast<size_t>(i)];
+
+    resetRenderState();
+    return static_cast<float>(std::sqrt(sumSquares / length));
+}
+
+//==============================================================================
+void SignalGenerator::setButterworth(Biquad& filter, double sampleRate, double frequency, bool highPass)
+{
+    // RBJ二阶巴特沃斯（Q = 0.7071）
+    const double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * 0.7071067811865476);
+    const double a0 = 1.0 + alpha;
+
+    const double b0 = highPass ? (1.0 + cosW0) * 0.5 : (1.0 - cosW0) * 0.5;
+    const double b1 = highPass ? -(1.0 + cosW0) : (1.0 - cosW0);
+
+    filter.b0 = static_cast<float>(b0 / a0);
+    filter.b1 = static_cast<float>(b1 / a0);
+    filter.b2 = static_cast<float>(b0 / a0);
+    filter.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+    filter.a2 = static_cast<float>((1.0 - alpha) / a0);
+    filter.z1 = filter.z2 = 0.0f;
+}
+
+void SignalGenerator::processBiquad(Biquad& filter, float* samples, int numSamples) noexcept
+{
+    float z1 = filter.z1, z2 = filter.z2;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float x = samples[i];
+        const float y = filter.b0 * x + z1;
+        z1 = filter.b1 * x - filter.a1 * y + z2;
+        z2 = filter.b2 * x - filter.a2 * y;
+        samples[i] = y;
+    }
+
+    filter.z1 = z1;
+    filter.z2 = z2;
+}
@@ -0,0 +1,161 @@
+﻿/*
+  ==============================================================================
+
+    SignalGenerator.h
+    Created: 2026-10-18
+    Author:  GohardSGG
+
+    内置校准信号发生器 - 扬声器电平校准
+
+    - 粉红噪声 / 带限粉红噪声（500Hz-2kHz）/ 正弦 / 对数扫频
+    - 每个物理通道独立的去相关噪声（多通道xorshift PRNG，按4路并行展开便于向量化）
+    - 电平为RMS dBFS，输出经RenderState的GAIN_n系数和Solo/Mute后与该通道的节目信号交叉淡化，
+      因此逐个Solo扬声器即可一次完成所有通道的Trim校准
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <array>
+
+//==============================================================================
+/**
+ * 校准信号发生器
+ *
+ * 线程模型：
+ * - 消息线程：setType()/setLevelDb()/setSineFrequency()/setSweepRange() 写原子参数
+ * - 音频线程：render() 按RenderState预计算的路由表生成信号，零锁零分配
+ *   开关和路由变化按通道做干/湿交叉淡化；开启状态下切换类型时发生器电平先淡出到0再切换
+ */
+class SignalGenerator
+{
+public:
+    //==============================================================================
+    enum class Type
+    {
+        Off = 0,
+        PinkNoise = 1,
+        BandPinkNoise = 2,    // 500Hz - 2kHz，声学测量常用的带限粉噪
+        Sine = 3,
+        Sweep = 4
+    };
+
+    //==============================================================================
+    SignalGenerator();
+    ~SignalGenerator() = default;
+
+    // 生命周期（prepareToPlay调用）
+    void prepare(double sampleRate, int maximumExpectedSamplesPerBlock);
+
+    //==============================================================================
+    // 消息线程接口
+    void setType(Type newType) noexcept;
+    Type getType() const noexcept { return static_cast<Type>(type.load(std::memory_order_relaxed)); }
+    void setLevelDb(float rmsDbFS) noexcept;
+    float getLevelDb() const noexcept { return levelDb.load(std::memory_order_relaxed); }
+    void setSineFrequency(float frequencyHz) noexcept;
+    float getSineFrequency() const noexcept { return sineFrequency.load(std::memory_order_relaxed); }
+    void setSweepRange(float startHz, float endHz, float durationSeconds) noexcept;
+    float getSweepStartHz() const noexcept { return sweepStartHz.load(std::memory_order_relaxed); }
+    float getSweepEndHz() const noexcept { return sweepEndHz.load(std::memory_order_relaxed); }
+    float getSweepSeconds() const noexcept { return sweepSeconds.load(std::memory_order_relaxed); }
+
+    static juce::String getTypeName(Type generatorType);
+
+    //==============================================================================
+    // 音频线程接口
+    // 是否需要渲染（开启中或仍在淡出）
+    bool isProducingOutput() const noexcept;
+
+    // 为channelIndices中的物理通道生成numSamples个样本，channelGains为对应条目的通道系数（含GAIN_n与Solo/Mute）
+    // 已移出路由表的通道继续按最后的系数淡出；返回false表示本块无输出（所有通道已完全回到节目信号）
+    bool render(int numSamples, const uint8_t* channelIndices, const float* channelGains, int numChannels) noexcept;
+
+    // 与节目信号交叉淡化：节目 × (1 - 湿度) + 发生器 × 湿度，湿度按render()本块的起止值线性渐变
+    void mixInto(juce::AudioBuffer<float>& programme, int numSamples) const noexcept;
+
+    //==============================================================================
+    static constexpr int MAX_CHANNELS = 26;
+    static constexpr float DEFAULT_LEVEL_DB = -20.0f;   // 校准常用 -20dBFS RMS
+    static constexpr float MIN_LEVEL_DB = -60.0f;
+    static constexpr float MAX_LEVEL_DB = -3.0f;        // 正弦峰值不超过0dBFS
+    static constexpr double FADE_SECONDS = 0.02;
+
+private:
+    //==============================================================================
+    // 每通道4路xorshift32状态：4路互相独立，内层循环固定4次迭代，编译器可直接生成SIMD
+    static constexpr int NOISE_LANES = 4;
+    struct alignas(16) NoiseState
+    {
+        uint32_t lanes[NOISE_LANES];
+    };
+
+    // Paul Kellet粉红滤波器（经济版，3极点，±0.5dB@9.2Hz-Nyquist）
+    struct PinkState
+    {
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+    };
+
+    // 二阶IIR（Transposed Direct Form II），用于带限噪声
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float z1 = 0.0f, z2 = 0.0f;
+    };
+
+    //==============================================================================
+    void seedChannel(int channel) noexcept;
+    void generateWhite(int channel, float* destination, int numSamples) noexcept;
+    void renderNoise(int channel, float* destination, int numSamples, bool bandLimited) noexcept;
+    void renderTone(Type toneType, int numSamples) noexcept;
+    void resetRenderState() noexcept;
+    float measureNoiseRms(bool bandLimited);
+
+    static void setButterworth(Biquad& filter, double sampleRate, double frequency, bool highPass);
+    static void processBiquad(Biquad& filter, float* samples, int numSamples) noexcept;
+
+    //==============================================================================
+    // 消息线程 -> 音频线程参数
+    std::atomic<int> type{ static_cast<int>(Type::Off) };
+    std::atomic<float> levelDb{ DEFAULT_LEVEL_DB };
+    std::atomic<float> sineFrequency{ 1000.0f };
+    std::atomic<float> sweepStartHz{ 20.0f };
+    std::atomic<float> sweepEndHz{ 20000.0f };
+    std::atomic<float> sweepSeconds{ 10.0f };
+
+    //==============================================================================
+    // 音频线程状态
+    double currentSampleRate = 48000.0;
+    Type renderType = Type::Off;              // 当前正在输出的类型（切换时先淡出）
+    float currentGain = 0.0f;                 // 当前输出电平（类型切换、电平变化时渐变）
+    float fadeStepPerSample = 0.001f;
+
+    // 每通道干/湿比例（0 = 节目，1 = 发生器）：开关和路由变化都通过它淡化，节目信号不会被硬切换
+    std::array<float, MAX_CHANNELS> channelMix{};
+    std::array<float, MAX_CHANNELS> channelGain{};        // 最后一次路由时的通道系数（淡出时沿用）
+    std::array<float, MAX_CHANNELS> blockMixStart{};      // 本块起止湿度，供mixInto()使用
+    std::array<float, MAX_CHANNELS> blockMixEnd{};
+    std::array<uint8_t, MAX_CHANNELS> blockChannels{};    // 本块有输出的通道（含正在淡出的通道）
+    int blockChannelCount = 0;
+    bool mixActive = false;                   // 任一通道湿度 > 0
+
+    std::array<NoiseState, MAX_CHANNELS> noiseStates;
+    std::array<PinkState, MAX_CHANNELS> pinkStates;
+    std::array<Biquad, MAX_CHANNELS> bandHighPass;
+    std::array<Biquad, MAX_CHANNELS> bandLowPass;
+    Biquad bandHighPassPrototype, bandLowPassPrototype;
+    float pinkNormalisation = 1.0f;           // 单位RMS归一化系数（prepare时测量）
+    float bandPinkNormalisation = 1.0f;
+
+    double tonePhase = 0.0;
+    double sweepPosition = 0.0;               // 扫频进度（秒）
+
+    juce::AudioBuffer<float> outputBuffer;    // MAX_CHANNELS × 块大小
+    juce::AudioBuffer<float> toneBuffer;      // 正弦/扫频为相干信号，只生成一次再拷贝
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalGenerator)
+};
@@ -1,5 +1,6 @@
 ﻿#include "StateManager.h"
 #include "PluginProcessor.h"
+#include "OSCAddressTable.h"
 #include "DebugLogger.h"
 
 //==============================================================================
@@ -76,26 +77,76 @@ const RenderState* StateManager::getCurrentRenderState() const noexcept
 void StateManager::onSoloStateChanged(const juce::String& channelName, bool state)
 {
     VST3_DBG("StateManager: Solo state changed - " + channelName + " = " + (state ? "ON" : "OFF"));
+    
+    masterLayerDirty.store(true, std::memory_order_relaxed);
+    
+    if (transactionDepth > 0)
+    {
+        renderStateUpdateDeferred = true;
+        return;
+    }
+    
     updateRenderState();
 }
 
 void StateManager::onMuteStateChanged(const juce::String& channelName, bool state)
 {
     VST3_DBG("StateManager: Mute state changed - " + channelName + " = " + (state ? "ON" : "OFF"));
+    
+    masterLayerDirty.store(true, std::memory_order_relaxed);
+    
+    if (transactionDepth > 0)
+    {
+        renderStateUpdateDeferred = true;
+        return;
+    }
+    
     updateRenderState();
 }
 
 void StateManager::onGlobalModeChanged()
 {
     VST3_DBG("StateManager: Global mode changed");
+    
+    // 全局模式（含Solo监听模式）改变所有通道的最终Mute，UI缓存失效
+    currentStateVersion.fetch_add(1, std::memory_order_acq_rel);
+    masterLayerDirty.store(true, std::memory_order_relaxed);
+    
+    if (transactionDepth > 0)
+    {
+        renderStateUpdateDeferred = true;
+        return;
+    }
+    
     updateRenderState();
 }
 
+void StateManager::onStateTransactionBegin()
+{
+    ++transactionDepth;
+}
+
+void StateManager::onStateTransactionEnd()
+{
+    // 🚀 整个事务只重建一次RenderState
+    if (transactionDepth > 0 && --transactionDepth == 0 && renderStateUpdateDeferred)
+    {
+        renderStateUpdateDeferred = false;
+        updateRenderState();
+    }
+}
+
 //==============================================================================
 // AudioProcessorValueTreeState::Listener 接口实现
 void StateManager::parameterChanged(const juce::String& parameterID, float newValue)
 {
     VST3_DBG("StateManager: Parameter changed - " + parameterID + " = " + juce::String(newValue));
+    
+    // 通道增益属于本地层，Master层不受影响
+    if (parameterID.startsWith("GAIN_")) {
+        localLayerDirty.store(true, std::memory_order_relaxed);
+    }
+    
     updateRenderState();
 }
 
@@ -103,9 +154,45 @@ void StateManager::parameterChanged(const juce::String& parameterID, float newVa
 void StateManager::onLayoutChanged()
 {
     VST3_DBG("StateManager: Layout changed");
+    
+    // 物理索引映射改变，三层全部重建
+    layoutLayerDirty.store(true, std::memory_order_relaxed);
+    masterLayerDirty.store(true, std::memory_order_relaxed);
+    localLayerDirty.store(true, std::memory_order_relaxed);
+    
     updateRenderState();
 }
 
+void StateManager::refreshRenderState()
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+    
+    if (transactionDepth > 0)
+    {
+        renderStateUpdateDeferred = true;
+        return;
+    }
+    
+    updateRenderState();
+}
+
+void StateManager::onLocalLayerChanged()
+{
+    localLayerDirty.store(true, std::memory_order_relaxed);
+    refreshRenderState();
+}
+
+void StateManager::stageRoleTransition()
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+    
+    // 尚未初始化时没有正在输出的快照，无需淡化
+    if (!initialized) return;
+    
+    roleTransitionStaged = true;
+    refreshRenderState();
+}
+
 //==============================================================================
 // 核心状态更新方法
 void StateManager::updateRenderState()
@@ -121,6 +208,10 @@ void StateManager::updateRenderState()
 
 void StateManager::collectCurrentState(RenderState* targetState)
 {
+    // 版本号先变为奇数再写字段：readRenderState据此丢弃读到一半被重写的快照
+    targetState->version.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
     // 清空目标状态 (手动初始化所有字段)
     for (int i = 0; i < RenderState::MAX_CHANNELS; ++i) {
         targetState->channelShouldMute[i] = false;
@@ -131,42 +222,132 @@ void StateManager::collectCurrentState(RenderState* targetState)
     }
     targetState->monoActive = false;
     targetState->monoChannelCount = 0;
+    targetState->activeInputSource = 0;
+    targetState->cueActive = false;
+    targetState->cueChannelCount = 0;
+    targetState->generatorChannelCount = 0;
+    targetState->comparisonKey = 0;
+    targetState->loudnessTrimDb = 0.0f;
+    
+    // Master传播跟踪：随快照一起发布，音频线程据此确认Slave已输出该序号
+    targetState->masterSequence = processor.appliedMasterSequence.load(std::memory_order_relaxed);
+    targetState->masterPublishedTicks = processor.appliedMasterPublishedTicks.load(std::memory_order_relaxed);
+    
+    // 角色随快照发布：音频线程的Master总线处理与通道状态总是同一角色
+    targetState->role = static_cast<uint8_t>(processor.getCurrentRole());
+    
+    // 角色切换淡化起点：切换时取正在输出的快照的有效增益，其余发布原样沿用，进行中的淡化不被打断
+    // （消息线程是唯一写入方，读取活跃缓冲区安全；连续切换时以上一快照的目标增益为起点）
+    const RenderState* audibleState = activeRenderState.load(std::memory_order_acquire);
+    if (roleTransitionStaged) {
+        roleTransitionStaged = false;
+        ++roleTransitionSerial;
+        for (int i = 0; i < RenderState::MAX_CHANNELS; ++i) {
+            targetState->roleTransitionFromGain[i] = audibleState->getEffectiveGain(i);
+        }
+    } else {
+        for (int i = 0; i < RenderState::MAX_CHANNELS; ++i) {
+            targetState->roleTransitionFromGain[i] = audibleState->roleTransitionFromGain[i];
+        }
+    }
+    targetState->roleTransitionSerial = roleTransitionSerial;
     
     // 收集各组件状态（直接调用现有逻辑，零计算）
     collectChannelStates(targetState);
     collectMasterBusStates(targetState);
     collectMonoChannelData(targetState);
+    collectCueBusData(targetState);         // AFL系数取个人增益，需在响度Trim折算之前
+    collectGeneratorData(targetState);      // 校准信号只经过GAIN_n修整，同样在响度Trim之前
+    collectLoudnessMatchData(targetState);  // 必须在通道和Mono状态之后
     
-    // 更新版本号
-    targetState->version.store(targetState->version.load() + 1, std::memory_order_release);
+    // 更新版本号（回到偶数：写入完成）
+    targetState->version.fetch_add(1, std::memory_order_release);
 }
 
 void StateManager::collectChannelStates(RenderState* target)
 {
-    const auto& currentLayout = processor.getCurrentLayout();
+    // 🚀 只重建输入发生变化的层（布局层在前：其他两层按它的物理索引收集）
+    if (layoutLayerDirty.exchange(false, std::memory_order_relaxed)) rebuildLayoutLayer();
+    if (masterLayerDirty.exchange(false, std::memory_order_relaxed)) rebuildMasterLayer();
+    if (localLayerDirty.exchange(false, std::memory_order_relaxed)) rebuildLocalLayer();
     
-    // 遍历当前布局中的所有通道
-    for (const auto& channelInfo : currentLayout.channels) {
+    // 合并：最终静音 = Master层 | 本地层，增益只来自本地层（非激活通道保持默认值）
+    const uint32_t muteMask = channelLayers.masterMuteMask | channelLayers.localMuteMask;
+    
+    for (int ch = 0; ch < RenderState::MAX_CHANNELS; ++ch) {
+        const uint32_t bit = 1u << ch;
+        target->channelIsActive[ch] = (channelLayers.activeMask & bit) != 0;
+        target->channelShouldMute[ch] = (muteMask & bit) != 0;
+        target->channelIsSUB[ch] = (channelLayers.subMask & bit) != 0;
+        target->channelFinalGain[ch] = channelLayers.localGain[static_cast<size_t>(ch)];
+    }
+}
+
+void StateManager::rebuildLayoutLayer()
+{
+    channelLayers.activeMask = 0;
+    channelLayers.subMask = 0;
+    
+    for (const auto& channelInfo : processor.getCurrentLayout().channels) {
         const int physicalIndex = channelInfo.channelIndex;
         if (physicalIndex < 0 || physicalIndex >= RenderState::MAX_CHANNELS) continue;
         
-        const juce::String& channelName = channelInfo.name;
+        const uint32_t bit = 1u << physicalIndex;
+        channelLayers.activeMask |= bit;
+        
+        // SUB通道（用于LowBoost处理与Mono排除）
+        if (processor.getSemanticState().isSUBChannel(channelInfo.name)) {
+            channelLayers.subMask |= bit;
+        }
+    }
+}
+
+void StateManager::rebuildMasterLayer()
+{
+    const auto& semanticState = processor.getSemanticState();
+    uint32_t muteMask = 0;
+    
+    // 直接调用SemanticChannelState的最终结果（保持所有SUB逻辑）
+    for (const auto& channelInfo : processor.getCurrentLayout().channels) {
+        const int physicalIndex = channelInfo.channelIndex;
+        if (physicalIndex < 0 || physicalIndex >= RenderState::MAX_CHANNELS) continue;
         
-        // 直接调用SemanticChannelState的最终结果（保持所有SUB逻辑）
-        target->channelShouldMute[physicalIndex] = 
-            processor.getSemanticState().getFinalMuteState(channelName);
+        if (semanticState.getFinalMuteState(channelInfo.name)) {
+            muteMask |= 1u << physicalIndex;
+        }
+    }
+    
+    channelLayers.masterMuteMask = muteMask;
+    masterLayerRebuilds.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StateManager::rebuildLocalLayer()
+{
+    channelLayers.localMuteMask = 0;
+    channelLayers.localGain.fill(1.0f);
+    
+    for (const auto& channelInfo : processor.getCurrentLayout().channels) {
+        const int physicalIndex = channelInfo.channelIndex;
+        if (physicalIndex < 0 || physicalIndex >= RenderState::MAX_CHANNELS) continue;
         
-        // 获取通道个人增益（来自VST3参数）
+        // 通道个人增益（来自VST3参数）
         const juce::String gainParamID = "GAIN_" + juce::String(physicalIndex + 1);
-        const float gainDb = processor.apvts.getRawParameterValue(gainParamID)->load();
-        target->channelFinalGain[physicalIndex] = juce::Decibels::decibelsToGain(gainDb);
+        float gainDb = processor.apvts.getRawParameterValue(gainParamID)->load();
         
-        // 标记通道激活
-        target->channelIsActive[physicalIndex] = true;
+        // 本地覆盖按语义通道保存，布局变化后映射到新的物理索引
+        const int channelId = OSCAddressTable::findChannelId(channelInfo.name);
+        if (channelId != OSCAddressTable::INVALID_CHANNEL_ID) {
+            gainDb += processor.localTrimDb[static_cast<size_t>(channelId)];
+            
+            if ((processor.localMuteMask & (1u << channelId)) != 0) {
+                channelLayers.localMuteMask |= 1u << physicalIndex;
+            }
+        }
         
-        // 标记SUB通道（用于LowBoost处理）
-        target->channelIsSUB[physicalIndex] = processor.getSemanticState().isSUBChannel(channelName);
+        channelLayers.localGain[static_cast<size_t>(physicalIndex)] = juce::Decibels::decibelsToGain(gainDb);
     }
+    
+    localLayerRebuilds.fetch_add(1, std::memory_order_relaxed);
 }
 
 void StateManager::collectMasterBusStates(RenderState* target)
@@ -175,6 +356,9 @@ void StateManager::collectMasterBusStates(RenderState* target)
     
     // 只收集Mono状态用于预计算参与通道（其他Master效果由MasterBusProcessor直接处理）
     target->monoActive = masterBus.isMonoActive();
+    
+    // 输入源选择（音频线程据此切换读指针）
+    target->activeInputSource = static_cast<uint8_t>(processor.getInputSource());
 }
 
 void StateManager::collectMonoChannelData(RenderState* target)
@@ -192,10 +376,8 @@ void StateManager::collectMonoChannelData(RenderState* target)
         const int physicalIndex = channelInfo.channelIndex;
         if (physicalIndex < 0 || physicalIndex >= RenderState::MAX_CHANNELS) continue;
         
-        const juce::String& channelName = channelInfo.name;
-        
-        // 排除SUB通道参与Mono混合
-        if (!processor.getSemanticState().isSUBChannel(channelName)) {
+        // 排除SUB通道参与Mono混合（布局层已在collectChannelStates中标记）
+        if (!target->channelIsSUB[physicalIndex]) {
             if (monoCount < RenderState::MAX_CHANNELS) {
                 target->monoChannelIndices[monoCount] = static_cast<uint8_t>(physicalIndex);
                 monoCount++;
@@ -206,11 +388,121 @@ void StateManager::collectMonoChannelData(RenderState* target)
     target->monoChannelCount = monoCount;
 }
 
+void StateManager::collectCueBusData(RenderState* target)
+{
+    const auto& semanticState = processor.getSemanticState();
+    const SoloMode soloMode = semanticState.getSoloMode();
+    
+    // SIP模式不使用Cue总线
+    if (soloMode == SoloMode::InPlace) return;
+    
+    const auto& currentLayout = processor.getCurrentLayout();
+    uint8_t cueCount = 0;
+    
+    // 预计算稀疏混音核：只收集Solo通道，音频线程开销与Solo通道数成正比
+    for (const auto& channelInfo : currentLayout.channels) {
+        const int physicalIndex = channelInfo.channelIndex;
+        if (physicalIndex < 0 || physicalIndex >= RenderState::MAX_CHANNELS) continue;
+        if (!semanticState.getSoloState(channelInfo.name)) continue;
+        if (cueCount >= RenderState::MAX_CHANNELS) break;
+        
+        float gainL = 0.0f, gainR = 0.0f;
+        getCuePanGains(channelInfo.name, gainL, gainR);
+        
+        // AFL：推子后，系数包含个人通道增益；PFL：推子前，单位增益
+        const float faderGain = (soloMode == SoloMode::AFL) ? target->channelFinalGain[physicalIndex] : 1.0f;
+        
+        target->cueChannelIndices[cueCount] = static_cast<uint8_t>(physicalIndex);
+        target->cueGainL[cueCount] = gainL * faderGain;
+        target->cueGainR[cueCount] = gainR * faderGain;
+        cueCount++;
+    }
+    
+    target->cueChannelCount = cueCount;
+    target->cueActive = cueCount > 0;
+}
+
+void StateManager::collectGeneratorData(RenderState* target)
+{
+    const auto& currentLayout = processor.getCurrentLayout();
+    uint8_t generatorCount = 0;
+    
+    // 路由表与发生器开关无关：关闭时音频线程仍需要它完成淡出
+    for (const auto& channelInfo : currentLayout.channels) {
+        const int physicalIndex = channelInfo.channelIndex;
+        if (physicalIndex < 0 || physicalIndex >= RenderState::MAX_CHANNELS) continue;
+        if (!processor.isChannelRoutedToGenerator(channelInfo.name)) continue;
+        if (generatorCount >= RenderState::MAX_CHANNELS) break;
+        
+        // Solo/Mute仍然生效：Solo单个扬声器即可逐一校准GAIN_n
+        target->generatorChannelIndices[generatorCount] = static_cast<uint8_t>(physicalIndex);
+        target->generatorGain[generatorCount] = target->channelShouldMute[physicalIndex]
+                                                    ? 0.0f : target->channelFinalGain[physicalIndex];
+        generatorCount++;
+    }
+    
+    target->generatorChannelCount = generatorCount;
+}
+
+void StateManager::getCuePanGains(const juce::String& channelName, float& gainL, float& gainR)
+{
+    // 左侧通道（L、LSS、LRS、LTF...、SUB L）只进左耳，右侧同理，其余（C、LFE、SUB M等）等功率居中
+    const bool isLeft = (channelName.startsWith("L") && channelName != "LFE")
+                        || channelName == "SUB L" || channelName == "SUB_L";
+    const bool isRight = channelName.startsWith("R")
+                         || channelName == "SUB R" || channelName == "SUB_R";
+    
+    if (isLeft) {
+        gainL = 1.0f;
+        gainR = 0.0f;
+    } else if (isRight) {
+        gainL = 0.0f;
+        gainR = 1.0f;
+    } else {
+        gainL = gainR = juce::MathConstants<float>::sqrt2 * 0.5f;
+    }
+}
+
+void StateManager::collectLoudnessMatchData(RenderState* target)
+{
+    // 比较状态标识：激活/静音通道组合 + Mono + 输入源（FNV-1a），0保留为"无状态"
+    uint32_t key = 2166136261u;
+    auto mix = [&key](uint32_t value) {
+        key ^= value;
+        key *= 16777619u;
+    };
+    
+    for (int i = 0; i < RenderState::MAX_CHANNELS; ++i) {
+        mix((target->channelIsActive[i] ? 1u : 0u) | (target->channelShouldMute[i] ? 2u : 0u));
+    }
+    mix(target->monoActive ? 1u : 0u);
+    mix(target->activeInputSource);
+    
+    target->comparisonKey = key | 1u;
+    
+    // 响度匹配Trim直接折算进通道增益，音频线程不增加任何额外运算
+    const float trimDb = processor.loudnessMatcher.getTrimDbForKey(target->comparisonKey);
+    target->loudnessTrimDb = trimDb;
+    
+    if (trimDb != 0.0f) {
+        const float trimGain = juce::Decibels::decibelsToGain(trimDb);
+        for (int i = 0; i < RenderState::MAX_CHANNELS; ++i) {
+            if (target->channelIsActive[i]) {
+                target->channelFinalGain[i] *= trimGain;
+            }
+        }
+    }
+}
+
 void StateManager::commitRenderState()
 {
     // 原子切换活跃和非活跃缓冲区
     RenderState* oldActive = activeRenderState.exchange(inactiveRenderState, std::memory_order_acq_rel);
     inactiveRenderState = oldActive;
+    publishCount.fetch_add(1, std::memory_order_release);
+    
+    // 编辑器下一帧合并刷新按钮
+    processor.markUIStateDirty();
     
     VST3_DBG("StateManager: Render state committed - version " + 
              juce::String(activeRenderState.load()->version.load()));
@@ -471,6 +763,7 @@ void StateManager::triggerStateUpdate()
 {
     // 🚀 使用正确的内存顺序：增加状态版本号，使UI缓存失效
     currentStateVersion.fetch_add(1, std::memory_order_acq_rel);
+    processor.markUIStateDirty();   // 选择模式变化不一定改变渲染快照
     
     // 触发render state更新，将最新状态传递到音频线程
     updateRenderState();
@@ -3,6 +3,8 @@
 #include <JuceHeader.h>
 #include <memory>
 #include <atomic>
+#include <array>
+#include <thread>
 #include "RenderState.h"
 #include "SemanticChannelState.h"
 
@@ -40,10 +42,47 @@ public:
     //=== 音频线程接口（线程安全，无锁）===
     const RenderState* getCurrentRenderState() const noexcept;
     
+    // 累计发布次数（每次缓冲区切换+1），供监控与基准测试判断新快照
+    uint64_t getPublishCount() const noexcept { return publishCount.load(std::memory_order_acquire); }
+    
+    //=== 非音频线程读取当前快照（监控/基准测试）：seqlock方式 ===
+    // 双缓冲的旧快照在下一次收集时被消息线程重写，直接读字段可能读到一半新一半旧的状态。
+    // reader读取期间发布计数或版本号变化（或版本号为奇数 = 正在写入）则重读；reader可能执行多次，只应写入局部结果。
+    // 没有快照时返回false。
+    template <typename Reader>
+    bool readRenderState(Reader&& reader) const
+    {
+        for (;;)
+        {
+            const uint64_t publish = getPublishCount();
+            const RenderState* state = getCurrentRenderState();
+            if (state == nullptr)
+                return false;
+            
+            const uint64_t version = state->version.load(std::memory_order_acquire);
+            if ((version & 1) == 0)
+            {
+                reader(*state);
+                
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (state->version.load(std::memory_order_relaxed) == version && getPublishCount() == publish)
+                    return true;
+            }
+            
+            std::this_thread::yield();
+        }
+    }
+    
+    // 分层重建次数，供基准测试验证Master更新不触发本地层重建
+    uint64_t getMasterLayerRebuildCount() const noexcept { return masterLayerRebuilds.load(std::memory_order_relaxed); }
+    uint64_t getLocalLayerRebuildCount() const noexcept { return localLayerRebuilds.load(std::memory_order_relaxed); }
+    
     //=== SemanticChannelState::StateChangeListener 接口 ===
     void onSoloStateChanged(const juce::String& channelName, bool state) override;
     void onMuteStateChanged(const juce::String& channelName, bool state) override;
     void onGlobalModeChanged() override;
+    void onStateTransactionBegin() override;
+    void onStateTransactionEnd() override;
     
     //=== AudioProcessorValueTreeState::Listener 接口 ===
     void parameterChanged(const juce::String& parameterID, float newValue) override;
@@ -51,6 +90,28 @@ public:
     //=== 布局变化处理 ===
     void onLayoutChanged();
     
+    //=== 外部触发的快照重建（消息线程，如响度匹配Trim更新）===
+    void refreshRenderState();
+    
+    //=== 本地覆盖层变化（消息线程）：只重建本地层，Master层不重新收集 ===
+    void onLocalLayerChanged();
+    
+    //=== 角色切换（消息线程）：下一次发布的快照标记为角色切换，音频线程从当前输出的增益淡化过去 ===
+    // 在ScopedTransaction内调用时，与新角色的全部状态变化合并为同一次发布
+    void stageRoleTransition();
+    
+    //=== 批量更新（消息线程）：作用域内的所有状态变化合并为一次RenderState发布 ===
+    class ScopedTransaction
+    {
+    public:
+        explicit ScopedTransaction(StateManager& managerToUse) : manager(managerToUse) { manager.onStateTransactionBegin(); }
+        ~ScopedTransaction() { manager.onStateTransactionEnd(); }
+        
+    private:
+        StateManager& manager;
+        JUCE_DECLARE_NON_COPYABLE(ScopedTransaction)
+    };
+    
     // 🚀 彻底修复：StateManager统一状态控制接口
     // 遵循原始设计意图：统一所有状态管理到StateManager
     //=== UI控制接口（消息线程）===
@@ -86,6 +147,32 @@ private:
     std::unique_ptr<RenderState> renderStateB;
     std::atomic<RenderState*> activeRenderState{nullptr};    // 音频线程读取
     RenderState* inactiveRenderState{nullptr};               // 消息线程更新
+    std::atomic<uint64_t> publishCount{0};
+    
+    //=== 分层通道状态（消息线程）：按物理通道索引的位掩码，每层只在自身输入变化时重建 ===
+    // - 布局层：激活/SUB通道
+    // - Master层：SemanticChannelState的最终Mute（Slave即Master镜像，含Solo联动）
+    // - 本地层：GAIN_n与本地Trim偏移合成的线性增益 + 本地静音覆盖
+    // collectChannelStates只做按位合并，Master更新不读取任何本地参数
+    static_assert(RenderState::MAX_CHANNELS <= 32, "Channel layers are 32-bit masks");
+    struct ChannelLayers
+    {
+        uint32_t activeMask = 0;
+        uint32_t subMask = 0;
+        uint32_t masterMuteMask = 0;
+        uint32_t localMuteMask = 0;
+        std::array<float, RenderState::MAX_CHANNELS> localGain{};
+    };
+    ChannelLayers channelLayers;
+    std::atomic<bool> layoutLayerDirty{true};
+    std::atomic<bool> masterLayerDirty{true};
+    std::atomic<bool> localLayerDirty{true};
+    std::atomic<uint64_t> masterLayerRebuilds{0};
+    std::atomic<uint64_t> localLayerRebuilds{0};
+    
+    void rebuildLayoutLayer();
+    void rebuildMasterLayer();
+    void rebuildLocalLayer();
     
     //=== 核心方法 ===
     void updateRenderState();
@@ -96,10 +183,24 @@ private:
     void collectChannelStates(RenderState* target);
     void collectMasterBusStates(RenderState* target);
     void collectMonoChannelData(RenderState* target);
+    void collectCueBusData(RenderState* target);
+    void collectGeneratorData(RenderState* target);
+    void collectLoudnessMatchData(RenderState* target);
+    
+    // Cue总线声像：按语义通道名归到左/右/中
+    static void getCuePanGains(const juce::String& channelName, float& gainL, float& gainR);
     
     //=== 内部状态 ===
     bool initialized = false;
     
+    // 批量事务期间推迟RenderState重建（消息线程）
+    int transactionDepth = 0;
+    bool renderStateUpdateDeferred = false;
+    
+    // 角色切换淡化（消息线程）：已标记待发布 / 当前切换序号（随每个快照发布）
+    bool roleTransitionStaged = false;
+    uint32_t roleTransitionSerial = 0;
+    
     // 🚀 彻底修复：UI状态模式管理（线程安全）
     std::atomic<bool> soloSelectionMode{false};
     std::atomic<bool> muteSelectionMode{false};